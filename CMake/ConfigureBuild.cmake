@@ -96,6 +96,7 @@ set(OGRE_STATIC_LIB 0)
 set(OGRE_SET_PROFILING 0)
 set(OGRE_SET_PROFILING_EXHAUSTIVE 0)
 set(OGRE_SET_USE_SIMD 0)
+set(OGRE_SET_USE_SIMD_AVX2 0)
 set(OGRE_SET_RESTRICT_ALIASING 0)
 set(OGRE_SET_IDSTRING_ALWAYS_READABLE 0)
 set(OGRE_SET_DISABLE_AMD_AGS 0)
@@ -192,6 +193,8 @@ elseif (OGRE_PROFILING_PROVIDER STREQUAL "remotery")
   set(OGRE_SET_PROFILING 2)
 elseif (OGRE_PROFILING_PROVIDER STREQUAL "offline")
   set(OGRE_SET_PROFILING 3)
+elseif (OGRE_PROFILING_PROVIDER STREQUAL "trace")
+  set(OGRE_SET_PROFILING 4)
 endif()
 if( OGRE_PROFILING_EXHAUSTIVE )
   set( OGRE_SET_PROFILING_EXHAUSTIVE 1 )
@@ -199,6 +202,9 @@ endif()
 if (OGRE_SIMD_SSE2 OR OGRE_SIMD_NEON)
   set(OGRE_SET_USE_SIMD 1)
 endif()
+if (OGRE_SIMD_SSE2 AND OGRE_SIMD_AVX2)
+  set(OGRE_SET_USE_SIMD_AVX2 1)
+endif()
 if (OGRE_RESTRICT_ALIASING)
   set(OGRE_SET_RESTRICT_ALIASING 1)
 endif()
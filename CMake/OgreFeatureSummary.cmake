@@ -197,6 +197,7 @@ var_to_string(OGRE_CONFIG_MEMTRACK_RELEASE _memtrack_release)
 var_to_string(OGRE_CONFIG_STRING_USE_CUSTOM_ALLOCATOR _string)
 var_to_string(OGRE_SIMD_SSE2 _simdsse2)
 var_to_string(OGRE_SIMD_NEON _simdneon)
+var_to_string(OGRE_SIMD_AVX2 _simdavx2)
 # threading settings
 if (OGRE_CONFIG_THREADS EQUAL 0)
 	set(_threads "none")
@@ -224,6 +225,7 @@ set(_features "${_features}Memory tracker (debug):          ${_memtrack_debug}\n
 set(_features "${_features}Memory tracker (release):        ${_memtrack_release}\n")
 set(_features "${_features}Use SIMD (SSE2):                 ${_simdsse2}\n")
 set(_features "${_features}Use SIMD (NEON):                 ${_simdneon}\n")
+set(_features "${_features}Use SIMD (AVX2):                 ${_simdavx2}\n")
 
 
 set(_features "${_features}\n----------------------------------------------------------------------------\n")
@@ -484,6 +484,8 @@ namespace Ogre
             }
         }
 
+        // Note MipLevelReady lands here too: the texture may have switched from the dummy
+        // texture to its mip tail (see TextureGpu::_notifyMipLevelReady).
         if( mTexturesDescSet )
         {
             // The texture's baked SRV has changed. We always need a new descriptor,
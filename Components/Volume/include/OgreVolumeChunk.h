@@ -39,6 +39,8 @@ namespace Ogre {
 namespace Volume {
 
     class Source;
+    class GridSource;
+    class CSGOperationSource;
     class MeshBuilderCallback;
     class ChunkHandler;
     class MeshBuilder;
@@ -120,9 +122,25 @@ namespace Volume {
         /// The parameters with which the chunktree got loaded.
         ChunkParameters *parameters;
 
+        /// The scene node the chunktree got loaded into.
+        SceneNode *parentNode;
+
+        /// The back lower left corner of the world.
+        Vector3 totalFrom;
+
+        /// The front upper right corner of the world.
+        Vector3 totalTo;
+
+        /// The amount of LOD levels.
+        size_t maxLevels;
+
+        /// The grids with edits of Chunk::combineWithSource waiting for the chunks being processed.
+        std::vector<GridSource*> gridsWithStagedEdits;
+
         /** Constructor.
         */
-        ChunkTreeSharedData(const ChunkParameters *params) : octreeVisible(false), dualGridVisible(false), volumeVisible(true), chunksBeingProcessed(0)
+        ChunkTreeSharedData(const ChunkParameters *params) : octreeVisible(false), dualGridVisible(false), volumeVisible(true), chunksBeingProcessed(0),
+            parentNode(0), totalFrom(Vector3::ZERO), totalTo(Vector3::ZERO), maxLevels(0)
         {
             this->parameters = new ChunkParameters(*params);
         }
@@ -173,6 +191,10 @@ namespace Volume {
         /// Holds some shared data among all chunks of the tree.
         ChunkTreeSharedData *mShared;
 
+        /// Incremented with every request of this chunk and when its geometry is cleared,
+        /// see ChunkRequest::generation.
+        size_t mGeneration;
+
         /** Loads a single chunk of the tree.
         @param parent
             The parent scene node for the volume
@@ -254,6 +276,11 @@ namespace Volume {
         */
         virtual void prepareGeometry(size_t level, OctreeNode *root, DualGridGenerator *dualGridGenerator, MeshBuilder *meshBuilder, const Vector3 &totalFrom, const Vector3 &totalTo);
 
+        /** Frees the geometry of this chunk and all of its children, for example when an update
+        removed everything from their area. Responses to requests still in flight are dropped.
+        */
+        virtual void clearGeometry();
+
         /** Loads the actual geometry when the processing is done.
         @param meshBuilder
             The MeshBuilder holding the geometry.
@@ -347,6 +374,44 @@ namespace Volume {
         */
         virtual void load(SceneNode *parent, const Vector3 &from, const Vector3 &to, size_t level, const ChunkParameters *parameters);
 
+        /** Re-meshes the chunks intersecting the given region, for example the dirty region of a
+        GridSource after combineWithSource. Only the affected chunks get new octrees and meshes,
+        asynchronously, and each of them keeps its old geometry until the new one is ready.
+        Beware that the workers read the source while meshing, so modify it only while no
+        chunks are being processed. combineWithSource takes care of that.
+        @param region
+            The region to update in volume space. Nothing happens if it is null.
+        */
+        virtual void updateRegion(const AxisAlignedBox &region);
+
+        /** Blocks until all chunks of this tree being processed are loaded. Afterwards the
+        workers don't read the source anymore until the next load or update.
+        */
+        virtual void waitForPendingChunks();
+
+        /** Combines a GridSource of this tree with another source and re-meshes the changed
+        region. As the chunks being processed read the grid, the edit is only staged while there
+        are any. The staged edits are then applied and re-meshed together in frameStarted once
+        the chunks in flight are done, so this never blocks.
+        @param gridSource
+            The grid to modify. Either the source of this tree or one it is made of.
+            Its dirty region is cleared.
+        @param operation
+            See GridSource::combineWithSource.
+        @param source
+            See GridSource::combineWithSource.
+        @param center
+            See GridSource::combineWithSource.
+        @param radius
+            See GridSource::combineWithSource.
+        */
+        virtual void combineWithSource(GridSource *gridSource, CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius);
+
+        /** Applies the edits staged by combineWithSource and re-meshes the changed region.
+        Does nothing while chunks are being processed, as they read the grids.
+        */
+        virtual void applyStagedEdits();
+
         /** Loads a TextureSource volume scene from a config file.
         @param parent
             The parent scene node for the volume.
@@ -73,6 +73,10 @@ namespace Volume {
 
         /// Whether this is an update of an existing tree
         bool isUpdate;
+
+        /// The generation of the origin chunk when this request was made. The response is
+        /// dropped if the chunk got requested again in the meantime.
+        size_t generation;
         
         /** Stream operator <<.
         @param o
@@ -93,16 +97,25 @@ namespace Volume {
         /// The workqueue load request.
         static const uint16 WORKQUEUE_LOAD_REQUEST;
 
-        /// The workqueue.
+        /// The dedicated workqueue meshing the chunks.
         WorkQueue* mWQ;
 
         /// The workqueue channel.
         uint16 mWorkQueueChannel;
+
+        /// The amount of loaded root chunks.
+        size_t mNumRootChunks;
         
-        /** Initializes the WorkQueue (once).
+        /** Initializes the WorkQueue (once). The chunks are meshed by an own pool with
+        one worker per hardware thread so they don't compete with other users of
+        Root's WorkQueue like resource loading.
         */
         void init();
 
+        /** Stops the workers and destroys the WorkQueue.
+        */
+        void shutdown();
+
     public:
         
         /** Constructor
@@ -119,10 +132,21 @@ namespace Volume {
         */
         void addRequest(const ChunkRequest &req);
 
-        /** Calls the process-update of the WorkQueue so it doesn't block.
+        /** Calls the process-update of the WorkQueue so it doesn't block. Must be called
+        regularly from the main thread to integrate the finished chunks.
         */
         void processWorkQueue();
 
+        /** Registers a loaded root chunk.
+        */
+        void addRootChunk();
+
+        /** Unregisters a root chunk. The WorkQueue is shut down along with the last one,
+        as this handler is a static and would otherwise outlive Root. The root chunk
+        must not have chunks being processed anymore.
+        */
+        void removeRootChunk();
+
         /// Implementation for WorkQueue::RequestHandler
         WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
         
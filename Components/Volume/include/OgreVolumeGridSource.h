@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __Ogre_Volume_GridSource_H__
 
 #include "OgreVector4.h"
+#include "OgreAxisAlignedBox.h"
 
 #include "OgreVolumePrerequisites.h"
 #include "OgreVolumeSource.h"
@@ -73,6 +74,30 @@ namespace Volume {
 
         /// Factor to come from volume coordinate to world coordinate.
         Real mVolumeSpaceToWorldSpaceFactor;
+
+        /// The area changed by combineWithSource since the last clearDirtyRegion, null if nothing changed.
+        AxisAlignedBox mDirtyRegion;
+
+        /** An edit evaluated by stageCombineWithSource but not yet written to the grid.
+        */
+        typedef struct StagedEdit
+        {
+            /// The first cell of the edited box.
+            int xStart, yStart, zStart;
+
+            /// The cell behind the last one of the edited box.
+            int xEnd, yEnd, zEnd;
+
+            /// The new values of the cells, x running fastest.
+            std::vector<float> values;
+        } StagedEdit;
+        typedef std::vector<StagedEdit> VecStagedEdit;
+
+        /// The staged edits in the order they were made.
+        VecStagedEdit mStagedEdits;
+
+        /// Reads the grid with the staged edits on top, the first operand of staged edits.
+        class StagedView;
         
         /** Overridden from VolumeSource.
         */
@@ -106,6 +131,40 @@ namespace Volume {
         */
         virtual void setVolumeGridValue(int x, int y, int z, float value) = 0;
 
+        /** Gets the volume value of a position as it will be once the staged edits are applied.
+        @param x
+            The x position.
+        @param y
+            The y position.
+        @param z
+            The z position.
+        @return
+            The density of the newest staged edit covering the position, else the one of the grid.
+        */
+        float getStagedVolumeGridValue(int x, int y, int z) const;
+
+        /** Evaluates an operation on the cells around a center.
+        @param operation
+            See combineWithSource.
+        @param source
+            See combineWithSource.
+        @param center
+            See combineWithSource.
+        @param radius
+            See combineWithSource.
+        @param stage
+            Whether to stage the result instead of writing it to the grid.
+        */
+        void evaluateOperation(CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius, bool stage);
+
+        /** Merges the area of some changed cells into the dirty region.
+        @param xStart
+            The first changed cell on the x axis, likewise for y and z.
+        @param xEnd
+            The cell behind the last changed one on the x axis, likewise for y and z.
+        */
+        void mergeDirtyRegion(int xStart, int yStart, int zStart, int xEnd, int yEnd, int zEnd);
+
         /** Gets a gradient of a point with optional sobel blurring.
         @param x
             The x coordinate of the point.
@@ -153,6 +212,14 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const;
 
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const;
+
+        /** Overridden from VolumeSource.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const;
+
         /** Gets the width of the texture.
         @return
             The width of the texture.
@@ -172,7 +239,9 @@ namespace Volume {
         size_t getDepth() const;
 
         /** Updates this grid with another source in a certain area. Use
-        it for example to add spheres as a brush.
+        it for example to add spheres as a brush. Chunks being meshed read the grid
+        concurrently, so use Chunk::combineWithSource on grids of loaded chunk trees or
+        stageCombineWithSource while chunks are in flight.
         @param operation
             The operation to use, will use this source and the other given one as operands. Beware that
             this function overrides the maybe existing sources in the operation.
@@ -186,6 +255,43 @@ namespace Volume {
             because the density outside of the sphere is needed, too.
         */
         virtual void combineWithSource(CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius);
+
+        /** Like combineWithSource, but only reads the grid and keeps the result until
+        applyStagedEdits. It is safe while chunks are being meshed from this grid. Later staged
+        edits see the earlier ones, and the operation and source aren't referenced afterwards.
+        @param operation
+            See combineWithSource.
+        @param source
+            See combineWithSource.
+        @param center
+            See combineWithSource.
+        @param radius
+            See combineWithSource.
+        */
+        void stageCombineWithSource(CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius);
+
+        /** Gets whether there are edits of stageCombineWithSource not yet written to the grid.
+        @return
+            true if applyStagedEdits has something to do.
+        */
+        bool hasStagedEdits() const;
+
+        /** Writes the staged edits to the grid in the order they were made and merges them into
+        the dirty region. Nothing may read the grid concurrently.
+        */
+        void applyStagedEdits();
+
+        /** Gets the area changed by combineWithSource since the last call to clearDirtyRegion.
+        It includes the neighbouring cells whose gradients depend on the changed values. Pass it
+        to Chunk::updateRegion to re-mesh only the affected chunks.
+        @return
+            The area in volume space, null if nothing changed.
+        */
+        const AxisAlignedBox& getDirtyRegion() const;
+
+        /** Marks the whole grid as up to date again.
+        */
+        void clearDirtyRegion();
     
         
         /** Overridden from VolumeSource.
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #define __Ogre_Volume_MeshBuilder_H__
 
 #include <vector>
+#include <string.h>
 #include "OgreManualObject.h"
 #include "OgreVector3.h"
 #include "OgreAxisAlignedBox.h"
@@ -133,9 +134,11 @@ namespace Volume {
         /// The buffer binding.
         static const unsigned short MAIN_BINDING;
 
-        /// Map to get a vertex index.
-        typedef map<Vertex, size_t>::type UMapVertexIndex;
-        UMapVertexIndex mIndexMap;
+        /** Open addressing hash table to get a vertex index. Holds the index + 1 of the vertex
+        in mVertices, 0 marks an empty slot. The size is always a power of two.
+        */
+        typedef vector<size_t>::type VecIndexSlots;
+        VecIndexSlots mIndexSlots;
 
          /// Holds the vertices of the mesh.
         VecVertex mVertices;
@@ -149,17 +152,55 @@ namespace Volume {
         /// Holds whether the initial bounding box has been set
         bool mBoxInit;
         
+        /** Hashes the bits of a vertex, FNV-1a.
+        @param v
+            The vertex.
+        @return
+            The hash.
+        */
+        static inline size_t hashVertex(const Vertex &v)
+        {
+            const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&v);
+            uint32 hash = 2166136261u;
+            for (size_t i = 0; i < sizeof(Vertex); ++i)
+            {
+                hash = (hash ^ bytes[i]) * 16777619u;
+            }
+            return hash;
+        }
+
+        /** Doubles the size of mIndexSlots and reinserts the known vertices.
+        */
+        void growIndexSlots();
+
         /** Adds a vertex to the data structure, reusing the index if it is already known.
         @param v
             The vertex.
         */
         inline void addVertex(const Vertex &v)
         {
+            // Keep the load factor below 0.5 so the probe sequences stay short.
+            if ((mVertices.size() + 1) * 2 > mIndexSlots.size())
+            {
+                growIndexSlots();
+            }
+            const size_t mask = mIndexSlots.size() - 1;
+            size_t slot = hashVertex(v) & mask;
             size_t i = 0;
-            if (mIndexMap.find(v) == mIndexMap.end())
+            while (mIndexSlots[slot])
+            {
+                i = mIndexSlots[slot] - 1;
+                // Same bitwise comparison the previously used map did via operator<.
+                if (memcmp(&mVertices[i], &v, sizeof(Vertex)) == 0)
+                {
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+            if (!mIndexSlots[slot])
             {
                 i = mVertices.size();
-                mIndexMap[v] = i;
+                mIndexSlots[slot] = i + 1;
                 mVertices.push_back(v);
 
                 // Update bounding box
@@ -196,10 +237,6 @@ namespace Volume {
                     }
                 }
             }
-            else
-            {
-                i = mIndexMap[v];
-            }
             mIndices.push_back(i);
         }
 
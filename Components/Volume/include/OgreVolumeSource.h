@@ -72,6 +72,9 @@ namespace Volume {
 
         /// The amount of items being written as one chunk during serialization.
         static const size_t SERIALIZATION_CHUNK_SIZE;
+
+        /// The amount of samples combining sources evaluate at once in their batched functions.
+        static const size_t BATCH_SIZE = 64;
         
         /** Destructor.
         */
@@ -93,6 +96,38 @@ namespace Volume {
         */
         virtual Real getValue(const Vector3 &position) const = 0;
 
+        /** Gets the density values of many positions at once. The positions are given as
+        structure of arrays so sources can evaluate them in tight loops with one virtual call
+        per batch instead of one per sample. The default implementation calls getValue for
+        each position.
+        @param x
+            The x coordinates of the positions.
+        @param y
+            The y coordinates of the positions.
+        @param z
+            The z coordinates of the positions.
+        @param values
+            Will hold the densities, must have room for count values.
+        @param count
+            The amount of positions.
+        */
+        virtual void getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const;
+
+        /** Gets the density values and gradients of many positions at once. The default
+        implementation calls getValueAndGradient for each position.
+        @param x
+            The x coordinates of the positions.
+        @param y
+            The y coordinates of the positions.
+        @param z
+            The z coordinates of the positions.
+        @param values
+            Will hold the gradients in x, y, z and the densities in w, must have room for count values.
+        @param count
+            The amount of positions.
+        */
+        virtual void getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const;
+
         /** Serializes a volume source to a discrete grid file with deflated
         compression. To achieve better compression, all density values are clamped
         within a maximum absolute value of (to - from).length() / 16.0. The values
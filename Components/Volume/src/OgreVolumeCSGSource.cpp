@@ -66,6 +66,29 @@ namespace Volume {
         Vector3 pMinCenter = position - mCenter;
         return mR - pMinCenter.length();
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGSphereSource::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Real dX = x[i] - mCenter.x;
+            const Real dY = y[i] - mCenter.y;
+            const Real dZ = z[i] - mCenter.z;
+            values[i] = mR - Math::Sqrt(dX * dX + dY * dY + dZ * dZ);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGSphereSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = CSGSphereSource::getValueAndGradient(Vector3(x[i], y[i], z[i]));
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -93,6 +116,31 @@ namespace Volume {
         // Lineare Algebra: Ein geometrischer Zugang, S.180-181
         return mD - mNormal.dotProduct(position);
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGPlaneSource::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = mD - (mNormal.x * x[i] + mNormal.y * y[i] + mNormal.z * z[i]);
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGPlaneSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = Vector4(
+                mNormal.x,
+                mNormal.y,
+                mNormal.z,
+                mD - (mNormal.x * x[i] + mNormal.y * y[i] + mNormal.z * z[i])
+                );
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -202,6 +250,46 @@ namespace Volume {
         }
         return valueB;
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGIntersectionSource::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            const size_t batch = count - start < BATCH_SIZE ? count - start : BATCH_SIZE;
+            mA->getValues(x + start, y + start, z + start, values + start, batch);
+            mB->getValues(x + start, y + start, z + start, valuesB, batch);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                if (!(values[start + i] < valuesB[i]))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGIntersectionSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            const size_t batch = count - start < BATCH_SIZE ? count - start : BATCH_SIZE;
+            mA->getValuesAndGradients(x + start, y + start, z + start, values + start, batch);
+            mB->getValuesAndGradients(x + start, y + start, z + start, valuesB, batch);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                if (!(values[start + i].w < valuesB[i].w))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -240,6 +328,46 @@ namespace Volume {
         }
         return valueB;
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGUnionSource::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            const size_t batch = count - start < BATCH_SIZE ? count - start : BATCH_SIZE;
+            mA->getValues(x + start, y + start, z + start, values + start, batch);
+            mB->getValues(x + start, y + start, z + start, valuesB, batch);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                if (!(values[start + i] > valuesB[i]))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGUnionSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            const size_t batch = count - start < BATCH_SIZE ? count - start : BATCH_SIZE;
+            mA->getValuesAndGradients(x + start, y + start, z + start, values + start, batch);
+            mB->getValuesAndGradients(x + start, y + start, z + start, valuesB, batch);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                if (!(values[start + i].w > valuesB[i].w))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -278,6 +406,48 @@ namespace Volume {
         }
         return valueB;
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGDifferenceSource::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        Real valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            const size_t batch = count - start < BATCH_SIZE ? count - start : BATCH_SIZE;
+            mA->getValues(x + start, y + start, z + start, values + start, batch);
+            mB->getValues(x + start, y + start, z + start, valuesB, batch);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                valuesB[i] = -valuesB[i];
+                if (!(values[start + i] < valuesB[i]))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGDifferenceSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        Vector4 valuesB[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            const size_t batch = count - start < BATCH_SIZE ? count - start : BATCH_SIZE;
+            mA->getValuesAndGradients(x + start, y + start, z + start, values + start, batch);
+            mB->getValuesAndGradients(x + start, y + start, z + start, valuesB, batch);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                valuesB[i] = (Real)-1.0 * valuesB[i];
+                if (!(values[start + i].w < valuesB[i].w))
+                {
+                    values[start + i] = valuesB[i];
+                }
+            }
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -330,6 +500,28 @@ namespace Volume {
     {
         return (Real)-1.0 * mSrc->getValue(position);
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGNegateSource::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        mSrc->getValues(x, y, z, values, count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = -values[i];
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGNegateSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        mSrc->getValuesAndGradients(x, y, z, values, count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = (Real)-1.0 * values[i];
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -350,6 +542,50 @@ namespace Volume {
     {
         return mSrc->getValue(position / mScale) * mScale;
     }
+
+    //-----------------------------------------------------------------------
+
+    void CSGScaleSource::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        Real scaledX[BATCH_SIZE], scaledY[BATCH_SIZE], scaledZ[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            const size_t batch = count - start < BATCH_SIZE ? count - start : BATCH_SIZE;
+            for (size_t i = 0; i < batch; ++i)
+            {
+                scaledX[i] = x[start + i] / mScale;
+                scaledY[i] = y[start + i] / mScale;
+                scaledZ[i] = z[start + i] / mScale;
+            }
+            mSrc->getValues(scaledX, scaledY, scaledZ, values + start, batch);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                values[start + i] *= mScale;
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void CSGScaleSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        Real scaledX[BATCH_SIZE], scaledY[BATCH_SIZE], scaledZ[BATCH_SIZE];
+        for (size_t start = 0; start < count; start += BATCH_SIZE)
+        {
+            const size_t batch = count - start < BATCH_SIZE ? count - start : BATCH_SIZE;
+            for (size_t i = 0; i < batch; ++i)
+            {
+                scaledX[i] = x[start + i] / mScale;
+                scaledY[i] = y[start + i] / mScale;
+                scaledZ[i] = z[start + i] / mScale;
+            }
+            mSrc->getValuesAndGradients(scaledX, scaledY, scaledZ, values + start, batch);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                values[start + i] *= mScale;
+            }
+        }
+    }
     
     //-----------------------------------------------------------------------
 
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreVolumeIsoSurfaceMC.h"
 #include "OgreVolumeOctreeNodeSplitPolicy.h"
 #include "OgreVolumeTextureSource.h"
+#include "OgreVolumeCSGSource.h"
 #include "OgreVolumeChunkHandler.h"
 #include "OgreVolumeMeshBuilder.h"
 #include "OgreVolumeDualGridGenerator.h"
@@ -42,6 +43,8 @@ THE SOFTWARE.
 #include "OgreVolumeMeshBuilder.h"
 #include "OgreVolumeOctreeNode.h"
 
+#include <algorithm>
+
 namespace Ogre {
 namespace Volume {
 
@@ -68,6 +71,7 @@ namespace Volume {
             req.level = level;
             req.maxLevels = maxLevels;
             req.isUpdate = mShared->parameters->updateFrom != Vector3::ZERO || mShared->parameters->updateTo != Vector3::ZERO;
+            req.generation = ++mGeneration;
 
             req.origin = this;
             req.root = OGRE_NEW OctreeNode(from, to);
@@ -149,7 +153,8 @@ namespace Volume {
     {
 
         // Handle the situation where we update an existing tree
-        if (mShared->parameters->updateFrom != Vector3::ZERO || mShared->parameters->updateTo != Vector3::ZERO)
+        const bool isUpdate = mShared->parameters->updateFrom != Vector3::ZERO || mShared->parameters->updateTo != Vector3::ZERO;
+        if (isUpdate)
         {
             // Early out if an update of a part of the tree volume is going on and this chunk is outside of the area.
             AxisAlignedBox chunkCube(from, to);
@@ -158,26 +163,23 @@ namespace Volume {
             {
                 return;
             }
-            // Free memory from old mesh version
-            if (mRenderOp.vertexData)
-            {
-                OGRE_DELETE mRenderOp.vertexData;
-                mRenderOp.vertexData = 0;
-            }
-            if (mRenderOp.indexData)
-            {
-                OGRE_DELETE mRenderOp.indexData;
-                mRenderOp.indexData = 0;
-            }
+            // The old mesh version stays visible until loadGeometry swaps in the new one.
+        }
+        else
+        {
+            // Set to invisible for now.
+            setVisible(false);
+            mInvisible = true;
         }
-
-        // Set to invisible for now.
-        setVisible(false);
-        mInvisible = true;
         
         // Don't generate this chunk if it doesn't contribute to the whole volume.
         if (!contributesToVolumeMesh(from, to))
         {
+            // Nothing is left of the surface here, so the children can't have any either.
+            if (isUpdate)
+            {
+                clearGeometry();
+            }
             return;
         }
     
@@ -203,8 +205,44 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void Chunk::clearGeometry()
+    {
+        // Responses to requests issued before this are stale now; don't let them bring the mesh back.
+        ++mGeneration;
+
+        OGRE_DELETE mRenderOp.vertexData;
+        mRenderOp.vertexData = 0;
+        OGRE_DELETE mRenderOp.indexData;
+        mRenderOp.indexData = 0;
+        setVisible(false);
+        mInvisible = true;
+
+        if (mChildren)
+        {
+            mChildren[0]->clearGeometry();
+            if (mChildren[1])
+            {
+                mChildren[1]->clearGeometry();
+                mChildren[2]->clearGeometry();
+                mChildren[3]->clearGeometry();
+                mChildren[4]->clearGeometry();
+                mChildren[5]->clearGeometry();
+                mChildren[6]->clearGeometry();
+                mChildren[7]->clearGeometry();
+            }
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     void Chunk::loadGeometry(MeshBuilder *meshBuilder, DualGridGenerator *dualGridGenerator, OctreeNode *root, size_t level, bool isUpdate)
     {
+        // Free memory from the old mesh version which was shown until now.
+        OGRE_DELETE mRenderOp.vertexData;
+        mRenderOp.vertexData = 0;
+        OGRE_DELETE mRenderOp.indexData;
+        mRenderOp.indexData = 0;
+
         size_t chunkTriangles = meshBuilder->generateBuffers(mRenderOp);
         mInvisible = chunkTriangles == 0;
 
@@ -217,7 +255,7 @@ namespace Volume {
 
         if (!mInvisible)
         {
-            if (isUpdate)
+            if (isUpdate && isAttached())
             {
                 mNode->detachObject(this);
             }
@@ -248,7 +286,7 @@ namespace Volume {
     //-----------------------------------------------------------------------
 
     Chunk::Chunk() : SimpleRenderable(0, new ObjectMemoryManager()), mNode(0), mError(false), mDualGrid(0), mOctree(0), mChildren(0),
-        mInvisible(false), isRoot(false), mShared(0)
+        mInvisible(false), isRoot(false), mShared(0), mGeneration(0)
     {
     }
     
@@ -265,6 +303,22 @@ namespace Volume {
             Root::getSingleton().removeFrameListener(this);
         }
 
+        if (isRoot && mShared)
+        {
+            // The workers still reference the chunks of this tree.
+            if (Root::getSingletonPtr())
+            {
+                waitForPendingChunks();
+            }
+            // Don't lose edits made while the last chunks were meshed, the grids outlive the tree.
+            for (std::vector<GridSource*>::iterator it = mShared->gridsWithStagedEdits.begin();
+                it != mShared->gridsWithStagedEdits.end(); ++it)
+            {
+                (*it)->applyStagedEdits();
+            }
+            mChunkHandler.removeRootChunk();
+        }
+
         if (mChildren)
         {
             OGRE_DELETE mChildren[0];
@@ -325,21 +379,22 @@ namespace Volume {
         if (parameters->updateFrom == Vector3::ZERO && parameters->updateTo == Vector3::ZERO)
         {
             mShared = new ChunkTreeSharedData(parameters);
+            mShared->parentNode = parent;
+            mShared->totalFrom = from;
+            mShared->totalTo = to;
+            mShared->maxLevels = level;
             parent->scale(Vector3(parameters->scale));
+            mChunkHandler.addRootChunk();
         }
 
-        mShared->chunksBeingProcessed = 0;
+        // An update might start while chunks of a former one are still being processed, so don't reset the counter here.
         
         doLoad(parent, from, to, from, to, level, level);
 
         // Wait for the threads.
         if (!parameters->async)
         {
-            while(mShared->chunksBeingProcessed)
-            {
-                OGRE_THREAD_SLEEP(0);
-                mChunkHandler.processWorkQueue();
-            }
+            waitForPendingChunks();
         }
         
     
@@ -352,6 +407,90 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void Chunk::updateRegion(const AxisAlignedBox &region)
+    {
+        if (!isRoot || !mShared)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+                "Only a loaded root chunk can be updated!",
+                __FUNCTION__);
+        }
+        if (region.isNull())
+        {
+            return;
+        }
+
+        AxisAlignedBox clampedRegion = region.intersection(AxisAlignedBox(mShared->totalFrom, mShared->totalTo));
+        if (clampedRegion.isNull())
+        {
+            return;
+        }
+
+        ChunkParameters *parameters = mShared->parameters;
+        parameters->updateFrom = clampedRegion.getMinimum();
+        parameters->updateTo = clampedRegion.getMaximum();
+        doLoad(mShared->parentNode, mShared->totalFrom, mShared->totalTo, mShared->totalFrom, mShared->totalTo, mShared->maxLevels, mShared->maxLevels);
+        parameters->updateFrom = Vector3::ZERO;
+        parameters->updateTo = Vector3::ZERO;
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void Chunk::waitForPendingChunks()
+    {
+        while (mShared->chunksBeingProcessed)
+        {
+            OGRE_THREAD_SLEEP(0);
+            mChunkHandler.processWorkQueue();
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
+    void Chunk::combineWithSource(GridSource *gridSource, CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius)
+    {
+        if (!isRoot || !mShared)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, 
+                "Only a loaded root chunk can be updated!",
+                __FUNCTION__);
+        }
+
+        // The workers read the grid, so stage the edit. It's applied right away if no chunks
+        // are in flight, else by frameStarted once they are done.
+        gridSource->stageCombineWithSource(operation, source, center, radius);
+        if (std::find(mShared->gridsWithStagedEdits.begin(), mShared->gridsWithStagedEdits.end(), gridSource) ==
+            mShared->gridsWithStagedEdits.end())
+        {
+            mShared->gridsWithStagedEdits.push_back(gridSource);
+        }
+
+        applyStagedEdits();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Chunk::applyStagedEdits()
+    {
+        if (mShared->chunksBeingProcessed || mShared->gridsWithStagedEdits.empty())
+        {
+            return;
+        }
+
+        AxisAlignedBox region;
+        for (std::vector<GridSource*>::iterator it = mShared->gridsWithStagedEdits.begin();
+            it != mShared->gridsWithStagedEdits.end(); ++it)
+        {
+            (*it)->applyStagedEdits();
+            region.merge((*it)->getDirtyRegion());
+            (*it)->clearDirtyRegion();
+        }
+        mShared->gridsWithStagedEdits.clear();
+        updateRegion(region);
+    }
+    
+    //-----------------------------------------------------------------------
+
     void Chunk::load(SceneNode *parent, SceneManager *sceneManager, const String& filename, bool validSourceResult, MeshBuilderCallback *lodCallback, const String& resourceGroup)
     {
         ConfigFile config;
@@ -475,7 +614,13 @@ namespace Volume {
 
     bool Chunk::frameStarted(const FrameEvent& evt)
     {
-    
+        // The chunks are meshed on an own WorkQueue which Root doesn't update.
+        if (isRoot)
+        {
+            mChunkHandler.processWorkQueue();
+            applyStagedEdits();
+        }
+
         if (mInvisible)
         {
             return true;
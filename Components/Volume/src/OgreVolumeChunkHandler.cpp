@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreVolumeMeshBuilder.h"
 #include "OgreVolumeOctreeNode.h"
 #include "OgreVolumeDualGridGenerator.h"
+#include "Threading/OgreDefaultWorkQueue.h"
 
 namespace Ogre {
 namespace Volume {
@@ -43,7 +44,21 @@ namespace Volume {
     {
         if (!mWQ)
         {
-            mWQ = Root::getSingleton().getWorkQueue();
+            DefaultWorkQueue *queue = OGRE_NEW DefaultWorkQueue("Ogre/VolumeRendering");
+            // Don't stall the frame when lots of chunks finish at once.
+            queue->setResponseProcessingTimeLimit(10);
+#if OGRE_THREAD_SUPPORT
+            unsigned threadCount = OGRE_THREAD_HARDWARE_CONCURRENCY;
+            if (!threadCount)
+            {
+                threadCount = 1;
+            }
+            queue->setWorkerThreadCount(threadCount);
+#endif
+            // Meshing is pure CPU work, the buffers get created in the response.
+            queue->setWorkersCanAccessRenderSystem(false);
+            queue->startup();
+            mWQ = queue;
             mWorkQueueChannel = mWQ->getChannel("Ogre/VolumeRendering");
             mWQ->addResponseHandler(mWorkQueueChannel, this);
             mWQ->addRequestHandler(mWorkQueueChannel, this);
@@ -52,7 +67,23 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
     
-    ChunkHandler::ChunkHandler() : mWQ(0), mWorkQueueChannel(0)
+    void ChunkHandler::shutdown()
+    {
+        // Root might already be shutdown and the queue can't log anymore then,
+        // the process is exiting anyway.
+        if (mWQ && Root::getSingletonPtr())
+        {
+            mWQ->removeRequestHandler(mWorkQueueChannel, this);
+            mWQ->removeResponseHandler(mWorkQueueChannel, this);
+            mWQ->shutdown();
+            OGRE_DELETE mWQ;
+            mWQ = 0;
+        }
+    }
+
+    //-----------------------------------------------------------------------
+    
+    ChunkHandler::ChunkHandler() : mWQ(0), mWorkQueueChannel(0), mNumRootChunks(0)
     {
     }
 
@@ -60,12 +91,8 @@ namespace Volume {
     
     ChunkHandler::~ChunkHandler()
     {
-        // Root might already be shutdown.
-        if (mWQ && Root::getSingletonPtr())
-        {
-            mWQ->removeRequestHandler(mWorkQueueChannel, this);
-            mWQ->removeResponseHandler(mWorkQueueChannel, this);
-        }
+        // The last root chunk normally shut the queue down already.
+        shutdown();
     }
 
     //-----------------------------------------------------------------------
@@ -80,7 +107,28 @@ namespace Volume {
   
     void ChunkHandler::processWorkQueue()
     {
-        mWQ->processResponses();
+        if (mWQ)
+        {
+            mWQ->processResponses();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+  
+    void ChunkHandler::addRootChunk()
+    {
+        ++mNumRootChunks;
+    }
+
+    //-----------------------------------------------------------------------
+  
+    void ChunkHandler::removeRootChunk()
+    {
+        assert(mNumRootChunks > 0);
+        if (--mNumRootChunks == 0)
+        {
+            shutdown();
+        }
     }
 
     //-----------------------------------------------------------------------
@@ -99,7 +147,15 @@ namespace Volume {
         if (res->succeeded())
         {
             ChunkRequest cReq = any_cast<ChunkRequest>(res->getRequest()->getData());
-            cReq.origin->loadGeometry(cReq.meshBuilder, cReq.dualGridGenerator, cReq.root, cReq.level, cReq.isUpdate);
+            if (cReq.generation == cReq.origin->mGeneration)
+            {
+                cReq.origin->loadGeometry(cReq.meshBuilder, cReq.dualGridGenerator, cReq.root, cReq.level, cReq.isUpdate);
+            }
+            else
+            {
+                // Stale, a newer request of this chunk is on its way.
+                cReq.origin->mShared->chunksBeingProcessed--;
+            }
             OGRE_DELETE cReq.root;
             OGRE_DELETE cReq.dualGridGenerator;
             OGRE_DELETE cReq.meshBuilder;
@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "OgreRay.h"
 #include "OgreVolumeCSGSource.h"
 
+#include <algorithm>
+
 namespace Ogre {
 namespace Volume {
     
@@ -198,6 +200,26 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
     
+    void GridSource::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = GridSource::getValue(Vector3(x[i], y[i], z[i]));
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+    
+    void GridSource::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = GridSource::getValueAndGradient(Vector3(x[i], y[i], z[i]));
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+    
     size_t GridSource::getWidth() const
     {
         return mWidth;
@@ -219,20 +241,75 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
     
-    void GridSource::combineWithSource(CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius)
+    class GridSource::StagedView : public Source
+    {
+    protected:
+
+        /// The grid whose staged values are read.
+        const GridSource &mGrid;
+
+    public:
+
+        StagedView(const GridSource &grid) : mGrid(grid)
+        {
+        }
+
+        /** Overridden from VolumeSource.
+        */
+        virtual Real getValue(const Vector3 &position) const
+        {
+            // The operation is only evaluated at cell positions, so take the nearest cell.
+            return (Real)mGrid.getStagedVolumeGridValue(
+                (int)(position.x * mGrid.mPosXScale + (Real)0.5),
+                (int)(position.y * mGrid.mPosYScale + (Real)0.5),
+                (int)(position.z * mGrid.mPosZScale + (Real)0.5));
+        }
+
+        /** Overridden from VolumeSource.
+        */
+        virtual Vector4 getValueAndGradient(const Vector3 &position) const
+        {
+            // Combining the cells only needs the values, the gradient stays the one of the grid.
+            Vector4 result = mGrid.GridSource::getValueAndGradient(position);
+            result.w = getValue(position);
+            return result;
+        }
+    };
+
+    //-----------------------------------------------------------------------
+
+    float GridSource::getStagedVolumeGridValue(int x, int y, int z) const
+    {
+        for (VecStagedEdit::const_reverse_iterator it = mStagedEdits.rbegin(); it != mStagedEdits.rend(); ++it)
+        {
+            if (x >= it->xStart && x < it->xEnd && y >= it->yStart && y < it->yEnd && z >= it->zStart && z < it->zEnd)
+            {
+                return it->values[((z - it->zStart) * (it->yEnd - it->yStart) + (y - it->yStart)) * (it->xEnd - it->xStart) + (x - it->xStart)];
+            }
+        }
+        return getVolumeGridValue(x, y, z);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void GridSource::evaluateOperation(CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius, bool stage)
     {
         Real worldWidthScale = (Real)1.0 / mPosXScale;
         Real worldHeightScale = (Real)1.0 / mPosYScale;
         Real worldDepthScale = (Real)1.0 / mPosZScale;
 
-        operation->setSourceA(this);
+        // Staged edits must not touch anything the workers read, mTrilinearValue included,
+        // so they read the cells through the view.
+        StagedView stagedView(*this);
+        operation->setSourceA(stage ? static_cast<Source*>(&stagedView) : this);
         operation->setSourceB(source);
         // No need for trilineaer interpolation here as we iterate over the
         // cells anyway.
         bool oldTrilinearValue = mTrilinearValue;
-        mTrilinearValue = false;
-        float value;
-        int x, y;
+        if (!stage)
+        {
+            mTrilinearValue = false;
+        }
         Vector3 scaledCenter(center.x * mPosXScale, center.y * mPosYScale, center.z * mPosZScale);
         int xStart = Math::Clamp(static_cast<int>(scaledCenter.x - radius * mPosXScale), 0, static_cast<int>(mWidth));
         int xEnd = Math::Clamp(static_cast<int>(scaledCenter.x + radius * mPosXScale), 0, static_cast<int>(mWidth));
@@ -240,23 +317,141 @@ namespace Volume {
         int yEnd = Math::Clamp(static_cast<int>(scaledCenter.y + radius * mPosYScale), 0, static_cast<int>(mHeight));
         int zStart = Math::Clamp(static_cast<int>(scaledCenter.z - radius * mPosZScale), 0, static_cast<int>(mDepth));
         int zEnd = Math::Clamp(static_cast<int>(scaledCenter.z + radius * mPosZScale), 0, static_cast<int>(mDepth));
-        Vector3 pos;
+        const bool isEmpty = xStart >= xEnd || yStart >= yEnd || zStart >= zEnd;
+
+        StagedEdit edit;
+        if (stage && !isEmpty)
+        {
+            edit.xStart = xStart;
+            edit.yStart = yStart;
+            edit.zStart = zStart;
+            edit.xEnd = xEnd;
+            edit.yEnd = yEnd;
+            edit.zEnd = zEnd;
+            edit.values.resize((size_t)(xEnd - xStart) * (size_t)(yEnd - yStart) * (size_t)(zEnd - zStart));
+        }
+
+        // Evaluate the operation in batches along x. Every cell only reads its own grid
+        // value, so reading a whole batch before writing it back gives the same result.
+        Real posX[BATCH_SIZE], posY[BATCH_SIZE], posZ[BATCH_SIZE], values[BATCH_SIZE];
+        size_t stagedIndex = 0;
         for (int z = zStart; z < zEnd; ++z)
         {
-            for (y = yStart; y < yEnd; ++y)
+            for (int y = yStart; y < yEnd; ++y)
             {
-                for (x = xStart; x < xEnd; ++x)
+                for (int batchStart = xStart; batchStart < xEnd; batchStart += (int)BATCH_SIZE)
                 {
-                    pos.x = x * worldWidthScale;
-                    pos.y = y * worldHeightScale;
-                    pos.z = z * worldDepthScale;
-                    value = operation->getValue(pos);
-                    setVolumeGridValue(x, y, z, value);
+                    const int batchEnd = std::min(batchStart + (int)BATCH_SIZE, xEnd);
+                    for (int x = batchStart; x < batchEnd; ++x)
+                    {
+                        posX[x - batchStart] = x * worldWidthScale;
+                        posY[x - batchStart] = y * worldHeightScale;
+                        posZ[x - batchStart] = z * worldDepthScale;
+                    }
+                    operation->getValues(posX, posY, posZ, values, batchEnd - batchStart);
+                    for (int x = batchStart; x < batchEnd; ++x)
+                    {
+                        if (stage)
+                        {
+                            edit.values[stagedIndex++] = (float)values[x - batchStart];
+                        }
+                        else
+                        {
+                            setVolumeGridValue(x, y, z, (float)values[x - batchStart]);
+                        }
+                    }
                 }
             }
         }
 
         mTrilinearValue = oldTrilinearValue;
+        // Don't leave the operation pointing at the view on the stack.
+        operation->setSourceA(this);
+
+        if (!isEmpty)
+        {
+            if (stage)
+            {
+                mStagedEdits.push_back(edit);
+            }
+            else
+            {
+                mergeDirtyRegion(xStart, yStart, zStart, xEnd, yEnd, zEnd);
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void GridSource::mergeDirtyRegion(int xStart, int yStart, int zStart, int xEnd, int yEnd, int zEnd)
+    {
+        Real worldWidthScale = (Real)1.0 / mPosXScale;
+        Real worldHeightScale = (Real)1.0 / mPosYScale;
+        Real worldDepthScale = (Real)1.0 / mPosZScale;
+
+        // Grow by one cell as the gradients and the interpolation of the
+        // neighbours read the changed values, too.
+        mDirtyRegion.merge(AxisAlignedBox(
+            (Real)(xStart - 1) * worldWidthScale, (Real)(yStart - 1) * worldHeightScale, (Real)(zStart - 1) * worldDepthScale,
+            (Real)(xEnd + 1) * worldWidthScale, (Real)(yEnd + 1) * worldHeightScale, (Real)(zEnd + 1) * worldDepthScale));
+    }
+
+    //-----------------------------------------------------------------------
+
+    void GridSource::combineWithSource(CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius)
+    {
+        evaluateOperation(operation, source, center, radius, false);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void GridSource::stageCombineWithSource(CSGOperationSource *operation, Source *source, const Vector3 &center, Real radius)
+    {
+        evaluateOperation(operation, source, center, radius, true);
+    }
+
+    //-----------------------------------------------------------------------
+
+    bool GridSource::hasStagedEdits() const
+    {
+        return !mStagedEdits.empty();
+    }
+
+    //-----------------------------------------------------------------------
+
+    void GridSource::applyStagedEdits()
+    {
+        // Later edits were evaluated on top of the earlier ones, so they win.
+        for (VecStagedEdit::const_iterator it = mStagedEdits.begin(); it != mStagedEdits.end(); ++it)
+        {
+            size_t index = 0;
+            for (int z = it->zStart; z < it->zEnd; ++z)
+            {
+                for (int y = it->yStart; y < it->yEnd; ++y)
+                {
+                    for (int x = it->xStart; x < it->xEnd; ++x)
+                    {
+                        setVolumeGridValue(x, y, z, it->values[index++]);
+                    }
+                }
+            }
+            mergeDirtyRegion(it->xStart, it->yStart, it->zStart, it->xEnd, it->yEnd, it->zEnd);
+        }
+        mStagedEdits.clear();
+    }
+
+    //-----------------------------------------------------------------------
+
+    const AxisAlignedBox& GridSource::getDirtyRegion() const
+    {
+        return mDirtyRegion;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void GridSource::clearDirtyRegion()
+    {
+        mDirtyRegion.setNull();
     }
  
     //-----------------------------------------------------------------------
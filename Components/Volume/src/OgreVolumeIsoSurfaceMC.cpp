@@ -46,17 +46,29 @@ namespace Volume {
         unsigned char cubeIndex = 0;
         Vector4 values[8];
 
-        // Find out the case.
-        for (size_t i = 0; i < 8; ++i)
+        if (volumeValues)
         {
-            if (volumeValues)
+            for (size_t i = 0; i < 8; ++i)
             {
                 values[i] = volumeValues[i];
             }
-            else
+        }
+        else
+        {
+            // Sample all corners as one batch.
+            Real cornersX[8], cornersY[8], cornersZ[8];
+            for (size_t i = 0; i < 8; ++i)
             {
-                values[i] = mSrc->getValueAndGradient(corners[i]);
+                cornersX[i] = corners[i].x;
+                cornersY[i] = corners[i].y;
+                cornersZ[i] = corners[i].z;
             }
+            mSrc->getValuesAndGradients(cornersX, cornersY, cornersZ, values, 8);
+        }
+
+        // Find out the case.
+        for (size_t i = 0; i < 8; ++i)
+        {
             if (values[i].w >= ISO_LEVEL)
             {
                 cubeIndex |= 1 << i;
@@ -65,6 +65,25 @@ namespace Volume {
     
     //-----------------------------------------------------------------------
 
+    void MeshBuilder::growIndexSlots()
+    {
+        const size_t newSize = mIndexSlots.empty() ? 256 : mIndexSlots.size() * 2;
+        mIndexSlots.clear();
+        mIndexSlots.resize(newSize, 0);
+        const size_t mask = newSize - 1;
+        for (size_t i = 0; i < mVertices.size(); ++i)
+        {
+            size_t slot = hashVertex(mVertices[i]) & mask;
+            while (mIndexSlots[slot])
+            {
+                slot = (slot + 1) & mask;
+            }
+            mIndexSlots[slot] = i + 1;
+        }
+    }
+    
+    //-----------------------------------------------------------------------
+
     size_t MeshBuilder::generateBuffers(RenderOperation &operation)
     {
         // Early out if nothing to do.
@@ -60,14 +60,33 @@ namespace Volume {
         }
 
         // Error metric of http://www.andrew.cmu.edu/user/jessicaz/publication/meshing/
-        Real f000 = mSrc->getValue(from);
-        Real f001 = mSrc->getValue(node->getCorner3());
-        Real f010 = mSrc->getValue(node->getCorner4());
-        Real f011 = mSrc->getValue(node->getCorner7());
-        Real f100 = mSrc->getValue(node->getCorner1());
-        Real f101 = mSrc->getValue(node->getCorner2());
-        Real f110 = mSrc->getValue(node->getCorner5());
-        Real f111 = mSrc->getValue(to);
+        // The corners are sampled as one batch.
+        const Vector3 corners[8] = {
+            from,
+            node->getCorner3(),
+            node->getCorner4(),
+            node->getCorner7(),
+            node->getCorner1(),
+            node->getCorner2(),
+            node->getCorner5(),
+            to
+        };
+        Real cornersX[8], cornersY[8], cornersZ[8], cornerValues[8];
+        for (size_t i = 0; i < 8; ++i)
+        {
+            cornersX[i] = corners[i].x;
+            cornersY[i] = corners[i].y;
+            cornersZ[i] = corners[i].z;
+        }
+        mSrc->getValues(cornersX, cornersY, cornersZ, cornerValues, 8);
+        const Real f000 = cornerValues[0];
+        const Real f001 = cornerValues[1];
+        const Real f010 = cornerValues[2];
+        const Real f011 = cornerValues[3];
+        const Real f100 = cornerValues[4];
+        const Real f101 = cornerValues[5];
+        const Real f110 = cornerValues[6];
+        const Real f111 = cornerValues[7];
 
         Vector3 positions[19][2] = {
             {node->getCenterBackBottom(), Vector3((Real)0.5, (Real)0.0, (Real)0.0)},
@@ -93,26 +112,50 @@ namespace Volume {
             {node->getCenterFrontTop(), Vector3((Real)0.5, (Real)1.0, (Real)1.0)}
         };
 
-    
+
+        // Sample the points in small batches so nodes which clearly need to be split still
+        // leave early. The center was already sampled above.
+        const size_t numPositions = 19;
+        const size_t centerIndex = 9;
+        const size_t batchSize = 4;
         Real error = (Real)0.0;
-        Vector4 value;
         Vector3 gradient;
-        for (size_t i = 0; i < 19; ++i)
+        for (size_t batchStart = 0; batchStart < numPositions; batchStart += batchSize)
         {
-            value = mSrc->getValueAndGradient(positions[i][0]);
-            gradient.x = value.x;
-            gradient.y = value.y;
-            gradient.z = value.z;
-            Real interpolated = interpolate(f000, f001, f010, f011, f100, f101, f110, f111, positions[i][1]);
-            Real gradientMagnitude = gradient.length();
-            if (gradientMagnitude < FLT_EPSILON)
+            const size_t batchEnd = std::min(batchStart + batchSize, numPositions);
+            Real positionsX[batchSize], positionsY[batchSize], positionsZ[batchSize];
+            Vector4 values[batchSize];
+            size_t numSamples = 0;
+            for (size_t i = batchStart; i < batchEnd; ++i)
             {
-                gradientMagnitude = (Real)1.0;
+                if (i != centerIndex)
+                {
+                    positionsX[numSamples] = positions[i][0].x;
+                    positionsY[numSamples] = positions[i][0].y;
+                    positionsZ[numSamples] = positions[i][0].z;
+                    ++numSamples;
+                }
             }
-            error += Math::Abs(value.w - interpolated) / gradientMagnitude;
-            if (error >= geometricError)
+            mSrc->getValuesAndGradients(positionsX, positionsY, positionsZ, values, numSamples);
+
+            size_t sample = 0;
+            for (size_t i = batchStart; i < batchEnd; ++i)
             {
-                return true;
+                const Vector4 &value = i == centerIndex ? centerValue : values[sample++];
+                gradient.x = value.x;
+                gradient.y = value.y;
+                gradient.z = value.z;
+                Real interpolated = interpolate(f000, f001, f010, f011, f100, f101, f110, f111, positions[i][1]);
+                Real gradientMagnitude = gradient.length();
+                if (gradientMagnitude < FLT_EPSILON)
+                {
+                    gradientMagnitude = (Real)1.0;
+                }
+                error += Math::Abs(value.w - interpolated) / gradientMagnitude;
+                if (error >= geometricError)
+                {
+                    return true;
+                }
             }
         }
         node->setCenterValue(centerValue);
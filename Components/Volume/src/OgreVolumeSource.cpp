@@ -37,6 +37,7 @@ namespace Volume {
     const uint32 Source::VOLUME_CHUNK_ID = StreamSerialiser::makeIdentifier("VOLU");
     const uint16 Source::VOLUME_CHUNK_VERSION = 1;
     const size_t Source::SERIALIZATION_CHUNK_SIZE = 1000;
+    const size_t Source::BATCH_SIZE;
 
     //-----------------------------------------------------------------------
 
@@ -61,6 +62,26 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
 
+    void Source::getValues(const Real *x, const Real *y, const Real *z, Real *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = getValue(Vector3(x[i], y[i], z[i]));
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void Source::getValuesAndGradients(const Real *x, const Real *y, const Real *z, Vector4 *values, size_t count) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            values[i] = getValueAndGradient(Vector3(x[i], y[i], z[i]));
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
     void Source::serialize(const Vector3 &from, const Vector3 &to, float voxelWidth, const String &file)
     {
         Real maxClampedAbsoluteDensity = (from - to).length() / (Real)16.0;
@@ -31,7 +31,66 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 
 #if OGRE_USE_SIMD == 1
-#    if OGRE_CPU == OGRE_CPU_X86
+#    if OGRE_CPU == OGRE_CPU_X86 && OGRE_USE_SIMD_AVX2 == 1
+// x86/x64 - AVX2 + FMA
+#        if OGRE_DOUBLE_PRECISION == 1
+#            error Double precision with AVX2 is not supported. Build Ogre without OGRE_SIMD_AVX2
+#        endif
+#        include <immintrin.h>
+#        define ARRAY_PACKED_REALS 8
+namespace Ogre
+{
+    typedef __m256 ArrayReal;
+    typedef __m256 ArrayMaskR;
+
+#        define ARRAY_REAL_ZERO _mm256_setzero_ps()
+#        define ARRAY_INT_ZERO _mm256_setzero_si256()
+#        define ARRAY_MASK_ZERO _mm256_setzero_ps()
+
+    class ArrayRadian;
+
+    typedef __m256i ArrayInt;
+    typedef __m256i ArrayMaskI;
+
+    /// To store the result of ToSnorm8, can be consumed by extractS8
+    typedef __m128i ArrayToS8;
+    /// To store the result of ToSnorm16, can be consumed by extractS16
+    typedef __m128i ArrayToS16;
+}  // namespace Ogre
+
+#        define OGRE_PREFETCH_T0( x ) _mm_prefetch( x, _MM_HINT_T0 )
+#        define OGRE_PREFETCH_T1( x ) _mm_prefetch( x, _MM_HINT_T1 )
+#        define OGRE_PREFETCH_T2( x ) _mm_prefetch( x, _MM_HINT_T2 )
+#        define OGRE_PREFETCH_NTA( x ) _mm_prefetch( x, _MM_HINT_NTA )
+
+// Distance (in ArrayMemoryManager's slots) used to keep fetching data. This also
+// means the memory manager needs to allocate extra memory for them.
+#        define OGRE_PREFETCH_SLOT_DISTANCE \
+            4 * ARRAY_PACKED_REALS  // Must be multiple of ARRAY_PACKED_REALS
+
+/// r = (a * b) + c
+#        define _mm256_madd_ps( a, b, c ) _mm256_fmadd_ps( a, b, c )
+/// r = -(a * b) + c
+#        define _mm256_nmsub_ps( a, b, c ) _mm256_fnmadd_ps( a, b, c )
+
+// AVX only has the generic _mm256_cmp_ps. These mirror the SSE predicates
+// (i.e. cmpneq is true for NaNs, the others are false)
+#        define _mm256_cmpeq_ps( a, b ) _mm256_cmp_ps( a, b, _CMP_EQ_OQ )
+#        define _mm256_cmpneq_ps( a, b ) _mm256_cmp_ps( a, b, _CMP_NEQ_UQ )
+#        define _mm256_cmplt_ps( a, b ) _mm256_cmp_ps( a, b, _CMP_LT_OS )
+#        define _mm256_cmple_ps( a, b ) _mm256_cmp_ps( a, b, _CMP_LE_OS )
+#        define _mm256_cmpgt_ps( a, b ) _mm256_cmp_ps( a, b, _CMP_GT_OS )
+#        define _mm256_cmpge_ps( a, b ) _mm256_cmp_ps( a, b, _CMP_GE_OS )
+
+/// Does not convert, just cast ArrayReal to ArrayInt
+#        define CastRealToInt( x ) _mm256_castps_si256( x )
+#        define CastIntToReal( x ) _mm256_castsi256_ps( x )
+/// Input must be 32-byte aligned
+#        define CastArrayToReal( outFloatPtr, arraySimd ) _mm256_store_ps( outFloatPtr, arraySimd )
+#        define CastArrayToInt32( outInt32Ptr, arraySimd ) \
+            _mm256_store_si256( reinterpret_cast<__m256i *>( outInt32Ptr ), arraySimd )
+
+#    elif OGRE_CPU == OGRE_CPU_X86
 // x86/x64 - SSE2
 #        if OGRE_DOUBLE_PRECISION == 1
 #            include <emmintrin.h>
@@ -313,6 +313,7 @@ namespace Ogre
             WorldMat,
             InheritOrientation,
             InheritScale,
+            Dirty,
             NumMemoryTypes
         };
 
@@ -353,6 +354,9 @@ namespace Ogre
             Number of Nodes in this depth level
         */
         size_t getFirstNode( Transform &outTransform );
+
+        /// Sets Transform::mDirty of every slot to 0. @see NodeMemoryManager::setDirtyTracking
+        void clearDirtyFlags();
     };
 
     /** Implementation to create the ObjectData variables needed by MovableObjects
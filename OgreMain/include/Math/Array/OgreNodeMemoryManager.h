@@ -68,6 +68,9 @@ namespace Ogre
         SceneMemoryMgrTypes mMemoryManagerType;
         NodeMemoryManager  *mTwinMemoryManager;
 
+        /// @see setDirtyTracking
+        bool mDirtyTracking;
+
         /** Makes mMemoryManagers big enough to be able to fulfill mMemoryManagers[newDepth]
         @param newDepth
             Hierarchy level depth we wish to grow to.
@@ -188,6 +191,25 @@ namespace Ogre
         void migrateToAndDetach( Transform &inOutTransform, size_t depth,
                                  NodeMemoryManager *dstNodeMemoryManager );
 
+        /** When enabled, Node::updateAllTransforms skips SIMD blocks in which no node
+            was modified, and whose parents weren't updated either.
+        @remarks
+            Node::setPosition, setOrientation, setScale, etc. flag the node's slot as dirty
+            (Transform::mDirty). When a block gets updated, its dirty flags are propagated
+            to the next depth level through the parents. All flags are cleared after the
+            whole hierarchy has been updated.
+        @par
+            This is worth it when most nodes don't move. When most nodes are dirty every frame
+            it only adds the overhead of checking the flags.
+        @par
+            The flags are always written; thus this can be toggled at any time.
+        */
+        void setDirtyTracking( bool bDirtyTracking ) { mDirtyTracking = bDirtyTracking; }
+        bool getDirtyTracking() const { return mDirtyTracking; }
+
+        /// Clears the dirty flags of all depth levels. @see setDirtyTracking
+        void _clearDirtyFlags();
+
         /// @copydoc ArrayMemoryManager::defragment
         void defragment();
         
@@ -0,0 +1,169 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ObjectDataBvh_H__
+#define __ObjectDataBvh_H__
+
+#include "OgrePrerequisites.h"
+
+#include "Math/Array/OgreObjectData.h"
+#include "OgreFastArray.h"
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+     *  @{
+     */
+    /** \addtogroup Memory
+     *  @{
+     */
+
+    /** Bounding volume hierarchy over the world AABBs of one render queue of an
+        ObjectMemoryManager, used to skip whole groups of objects during frustum culling.
+    @remarks
+        Objects can't be reordered (their ObjectData slots are owned by the memory manager),
+        therefore the leaves of the tree are packs of ARRAY_PACKED_REALS objects, and they
+        are grouped ARRAY_PACKED_REALS at a time, bottom up, in the same order they're
+        laid out in memory. This keeps refits cache friendly, and culling returns
+        contiguous ranges of memory that MovableObject::cullFrustum can walk as usual.
+    @par
+        Thus the hierarchy is only as good as the spatial coherence of the memory layout:
+        it works best when objects that are close to each other were created together
+        (which is the usual case when loading a level), and it's useless if the objects
+        of each pack are scattered across the whole scene.
+    @par
+        Each node stores the bounds of its ARRAY_PACKED_REALS children as a single
+        ArrayAabb, so a node is tested against a plane with the same SIMD code
+        MovableObject::cullFrustum uses for objects.
+        Unused lanes are set to Aabb::BOX_NULL, which never passes the frustum test.
+        Infinite boxes always pass it.
+    @par
+        The result of cullFrustum is conservative; the objects in the returned
+        ranges still need to go through MovableObject::cullFrustum.
+    */
+    class _OgreExport ObjectDataBvh : public OgreAllocatedObj
+    {
+    public:
+        /// A contiguous range of packs (of ARRAY_PACKED_REALS objects each)
+        struct PackRange
+        {
+            uint32 firstPack;
+            uint32 numPacks;
+        };
+        typedef FastArray<PackRange> PackRangeArray;
+
+    protected:
+        /// All the nodes. Leaves first, root last.
+        /// Lane j of node i of a level holds the bounds of child
+        /// i * ARRAY_PACKED_REALS + j of the level below (or the pack, for leaves).
+        ArrayAabb *mNodes;
+        size_t     mNumNodes;
+        size_t     mNodesCapacity;
+
+        /// mLevelOffsets[i] is the index in mNodes of the first node of level i.
+        /// Level 0 are the leaves. Has one extra entry with mNumNodes.
+        FastArray<size_t> mLevelOffsets;
+
+        size_t mNumPacks;
+        uint32 mNumBuilds;
+
+        /// Scratch memory for cullFrustum
+        FastArray<uint32> mStack;
+
+        void addVisibleRange( size_t firstPack, size_t numPacks, uint32 maxPacksPerRange,
+                              size_t firstRangeIdx, PackRangeArray &outRanges );
+
+    public:
+        ObjectDataBvh();
+        ~ObjectDataBvh();
+
+        /** Builds the hierarchy from scratch.
+        @param objData
+            First ObjectData of the render queue, as returned by
+            ObjectMemoryManager::getFirstObjectData.
+        @param numObjs
+            Number of objects (including fragmented slots), as returned by
+            ObjectMemoryManager::getFirstObjectData.
+        */
+        void build( const ObjectData &objData, size_t numObjs );
+
+        /** Recalculates the bounds of all nodes from the current world AABBs.
+        @remarks
+            The number of objects must match the one given to build.
+            Same as calling refitLeaves on all leaves, followed by refitNodes.
+        */
+        void refit( const ObjectData &objData );
+
+        /** Recalculates the bounds of the leaves in range [firstLeaf; firstLeaf + numLeaves)
+            from the current world AABBs. Different ranges can be refit from different
+            threads at the same time.
+        @remarks
+            The number of objects must match the one given to build.
+        */
+        void refitLeaves( const ObjectData &objData, size_t firstLeaf, size_t numLeaves );
+
+        /// Recalculates the bounds of all non-leaf nodes from the leaves.
+        /// Must be called after all leaves were refit.
+        void refitNodes();
+
+        /** Refits the hierarchy if possible, otherwise (the number of
+            packs changed) rebuilds it. Must be called every time world AABBs change.
+        */
+        void update( const ObjectData &objData, size_t numObjs );
+
+        /** Returns the ranges of packs that may be inside the frustum.
+        @param frustumPlanes
+            The 6 frustum planes, as returned by Frustum::getFrustumPlanes
+        @param maxPacksPerRange
+            Ranges will be split so that they're never longer than this value.
+        @param outRanges [out]
+            Ranges of packs sorted by memory address. Not cleared.
+        @return
+            Number of packs added to outRanges.
+        */
+        size_t cullFrustum( const Plane *frustumPlanes, uint32 maxPacksPerRange,
+                            PackRangeArray &outRanges );
+
+        size_t getNumPacks() const { return mNumPacks; }
+        size_t getNumLeaves() const
+        {
+            return mLevelOffsets.empty() ? 0u : mLevelOffsets[1] - mLevelOffsets[0];
+        }
+        size_t getNumLevels() const { return mLevelOffsets.empty() ? 0u : mLevelOffsets.size() - 1u; }
+        /// Number of times the hierarchy has been built. Useful for profiling.
+        uint32 getNumBuilds() const { return mNumBuilds; }
+    };
+
+    /** @} */
+    /** @} */
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
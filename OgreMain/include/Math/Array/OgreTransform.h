@@ -74,6 +74,11 @@ namespace Ogre
         /// Ours is mInheritScale[mIndex]
         bool *RESTRICT_ALIAS mInheritScale;
 
+        /// Non-zero if the derived transform needs to be recalculated because either the
+        /// local transform or the parent changed since the last update.
+        /// Ours is mDirty[mIndex]. @see NodeMemoryManager::setDirtyTracking
+        uint8 *RESTRICT_ALIAS mDirty;
+
         Transform() :
             mIndex( 0 ),
             mParents( 0 ),
@@ -86,7 +91,8 @@ namespace Ogre
             mDerivedScale( 0 ),
             mDerivedTransform( 0 ),
             mInheritOrientation( 0 ),
-            mInheritScale( 0 )
+            mInheritScale( 0 ),
+            mDirty( 0 )
         {
         }
 
@@ -138,6 +144,9 @@ namespace Ogre
 
             mInheritOrientation[mIndex] = inCopy.mInheritOrientation[inCopy.mIndex];
             mInheritScale[mIndex] = inCopy.mInheritScale[inCopy.mIndex];
+
+            // We've been moved to a different slot (different parent or depth)
+            mDirty[mIndex] = 1u;
         }
 
         /** Rebases all the pointers from our SoA structs so that they point to a new location
@@ -174,6 +183,7 @@ namespace Ogre
                 newBasePtrs[NodeArrayMemoryManager::InheritOrientation] + diff );
             mInheritScale =
                 reinterpret_cast<bool *>( newBasePtrs[NodeArrayMemoryManager::InheritScale] + diff );
+            mDirty = reinterpret_cast<uint8 *>( newBasePtrs[NodeArrayMemoryManager::Dirty] + diff );
         }
 
         /** Advances all pointers to the next pack, i.e. if we're processing 4 elements at a time, move
@@ -192,6 +202,7 @@ namespace Ogre
             mDerivedTransform += ARRAY_PACKED_REALS;
             mInheritOrientation += ARRAY_PACKED_REALS;
             mInheritScale += ARRAY_PACKED_REALS;
+            mDirty += ARRAY_PACKED_REALS;
         }
 
         void advancePack( size_t numAdvance )
@@ -207,6 +218,7 @@ namespace Ogre
             mDerivedTransform += ARRAY_PACKED_REALS * numAdvance;
             mInheritOrientation += ARRAY_PACKED_REALS * numAdvance;
             mInheritScale += ARRAY_PACKED_REALS * numAdvance;
+            mDirty += ARRAY_PACKED_REALS * numAdvance;
         }
     };
 }  // namespace Ogre
@@ -244,6 +244,14 @@ namespace Ogre
         /// @copydoc cbitset64::set
         inline void set( const size_t position );
 
+        /** Sets all bits in range [position; position + numBits) to 1
+        @param position
+            Value in range [0; capacity)
+        @param numBits
+            position + numBits must be <= capacity
+        */
+        inline void setRange( size_t position, size_t numBits );
+
         /// @copydoc cbitset64::unset
         inline void unset( const size_t position );
 
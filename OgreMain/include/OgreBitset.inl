@@ -267,6 +267,25 @@ namespace Ogre
         mValues[idx] |= mask;
     }
     //-------------------------------------------------------------------------
+    void bitset64::setRange( size_t position, size_t numBits )
+    {
+        OGRE_ASSERT_MEDIUM( position + numBits <= mBitsCapacity );
+
+        while( numBits > 0u )
+        {
+            const size_t idx = position >> 6u;
+            const size_t localIdx = position & 63u;
+            const size_t numLocalBits = std::min<size_t>( numBits, 64u - localIdx );
+            const uint64 mask = numLocalBits == 64u
+                                    ? std::numeric_limits<uint64>::max()
+                                    : ( ( uint64( 1ul ) << numLocalBits ) - uint64( 1ul ) ) << localIdx;
+            mValues[idx] |= mask;
+
+            position += numLocalBits;
+            numBits -= numLocalBits;
+        }
+    }
+    //-------------------------------------------------------------------------
     void bitset64::unset( const size_t position )
     {
         OGRE_ASSERT_MEDIUM( position < mBitsCapacity );
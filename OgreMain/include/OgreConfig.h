@@ -44,6 +44,7 @@ THE SOFTWARE.
 #define OGRE_PROFILING_INTERNAL 1
 #define OGRE_PROFILING_REMOTERY 2
 #define OGRE_PROFILING_INTERNAL_OFFLINE 3
+#define OGRE_PROFILING_INTERNAL_TRACE 4
 
 /** There are three modes for handling asserts in OGRE:
 0 - STANDARD - Standard asserts in debug builds, nothing in release builds
@@ -68,6 +69,14 @@ THE SOFTWARE.
 #    define OGRE_DOUBLE_PRECISION 0
 #endif
 
+/** If set to 1 (and OGRE_USE_SIMD is 1 on x86), the SIMD math library (ArrayVector3 & co.)
+    uses 8-wide AVX2 + FMA instead of 4-wide SSE2. ARRAY_PACKED_REALS becomes 8
+    and OGRE_SIMD_ALIGNMENT becomes 32.
+*/
+#ifndef OGRE_USE_SIMD_AVX2
+#    define OGRE_USE_SIMD_AVX2 0
+#endif
+
 /** Define number of texture coordinate sets allowed per vertex.
  */
 #define OGRE_MAX_TEXTURE_COORD_SETS 8
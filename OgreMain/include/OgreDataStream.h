@@ -494,6 +494,8 @@ namespace Ogre
         /// Reference to source file stream (read-write)
         std::fstream *mFStream;
         bool          mFreeOnClose;
+        /// Absolute path to the file in the OS' filesystem, if known. See setFullPath
+        String mFullPath;
 
         void determineAccess();
 
@@ -594,6 +596,80 @@ namespace Ogre
         /** @copydoc DataStream::close
          */
         void close() override;
+
+        /** Sets the path of the file in the OS' filesystem that this stream reads from.
+            Archives set it so that consumers can reopen the file with a
+            MappedFileDataStream. Leave empty if the stream doesn't come from a
+            regular file.
+        */
+        void          setFullPath( const String &fullPath ) { mFullPath = fullPath; }
+        const String &getFullPath() const { return mFullPath; }
+    };
+
+    /** Read-only subclass of DataStream that maps a whole file into the address space.
+    @remarks
+        Unlike prebuffering a stream into a MemoryDataStream, nothing gets allocated
+        nor copied: the OS pages in the contents on demand (and reads ahead, since we
+        hint sequential access), and getPtr/getCurrentPtr let consumers access the
+        data in place.
+    @par
+        The pointers stay valid until the stream is closed or destroyed.
+    */
+    class _OgreExport MappedFileDataStream final : public DataStream
+    {
+    protected:
+        /// Start of the mapped view. Null if the file is empty or the stream was closed.
+        uchar const *mData;
+        size_t       mPos;
+#    if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        void *mFileHandle;
+        void *mMappingHandle;
+#    endif
+
+    public:
+        /** Maps the file at the given path.
+        @param name
+            The name to give this stream (e.g. the resource name).
+        @param fullPath
+            Path to the file in the OS' filesystem.
+        @exception ERR_FILE_NOT_FOUND if the file can't be opened or mapped.
+        */
+        MappedFileDataStream( const String &name, const String &fullPath );
+        ~MappedFileDataStream() override;
+
+        /// Returns false on platforms where files can't be mapped.
+        /// The constructor always throws on those.
+        static bool isSupported();
+
+        /// Get a pointer to the start of the mapped data
+        const uchar *getPtr() const { return mData; }
+
+        /// Get a pointer to the current position in the mapped data
+        const uchar *getCurrentPtr() const { return mData + mPos; }
+
+        /** @copydoc DataStream::read
+         */
+        size_t read( void *buf, size_t count ) override;
+
+        /** @copydoc DataStream::skip
+         */
+        void skip( long count ) override;
+
+        /** @copydoc DataStream::seek
+         */
+        void seek( size_t pos ) override;
+
+        /** @copydoc DataStream::tell
+         */
+        size_t tell() const override;
+
+        /** @copydoc DataStream::eof
+         */
+        bool eof() const override;
+
+        /** @copydoc DataStream::close
+         */
+        void close() override;
     };
 
     /** Common subclass of DataStream for handling data from C-style file
@@ -126,6 +126,10 @@ namespace Ogre
         }
 
         void checkValidity() const;
+
+        /// Calls TextureGpu::_notifyUsed on all our textures.
+        /// See TextureGpuManager::setResidencyBudget
+        void _notifyTexturesUsed( uint32 frameCount ) const;
     };
 
     struct _OgreExport DescriptorSetTexture2
@@ -359,6 +363,10 @@ namespace Ogre
         }
 
         void checkValidity() const;
+
+        /// Calls TextureGpu::_notifyUsed on all our textures.
+        /// See TextureGpuManager::setResidencyBudget
+        void _notifyTexturesUsed( uint32 frameCount ) const;
     };
 
     /** @} */
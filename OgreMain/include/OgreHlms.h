@@ -34,12 +34,15 @@ THE SOFTWARE.
 #include "OgreHlmsPso.h"
 #include "OgreStringVector.h"
 #include "Threading/OgreLightweightMutex.h"
+#include "Threading/OgreThreads.h"
 #if !OGRE_NO_JSON
 #    include "OgreHlmsJson.h"
 #endif
 
 #include "OgreHeaderPrefix.h"
 
+#include <atomic>
+
 namespace Ogre
 {
     class CompositorShadowNode;
@@ -205,6 +208,45 @@ namespace Ogre
             }
         };
 
+        /// Bits for each preprocessor pass, named after the directives they handle.
+        enum TemplatePass
+        {
+            TemplatePassMath = 1u << 0u,         ///< @pset, @padd, @psub, etc.
+            TemplatePassForEach = 1u << 1u,      ///< @foreach
+            TemplatePassProperty = 1u << 2u,     ///< @property
+            TemplatePassUndefPiece = 1u << 3u,   ///< @undefpiece
+            TemplatePassPiece = 1u << 4u,        ///< @piece
+            TemplatePassInsertPiece = 1u << 5u,  ///< @insertpiece
+            TemplatePassCounter = 1u << 6u,      ///< @counter, @value, @set, @add, etc.
+            TemplatePassAll = ( 1u << 7u ) - 1u
+        };
+
+        /// A template or piece file, read once and kept in memory so that generating each
+        /// permutation doesn't have to open it again (see getTemplateFile).
+        struct TemplateFile
+        {
+            String source;
+            /// TemplatePass bits of the directives found in source. A pass whose directives
+            /// don't appear in the file would only copy its input, and can be skipped.
+            uint32 passes;
+            bool   bExists;
+        };
+        typedef map<String, TemplateFile>::type TemplateFileMap;
+
+        /// A shader that was restored (i.e. by HlmsDiskCache) but hasn't been compiled yet.
+        /// It gets compiled the first time it is needed, or earlier by the warm up thread.
+        struct PendingShaderCode
+        {
+            /// Contains merged properties (pass and renderable's)
+            RenderableCache mergedCache;
+            /// Preprocessed shader code. Only used if bSourceUpToDate is true, otherwise
+            /// the templates have to be run through the Hlms preprocessor again.
+            String sourceFile[NumShaderTypes];
+            bool   bSourceUpToDate;
+
+            PendingShaderCode() : mergedCache( HlmsPropertyVec(), 0 ), bSourceUpToDate( false ) {}
+        };
+
         struct TextureRegs
         {
             uint32 strNameIdxStart;
@@ -223,10 +265,18 @@ namespace Ogre
         typedef vector<PassCache>::type       PassCacheVec;
         typedef vector<RenderableCache>::type RenderableCacheVec;
         typedef vector<ShaderCodeCache>::type ShaderCodeCacheVec;
+        typedef vector<PendingShaderCode>::type PendingShaderCodeVec;
+        /// Maps the hash of PendingShaderCode::mergedCache to its index in mPendingShaderCode.
+        typedef unordered_multimap<size_t, size_t>::type PendingShaderCodeIdxMap;
 
         PassCacheVec       mPassCache;
         RenderableCacheVec mRenderableCache;
         ShaderCodeCacheVec mShaderCodeCache;  // GUARDED_BY( mMutex )
+        /// Entries are taken from the back.
+        PendingShaderCodeVec    mPendingShaderCode;     // GUARDED_BY( mMutex )
+        PendingShaderCodeIdxMap mPendingShaderCodeIdx;  // GUARDED_BY( mMutex )
+        /// Entries are never removed while shaders are being generated.
+        TemplateFileMap mTemplateFiles;  // GUARDED_BY( mMutex )
         HlmsCacheVec       mShaderCache;      // GUARDED_BY( mMutex )
 
         typedef std::vector<HlmsPropertyVec> HlmsPropertyVecVec;
@@ -249,6 +299,18 @@ namespace Ogre
         ThreadDataVec    mT;
         LightweightMutex mMutex;
 
+        /// While alive, the warm up thread owns the last entry of mT.
+        ThreadHandlePtr   mWarmUpThread;
+        std::atomic<bool> mStopWarmUp;
+        /// Set by the warm up thread when it runs out of work. mWarmUpThread still
+        /// needs to be joined (see stopWarmUpThread).
+        std::atomic<bool> mWarmUpFinished;
+        /// Hash of the mergedCache the warm up thread is compiling, if mWarmUpInFlight.
+        size_t mWarmUpInFlightHash;  // GUARDED_BY( mMutex )
+        bool   mWarmUpInFlight;      // GUARDED_BY( mMutex )
+        /// Held by the warm up thread while it uses mT, so that mT can be safely resized.
+        LightweightMutex mWarmUpMutex;
+
         static LightweightMutex msGlobalMutex;
 
         static bool msHasParticleFX2Plugin;
@@ -402,6 +464,16 @@ namespace Ogre
         bool insertPieces( String &inBuffer, String &outBuffer, size_t tid ) const;
         bool parseCounter( const String &inString, String &outString, size_t tid );
 
+        /// Returns the TemplatePass bits needed to preprocess the given source.
+        static uint32 findTemplatePasses( const String &source );
+
+        /** Returns the contents of a template or piece file, reading it only the first time.
+            Cached files are discarded by clearShaderCache.
+        @return
+            Null if the file doesn't exist.
+        */
+        const TemplateFile *getTemplateFile( Archive *archive, const String &filename );
+
     public:
         /// For standalone parsing.
         bool parseOffline( const String &filename, String &inBuffer, String &outBuffer, size_t tid );
@@ -466,6 +538,35 @@ namespace Ogre
                                                   const String &debugFilenameOutput, uint32 finalHash,
                                                   ShaderType shaderType, size_t tid );
 
+        /** Compiles already preprocessed shader code and adds it to the shader code cache
+        @param codeCache [in/out]
+            All variables must be filled except for ShaderCodeCache::shaders which is the output
+        @param source
+            Preprocessed source for each shader stage. Empty strings are skipped.
+        */
+        void compilePreprocessedShaderCode( ShaderCodeCache &codeCache,
+                                            const String     source[NumShaderTypes],
+                                            uint32 shaderCounter, size_t tid );
+
+        static size_t calculateRenderableCacheHash( const RenderableCache &mergedCache );
+
+        /** Looks for mergedCache in mPendingShaderCode and, if found, moves it out of it.
+            Caller must hold mMutex.
+        @param mergedCacheHash
+            See calculateRenderableCacheHash.
+        @return
+            True if found.
+        */
+        bool takePendingShaderCode( const RenderableCache &mergedCache, size_t mergedCacheHash,
+                                    PendingShaderCode &outPendingShaderCode );
+
+        /// Removes the last entry of mPendingShaderCode. Caller must hold mMutex.
+        void popPendingShaderCode( PendingShaderCode &outPendingShaderCode );
+
+        /// Adds shaders that will be compiled the first time they're needed (or by the
+        /// warm up thread, see startWarmUpThread). The input container is emptied.
+        void addPendingShaderCode( PendingShaderCodeVec &pendingShaderCode );
+
     public:
         void _compileShaderFromPreprocessedSource( const RenderableCache &mergedCache,
                                                    const String           source[NumShaderTypes],
@@ -627,8 +728,14 @@ namespace Ogre
         const String &getShaderProfile() const { return mShaderProfile; }
         IdString      getShaderSyntax() const { return mShaderSyntax; }
 
+        /// Checksum of all the template and piece files, of every shader stage.
         void getTemplateChecksum( uint64 outHash[2] ) const;
 
+        /** Checksum of the template and piece files a single shader stage is generated from.
+            All zeroes if there is no template for that stage.
+        */
+        void getTemplateChecksum( ShaderType shaderType, uint64 outHash[2] ) const;
+
         /// Sets the precision mode of Hlms. See PrecisionMode
         /// Note: This call may invalidate the shader cache!
         /// Call as early as possible.
@@ -800,6 +907,28 @@ namespace Ogre
         void _setNumThreads( size_t numThreads );
         void _setShadersGenerated( uint32 shadersGenerated );
 
+        /** Starts a background thread that compiles the shaders restored by HlmsDiskCache
+            that haven't been needed yet, so that they don't have to be compiled at the
+            time they're first used.
+        @remarks
+            Does nothing if RenderSystem::supportsMultithreadedShaderCompilation is false;
+            in that case the pending shaders are only compiled when needed.
+        @par
+            The thread stops on its own once there's nothing left to compile.
+            It's also stopped by clearShaderCache.
+        */
+        void startWarmUpThread();
+
+        /// Stops the thread started by startWarmUpThread. Shaders that haven't been compiled
+        /// yet are kept and will be compiled on demand.
+        void stopWarmUpThread();
+
+        /// Returns the number of shaders restored by HlmsDiskCache that haven't been compiled yet.
+        size_t getNumPendingShaders();
+
+        /// Work done by the thread started by startWarmUpThread.
+        void _warmUpThread();
+
         /** Creates a unique datablock that can be shared by multiple renderables.
         @remarks
             The name of the datablock must be in paramVec["name"] and must be unique
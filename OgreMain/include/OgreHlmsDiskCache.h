@@ -130,17 +130,52 @@ namespace Ogre
                                     some stalls at runtime, due to the driver translating the Microcode
                                     to the internal ISA.
     @endcode
+    @par
+        Each shader is stored as a separate entry, addressed by a 128-bit hash of its merged
+        properties & pieces plus the checksum of the templates that produced its preprocessed
+        code. When a template changes, only the entries produced by older templates need to
+        go through the Hlms preprocessor again; the rest of the cache is still used as is.
+    @par
+        applyTo can either compile everything before returning, or hand the entries to the Hlms
+        so they're compiled the first time they're needed, while a background thread compiles
+        the rest (see Hlms::startWarmUpThread). The latter doesn't stall loading.
     */
     class _OgreExport HlmsDiskCache : public OgreAllocatedObj
     {
     public:
         struct SourceCode
         {
+            /// Checksum of the templates used to generate sourceFile (see calculateTemplateHash).
+            /// 0 if sourceFile is empty.
+            uint64                templateHash[2];  // 128 bit hash
             Hlms::RenderableCache mergedCache;
             String                sourceFile[NumShaderTypes];
 
             SourceCode();
-            SourceCode( const Hlms::ShaderCodeCache &shaderCodeCache );
+            SourceCode( const Hlms::ShaderCodeCache &shaderCodeCache, const Hlms *hlms,
+                        const uint64 stageTemplateHash[NumShaderTypes][2] );
+
+            /// Calculates the key this entry is stored with: a 128-bit hash
+            /// of mergedCache and templateHash.
+            void getKey( uint64 outKey[2] ) const;
+
+            /** Calculates the checksum of the templates this entry's sourceFile depends on.
+            @remarks
+                Properties set by a stage's templates are seen by the stages after it, so
+                every stage up to the last one with source code is included, as well as the
+                datablock custom pieces this entry uses. Stages after that produced no code
+                for this entry and are not included.
+            @param stageTemplateHash
+                See Hlms::getTemplateChecksum( ShaderType, uint64[2] ).
+            @param outHash [out]
+                All zeroes if sourceFile is empty.
+            */
+            void calculateTemplateHash( const Hlms *hlms,
+                                        const uint64 stageTemplateHash[NumShaderTypes][2],
+                                        uint64       outHash[2] ) const;
+
+            bool isSourceUpToDate( const Hlms  *hlms,
+                                   const uint64 stageTemplateHash[NumShaderTypes][2] ) const;
         };
 
         typedef vector<SourceCode>::type SourceCodeVec;
@@ -205,7 +240,17 @@ namespace Ogre
         void clearCache();
 
         void copyFrom( Hlms *hlms );
-        void applyTo( Hlms *hlms, size_t numThreads );
+        /** Restores the cache into the Hlms.
+        @param hlms
+        @param numThreads
+            Number of threads to compile the shaders with, when bDeferCompilation is false.
+        @param bDeferCompilation
+            When false, all shaders are compiled before returning.
+            When true, the shaders are compiled the first time they're needed, and a background
+            thread is started to compile the rest (if the RenderSystem supports it).
+            See Hlms::startWarmUpThread.
+        */
+        void applyTo( Hlms *hlms, size_t numThreads, bool bDeferCompilation = false );
 
         void saveTo( DataStreamPtr &dataStream );
         void loadFrom( DataStreamPtr &dataStream );
@@ -484,6 +484,14 @@ namespace Ogre
         /// hurt loading times with unnecessary disk access
         static bool msUseTimestampAsHash;
 
+        /// When true (default) and the mesh comes from a regular file in the filesystem,
+        /// the file is memory mapped instead of read into a heap buffer. The serializer
+        /// then uploads vertex & index data to the GPU straight from the mapping,
+        /// without intermediate allocations nor copies (unless the mesh must be
+        /// endian-flipped or keeps a shadow copy).
+        /// Otherwise, or if mapping fails, the file is fully prebuffered into RAM.
+        static bool msUseMemoryMappedFiles;
+
         void prepareForShadowMapping( bool forceSameBuffers );
 
         /// Returns true if the mesh is ready for rendering with valid shadow mapping Vaos
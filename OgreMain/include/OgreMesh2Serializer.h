@@ -66,7 +66,11 @@ namespace Ogre
 
         /// OGRE version v2.0+
         MESH_VERSION_2_1,
-        MESH_VERSION_LEGACY  // R0 & R1 (beta)
+        MESH_VERSION_LEGACY,  // R0 & R1 (beta)
+
+        /// Same as MESH_VERSION_2_1, but vertex & index data is stored in page aligned
+        /// blobs at the end of the file, for faster loading. See MeshSerializerImpl_v2_1_Packed
+        MESH_VERSION_2_1_PACKED
     };
 
     /** \addtogroup Core
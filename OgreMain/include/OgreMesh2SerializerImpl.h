@@ -99,6 +99,10 @@ namespace Ogre
             uint32               numIndices;
             void                *indexData;
             OperationType        operationType;
+            /// When true, vertexBuffers / indexData point inside the stream's memory
+            /// and must not be freed. See MeshSerializerImpl::readInPlace
+            bool externalVertexData;
+            bool externalIndexData;
 
             SubMeshLod();
         };
@@ -113,7 +117,11 @@ namespace Ogre
         virtual void writeSubMeshLod( const VertexArrayObject *vao, uint8 lodLevel, uint8 lodSource );
         virtual void writeSubMeshLodOperation( const VertexArrayObject *vao );
         virtual void writeIndexes( IndexBufferPacked *indexBuffer );
+        /// Writes the contents of the index buffer, already mapped in pIdx
+        virtual void writeIndexData( const IndexBufferPacked *indexBuffer, const void *pIdx );
         virtual void writeGeometry( const VertexBufferPackedVec &pGeom );
+        /// Writes the contents of the vertex buffer, already mapped in pData
+        virtual void writeVertexData( const VertexBufferPacked *vertexBuffer, const void *pData );
         virtual void writeSkeletonLink( const String &skelName );
 
         virtual void writeMeshLodLevel( const Mesh *pMesh );
@@ -138,6 +146,10 @@ namespace Ogre
         size_t         calcHashForCachesSize();
         virtual size_t calcSkeletonLinkSize( const String &skelName );
         virtual size_t calcSubMeshLodOperationSize( const VertexArrayObject *vao );
+        /// Size of what writeIndexData writes
+        virtual size_t calcIndexDataSize( const IndexBufferPacked *indexBuffer );
+        /// Size of what writeVertexData writes
+        virtual size_t calcVertexDataSize( const VertexBufferPacked *vertexBuffer );
         virtual size_t calcSubMeshNameTableSize( const Mesh *pMesh );
         /*virtual size_t calcEdgeListSize(const Mesh* pMesh);
         virtual size_t calcEdgeListLodSize(const EdgeData* data, bool isManual);
@@ -163,9 +175,16 @@ namespace Ogre
         virtual void readSubMeshLod( DataStreamPtr &stream, Mesh *pMesh, SubMeshLod *subLod,
                                      uint8 currentLod );
         virtual void readIndexes( DataStreamPtr &stream, SubMeshLod *subLod );
+        /// Fills subLod->indexData. numIndices & index32Bit must already be set
+        virtual void readIndexData( DataStreamPtr &stream, SubMeshLod *subLod );
         virtual void readGeometry( DataStreamPtr &stream, SubMeshLod *subLod );
         virtual void readVertexDeclaration( DataStreamPtr &stream, SubMeshLod *subLod );
         virtual void readVertexBuffer( DataStreamPtr &stream, SubMeshLod *subLod );
+        /// Fills subLod->vertexBuffers[source]
+        virtual void readVertexData( DataStreamPtr &stream, SubMeshLod *subLod, uint8 source,
+                                     size_t bytesPerVertex );
+        /// Only MeshSerializerImpl_v2_1_Packed supports it. Throws otherwise.
+        virtual void readPackedTableOfContents( DataStreamPtr &stream );
         virtual void readSubMeshLodOperation( DataStreamPtr &stream, SubMeshLod *subLod );
         /*virtual void readGeometry(DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
         virtual void readGeometryVertexDeclaration(DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
@@ -189,6 +208,17 @@ namespace Ogre
 
         virtual void createSubMeshVao( SubMesh *sm, SubMeshLodVec &submeshLods, uint8 numVaoPasses );
 
+        /// Frees the vertex & index data we own. Used for cleaning up on failure.
+        void freeSubMeshLods( SubMeshLodVec &submeshLods );
+
+        /** Returns a pointer to the next sizeBytes of the stream and skips them,
+            without copying anything.
+        @remarks
+            Only valid while importing, when mStreamData isn't null.
+            The data isn't endian-flipped.
+        */
+        const uint8 *readInPlace( DataStreamPtr &stream, size_t sizeBytes );
+
         /// Flip an entire vertex buffer to/from little endian
         /// working on the data pointer passed in pData
         void flipLittleEndian( void *pData, VertexBufferPacked *vertexBuffer );
@@ -217,6 +247,79 @@ namespace Ogre
         uint64      mCalculatedHash[2];  // Calculated when exporting
         ushort      exportedLodCount;    // Needed to limit exported Edge data, when exporting
         VaoManager *mVaoManager;
+
+        /// When importing from a stream whose contents are all in memory (prebuffered or memory
+        /// mapped) and need no endian conversion, this is the start of those contents. Null otherwise.
+        const uint8 *mStreamData;
+        /// When true, vertex/index buffers are uploaded straight from mStreamData
+        /// (i.e. mStreamData is valid and the mesh doesn't keep shadow copies)
+        bool mZeroCopyVertexData;
+        bool mZeroCopyIndexData;
+    };
+
+    /** Loading-friendly variant of the latest format ("[MeshSerializer_v2.1 R2 Packed]").
+    @remarks
+        The metadata is the same, but vertex & index buffers aren't stored inline.
+        M_PACKED_TABLE_OF_CONTENTS, right after the header, lists blobs which are stored
+        at the end of the file (M_PACKED_DATA), each one at a file offset multiple of the
+        alignment (the page size by default) and already in the layout VaoManager
+        wants: interleaved vertices and 16/32-bit indices. Chunks refer to them by index.
+    @par
+        Combined with Mesh::msUseMemoryMappedFiles, buffers get uploaded straight from
+        the mapped pages. Buffers shared by several LODs or passes are stored once.
+    @par
+        The blobs of a mesh must add up to less than 4GB.
+    */
+    class _OgrePrivate MeshSerializerImpl_v2_1_Packed : public MeshSerializerImpl
+    {
+    public:
+        MeshSerializerImpl_v2_1_Packed( VaoManager *vaoManager, uint32 alignment = 4096u );
+        ~MeshSerializerImpl_v2_1_Packed() override;
+
+    protected:
+        struct PackedBlob
+        {
+            /// Relative to the first blob
+            uint64 offset;
+            uint64 size;
+            /// Only valid while exporting
+            BufferPacked *buffer;
+        };
+        typedef vector<PackedBlob>::type PackedBlobVec;
+
+        void   writeMesh( const Mesh *pMesh ) override;
+        void   writeIndexData( const IndexBufferPacked *indexBuffer, const void *pIdx ) override;
+        void   writeVertexData( const VertexBufferPacked *vertexBuffer, const void *pData ) override;
+        size_t calcIndexDataSize( const IndexBufferPacked *indexBuffer ) override;
+        size_t calcVertexDataSize( const VertexBufferPacked *vertexBuffer ) override;
+
+        void readPackedTableOfContents( DataStreamPtr &stream ) override;
+        void readIndexData( DataStreamPtr &stream, SubMeshLod *subLod ) override;
+        void readVertexData( DataStreamPtr &stream, SubMeshLod *subLod, uint8 source,
+                             size_t bytesPerVertex ) override;
+
+        /// Fills mBlobs with every buffer of the mesh, each one once
+        void   collectBlobs( const Mesh *pMesh );
+        void   addBlob( BufferPacked *buffer );
+        uint32 findBlob( const BufferPacked *buffer ) const;
+
+        void writePackedTableOfContents();
+        void writePackedData();
+        void writePadding( size_t numBytes );
+
+        /** Returns the contents of a blob.
+        @param zeroCopy
+            When true the returned pointer is inside the stream memory (outExternal = true).
+            Otherwise it's a new allocation the caller owns and must endian-flip.
+        */
+        uint8 *readBlob( DataStreamPtr &stream, uint32 blobIdx, size_t sizeBytes, bool zeroCopy,
+                         bool &outExternal );
+
+        uint32        mAlignment;
+        PackedBlobVec mBlobs;
+        uint64        mBlobsDataSize;
+        /// Position of the first blob in the stream being imported
+        uint64 mBlobsStart;
     };
 
     class _OgrePrivate MeshSerializerImpl_v2_1_R1 : public MeshSerializerImpl
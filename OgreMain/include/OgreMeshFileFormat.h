@@ -59,6 +59,14 @@ namespace Ogre
     enum MeshChunkID {
         M_HEADER                = 0x1000,
             // char*          version           : Version number check
+        M_PACKED_TABLE_OF_CONTENTS = 0x2000,
+            // Only present in the packed format, where vertex & index data is stored
+            // in M_PACKED_DATA instead of inline, and chunks refer to it by blob index.
+            // uint32 alignment     : Alignment of each blob (and of the file offset of the first one)
+            // uint64 dataSize      : Size of all the blobs. They're at the end of the file.
+            // uint32 numBlobs
+            // uint64 blobOffset    : Relative to the first blob (repeats numBlobs times)
+            // uint64 blobSize      : (repeats numBlobs times)
         M_MESH                = 0x3000,
             // Optional hash data for caches
             M_HASH_FOR_CACHES = 0x3200,
@@ -88,6 +96,8 @@ namespace Ogre
                         // unsigned int* faceVertexIndices (indexCount)
                         // OR
                         // unsigned short* faceVertexIndices (indexCount)
+                        // OR (packed format)
+                        // uint32 blobIdx
                     M_SUBMESH_M_GEOMETRY = 0x4330,
                         // unsigned int vertexCount
                         // uint8 numSources;    //Number of vertex buffers.
@@ -99,7 +109,7 @@ namespace Ogre
                         M_SUBMESH_M_GEOMETRY_VERTEX_BUFFER = 0x4332, // Repeating section
                             // uint8 bindIndex;    // Index to bind this buffer to
                             // uint8 vertexSize;   // Per-vertex size, must agree with declaration at this index
-                            // raw buffer data
+                            // raw buffer data (or uint32 blobIdx in the packed format)
                     M_SUBMESH_M_GEOMETRY_EXTERNAL_SOURCE = 0x4340,
                         // This section is mutually exclusive w/ M_SUBMESH_M_GEOMETRY
                         // uint8 lodSource; //Get this vertex buffer from a LOD different source.
@@ -181,6 +191,10 @@ namespace Ogre
                         M_ANIMATION_POSE_REF = 0xD113, // repeat for number of referenced poses
                             // unsigned short poseIndex
                             // float influence
+        M_PACKED_DATA           = 0xF000,
+            // Only present in the packed format. Must be the last chunk.
+            // Zero padding until the file offset is a multiple of the alignment,
+            // followed by the blobs listed in M_PACKED_TABLE_OF_CONTENTS
 
     /* Version 1.10 of the .mesh format (deprecated)
     enum MeshChunkID {
@@ -706,8 +706,16 @@ namespace Ogre
         /** @see SceneManager::updateAllTransforms()
         @remarks
             We don't pass by reference on purpose (avoid implicit aliasing)
-        */
-        static void updateAllTransforms( const size_t numNodes, Transform t );
+        @param bSkipClean
+            When true, blocks of ARRAY_PACKED_REALS nodes where neither the nodes nor their
+            parents are dirty are skipped. Each node ORs its parent's dirty flag into its own
+            before the check, so a dirty node propagates to its children when the next depth
+            level is updated. Clean nodes sharing a block with dirty ones are recalculated but
+            keep their dirty flag cleared.
+            @see NodeMemoryManager::setDirtyTracking
+        */
+        static void updateAllTransforms( const size_t numNodes, Transform t,
+                                         bool bSkipClean = false );
 
         /** Gets the local position, relative to this node, of the given world-space position */
         virtual_l2 Vector3 convertWorldToLocalPosition( const Vector3 &worldPos );
@@ -140,6 +140,16 @@ namespace Ogre
             void execute() override;
         };
 
+        class NotifyMipLevelReady : public Cmd
+        {
+            TextureGpu *texture;
+            uint8       mipLevel;
+
+        public:
+            NotifyMipLevelReady( TextureGpu *_textureGpu, uint8 _mipLevel );
+            void execute() override;
+        };
+
 #ifdef OGRE_PROFILING_TEXTURES
         class LogProfilingData : public Cmd
         {
@@ -45,6 +45,11 @@ namespace Ogre
     /** Utility class for provides optimised functions.
     @note
         This class are supposed used by internal engine only.
+    @remarks
+        The implementation is picked at run-time (e.g. AVX2 + FMA if the CPU supports it).
+        This only applies to the routines of this class; the SoA Array math used by
+        Node, MovableObject, culling and skeletal animation gets its width at build time
+        (see OGRE_SIMD_AVX2), as it determines the memory layout.
     */
     class _OgreExport OptimisedUtil
     {
@@ -74,6 +79,18 @@ namespace Ogre
         */
         static OptimisedUtil *getImplementation() { return msImplementation; }
 
+        /** Gets the plain C++ implementation, regardless of the run-time environment.
+        @note
+            Meant for validating the SIMD implementations against it.
+        */
+        static OptimisedUtil *_getGeneralImplementation();
+
+        /** Gets the AVX2 + FMA implementation.
+        @return
+            Null if this build or the CPU can't run it.
+        */
+        static OptimisedUtil *_getAvx2Implementation();
+
         /** Performs software vertex skinning.
         @param srcPosPtr Pointer to source position buffer.
         @param destPosPtr Pointer to destination position buffer.
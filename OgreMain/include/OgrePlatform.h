@@ -508,7 +508,10 @@ THE SOFTWARE.
 #endif
 
 // Find perfect alignment (should supports SIMD alignment if SIMD available)
-#if OGRE_CPU == OGRE_CPU_X86
+#if OGRE_CPU == OGRE_CPU_X86 && OGRE_USE_SIMD == 1 && OGRE_USE_SIMD_AVX2 == 1
+// ArrayMemoryManager & co. need 32-byte alignment for aligned 256-bit loads & stores
+#    define OGRE_SIMD_ALIGNMENT 32
+#elif OGRE_CPU == OGRE_CPU_X86
 #    define OGRE_SIMD_ALIGNMENT 16
 #else
 #    define OGRE_SIMD_ALIGNMENT 16
@@ -523,6 +526,23 @@ THE SOFTWARE.
 #        define __OGRE_HAVE_SSE 1
 #    endif
 
+// Define whether or not Ogre compiled with AVX2 support (which also implies SSE support).
+#    if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_X86 && OGRE_USE_SIMD_AVX2 == 1
+#        define __OGRE_HAVE_AVX2 1
+#    endif
+
+// Define whether or not Ogre compiles AVX2 + FMA kernels that are picked at runtime
+// based on PlatformInformation. Unlike __OGRE_HAVE_AVX2 this doesn't require
+// the whole build to target AVX2. Only OptimisedUtil uses it; the SoA Array math
+// (node transforms, culling, bounds, skeletal animation) still needs __OGRE_HAVE_AVX2.
+#    if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_X86 && \
+        OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN && \
+        ( ( OGRE_COMPILER == OGRE_COMPILER_MSVC && OGRE_COMP_VER >= 1700 ) || \
+          ( OGRE_COMPILER == OGRE_COMPILER_GNUC && OGRE_COMP_VER >= 490 ) || \
+          OGRE_COMPILER == OGRE_COMPILER_CLANG )
+#        define __OGRE_HAVE_AVX2_DISPATCH 1
+#    endif
+
 // Define whether or not Ogre compiled with NEON support.
 #    if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && \
         ( defined( __aarch64__ ) || defined( __arm64__ ) || defined( _M_ARM64 ) || \
@@ -536,6 +556,23 @@ THE SOFTWARE.
 #    define __OGRE_HAVE_SSE 0
 #endif
 
+#ifndef __OGRE_HAVE_AVX2
+#    define __OGRE_HAVE_AVX2 0
+#endif
+
+#ifndef __OGRE_HAVE_AVX2_DISPATCH
+#    define __OGRE_HAVE_AVX2_DISPATCH 0
+#endif
+
+// Marks a function as using AVX2 + FMA even if the rest of the file isn't built for it.
+// Such functions must only be called after checking PlatformInformation.
+#if __OGRE_HAVE_AVX2_DISPATCH && \
+    ( OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG )
+#    define _OGRE_AVX2_TARGET_ATTRIBUTE __attribute__( ( target( "avx2,fma" ) ) )
+#else
+#    define _OGRE_AVX2_TARGET_ATTRIBUTE
+#endif
+
 #if OGRE_USE_SIMD == 0 || !defined( __OGRE_HAVE_NEON )
 #    define __OGRE_HAVE_NEON 0
 #endif
@@ -72,6 +72,11 @@ namespace Ogre
             CPU_FEATURE_FPU         = 1 << 9,
             CPU_FEATURE_PRO         = 1 << 10,
             CPU_FEATURE_HTT         = 1 << 11,
+            /// The AVX family is only reported when the OS also saves the YMM/ZMM registers
+            CPU_FEATURE_AVX         = 1 << 15,
+            CPU_FEATURE_AVX2        = 1 << 16,
+            CPU_FEATURE_FMA         = 1 << 17,
+            CPU_FEATURE_AVX512F     = 1 << 18,
 #elif OGRE_CPU == OGRE_CPU_ARM
             CPU_FEATURE_NEON        = 1 << 13,
 #elif OGRE_CPU == OGRE_CPU_MIPS
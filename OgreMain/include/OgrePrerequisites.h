@@ -307,6 +307,7 @@ namespace Ogre
     class SkeletonManager;
     class Sphere;
     class SphereSceneQuery;
+    class StageGraph;
     class StagingBuffer;
     class StagingTexture;
     class StreamSerialiser;
@@ -341,6 +342,7 @@ namespace Ogre
     class WireAabb;
     class WireBoundingBox;
     class WorkQueue;
+    class WorkStealingScheduler;
     class CompositorManager2;
     class CompositorWorkspace;
 
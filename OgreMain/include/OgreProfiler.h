@@ -54,6 +54,8 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #    include "Remotery.h"
 #elif OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE
 #    include "OgreOfflineProfiler.h"
+#elif OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+#    include "OgreTraceProfiler.h"
 #endif
 
 #include "OgreHeaderPrefix.h"
@@ -171,6 +173,40 @@ namespace Ogre
 #    define OgreProfileGpuBeginDynamic( a )
 #    define OgreProfileGpuBeginDynamicHashed( a, hash )
 #    define OgreProfileGpuEnd( a )
+#elif OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+// Names of static markers are registered once per call site, so recording is lock-free
+#    define OgreProfilerUseStableMarkers true
+#    define OgreTraceProfilerInstance Ogre::Profiler::getSingleton().getTraceProfiler()
+#    define OgreProfileL2( a, line ) \
+        static const Ogre::TraceMarker _OgreTraceMarker##line( a ); \
+        Ogre::TraceScope _OgreTraceScope##line( OgreTraceProfilerInstance, _OgreTraceMarker##line )
+#    define OgreProfileL( a, line ) OgreProfileL2( a, line )
+#    define OgreProfile( a ) OgreProfileL( a, __LINE__ )
+#    if OGRE_PROFILING_EXHAUSTIVE
+#        define OgreProfileExhaustive( a ) OgreProfile( a )
+#        define OgreProfileExhaustiveAggr( a ) OgreProfile( a )
+#    endif
+#    define OgreProfileBeginL2( a, line ) \
+        { \
+            static const Ogre::TraceMarker _OgreTraceMarker##line( a ); \
+            OgreTraceProfilerInstance.profileBegin( _OgreTraceMarker##line ); \
+        }
+#    define OgreProfileBeginL( a, line ) OgreProfileBeginL2( a, line )
+#    define OgreProfileBegin( a ) OgreProfileBeginL( a, __LINE__ )
+#    define OgreProfileBeginDynamic( a ) OgreTraceProfilerInstance.profileBeginDynamic( a )
+#    define OgreProfileBeginDynamicHashed( a, hash ) OgreProfileBeginDynamic( a )
+#    define OgreProfileEnd( a ) OgreTraceProfilerInstance.profileEnd()
+#    define OgreProfileGroup( a, g ) OgreProfile( a )
+#    define OgreProfileGroupAggregate( a, g ) OgreProfile( a )
+#    define OgreProfileBeginGroup( a, g ) OgreProfileBegin( a )
+#    define OgreProfileEndGroup( a, g ) OgreProfileEnd( a )
+#    define OgreProfileBeginGPUEvent( e )
+#    define OgreProfileEndGPUEvent( e )
+#    define OgreProfileMarkGPUEvent( e )
+#    define OgreProfileGpuBegin( a )
+#    define OgreProfileGpuBeginDynamic( a )
+#    define OgreProfileGpuBeginDynamicHashed( a, hash )
+#    define OgreProfileGpuEnd( a )
 #else
 #    define OgreProfilerUseStableMarkers true
 #    define OgreProfileExhaustive( a )
@@ -596,6 +632,8 @@ namespace Ogre
 
 #if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE
         OfflineProfiler &getOfflineProfiler() { return mOfflineProfiler; }
+#elif OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        TraceProfiler &getTraceProfiler() { return mTraceProfiler; }
 #endif
 
     protected:
@@ -619,6 +657,8 @@ namespace Ogre
 
 #if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE
         OfflineProfiler mOfflineProfiler;
+#elif OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        TraceProfiler mTraceProfiler;
 #endif
 
         // lol. Uses typedef; put's original container type in name.
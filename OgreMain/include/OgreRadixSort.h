@@ -322,6 +322,88 @@ namespace Ogre
         }
     };
 
+    /** LSD radix sort for contiguous arrays of POD values, ordered by an unsigned 64-bit key.
+    @remarks
+        Unlike RadixSort, it sorts the values themselves (no iterators, no copies to
+        an intermediate container) which makes it considerably more cache friendly.
+        The histograms for all 8 passes (one per byte) are built in a single pass
+        over the data, and passes in which every key has the same byte are skipped
+        entirely; which is common when the most significant bits encode a small
+        number of categories (e.g. RenderQueue's hashes).
+    @par
+        The sort is stable.
+    @param data
+        Values to sort.
+    @param tmp
+        Scratch memory. Must be able to hold numElements values.
+    @param numElements
+        Number of values in data.
+    @param keyFunc
+        A functor which returns the uint64 key for comparison when given a value.
+    @return
+        Pointer to the sorted values. It's either data or tmp, depending
+        on the number of passes that were needed.
+    */
+    template <typename T, typename TKeyFunc>
+    T *radixSortUint64( T *data, T *tmp, size_t numElements, TKeyFunc keyFunc )
+    {
+        if( numElements < 2u )
+            return data;
+
+        size_t counters[8][256];
+        memset( counters, 0, sizeof( counters ) );
+
+        // Alpha pass: build all histograms at once
+        bool needsSorting = false;
+        uint64 prevKey = keyFunc( data[0] );
+        for( size_t i = 0u; i < numElements; ++i )
+        {
+            const uint64 key = keyFunc( data[i] );
+            // cheap check to see if needs sorting (temporal coherence)
+            needsSorting |= key < prevKey;
+            prevKey = key;
+
+            for( size_t p = 0u; p < 8u; ++p )
+                ++counters[p][( key >> ( p * 8u ) ) & 0xFFu];
+        }
+
+        // early exit if already sorted
+        if( !needsSorting )
+            return data;
+
+        T *src = data;
+        T *dst = tmp;
+
+        for( size_t p = 0u; p < 8u; ++p )
+        {
+            const size_t shift = p * 8u;
+            size_t *RESTRICT_ALIAS counter = counters[p];
+
+            // Skip the pass if all keys have the same value for this byte.
+            if( counter[( keyFunc( src[0] ) >> shift ) & 0xFFu] == numElements )
+                continue;
+
+            // Convert the histogram into offsets
+            size_t offset = 0u;
+            for( size_t i = 0u; i < 256u; ++i )
+            {
+                const size_t count = counter[i];
+                counter[i] = offset;
+                offset += count;
+            }
+
+            for( size_t i = 0u; i < numElements; ++i )
+            {
+                const size_t byteVal = ( keyFunc( src[i] ) >> shift ) & 0xFFu;
+                dst[counter[byteVal]++] = src[i];
+            }
+
+            std::swap( src, dst );
+        }
+
+        return src;
+    }
+
     /** @} */
     /** @} */
 
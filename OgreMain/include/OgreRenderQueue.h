@@ -213,20 +213,57 @@ namespace Ogre
             DisableSort,
             NormalSort,
             StableSort,
+            /// Exploits temporal coherence across frames. The sorted order from the
+            /// previous frame is remembered (per culling camera) and used as the starting
+            /// point; only the renderables whose hash changed get sorted again and merged
+            /// back in. Falls back to NormalSort when too many hashes changed.
+            /// Ideal for large queues with mostly static objects. Not stable.
+            TemporalSort,
+            /// Same result as StableSort, but uses an LSD radix sort on the 64-bit hash
+            /// (see radixSortUint64). Faster than NormalSort for large queues.
+            RadixSort,
         };
 
-    private:
         typedef FastArray<QueuedRenderable> QueuedRenderableArray;
 
         struct ThreadRenderQueue
         {
             QueuedRenderableArray q;
+            /// Entries in range [0; numSorted) are already sorted (see _sortThreadQueue)
+            size_t numSorted;
+            /// Scratch memory for RadixSort.
+            QueuedRenderableArray radixSortTmp;
             /// The padding prevents false cache sharing when multithreading.
             uint8 padding[128];
+
+            ThreadRenderQueue() : numSorted( 0u ) {}
         };
 
         typedef FastArray<ThreadRenderQueue> QueuedRenderableArrayPerThread;
 
+        struct TemporalSortEntry
+        {
+            uint64 hash;
+            uint32 idx;
+
+            TemporalSortEntry( uint64 _hash, uint32 _idx ) : hash( _hash ), idx( _idx ) {}
+
+            bool operator<( const TemporalSortEntry &_r ) const { return this->hash < _r.hash; }
+        };
+        typedef FastArray<TemporalSortEntry> TemporalSortEntryArray;
+
+    private:
+        /// Sorted order from the last time a RenderQueueGroup got rendered by a given
+        /// camera. Stored as indices into mQueuedRenderables before sorting.
+        struct TemporalSortCache
+        {
+            FastArray<uint32> sortedIndices;
+            bool              usedThisFrame;
+
+            TemporalSortCache() : usedThisFrame( false ) {}
+        };
+        typedef map<const Camera *, TemporalSortCache>::type TemporalSortCacheMap;
+
         struct RenderQueueGroup
         {
             QueuedRenderableArrayPerThread mQueuedRenderablesPerThread;
@@ -234,6 +271,7 @@ namespace Ogre
             RqSortMode                     mSortMode;
             bool                           mSorted;
             Modes                          mMode;
+            TemporalSortCacheMap           mTemporalSortCache;
 
             RenderQueueGroup() : mSortMode( NormalSort ), mSorted( false ), mMode( FAST ) {}
         };
@@ -277,6 +315,14 @@ namespace Ogre
 
         ParallelHlmsCompileQueue mParallelHlmsCompileQueue;
 
+        /// RenderQueue IDs whose per-thread queues are waiting for _mergeRenderQueuesThread.
+        FastArray<uint8> mPendingMerges;
+
+        /// Scratch buffers for sortTemporal. Kept around to avoid reallocations.
+        QueuedRenderableArray  mTemporalSortSource;
+        TemporalSortEntryArray mTemporalSortKept;
+        TemporalSortEntryArray mTemporalSortDisplaced;
+
         /** Returns a new (or an existing) indirect buffer that can hold the requested number of
         draws.
         @param numDraws
@@ -287,6 +333,18 @@ namespace Ogre
         */
         IndirectBufferPacked *getIndirectBuffer( size_t numDraws );
 
+        /** Sorts renderQueueGroup.mQueuedRenderables using the order the current culling
+            camera saw last time as a starting point. See _sortTemporal.
+        */
+        void sortTemporal( RenderQueueGroup &renderQueueGroup );
+
+        /** For every RenderQueue ID in [firstRq; lastRq) that uses NormalSort, StableSort or RadixSort,
+            sorts what's left of the per-thread queues (i.e. entries added after culling,
+            such as v1 objects) then merges them all into mQueuedRenderables; in parallel
+            using the worker threads if there's enough work.
+        */
+        void mergeSortedThreadQueues( uint8 firstRq, uint8 lastRq );
+
         FORCEINLINE void addRenderable( size_t threadIdx, uint8 renderQueueId, bool casterPass,
                                         Renderable *pRend, const MovableObject *pMovableObject,
                                         bool isV1 );
@@ -395,6 +453,66 @@ namespace Ogre
 
         void _warmUpShadersThread( size_t threadIdx );
 
+        /** Sorts the renderables added by the given thread to the given RenderQueue ID.
+            Called by SceneManager from the worker threads once culling is done, so that
+            most of the sorting is done in parallel; and only merging is left for render().
+        @remarks
+            Only NormalSort, StableSort and RadixSort queues are sorted.
+            TemporalSort relies on the unsorted order and thus is left as is.
+        */
+        void _sortThreadRenderQueue( size_t threadIdx, uint8 rqId );
+
+        /** Merges the sorted per-thread queues of all RQ IDs in mPendingMerges into
+            their mQueuedRenderables. See _mergeThreadQueues.
+        */
+        void _mergeRenderQueuesThread( size_t threadIdx, size_t numThreads );
+
+        /// Sorts the entries in threadRenderQueue that haven't been sorted yet,
+        /// and merges them with the ones that were.
+        static void _sortThreadQueue( ThreadRenderQueue &threadRenderQueue, RqSortMode sortMode );
+
+        /** Merges the part of the sorted per-thread queues that belongs to thread threadIdx
+            into outQueuedRenderables.
+        @remarks
+            Each thread is assigned a range of hashes so every thread writes to a different
+            (contiguous) region of the output. Equal hashes are always merged by the same
+            thread; thus StableSort (and RadixSort) produce the same order as std::stable_sort
+            on the concatenated queues.
+        @param perThreadQueue
+            Queues sorted by _sortThreadQueue.
+        @param outQueuedRenderables [out]
+            Must already be sized to hold the entries of all queues.
+        @param threadIdx
+            Index of the calling thread, in range [0; numThreads).
+        @param numThreads
+            Number of threads taking part in the merge.
+        */
+        static void _mergeThreadQueues( const QueuedRenderableArrayPerThread &perThreadQueue,
+                                        QueuedRenderableArray &outQueuedRenderables,
+                                        size_t threadIdx, size_t numThreads );
+
+        /** Sorts queuedRenderables using the order in sortedIndices (from a previous call) as
+            the starting point, then stores the new order in sortedIndices.
+            See RqSortMode::TemporalSort.
+        @remarks
+            The previous order is walked once, splitting it into a run that is already sorted
+            and a list of displaced entries. If few entries were displaced, only those get
+            sorted and then merged with the run: O(N + K log K) instead of O(N log N).
+        @param queuedRenderables [in/out]
+            Entries to sort.
+        @param sortedIndices [in/out]
+            Indices into queuedRenderables (before sorting) in sorted order. Empty on the first call.
+        @param tmpSource
+            Scratch memory. Passed in to avoid reallocations.
+        @param tmpKept
+            Scratch memory. Passed in to avoid reallocations.
+        @param tmpDisplaced
+            Scratch memory. Passed in to avoid reallocations.
+        */
+        static void _sortTemporal( QueuedRenderableArray &queuedRenderables,
+                                   FastArray<uint32> &sortedIndices, QueuedRenderableArray &tmpSource,
+                                   TemporalSortEntryArray &tmpKept, TemporalSortEntryArray &tmpDisplaced );
+
         void _compileShadersThread( size_t threadIdx );
 
         /// Don't call this too often. Only renders v1 objects at the moment.
@@ -36,6 +36,7 @@ Torus Knot Software Ltd.
 #include "Animation/OgreSkeletonAnimManager.h"
 #include "Compositor/Pass/OgreCompositorPass.h"
 #include "Math/Array/OgreNodeMemoryManager.h"
+#include "Math/Array/OgreObjectDataBvh.h"
 #include "Math/Array/OgreObjectMemoryManager.h"
 #include "OgreAnimationState.h"
 #include "OgreAutoParamDataSource.h"
@@ -160,13 +161,36 @@ namespace Ogre
         /// Number of nodes to process for each thread. Must be multiple of ARRAY_PACKED_REALS
         size_t numNodesPerThread;
         size_t numTotalNodes;
+        /// See NodeMemoryManager::setDirtyTracking
+        bool skipClean;
 
-        UpdateTransformRequest() : numNodesPerThread( 0 ), numTotalNodes( 0 ) {}
+        UpdateTransformRequest() : numNodesPerThread( 0 ), numTotalNodes( 0 ), skipClean( false ) {}
 
-        UpdateTransformRequest( const Transform &_t, size_t _numNodesPerThread, size_t _numTotalNodes ) :
+        UpdateTransformRequest( const Transform &_t, size_t _numNodesPerThread, size_t _numTotalNodes,
+                                bool _skipClean = false ) :
             t( _t ),
             numNodesPerThread( _numNodesPerThread ),
-            numTotalNodes( _numTotalNodes )
+            numTotalNodes( _numTotalNodes ),
+            skipClean( _skipClean )
+        {
+        }
+    };
+
+    /// All variables are read-only for the worker threads.
+    struct CastersBoxRequest
+    {
+        /// First RenderQueue ID to include (inclusive)
+        uint8 firstRq;
+        /// Last RenderQueue ID to include (exclusive)
+        uint8 lastRq;
+        /// Visibility flags objects must match (already combined with the scene's mask)
+        uint32 visibilityMask;
+
+        CastersBoxRequest() : firstRq( 0 ), lastRq( 0 ), visibilityMask( 0 ) {}
+        CastersBoxRequest( uint8 _firstRq, uint8 _lastRq, uint32 _visibilityMask ) :
+            firstRq( _firstRq ),
+            lastRq( _lastRq ),
+            visibilityMask( _visibilityMask )
         {
         }
     };
@@ -469,6 +493,9 @@ namespace Ogre
         LightArrayPerThread                      mGlobalLightListPerThread;
         BuildLightListRequestPerThread           mBuildLightListRequestPerThread;
 
+        /// Partial results of _calculateCurrentCastersBox. One per thread.
+        FastArray<AxisAlignedBox> mCastersBoxPerThread;
+
         /// Current ambient light.
         ColourValue mAmbientLight[2];
         Vector3     mAmbientLightHemisphereDir;
@@ -783,20 +810,7 @@ namespace Ogre
         */
         virtual void _resumeRendering( RenderContext *context );
 
-    protected:
-        Real mDefaultShadowFarDist;
-        Real mDefaultShadowFarDistSquared;
-        Real mShadowTextureOffset;     ///< Proportion of texture offset in view direction e.g. 0.4
-        Real mShadowTextureFadeStart;  ///< As a proportion e.g. 0.6
-        Real mShadowTextureFadeEnd;    ///< As a proportion e.g. 0.9
-
-        CompositorTextureVec mCompositorTextures;
-
-        /// Visibility mask used to show / hide objects
-        uint32 mVisibilityMask;
-        uint32 mLightMask;
-        bool   mFindVisibleObjects;
-
+        /// Type of work the worker threads are asked to do.
         enum RequestType
         {
             CULL_FRUSTUM,
@@ -805,18 +819,50 @@ namespace Ogre
             UPDATE_ALL_BONE_TO_TAG_TRANSFORMS,
             UPDATE_ALL_TAG_ON_TAG_TRANSFORMS,
             UPDATE_ALL_BOUNDS,
+            UPDATE_SCENE_GRAPH_STAGES,
             UPDATE_ALL_LODS,
+            CALCULATE_CASTERS_BOX,
             BUILD_LIGHT_LIST01,
             BUILD_LIGHT_LIST02,
             WARM_UP_SHADERS,
             WARM_UP_SHADERS_COMPILE,
             PARALLEL_HLMS_COMPILE,
+            MERGE_RENDER_QUEUES,
             PARTICLE_SYSTEM_MANAGER2,
             USER_UNIFORM_SCALABLE_TASK,
             STOP_THREADS,
             NUM_REQUESTS
         };
 
+        struct WorkerThreadStats
+        {
+            /// Time spent by the thread on each RequestType, in microseconds.
+            uint64 microseconds[NUM_REQUESTS];
+            /// Number of times each RequestType was executed by the thread.
+            uint32 numRuns[NUM_REQUESTS];
+            /// Chunks processed by the thread. Only counted while work stealing is enabled.
+            uint64 numChunksProcessed;
+            /// Chunks stolen by the thread from other threads.
+            uint64 numChunksStolen;
+
+            WorkerThreadStats() { reset(); }
+            void reset();
+        };
+
+    protected:
+        Real mDefaultShadowFarDist;
+        Real mDefaultShadowFarDistSquared;
+        Real mShadowTextureOffset;     ///< Proportion of texture offset in view direction e.g. 0.4
+        Real mShadowTextureFadeStart;  ///< As a proportion e.g. 0.6
+        Real mShadowTextureFadeEnd;    ///< As a proportion e.g. 0.9
+
+        CompositorTextureVec mCompositorTextures;
+
+        /// Visibility mask used to show / hide objects
+        uint32 mVisibilityMask;
+        uint32 mLightMask;
+        bool   mFindVisibleObjects;
+
         size_t mNumWorkerThreads;
         bool   mForceMainThread;
         /// Performance optimization. When true, ParticleSystemManager2::_prepareParallel()
@@ -827,11 +873,82 @@ namespace Ogre
         UpdateLodRequest              mUpdateLodRequest;
         UpdateTransformRequest        mUpdateTransformRequest;
         ObjectMemoryManagerVec const *mUpdateBoundsRequest;
+        CastersBoxRequest             mCastersBoxRequest;
         UniformScalableTask          *mUserTask;
         RequestType                   mRequestType;
         Barrier                      *mWorkerThreadsBarrier;
         ThreadHandleVec               mWorkerThreads;
 
+        /// A contiguous range of objects within a render queue of an ObjectMemoryManager.
+        /// When work stealing is enabled, it is the unit of work given to a worker thread.
+        struct ObjectDataChunk
+        {
+            ObjectMemoryManager *memoryManager;
+            uint8                rqId;
+            /// Always a multiple of ARRAY_PACKED_REALS
+            size_t firstObj;
+            size_t numObjs;
+        };
+        typedef FastArray<ObjectDataChunk> ObjectDataChunkArray;
+
+        bool                   mWorkStealing;
+        uint32                 mObjectsPerChunk;
+        ObjectDataChunkArray   mObjectDataChunks;
+        WorkStealingScheduler *mWorkStealingScheduler;
+
+        FastArray<WorkerThreadStats> mWorkerThreadStats;
+
+        enum SceneGraphStageType
+        {
+            SgsTransforms,
+            SgsAnimations,
+            SgsParticlePrepare,
+            SgsBoneToTag,
+            SgsTagOnTag,
+            SgsBounds,
+            SgsBvhRefitLeaves,
+            SgsBvhRefitNodes
+        };
+
+        /// Describes the work of each stage in mStageGraph. @see setUpdateStageGraph
+        struct SceneGraphStage
+        {
+            SceneGraphStageType type;
+            /// First node of the depth level (transform stages)
+            Transform t;
+            /// First object of the render queue (bounds & BVH stages)
+            ObjectData objData;
+            /// Only used by SgsBvhRefitLeaves and SgsBvhRefitNodes
+            ObjectDataBvh *bvh;
+            size_t         numTotal;
+            /// Always a multiple of ARRAY_PACKED_REALS, except for animation stages,
+            /// where each job is a thread's partition, and SgsBvhRefitLeaves (in leaves).
+            size_t objectsPerJob;
+            /// See NodeMemoryManager::setDirtyTracking. Only used by SgsTransforms
+            bool skipClean;
+        };
+        typedef FastArray<SceneGraphStage> SceneGraphStageArray;
+
+        bool                 mUpdateStageGraph;
+        StageGraph          *mStageGraph;
+        SceneGraphStageArray mSceneGraphStages;
+
+        /// A BVH over one render queue of an ObjectMemoryManager. @see setBvhCulling
+        struct CullBvh
+        {
+            ObjectMemoryManager *memoryManager;
+            uint8                rqId;
+            /// True when the world AABBs changed since the BVH was last updated
+            bool           boundsDirty;
+            ObjectDataBvh *bvh;
+        };
+        typedef vector<CullBvh>::type CullBvhVec;
+
+        bool                          mBvhCulling;
+        uint32                        mBvhMinObjects;
+        CullBvhVec                    mCullBvhs;
+        ObjectDataBvh::PackRangeArray mBvhPackRanges;
+
         /** Contains MovableObjects to be visited and rendered.
         @rermarks
             Declared here to avoid allocating and deallocating every frame. Declared as array of
@@ -932,6 +1049,44 @@ namespace Ogre
         */
         void updateAllLodsThread( const UpdateLodRequest &request, size_t threadIdx );
 
+        /// Processes the jobs from mStageGraph. @see updateSceneGraphStages
+        void updateSceneGraphStagesThread( size_t threadIdx );
+
+        /// Adds a stage to mStageGraph, returns its index.
+        size_t addSceneGraphStage( SceneGraphStageType type, size_t numTotal, size_t objectsPerJob,
+                                   size_t dependency,
+                                   size_t dependency2 = std::numeric_limits<size_t>::max() );
+
+        /** Adds one stage per non-empty depth level of the given node memory manager; each
+            level depending on the previous one. The first level also depends on 'dependency2'.
+        @return
+            Index of the last stage added, or 'dependency' if none was added.
+        */
+        size_t addNodeStages( NodeMemoryManager *nodeMemoryManager, size_t firstDepth,
+                              SceneGraphStageType firstType, SceneGraphStageType type,
+                              size_t dependency,
+                              size_t dependency2 = std::numeric_limits<size_t>::max() );
+
+        /// Adds one stage per non-empty render queue of the given memory managers,
+        /// all of them depending on 'dependency' and 'dependency2' (but not on each other).
+        void addBoundsStages( const ObjectMemoryManagerVec &objectMemManager, size_t dependency,
+                              size_t dependency2 );
+
+        /** Calculates the bounds of all shadow casters assigned to this thread, and
+            stores the result in mCastersBoxPerThread[threadIdx].
+            @see _calculateCurrentCastersBox
+        @param threadIdx
+            Thread index so we know at which point we should start at.
+            Must be unique for each worker thread
+        */
+        void calculateCastersBoxThread( const CastersBoxRequest &request, size_t threadIdx );
+
+        /** Fires the worker threads to calculate the casters box of the given request,
+            and merges their partial results.
+            @see _calculateCurrentCastersBox
+        */
+        AxisAlignedBox _calculateCurrentCastersBoxThreaded( const CastersBoxRequest &request );
+
         /** Low level culling, culls all objects against the given frustum active cameras. This
             includes checking visibility flags (both scene and viewport's)
             @see MovableObject::cullFrustum
@@ -943,6 +1098,63 @@ namespace Ogre
         */
         void cullFrustum( const CullFrustumRequest &request, size_t threadIdx );
 
+        /// Culls numObjs from objData. Helper for cullFrustum, which
+        /// may call it several times per render queue when work stealing.
+        void cullFrustumObjects( const CullFrustumRequest &request, size_t threadIdx, uint8 rqId,
+                                 size_t numObjs, const ObjectData &objData,
+                                 const CullFrustumPreparedData &preparedData,
+                                 MovableObject::MovableObjectArray &outVisibleObjects );
+
+        /** Splits the objects from the given memory managers into chunks of mObjectsPerChunk,
+            to be distributed among worker threads. Does nothing if work stealing is disabled.
+        @remarks
+            Must be called from the main thread, before firing the worker threads.
+            Use addObjectDataChunks to add more memory managers to the same batch, and
+            call finishObjectDataChunks once the batch is complete.
+        */
+        void prepareObjectDataChunks( const ObjectMemoryManagerVec &objectMemManager, size_t firstRq,
+                                      size_t lastRq );
+        void addObjectDataChunks( ObjectMemoryManager *memoryManager, size_t firstRq, size_t lastRq );
+        void finishObjectDataChunks();
+
+        /** Retrieves the next chunk of objects the given worker thread should process.
+        @param outObjData [out]
+            ObjectData already advanced to the start of the chunk.
+        @return
+            Null when there is no more work left.
+        */
+        const ObjectDataChunk *getNextObjectDataChunk( size_t threadIdx, ObjectData &outObjData );
+
+        /// Adds the chunks of a single render queue, regardless of whether work stealing is enabled.
+        void addRenderQueueChunks( ObjectMemoryManager *memoryManager, uint8 rqId, size_t totalObjs );
+
+        /** Fills mObjectDataChunks with the ranges of objects that may be visible from
+            request.camera, according to the BVH of each render queue.
+            Render queues with less than mBvhMinObjects objects are added whole.
+        */
+        void prepareBvhCullChunks( const CullFrustumRequest &request );
+
+        /// Returns the BVH of the given render queue, creating and updating it if needed.
+        ObjectDataBvh *getCullBvh( ObjectMemoryManager *memoryManager, uint8 rqId,
+                                   const ObjectData &objData, size_t totalObjs );
+
+        /// Flags the BVHs of the given memory managers for refit. Call after updating bounds.
+        void markCullBvhsDirty( const ObjectMemoryManagerVec &objectMemManager );
+
+        /** If the given render queue has a BVH that can be refit (i.e. the number of objects
+            didn't change), adds the stages to refit it in the worker threads, depending on
+            'dependency'; and flags the BVH as up to date.
+            Otherwise it stays dirty, and getCullBvh will rebuild it when needed.
+        */
+        void addCullBvhRefitStages( ObjectMemoryManager *memoryManager, uint8 rqId,
+                                    const ObjectData &objData, size_t totalObjs,
+                                    size_t dependency );
+
+        /// Refits the BVHs of the given memory managers in the worker threads.
+        /// Call after updating bounds, when not using setUpdateStageGraph.
+        void refitCullBvhs( const ObjectMemoryManagerVec &objectMemManager );
+        void destroyCullBvhs();
+
         /** Builds a list of all lights that are visible by all queued cameras (this should be fed by
             Compositor). Then calls MovableObject::buildLightList with that list so that each
             MovableObject gets it's own sorted list of the closest lights.
@@ -1013,6 +1225,76 @@ namespace Ogre
 
         size_t getNumWorkerThreads() const { return mNumWorkerThreads; }
 
+        /** Enables work stealing among worker threads.
+        @remarks
+            By default each worker thread processes a fixed 1/N slice of every render queue.
+            This is cheap, but when the cost per object is uneven (e.g. Lod changes, objects
+            outside the frustum) some threads finish early and sit idle in the barrier.
+        @par
+            When enabled, culling, bounds, Lod and shadow casters' box updates are split
+            in chunks of objectsPerChunk objects; and threads that run out of chunks steal
+            them from those that are still busy.
+        @par
+            It also enables per-thread statistics. See getWorkerThreadStats.
+        @param bWorkStealing
+            True to enable. False to go back to the fixed split.
+        @param objectsPerChunk
+            Number of objects per chunk. Will be rounded up to multiple of ARRAY_PACKED_REALS.
+            Too small increases scheduling overhead, too large hurts load balancing.
+        */
+        void   setWorkStealing( bool bWorkStealing, uint32 objectsPerChunk = 512u );
+        bool   getWorkStealing() const { return mWorkStealing; }
+        uint32 getObjectsPerChunk() const { return mObjectsPerChunk; }
+
+        /** Returns the statistics of the given worker thread, accumulated since the last call
+            to resetWorkerThreadStats. Only collected while work stealing is enabled.
+        @remarks
+            Useful to find which stage is the slowest, and how unbalanced the work is.
+            Do not call while the worker threads are running.
+        */
+        const WorkerThreadStats &getWorkerThreadStats( size_t threadIdx ) const
+        {
+            return mWorkerThreadStats[threadIdx];
+        }
+        void resetWorkerThreadStats();
+
+        /** When enabled, the scene graph update (node transforms, animations, TagPoints and
+            bounds) is described as a graph of stages and run in a single dispatch to the
+            worker threads, instead of syncing all threads after every depth level and step.
+        @remarks
+            Each depth level of each NodeMemoryManager, and each render queue of each
+            ObjectMemoryManager is a stage split into jobs of getObjectsPerChunk objects.
+            A depth level can start as soon as its parent level is done. Bounds of each
+            render queue only depend on the last TagPoint level.
+        @par
+            Threads waiting on a dependency spin; which is fine because the dependency is
+            being worked on. Most useful with many depth levels and many worker threads.
+        */
+        void setUpdateStageGraph( bool bEnabled ) { mUpdateStageGraph = bEnabled; }
+        bool getUpdateStageGraph() const { return mUpdateStageGraph; }
+
+        /** Enables frustum culling through a bounding volume hierarchy built on top of
+            each render queue of each ObjectMemoryManager. See ObjectDataBvh.
+        @remarks
+            Culling tests the whole hierarchy first (in the main thread), and then only
+            the packs of objects that may be visible are sent to the worker threads, in
+            chunks of getObjectsPerChunk objects.
+        @par
+            The hierarchy is refit in the worker threads after every bounds update, and
+            rebuilt when the number of objects changes. Its layout follows the memory layout
+            of the objects, so rebuilding wouldn't improve a hierarchy whose quality has
+            degraded (i.e. objects that moved far away from their neighbours in memory).
+            It pays off with large scenes where most objects are outside the frustum, and
+            when the same objects are culled many times per frame (e.g. shadow map cascades).
+        @param bEnabled
+            True to enable. False destroys all the hierarchies.
+        @param minObjects
+            Render queues with fewer objects are culled linearly.
+        */
+        void   setBvhCulling( bool bEnabled, uint32 minObjects = 4096u );
+        bool   getBvhCulling() const { return mBvhCulling; }
+        uint32 getBvhMinObjects() const { return mBvhMinObjects; }
+
         /// Finds all the movable objects with the type and name passed as parameters.
         virtual MovableObjectVec findMovableObjects( const String &type, const String &name );
 
@@ -1909,6 +2191,10 @@ namespace Ogre
         */
         void updateAllTransforms();
 
+        /// Clears the dirty flags of every NodeMemoryManager in mNodeMemoryManagerUpdateList
+        /// with dirty tracking enabled. @see NodeMemoryManager::setDirtyTracking
+        void clearNodeDirtyFlags();
+
         /** Updates all TagPoints, both TagPoints that are children of bones, and TagPoints that
             are children of other TagPoints.
         @remarks
@@ -1926,6 +2212,15 @@ namespace Ogre
         */
         void updateAllBounds( const ObjectMemoryManagerVec &objectMemManager );
 
+        /** Performs the work of updateAllTransforms, updateAllAnimations, updateAllTagPoints
+            and updateAllBounds (of both entities and lights) in a single dispatch to the
+            worker threads. @see setUpdateStageGraph
+        @remarks
+            Node listeners still get notified right after transforms are updated. When there
+            are any, the transforms get their own dispatch so the listeners can run in between.
+        */
+        void updateSceneGraphStages();
+
         /** Updates the Lod values of all objects relative to the given camera.
          */
         void updateAllLods( const Camera *lodCamera, Real lodBias, uint8 firstRq, uint8 lastRq );
@@ -1989,6 +2284,9 @@ namespace Ogre
         void _fireParallelHlmsCompile();
         void waitForParallelHlmsCompile();
 
+        /// Merges the per-thread render queues in parallel. See RenderQueue::_mergeRenderQueuesThread
+        void _fireMergeRenderQueues();
+
         void _fireParticleSystemManager2Update();
 
         /// Called when the frame has fully ended (ALL passes have been executed to all RTTs)
@@ -2630,6 +2928,11 @@ namespace Ogre
             valid during viewport update. */
         CamerasInProgress getCamerasInProgress() const { return mCamerasInProgress; }
 
+        /** Calculates the bounds of all visible shadow casters in the given RenderQueue range.
+            When there are enough objects the work is split across worker threads; each one
+            merges its objects using SIMD, and the partial results are merged at the end.
+            Otherwise the bounds are calculated in the calling thread.
+        */
         AxisAlignedBox _calculateCurrentCastersBox( uint32 viewportVisibilityMask, uint8 firstRq,
                                                     uint8 lastRq ) const;
 
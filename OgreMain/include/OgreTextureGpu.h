@@ -353,6 +353,10 @@ namespace Ogre
         /// Used if hasAutomaticBatching() == true
         TexturePool const *mTexturePool;
 
+        /// Last frame (see TextureGpuManager::getFrameCount) this texture was bound for
+        /// rendering. Used by TextureGpuManager::setResidencyBudget
+        mutable uint32 mLastFrameUsed;
+
         vector<TextureGpuListener *>::type mListeners;
 
         virtual void createInternalResourcesImpl() = 0;
@@ -552,6 +556,17 @@ namespace Ogre
         /// Notifies it is safe to use the real data. Everything has been uploaded.
         virtual void notifyDataIsReady() = 0;
 
+        /** Notifies mipLevel and all the mips smaller than it have been uploaded while the rest
+            is still streaming (see TextureGpuManager::setProgressiveStreaming).
+        @remarks
+            Backends that can restrict the sampled mips start displaying the real texture
+            from mipLevel onwards instead of the dummy texture. isDataReady keeps
+            returning false until notifyDataIsReady.
+            The default implementation keeps displaying the dummy texture.
+            Either way listeners receive TextureGpuListener::MipLevelReady.
+        */
+        virtual void _notifyMipLevelReady( uint8 mipLevel );
+
         /// Forces downloading data from GPU to CPU, usually because the data on GPU changed
         /// and we're in strategy AlwaysKeepSystemRamCopy. May stall.
         void _syncGpuResidentToSystemRam();
@@ -710,6 +725,9 @@ namespace Ogre
 
         virtual void _setToDisplayDummyTexture() = 0;
         virtual void _notifyTextureSlotChanged( const TexturePool *newPool, uint16 slice );
+        /// Called by TextureGpuManager when our pool got a new (bigger) master texture.
+        /// We keep the same slice, and if we were ready we stay ready.
+        void _notifyTexturePoolMasterChanged();
 
         /** 2D Texture with automatic batching will be merged with other textures into the
             same pool as one big 2D Array texture behind the scenes.
@@ -736,6 +754,10 @@ namespace Ogre
 
         const TexturePool *getTexturePool() const { return mTexturePool; }
 
+        /// Called when the texture gets bound for rendering. See TextureGpuManager::setResidencyBudget
+        void   _notifyUsed( uint32 frameCount ) const { mLastFrameUsed = frameCount; }
+        uint32 getLastFrameUsed() const { return mLastFrameUsed; }
+
         void addListener( TextureGpuListener *listener );
         void removeListener( TextureGpuListener *listener );
         void notifyAllListenersTextureChanged( uint32 reason, void *extraData = 0 );
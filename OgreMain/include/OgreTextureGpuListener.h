@@ -99,6 +99,12 @@ namespace Ogre
             /// It does NOT mean that Ogre has finished issueing rendering commands to
             /// a RenderTexture and is now ready to be presented to the monitor.
             ReadyForRendering,
+            /// A mip level (and all the ones smaller than it) finished uploading, while
+            /// the rest of the texture is still streaming. Only sent when
+            /// TextureGpuManager::setProgressiveStreaming is enabled.
+            /// Cast const uint8 *mip = reinterpret_cast<const uint8*>( extraData );
+            /// to know which mip.
+            MipLevelReady,
             Deleted
         };
 
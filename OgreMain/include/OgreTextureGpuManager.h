@@ -40,6 +40,7 @@ THE SOFTWARE.
 #include "Threading/OgreThreads.h"
 #include "Threading/OgreWaitableEvent.h"
 
+#include "ogrestd/deque.h"
 #include "ogrestd/list.h"
 #include "ogrestd/map.h"
 #include "ogrestd/set.h"
@@ -320,6 +321,9 @@ namespace Ogre
             bool autoDeleteImage;
             /// Indicates we're going to GpuResidency::OnSystemRam instead of Resident
             bool toSysRam;
+            /// Size of the image decoded by the multiload pool; 0 if it wasn't decoded there.
+            /// See TextureGpuManager::setMultiLoadMaxPendingBytes
+            size_t multiLoadBytes;
 
             LoadRequest( const String &_name, Archive *_archive,
                          ResourceLoadingListener *_loadingListener, Image2 *_image, TextureGpu *_texture,
@@ -332,12 +336,14 @@ namespace Ogre
                 sliceOrDepth( _sliceOrDepth ),
                 filters( _filters ),
                 autoDeleteImage( _autoDeleteImage ),
-                toSysRam( _toSysRam )
+                toSysRam( _toSysRam ),
+                multiLoadBytes( 0u )
             {
             }
         };
 
         typedef vector<LoadRequest>::type LoadRequestVec;
+        typedef deque<LoadRequest>::type  LoadRequestDeque;
 
         struct UsageStats
         {
@@ -470,6 +476,10 @@ namespace Ogre
             /// See setWorkerThreadMaxPerStagingTextureRequestBytes
             /// Read by worker thread. Occasionally written by main thread. Not protected.
             size_t maxPerStagingTextureRequestBytes;
+            /// See setProgressiveStreaming
+            /// Read by worker thread. Written by main thread with mMutex held.
+            size_t maxUploadBytesPerFrame;
+            uint32 mipTailMaxResolution;
 
             /// Resheduled textures are textures which were transitioned to Resident
             /// preemptively using the metadata cache, but it turned out to be wrong
@@ -548,12 +558,30 @@ namespace Ogre
 
         /// Threadpool for loading many textures in parallel. See setMultiLoadPool()
         std::vector<ThreadHandlePtr> mMultiLoadWorkerThreads;
-        LoadRequestVec               mMultiLoads;
-        LightweightMutex             mMultiLoadsMutex;
-        Semaphore                    mMultiLoadsSemaphore;
-        std::atomic<uint32>          mPendingMultiLoads;
+        /// FIFO, so that textures are decoded in the order they were requested.
+        LoadRequestDeque    mMultiLoads;
+        LightweightMutex    mMultiLoadsMutex;
+        Semaphore           mMultiLoadsSemaphore;
+        std::atomic<uint32> mPendingMultiLoads;
+        /// Bytes of images decoded by the multiload pool the streaming thread hasn't consumed yet.
+        std::atomic<size_t> mMultiLoadPendingBytes;
+        /// Read by the multiload pool while the main thread may change it.
+        std::atomic<size_t> mMultiLoadMaxPendingBytes;
 
         TexturePoolList  mTexturePool;
+        /// See setMaxTexturePoolSlices
+        uint16           mMaxTexturePoolSlices;
+
+        /// Incremented every frame by _updateResidency. See TextureGpu::getLastFrameUsed
+        uint32                     mFrameCount;
+        /// See setResidencyBudget
+        size_t                     mResidencyBudgetBytes;
+        uint32                     mResidencyFramesUnused;
+        GpuResidency::GpuResidency mResidencyEvictTo;
+        size_t                     mResidencyUsedBytes;
+        /// Scratch memory for _updateResidency
+        TextureGpuVec mTmpEvictionCandidates;
+        TextureGpuVec mTmpRestoreCandidates;
         ResourceEntryMap mEntries;
         /// Protects mEntries
         mutable LightweightMutex mEntriesMutex;
@@ -658,6 +686,17 @@ namespace Ogre
         void destroyAllTextures();
         void destroyAllPools();
 
+        /// Creates a resident master texture for a new pool of numSlices slices
+        /// compatible with the given texture.
+        TextureGpu *createTexturePoolMaster( TextureGpu *texture, uint32 numSlices );
+
+        /** Replaces the master texture of a full pool with one that has numSlicesToAdd more
+            slices (up to mMaxTexturePoolSlices). Used slices are copied on the GPU and every
+            texture keeps its slot; they're notified via
+            TextureGpu::_notifyTexturePoolMasterChanged so descriptors get rebuilt.
+        */
+        void growTexturePool( TexturePool &pool, TextureGpu *texture, uint32 numSlicesToAdd );
+
         virtual TextureGpu *createTextureImpl( GpuPageOutStrategy::GpuPageOutStrategy pageOutStrategy,
                                                IdString name, uint32 textureFlags,
                                                TextureTypes::TextureTypes initialType ) = 0;
@@ -1078,6 +1117,75 @@ namespace Ogre
                              size_t &outUsedStagingTextureBytes,
                              size_t &outAvailableStagingTextureBytes );
 
+        struct TexturePoolMemoryStats
+        {
+            TextureGpu const *masterTexture;
+            /// Total size of the pool in VRAM
+            size_t bytes;
+            /// Size of the slices that have a texture assigned
+            size_t usedBytes;
+            uint16 numSlices;
+            uint16 numUsedSlices;
+        };
+        typedef vector<TexturePoolMemoryStats>::type TexturePoolMemoryStatsVec;
+
+        /// Reports how much memory each pool (see TextureFlags::AutomaticBatching) is using.
+        /// outStats is not cleared.
+        void getTexturePoolMemoryStats( TexturePoolMemoryStatsVec &outStats ) const;
+
+        /** Limits how much VRAM textures loaded from file may use.
+        @par
+            Every frame we track which textures were bound for rendering (see
+            TextureGpu::getLastFrameUsed). When the Resident textures add up to more than
+            budgetBytes, textures that haven't been used for framesUnused frames are
+            evicted, least recently used first, until we're within budget again.
+        @par
+            If an evicted texture gets bound again (e.g. its datablock became visible) it
+            gets scheduled to go back to Resident; it will show the dummy texture until it
+            finishes loading. Use prefetchTexture to avoid that.
+        @remarks
+            Only textures loaded from file are evicted. Manual textures, RenderToTexture,
+            UAVs and textures with pending residency changes are never touched (but
+            they do count towards the budget).
+        @par
+            Textures with TextureFlags::AutomaticBatching only give their memory back once
+            the whole pool is empty, thus they're never evicted. Their pools count towards
+            the budget with all their slices, used or not.
+        @par
+            Textures count as used the frame they become Resident and the frame their data
+            becomes ready, so they aren't evicted right after loading.
+        @param budgetBytes
+            Budget in bytes. 0 to disable (default).
+        @param framesUnused
+            Textures used within the last framesUnused frames are never evicted.
+        @param evictTo
+            Either GpuResidency::OnStorage (frees all memory; the texture is
+            reloaded from file) or GpuResidency::OnSystemRam (keeps a copy in RAM).
+        */
+        void setResidencyBudget( size_t budgetBytes, uint32 framesUnused = 60u,
+                                 GpuResidency::GpuResidency evictTo = GpuResidency::OnStorage );
+        size_t getResidencyBudget() const { return mResidencyBudgetBytes; }
+
+        /// Bytes of Resident textures as of the last _updateResidency.
+        /// Only calculated if setResidencyBudget is active.
+        size_t getResidencyUsedBytes() const { return mResidencyUsedBytes; }
+
+        /** Tells the residency manager this texture is about to be needed, e.g. because
+            the camera is heading towards the objects using it, or a page containing it is
+            being loaded.
+        @remarks
+            The texture counts as used this frame (so it won't be evicted for
+            framesUnused frames) and if it's not Resident, it gets scheduled to become
+            Resident. See setResidencyBudget.
+        */
+        void prefetchTexture( TextureGpu *texture );
+
+        /// Number of times _updateResidency has been called. Roughly the number of frames.
+        uint32 getFrameCount() const { return mFrameCount; }
+
+        /// Evicts / restores textures according to setResidencyBudget. Called every frame.
+        void _updateResidency();
+
         void dumpStats() const;
         void dumpMemoryUsage( Log *log, Ogre::uint32 mask = ResidencyMask::All ) const;
 
@@ -1085,6 +1193,24 @@ namespace Ogre
         /// See TextureGpuManagerListener. Pointer cannot be null.
         void setTextureGpuManagerListener( TextureGpuManagerListener *listener );
 
+        /** When a pool (see TextureFlags::AutomaticBatching) is full, instead of creating
+            a new pool we grow the existing one by TextureGpuManagerListener::getNumSlicesFor
+            slices (by copying it on the GPU into a bigger 2D array texture), so that textures
+            keep being batched together.
+        @par
+            Pools won't grow beyond this number of slices; a new pool is created instead.
+            Manually reserved pools (see reservePoolId) never grow, and neither do pools
+            for which TextureGpuManagerListener::getNumSlicesFor returns 1.
+        @remarks
+            Growing is not free: it temporarily needs memory for both the old and new pool.
+            Set to 0 to disable growing altogether.
+        @param maxSlices
+            Default is 256, which is the minimum number of array layers guaranteed
+            by all supported APIs.
+        */
+        void   setMaxTexturePoolSlices( uint16 maxSlices );
+        uint16 getMaxTexturePoolSlices() const { return mMaxTexturePoolSlices; }
+
         /** OgreNext always performs background streaming to load textures in a worker thread.
             However there is only ONE background thread performing all work serially while
             the main thread can do other stuff (like rendering, even if textures aren't ready).
@@ -1128,6 +1254,10 @@ namespace Ogre
             If you need to preserve ordering, you can use TextureGpu::scheduleTransition and
             set bSkipMultiload = true.
 
+            Textures are handed to the threadpool in the order they were requested, and
+            the threadpool won't decode further ahead than setMultiLoadMaxPendingBytes
+            allows.
+
             Testing indicates the ideal value is somewhere between 4-8 threads.
             More threads and you get diminishing returns.
         @param numThreads
@@ -1135,6 +1265,24 @@ namespace Ogre
             0 to disable this feature (Default).
         */
         void setMultiLoadPool( uint32 numThreads );
+        size_t getMultiLoadPoolSize() const { return mMultiLoadWorkerThreads.size(); }
+
+        /** When the MultiLoad pool decodes images faster than the background thread can
+            upload them (e.g. thousands of textures queued during a level load), the decoded
+            images pile up in RAM.
+
+            Once the images waiting for the background thread add up to more than this
+            value, the threadpool stops decoding until the background thread catches up.
+        @remarks
+            The value is an approximation and not a hard limit: images already being decoded
+            will be finished, and a single image larger than the limit will still be loaded.
+
+            Default is the same as setWorkerThreadMaxPreloadBytes' default for the platform.
+        @param maxPendingBytes
+            Value in bytes. Can be changed at any time.
+        */
+        void   setMultiLoadMaxPendingBytes( size_t maxPendingBytes );
+        size_t getMultiLoadMaxPendingBytes() const { return mMultiLoadMaxPendingBytes.load(); }
 
         /** Background streaming works by having a bunch of preallocated StagingTextures so
             we're ready to start uploading as soon as we see a request to load a texture
@@ -1247,6 +1395,36 @@ namespace Ogre
         */
         void setWorkerThreadMaxPreloadBytes( size_t maxPreloadBytes );
 
+        /** Textures are uploaded from the smallest mip to the biggest one. When this
+            setting is enabled, the biggest mips are spread across frames:
+        @par
+            The mip tail (all mips whose width and height are <= mipTailMaxResolution)
+            gets uploaded as soon as the image is loaded. Bigger mips are only uploaded
+            while less than maxUploadBytesPerFrame bytes have been uploaded since the last
+            _update call; the rest waits for the next frame.
+        @par
+            As each mip finishes, the texture starts being displayed from that mip instead
+            of the dummy texture (see TextureGpu::_notifyMipLevelReady; currently GL3+ and
+            D3D11, and not for TextureFlags::AutomaticBatching textures) and listeners get
+            TextureGpuListener::MipLevelReady.
+            TextureGpuListener::ReadyForRendering is still sent once all mips are uploaded.
+        @remarks
+            This avoids frame hitches when lots of big textures (e.g. 4k) finish loading
+            in the same frame, at the expense of taking a few more frames to load them.
+        @par
+            Textures loaded from multiple images (e.g. cubemaps made of 6 files) don't
+            get MipLevelReady events, but they still follow the upload budget.
+        @param maxUploadBytesPerFrame
+            Value in bytes. 0 to disable (default). The budget is approximate: one mip
+            is always allowed to go through even if it's bigger than the budget.
+        @param mipTailMaxResolution
+            Mips with width & height at or below this value ignore the budget.
+        */
+        void setProgressiveStreaming( size_t maxUploadBytesPerFrame,
+                                      uint32 mipTailMaxResolution = 256u );
+        size_t getMaxUploadBytesPerFrame() const { return mStreamingData.maxUploadBytesPerFrame; }
+        uint32 getMipTailMaxResolution() const { return mStreamingData.mipTailMaxResolution; }
+
         /** The worker thread tracks how many data it is loading so the Main thread can request
             additional StagingTextures if necessary.
 
@@ -0,0 +1,273 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _OgreTraceProfiler_H_
+#define _OgreTraceProfiler_H_
+
+#include "OgrePrerequisites.h"
+
+#include "OgreIdString.h"
+#include "Threading/OgreLightweightMutex.h"
+#include "Threading/OgreThreads.h"
+
+#include <atomic>
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+     *  @{
+     */
+    /** \addtogroup General
+     *  @{
+     */
+
+    /** Name of a trace event.
+    @remarks
+        Registering the name (so it can be exported later) takes a lock, therefore
+        markers are meant to be static objects: the OgreProfile* macros create one
+        per call site, so the hot path only has to copy the hash.
+    */
+    struct _OgreExport TraceMarker
+    {
+        /// IdString( name ).getU32Value()
+        uint32 nameHash;
+
+        TraceMarker( const char *_name );
+    };
+
+    /**
+    @class TraceProfiler
+        Low overhead profiler that records begin/end events into per-thread ring
+        buffers, and exports them as Chrome trace JSON (chrome://tracing, Perfetto,
+        Speedscope, etc).
+    @remarks
+        Recording an event doesn't lock, allocate or hash strings. Each thread owns a
+        fixed size ring buffer of TraceEvents which only that thread writes to;
+        when it's full the oldest events are overwritten, therefore memory
+        consumption never grows (unlike OfflineProfiler).
+    @par
+        While not capturing, the cost of an event is a single relaxed atomic load.
+        Together with setSampleFrequency (only capture one in every N frames) this
+        makes it cheap enough to be left on in production builds.
+    @par
+        Threads that record their first event are registered automatically.
+        Use setThreadName to get readable names in the exported trace.
+    */
+    class _OgreExport TraceProfiler : public OgreAllocatedObj
+    {
+    public:
+        enum TraceEventType
+        {
+            TraceEventBegin,
+            TraceEventEnd
+        };
+
+        struct TraceEvent
+        {
+            /// In nanoseconds, from std::chrono::steady_clock
+            uint64 nsTimestamp;
+            /// Hash of the name. Unused by TraceEventEnd
+            uint32 nameHash;
+            /// TraceEventType
+            uint16 type;
+            /// Lowest 16 bits of the index of the captured frame this event belongs to.
+            /// Events from different captured frames are never paired on export.
+            uint16 captureIdx;
+        };
+
+    protected:
+        class ThreadBuffer
+        {
+        public:
+            TraceEvent *mEvents;
+            /// Capacity - 1. Capacity is always a power of 2
+            uint64 mCapacityMask;
+            /// Total number of events ever written. Only written by the owner thread
+            std::atomic<uint64> mWriteIdx;
+            /// Events before this index were discarded by reset. Protected by mMutex
+            uint64 mReadStartIdx;
+
+            uint32 mThreadIdx;
+            /// Protected by mMutex
+            String mThreadName;
+
+            ThreadBuffer( size_t capacity, uint32 threadIdx );
+            ~ThreadBuffer();
+
+            inline void push( uint64 nsTimestamp, uint32 nameHash, TraceEventType type,
+                              uint32 captureIdx )
+            {
+                const uint64 writeIdx = mWriteIdx.load( std::memory_order_relaxed );
+                TraceEvent &traceEvent = mEvents[writeIdx & mCapacityMask];
+                traceEvent.nsTimestamp = nsTimestamp;
+                traceEvent.nameHash = nameHash;
+                traceEvent.type = static_cast<uint16>( type );
+                traceEvent.captureIdx = static_cast<uint16>( captureIdx );
+                mWriteIdx.store( writeIdx + 1u, std::memory_order_release );
+            }
+
+            /// Copies the events that haven't been overwritten (or discarded) yet
+            void copyEvents( FastArray<TraceEvent> &outEvents ) const;
+        };
+
+        typedef FastArray<ThreadBuffer *> ThreadBufferArray;
+
+        std::atomic<bool> mCapturing;
+        bool              mEnabled;
+        /// Incremented every time _frameStarted decides to capture a frame
+        std::atomic<uint32> mCaptureIdx;
+
+        uint32 mSampleFrequency;
+        uint64 mFrameCount;
+
+        size_t mEventsPerThread;
+
+        /// Protects mThreadBuffers, and the names & read indices of each ThreadBuffer
+        LightweightMutex  mMutex;
+        TlsHandle         mTlsHandle;
+        ThreadBufferArray mThreadBuffers;
+
+        String mOnShutdownPath;
+
+        ThreadBuffer *getThreadBuffer();
+        ThreadBuffer *allocateThreadBuffer();
+
+        uint64 getNanoseconds() const;
+
+        void profileBegin( uint32 nameHash )
+        {
+            if( !mCapturing.load( std::memory_order_relaxed ) )
+                return;
+            const uint64 nsTimestamp = getNanoseconds();
+            getThreadBuffer()->push( nsTimestamp, nameHash, TraceEventBegin,
+                                     mCaptureIdx.load( std::memory_order_relaxed ) );
+        }
+
+    public:
+        TraceProfiler();
+        ~TraceProfiler();
+
+        /// Records the start of an event. Does nothing if we're not capturing this frame.
+        void profileBegin( const TraceMarker &marker ) { profileBegin( marker.nameHash ); }
+
+        /** Records the start of an event whose name is not known at compile time.
+        @remarks
+            Slower than the TraceMarker overload because the name has to be hashed and
+            registered (which takes a lock). Avoid generating unique names every frame,
+            as every name ever seen is kept until shutdown.
+        */
+        void profileBeginDynamic( const char *name );
+
+        /// Records the end of the last event started by this thread.
+        void profileEnd()
+        {
+            if( !mCapturing.load( std::memory_order_relaxed ) )
+                return;
+            const uint64 nsTimestamp = getNanoseconds();
+            getThreadBuffer()->push( nsTimestamp, 0u, TraceEventEnd,
+                                     mCaptureIdx.load( std::memory_order_relaxed ) );
+        }
+
+        /** Enables or disables capturing. When disabled, no events are recorded.
+        @remarks
+            Takes effect on the next _frameStarted call.
+        */
+        void setEnabled( bool bEnabled );
+        bool isEnabled() const { return mEnabled; }
+
+        /** Only capture one in every N frames.
+        @param everyNthFrame
+            1 to capture every frame. Values <= 1 are treated as 1.
+        */
+        void setSampleFrequency( uint32 everyNthFrame );
+        uint32 getSampleFrequency() const { return mSampleFrequency; }
+
+        /** Size of the ring buffer of each thread, in events. Will be rounded up to the next
+            power of 2. Only affects threads that haven't recorded any event yet.
+        @remarks
+            Each event takes sizeof( TraceEvent ) = 16 bytes.
+        */
+        void setEventsPerThread( size_t numEvents );
+        size_t getEventsPerThread() const { return mEventsPerThread; }
+
+        /// Whether the current frame is being captured.
+        bool isCapturing() const { return mCapturing.load( std::memory_order_relaxed ); }
+
+        /// Names the calling thread in the exported trace.
+        void setThreadName( const char *name );
+
+        /** Called by Root at the beginning of every frame. Decides whether this
+            frame will be captured.
+        */
+        void _frameStarted();
+        /// Called by Root at the end of every frame. Stops capturing.
+        void _frameEnded();
+
+        /// Discards all the recorded events. Thread safe.
+        void reset();
+
+        /** Writes the recorded events as Chrome trace JSON into outJson.
+        @remarks
+            Thread safe, but if other threads are recording at the same time,
+            events that were overwritten while being copied are dropped.
+            Best called between frames, or after _frameEnded.
+        @par
+            Events are not consumed; call reset to discard them.
+        */
+        void exportChromeTrace( String &outJson );
+
+        /// Same as exportChromeTrace, but writes into a file.
+        void dumpChromeTrace( const String &fullPath );
+
+        /// Ogre will call dumpChromeTrace on shutdown if you set this path.
+        /// Empty string to disable.
+        void setDumpPathOnShutdown( const String &fullPath );
+    };
+
+    /// Scoped TraceProfiler event. Use the OgreProfile macro instead.
+    class TraceScope
+    {
+        TraceProfiler *mTraceProfiler;
+
+    public:
+        TraceScope( TraceProfiler &traceProfiler, const TraceMarker &marker ) :
+            mTraceProfiler( &traceProfiler )
+        {
+            mTraceProfiler->profileBegin( marker );
+        }
+        ~TraceScope() { mTraceProfiler->profileEnd(); }
+    };
+
+    /** @} */
+    /** @} */
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
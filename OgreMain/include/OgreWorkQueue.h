@@ -33,11 +33,13 @@ THE SOFTWARE.
 #include "OgreAny.h"
 #include "OgreCommon.h"
 #include "OgreSharedPtr.h"
+#include "Threading/OgreMpmcRingBuffer.h"
 #include "Threading/OgreThreadHeaders.h"
 
 #include "ogrestd/deque.h"
 #include "ogrestd/list.h"
 #include "ogrestd/map.h"
+#include "ogrestd/set.h"
 
 #include "OgreHeaderPrefix.h"
 
@@ -110,6 +112,13 @@ namespace Ogre
             /// Constructor
             Request( uint16 channel, uint16 rtype, const Any &rData, uint8 retry, RequestID rid );
             ~Request();
+
+            /// Requests are small and short lived (often thousands per second), so
+            /// their memory is recycled through a lock-free free list.
+            void *operator new( size_t sz );
+            void *operator new( size_t sz, const char *file, int line, const char *func );
+            void  operator delete( void *ptr, size_t sz );
+            void  operator delete( void *ptr, const char *file, int line, const char *func );
             /// Set the abort flag
             void abortRequest() const { mAborted = true; }
             /// Get the request channel (top level categorisation)
@@ -377,6 +386,15 @@ namespace Ogre
     };
 
     /** Base for a general purpose request / response style background work queue.
+    @remarks
+        Requests are pushed into a lock-free ring buffer, so submitting work never
+        contends with the workers. If the ring is full, requests spill into a
+        mutex-guarded queue until it drains.
+    @par
+        Requests sitting in the ring can't be iterated. Aborting them is therefore
+        deferred: the abort is recorded, and the worker applies it when it picks up
+        the request. The same applies to the batch of responses being processed by
+        processResponses, which swaps the whole response queue out under a single lock.
      */
     class _OgreExport DefaultWorkQueueBase : public WorkQueue
     {
@@ -485,9 +503,47 @@ namespace Ogre
         typedef deque<Request *>::type  RequestQueue;
         typedef deque<Response *>::type ResponseQueue;
 
-        RequestQueue  mRequestQueue;   // Guarded by mRequestMutex
-        RequestQueue  mProcessQueue;   // Guarded by mProcessMutex
-        ResponseQueue mResponseQueue;  // Guarded by mResponseMutex
+        /// Requests waiting for a worker.
+        MpmcRingBuffer<Request *> mRequestRing;
+        /// Overflow of mRequestRing. While it's not empty new requests go here too,
+        /// so that they don't overtake older ones.
+        RequestQueue        mRequestQueue;  // Guarded by mRequestMutex
+        std::atomic<size_t> mNumOverflowRequests;
+        RequestQueue        mProcessQueue;   // Guarded by mProcessMutex
+        ResponseQueue       mResponseQueue;  // Guarded by mResponseMutex
+        /// Responses taken by processResponses that haven't been processed yet.
+        /// Only accessed from the thread calling processResponses.
+        ResponseQueue mResponseBatch;
+
+        /** Aborts that couldn't be applied immediately because the request was in
+            mRequestRing or mResponseBatch. RequestIDs are increasing, so every
+            request issued before the abort call has an ID <= the recorded watermark.
+        */
+        struct AbortRecords
+        {
+            /// Requests with an ID <= allRid are aborted.
+            RequestID allRid;
+            /// Requests of the channel with an ID <= the value are aborted.
+            map<uint16, RequestID>::type channelRid;
+            set<RequestID>::type         ids;
+
+            AbortRecords() : allRid( 0 ) {}
+
+            bool empty() const { return !allRid && channelRid.empty() && ids.empty(); }
+            bool matches( const Request *r ) const;
+            void clear();
+        };
+        AbortRecords mPendingAborts;   // Guarded by mProcessMutex
+        /** Requests pushed (or about to be pushed) to mRequestRing or mRequestQueue that
+            haven't been checked against mPendingAborts yet. The ring doesn't dispatch in
+            RequestID order when several threads add requests, so mPendingAborts can only be
+            cleared once this reaches 0.
+        */
+        std::atomic<size_t> mNumUndispatchedRequests;
+        AbortRecords mResponseAborts;  // Guarded by mResponseMutex
+        /// Incremented every time mResponseAborts changes.
+        std::atomic<uint32> mResponseAbortCount;
+        bool                mProcessingResponses;  // Guarded by mResponseMutex
 
         /// Thread function
         struct _OgreExport WorkerFunc OGRE_THREAD_WORKER_INHERIT
@@ -559,7 +615,7 @@ namespace Ogre
 
         RequestHandlerListByChannel  mRequestHandlers;
         ResponseHandlerListByChannel mResponseHandlers;
-        RequestID                    mRequestCount;  // Guarded by mRequestMutex
+        std::atomic<RequestID>       mRequestCount;
         bool                         mPaused;
         bool                         mAcceptRequests;
         bool                         mShuttingDown;
@@ -580,6 +636,10 @@ namespace Ogre
         void      processResponse( Response *r );
         /// Notify workers about a new request.
         virtual void notifyWorkers() = 0;
+        /// Puts the request in the ring buffer (or the overflow queue) and notifies the workers.
+        void pushRequest( Request *req );
+        /// Applies mResponseAborts to mResponseBatch. mResponseMutex must be held.
+        void applyResponseAborts();
         /// Put a Request on the queue with a specific RequestID.
         void addRequestWithRID( RequestID rid, uint16 channel, uint16 requestType, const Any &rData,
                                 uint8 retryCount );
@@ -40,6 +40,8 @@ namespace Ogre
 {
     OGRE_ASSUME_NONNULL_BEGIN
 
+    struct ParticleGpuAffector;
+
     /// Affectors are per ParticleSystemDef
     class _OgreExport ParticleAffector2 : public StringInterface
     {
@@ -69,6 +71,14 @@ namespace Ogre
         virtual void run( ParticleCpuData cpuData, size_t numParticles,
                           ArrayReal timeSinceLast ) const = 0;
 
+        /** Returns true if this affector can also run in the particle compute shader
+            (see ParticleSystemDef::setGpuSimulation) and fills outAffector.
+        @remarks
+            The result on the GPU must be the same as run()'s.
+            See ParticleGpuSimulation::compareWithCpu.
+        */
+        virtual bool getGpuAffector( ParticleGpuAffector & /*outAffector*/ ) const { return false; }
+
         virtual void _cloneFrom( const ParticleAffector2 *original ) = 0;
 
         /** Returns the name of the type of affector.
@@ -0,0 +1,250 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef OgreParticleGpuSimulation_H
+#define OgreParticleGpuSimulation_H
+
+#include "OgrePrerequisites.h"
+
+#include "OgreResourceTransition.h"
+#include "OgreVector4.h"
+#include "ParticleSystem/OgreParticle2.h"
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    OGRE_ASSUME_NONNULL_BEGIN
+
+    class ParticleAffector2;
+    class ParticleSystemDef;
+
+    namespace ParticleGpuAffectorOp
+    {
+        /// Operations the particle compute shader knows how to perform.
+        /// Keep in sync with Samples/Media/Compute/ParticleFX2/Any/Particles_piece_cs.any
+        enum ParticleGpuAffectorOp
+        {
+            /// direction += params[0].xyz * timeSinceLast
+            LinearForceAdd,
+            /// direction = ( direction + params[0].xyz ) * 0.5
+            LinearForceAverage,
+            /// colour = clamp( colour + params[0] * timeSinceLast, params[1], params[2] )
+            ColourFade,
+            /// Same as ColourFade, but adds params[0] while the time to live is greater
+            /// than stateChange, params[1] otherwise. Clamps against params[2] & params[3].
+            ColourFadeTwoStates,
+            /// dimensions += params[0].x * timeSinceLast
+            ScaleAdd,
+            /// dimensions *= pow( params[0].x, timeSinceLast )
+            ScaleMultiply,
+            /// rotation += rotationSpeed * timeSinceLast (wrapped to [-PI; PI])
+            Rotate
+        };
+    }  // namespace ParticleGpuAffectorOp
+
+    /// Description of a ParticleAffector2 that can run in the particle compute shader.
+    /// See ParticleAffector2::getGpuAffector.
+    struct _OgreExport ParticleGpuAffector
+    {
+        ParticleGpuAffectorOp::ParticleGpuAffectorOp op;
+        float                                        stateChange;
+        Vector4                                      params[4];
+
+        ParticleGpuAffector() : op( ParticleGpuAffectorOp::LinearForceAdd ), stateChange( 0.0f )
+        {
+            params[0] = params[1] = params[2] = params[3] = Vector4::ZERO;
+        }
+    };
+
+    /// State of a particle in the GPU pool. Laid out to match the compute shader (std430).
+    struct _OgrePrivate ParticleGpuState
+    {
+        float mPos[3];
+        float mTimeToLive;
+        float mDirection[3];
+        float mTotalTimeToLive;
+        float mDimensions[2];
+        float mRotation;
+        float mRotationSpeed;
+        float mColour[4];
+    };
+
+    /// A newly emitted particle, initialized on the CPU, to be copied into the GPU pool.
+    struct _OgrePrivate ParticleGpuSpawn
+    {
+        uint32           mHandle;
+        uint32           mPadding[3];
+        ParticleGpuState mState;
+    };
+
+    /** Runs the simulation of ParticleSystemDefs that have ParticleSystemDef::setGpuSimulation
+        enabled as HlmsComputeJobs.
+    @remarks
+        Emitters still run on the CPU: they initialize the new particles exactly as they would
+        in the CPU path (thus emitters from plugins keep working), and these are uploaded and
+        scattered into the pool by the "Compute/ParticleFX2/Spawn" job.
+
+        The affectors and the integration (including writing the ParticleGpuData the vertex
+        shader reads) run in "Compute/ParticleFX2/Simulate". Only affectors that return
+        true from ParticleAffector2::getGpuAffector are supported.
+
+        The CPU keeps ticking the time to live of each particle (which is deterministic, affectors
+        never modify it) so it knows when to recycle their handles. Everything else (position,
+        colour, etc) only lives in the GPU.
+
+        The jobs are bundled at Samples/Media/Compute/ParticleFX2
+    @par
+        simulateReference() is a scalar implementation of the compute shader. It must be kept
+        in sync with the shader. The CPU path is validated against it (see compareWithCpu),
+        and so is the shader itself when the RenderSystem supports compute (see compareWithGpu).
+    */
+    class _OgreExport ParticleGpuSimulation : public OgreAllocatedObj
+    {
+    public:
+        /// Maximum number of affectors a ParticleSystemDef can have to be simulated on the GPU.
+        static constexpr uint32 MaxAffectors = 8u;
+        /// Number of float4 each affector takes in the shader.
+        static constexpr uint32 AffectorStride = 5u;
+
+    protected:
+        HlmsCompute    *mHlmsCompute;
+        HlmsComputeJob *mSpawnJob;
+        HlmsComputeJob *mSimulateJob;
+
+        FastArray<float>        mAffectorData;
+        ResourceTransitionArray mResourceTransitions;
+
+        /// Dispatches "Compute/ParticleFX2/Simulate" over the first numParticles of pool.
+        void dispatchSimulate( UavBufferPacked *pool, UavBufferPacked *renderData,
+                               uint32 numParticles, const FastArray<ParticleGpuAffector> &gpuAffectors,
+                               float timeSinceLast );
+
+    public:
+        ParticleGpuSimulation( HlmsCompute *hlmsCompute );
+
+        /** Uploads the new particles of systemDef and advances its simulation.
+            Must be called from the main thread.
+        @param systemDef
+            ParticleSystemDef::isGpuSimulated must be true.
+        @param numSpawns
+            Number of new particles in systemDef's spawn list.
+        @param timeSinceLast
+            Time in seconds since last frame.
+        */
+        void simulate( ParticleSystemDef *systemDef, uint32 numSpawns, float timeSinceLast );
+
+        /// Returns true if all the affectors can run on the GPU and fills outAffectors.
+        static bool getGpuAffectors( const FastArray<ParticleAffector2 *> &affectors,
+                                     FastArray<ParticleGpuAffector>       &outAffectors );
+
+        /// Copies the particle at the given handle from SoA memory.
+        static void packState( const ParticleCpuData &cpuData, uint32 handle,
+                               ParticleGpuState &outState );
+
+        /** Scalar version of "Compute/ParticleFX2/Simulate".
+        @param particles [in/out]
+            Particles to advance.
+        @param outGpuData [out]
+            Array of numParticles. Same data the compute shader would write for the vertex shader.
+        @param numParticles
+            Number of particles.
+        @param affectors
+            Affectors to run, in order.
+        @param numAffectors
+            Number of affectors.
+        @param timeSinceLast
+            Time in seconds since last frame.
+        */
+        static void simulateReference( ParticleGpuState *particles, ParticleGpuData *outGpuData,
+                                       size_t numParticles, const ParticleGpuAffector *affectors,
+                                       size_t numAffectors, float timeSinceLast );
+
+        /** Advances the given particles numFrames times through the CPU path (the affectors'
+            ParticleAffector2::run and the same tick ParticleSystemManager2 performs) and
+            through simulateReference, then compares the results.
+        @remarks
+            Useful to validate new GPU affectors. It doesn't need a RenderSystem.
+            cpuData is modified.
+        @param cpuData
+            Particles to simulate.
+        @param numParticles
+            Number of particles in cpuData. Must be multiple of ARRAY_PACKED_REALS.
+        @param affectors
+            Affectors to run. All must support getGpuAffector.
+        @param timeSinceLast
+            Time in seconds since last frame.
+        @param numFrames
+            Number of frames to simulate.
+        @param tolerance
+            Maximum absolute difference allowed for each component of the state. The encoded
+            ParticleGpuData is allowed to differ by 1 unit in the last place.
+        @param outReport [out]
+            Optional. Description of the first mismatch, if any.
+        @return
+            Number of particles that didn't match.
+        */
+        static size_t compareWithCpu( ParticleCpuData cpuData, size_t numParticles,
+                                      const FastArray<ParticleAffector2 *> &affectors,
+                                      float timeSinceLast, uint32 numFrames, float tolerance,
+                                      String *ogre_nullable outReport = 0 );
+
+        /** Uploads the given particles, runs them numFrames times through
+            "Compute/ParticleFX2/Simulate" and through simulateReference, then reads back
+            the GPU results and compares them.
+        @remarks
+            Useful to validate the compute shader against simulateReference.
+            The RenderSystem must support RSC_COMPUTE_PROGRAM. This function stalls.
+        @param cpuData
+            Particles to simulate.
+        @param numParticles
+            Number of particles in cpuData.
+        @param affectors
+            See compareWithCpu.
+        @param timeSinceLast
+            Time in seconds since last frame.
+        @param numFrames
+            Number of frames to simulate.
+        @param tolerance
+            See compareWithCpu.
+        @param outReport [out]
+            Optional. Description of the first mismatch, if any.
+        @return
+            Number of particles that didn't match.
+        */
+        size_t compareWithGpu( const ParticleCpuData &cpuData, size_t numParticles,
+                               const FastArray<ParticleAffector2 *> &affectors, float timeSinceLast,
+                               uint32 numFrames, float tolerance,
+                               String *ogre_nullable outReport = 0 );
+    };
+
+    OGRE_ASSUME_NONNULL_END
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -44,6 +44,8 @@ namespace Ogre
     OGRE_ASSUME_NONNULL_BEGIN
 
     class ParticleAffector2;
+    struct ParticleGpuAffector;
+    struct ParticleGpuSpawn;
     class EmitterDefData;
     struct EmitterInstanceData;
     class ParticleSystem2;
@@ -108,6 +110,12 @@ namespace Ogre
             String doGet( const void *target ) const override;
             void   doSet( void *target, const String &val ) override;
         };
+        class _OgrePrivate CmdGpuSimulation final : public ParamCommand
+        {
+        public:
+            String doGet( const void *target ) const override;
+            void   doSet( void *target, const String &val ) override;
+        };
 
         static CmdBillboardType msBillboardTypeCmd;
 #if 0
@@ -116,12 +124,14 @@ namespace Ogre
         static CmdBillboardRotationType msBillboardRotationTypeCmd;
         static CmdCommonDirection       msCommonDirectionCmd;
         static CmdCommonUpVector        msCommonUpVectorCmd;
+        static CmdGpuSimulation         msGpuSimulationCmd;
 
     public:
         static constexpr uint32 InvalidHandle = 0xFFFFFFFF;
 
     protected:
         friend class ParticleSystemManager2;
+        friend class ParticleGpuSimulation;
 
         String mName;
 
@@ -165,8 +175,26 @@ namespace Ogre
         /// Contains ACTIVE particle systems to be processed this frame. Sorted by relevance/priority.
         FastArray<ParticleSystem2 *> mActiveParticleSystems;
 
+        /// A contiguous range of handles requested by one emitter of one instance.
+        struct EmissionBurst
+        {
+            uint32     firstHandle;
+            uint32     numParticles;
+            uint32     emitterIdx;
+            /// Where this burst starts in mNewParticles.
+            uint32     newParticlesOffset;
+            Vector3    instancePos;
+            Quaternion instanceRot;
+        };
+
+        /// Filled by ParticleSystemManager2::_prepareParallel (one per burst, in emission order).
+        FastArray<EmissionBurst> mEmissionBursts;
+
         /// This is a "temporary" array used by ParticleSystemManager::updateSerial to store
         /// the newly created particles for ParticleSystemManager::update to process.
+        ///
+        /// It is sized by _prepareParallel, but its contents are filled by each thread in
+        /// ParticleSystemManager2::_updateParallel01 from mEmissionBursts.
         FastArray<EmittedParticle> mNewParticles;
 
         /// One per thread.
@@ -174,10 +202,54 @@ namespace Ogre
         /// One per thread.
         FastArray<Aabb> mAabb;
 
+        /// Only created by init() if sorting was enabled (see ParticleSystem::setSortingEnabled).
+        /// Contains the alive particles sorted back to front, replacing the shared index buffer.
+        IndexBufferPacked *ogre_nullable mSortedIndexBuffer;
+        /// mSortedIndexBuffer's mapped memory. Only valid while updating.
+        void *ogre_nullable mSortedIndices;
+        /// Number of particles written to mSortedIndices in the last update.
+        uint32 mNumSortedParticles;
+        /// See _calculateDepthSortKeys(). One per particle. Empty if mSortedIndexBuffer is nullptr.
+        FastArray<uint64> mDepthSortKeys;
+        /// Scratch memory for _sortParticlesBackToFront().
+        FastArray<uint64> mDepthSortTmp;
+
+        /// See setGpuSimulation().
+        bool mGpuSimulation;
+        /// Set when the GPU pool must be cleared before simulating again.
+        bool mGpuPoolNeedsReset;
+        /// Only created by init() if the particles are simulated on the GPU.
+        /// State of each particle (ParticleGpuState). One per particle.
+        UavBufferPacked *ogre_nullable mGpuPool;
+        /// What the compute shader writes for the vertex shader (ParticleGpuData).
+        /// When simulating on the GPU, mGpuData is a view of this buffer.
+        UavBufferPacked *ogre_nullable mGpuRenderData;
+        /// Particles emitted this frame (ParticleGpuSpawn). See mGpuSpawns.
+        UavBufferPacked *ogre_nullable mGpuSpawnBuffer;
+        /// Sized by _prepareParallel like mNewParticles and filled by each thread in
+        /// ParticleSystemManager2::_updateParallel01.
+        FastArray<ParticleGpuSpawn> mGpuSpawns;
+        /// Scratch memory for ParticleGpuSimulation::simulate.
+        FastArray<ParticleGpuAffector> mGpuAffectors;
+
         ParticleType::ParticleType mParticleType;
 
         uint32 allocParticle();
 
+        /** Allocates up to numParticles particles with consecutive handles.
+            Much faster than calling allocParticle() numParticles times.
+        @param numParticles
+            Number of particles requested.
+        @param outFirstHandle [out]
+            First handle of the range. Left untouched if nothing was allocated.
+        @return
+            Number of particles allocated, in range [0; numParticles].
+            It can be lower than requested if the range would wrap around the quota (call
+            again to get the rest) or the pool is almost full.
+            0 means the pool run out of particles.
+        */
+        uint32 allocParticles( uint32 numParticles, uint32 &outFirstHandle );
+
         void deallocParticle( uint32 handle );
 
         /** Gets the particle handle based on cpuData's current advanced pointers and its idx
@@ -203,6 +275,9 @@ namespace Ogre
 
         void cloneTo( ParticleSystemDef *toClone );
 
+        /// Returns true if setGpuSimulation( true ) can be honoured. Logs why not otherwise.
+        bool canSimulateOnGpu() const;
+
     public:
         ParticleSystemDef( IdType id, ObjectMemoryManager *objectMemoryManager,
                            SceneManager *ogre_nullable manager,
@@ -230,8 +305,43 @@ namespace Ogre
         ParticleSystemDef *clone( const String                         &newName,
                                   ParticleSystemManager2 *ogre_nullable dstManager = 0 );
 
+        /** Allocates all the memory needed by the particles.
+        @remarks
+            ParticleSystem::setSortingEnabled( true ) must be called before init() for
+            the particles to be sorted back to front (e.g. for alpha blended smoke).
+            Changing it afterwards has no effect.
+
+            When sorting, the ParticleSystemDef gets its own dynamic index buffer instead of
+            sharing ParticleSystemManager2's. It is rewritten every frame based on
+            ParticleSystemManager2::setCameraPosition, so it's not free: only enable it
+            where the artifacts are noticeable.
+        */
         void init( VaoManager *vaoManager );
 
+        /** When true, init() will try to simulate the particles on the GPU with compute shaders
+            instead of on the CPU. See ParticleGpuSimulation.
+        @remarks
+            Must be called before init(). Changing it afterwards has no effect.
+
+            Ignored (i.e. the CPU is used) if:
+                - The RenderSystem doesn't support compute shaders.
+                - Any of the affectors can't run on the GPU
+                  (see ParticleAffector2::getGpuAffector).
+                - Sorting is enabled (see ParticleSystem::setSortingEnabled).
+                - This is a BillboardSet.
+
+            Since the positions never leave the GPU, the AABB of GPU simulated systems
+            is infinite.
+        */
+        void setGpuSimulation( bool bGpuSimulation );
+
+        /// Returns the value set by setGpuSimulation.
+        bool getGpuSimulation() const { return mGpuSimulation; }
+
+        /// Returns true if init() decided to simulate the particles on the GPU.
+        /// See setGpuSimulation().
+        bool isGpuSimulated() const { return mGpuPool != 0; }
+
         void _destroy( VaoManager *ogre_nullable vaoManager );
 
         bool isInitialized() const;
@@ -325,6 +435,45 @@ namespace Ogre
 
         ParticleCpuData getParticleCpuData() const { return mParticleCpuData; }
 
+        /// Returns true if init() was called with sorting enabled.
+        bool isDepthSorted() const { return mSortedIndexBuffer != 0; }
+
+        /** Calculates the keys used by _sortParticlesBackToFront().
+            Dead particles get the highest key so they end up last.
+        @param cpuData
+            Must already be advanced to the first pack to process.
+        @param numParticles
+            Number of particles to process. Must be multiple of ARRAY_PACKED_REALS.
+        @param camPos
+            Camera position in all lanes.
+        @param firstSlot
+            Index in mGpuData of the first particle to process.
+        @param outKeys [out]
+            Array of numParticles keys. The lower 32 bits hold the sort key,
+            the upper 32 bits hold the particle's index in mGpuData.
+        */
+        static void _calculateDepthSortKeys( const ParticleCpuData &cpuData, size_t numParticles,
+                                             const ArrayVector3 &camPos, uint32 firstSlot,
+                                             uint64 *outKeys );
+
+        /** Sorts the keys generated by _calculateDepthSortKeys() farthest first and writes
+            6 indices for each alive particle, in the same layout as the shared index buffer.
+        @param keys
+            Keys to sort. Contents are undefined afterwards.
+        @param tmp
+            Scratch memory. Must be able to hold numParticles keys.
+        @param numParticles
+            Number of keys.
+        @param bUse16BitIndices
+            True if outIndices is uint16, false if it is uint32.
+        @param outIndices [out]
+            Must be able to hold numParticles * 6 indices.
+        @return
+            Number of particles (alive ones) written to outIndices.
+        */
+        static uint32 _sortParticlesBackToFront( uint64 *keys, uint64 *tmp, size_t numParticles,
+                                                 bool bUse16BitIndices, void *outIndices );
+
         /// Returns the number of active particles rounded up to match up SIMD processing.
         ///
         /// e.g.
@@ -436,9 +585,6 @@ namespace Ogre
         /// mEmitterInstanceData.size() == ParticleSystemDef::mEmitters.size()
         FastArray<EmitterInstanceData> mEmitterInstanceData;
 
-        /// mNewParticlesPerEmitter.size() == ParticleSystemDef::mEmitters.size()
-        FastArray<size_t> mNewParticlesPerEmitter;
-
     public:
         /// See MovableObject::mGlobalIndex.
         /// This one tracks our place in ParticleSystemDef::mParticleSystems
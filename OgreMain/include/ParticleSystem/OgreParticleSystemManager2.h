@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "ParticleSystem/OgreParticle2.h"
 #include "Threading/OgreSemaphore.h"
 
+#include <atomic>
 #include <map>
 
 #include "OgreHeaderPrefix.h"
@@ -48,6 +49,7 @@ namespace Ogre
 
     class ParticleAffectorFactory2;
     class ParticleEmitterDefDataFactory;
+    class ParticleGpuSimulation;
 
     class ArrayAabb;
 
@@ -73,16 +75,26 @@ namespace Ogre
         ParticleSystemManager2 *ogre_nullable mMaster;
         ObjectMemoryManager                  *mMemoryManager;
 
-        Vector3                        mCameraPos;
-        FastArray<ParticleSystemDef *> mActiveParticlesLeftToSort;  // GUARDED_BY( mSortMutex )
-        LightweightMutex               mSortMutex;
+        Vector3 mCameraPos;
+        /// Index to mActiveParticleSystemDefs of the next one to be handed out by
+        /// _prepareParallel() to a worker thread.
+        std::atomic<size_t> mNextDefToPrepare;
+
+        /// ParticleSystemDefs & BillboardSets being updated this frame whose
+        /// particles must be sorted back to front. See ParticleSystemDef::isDepthSorted.
+        FastArray<ParticleSystemDef *> mDepthSortedDefs;
+
+        /// Created on demand, the first time a ParticleSystemDef simulated on the GPU is updated.
+        ParticleGpuSimulation *ogre_nullable mGpuSimulation;
 
         void calculateHighestPossibleQuota( VaoManager *vaoManager );
         void createSharedIndexBuffers( VaoManager *vaoManager );
 
-        inline void tickParticles( size_t threadIdx, ArrayReal timeSinceLast, ParticleCpuData cpuData,
-                                   ParticleGpuData *gpuData, const size_t numParticles,
-                                   ParticleSystemDef *systemDef, ArrayAabb &inOutAabb );
+        /// Only advances the time to live, and collects the particles that died.
+        /// Used when the rest of the simulation happens on the GPU. See ParticleGpuSimulation.
+        inline void tickTimeToLive( ArrayReal timeSinceLast, ParticleCpuData cpuData,
+                                    size_t numParticles, ParticleSystemDef *systemDef,
+                                    FastArray<uint32> &outParticlesToKill );
 
         inline void sortAndPrepare( ParticleSystemDef *systemDef, const Vector3 &camPos,
                                     float timeSinceLast );
@@ -104,6 +116,29 @@ namespace Ogre
 
         static ParticleAffectorFactory2 *getAffectorFactory( IdString name );
 
+        /** Advances the position & time to live of the particles and writes the data
+            the vertex shader needs. This is the CPU path.
+        @param timeSinceLast
+            Time in seconds since last frame.
+        @param cpuData
+            Must already be advanced to the first pack to process.
+        @param gpuData [out]
+            Array of numParticles.
+        @param numParticles
+            Number of particles to process. Must be multiple of ARRAY_PACKED_REALS.
+        @param systemDef
+            Owner of the particles. Can be nullptr if outParticlesToKill is nullptr.
+        @param outParticlesToKill [out]
+            Optional. Handles of the particles that died are pushed here.
+        @param inOutAabb [in/out]
+            Grown to contain all the alive particles.
+        */
+        static void _tickParticles( ArrayReal timeSinceLast, ParticleCpuData cpuData,
+                                    ParticleGpuData *gpuData, size_t numParticles,
+                                    const ParticleSystemDef *ogre_nullable systemDef,
+                                    FastArray<uint32> *ogre_nullable outParticlesToKill,
+                                    ArrayAabb                       &inOutAabb );
+
         /** ParticleSystemManager2 must know the highest possible quota any of its particle
             systems may achieve.
 
@@ -236,10 +271,11 @@ namespace Ogre
             This function is called from multiple threads.
 
             Each thread handles a whole ParticleSystemDef. (i.e. 2 threads won't concurrently
-            access the same ParticleSystemDef).
+            access the same ParticleSystemDef). They're handed out without locking.
 
-            It handles sorting them by distance to camera; and emits
-            new particles that instances require.
+            It handles sorting them by distance to camera; and reserves the handles of the
+            new particles that instances require (one contiguous range per emitter, when possible).
+            The new particles are initialized later by all threads in _updateParallel01().
         */
         void _prepareParallel();
 
@@ -248,6 +284,7 @@ namespace Ogre
         @remarks
             Unlike _prepareParallel(), each thread concurrently access the same ParticleSystemDef.
             This function is in charge of initializing new particles.
+            Each burst of particles reserved in _prepareParallel() is split across all threads.
             Each thread handles one particle (i.e. 2 threads won't concurrently access the same
             ParticleCpuData).
             @par
@@ -266,6 +303,18 @@ namespace Ogre
         */
         void _updateParallel02( size_t threadIdx, size_t numThreads );
 
+        /// Returns true if _updateParallel03() must be called after _updateParallel02().
+        bool _needsUpdateParallel03() const { return !mDepthSortedDefs.empty(); }
+
+        /** See _updateParallel02().
+        @remarks
+            Sorts the particles of the ParticleSystemDefs that have sorting enabled back to front,
+            using the keys calculated by all threads in _updateParallel02(); and writes the
+            result to their index buffers.
+            Each thread handles whole ParticleSystemDefs.
+        */
+        void _updateParallel03( size_t threadIdx, size_t numThreads );
+
         /// See prepareForUpdate()
         ///
         /// Must be called after prepareForUpdate() & _prepareParallel().
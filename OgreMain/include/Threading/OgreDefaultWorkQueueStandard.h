@@ -73,6 +73,9 @@ namespace Ogre
         OGRE_THREAD_SYNCHRONISER( mInitSync );
 
         OGRE_THREAD_SYNCHRONISER( mRequestCondition );
+        /// Workers inside waitForNextRequest. Lets notifyWorkers skip
+        /// locking mRequestMutex while all workers are busy.
+        std::atomic<uint32> mNumWaitingWorkers;
 #if OGRE_THREAD_SUPPORT
         typedef vector<OGRE_THREAD_TYPE *>::type WorkerThreadList;
         WorkerThreadList                         mWorkers;
@@ -0,0 +1,190 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _OgreMpmcRingBuffer_H_
+#define _OgreMpmcRingBuffer_H_
+
+#include "OgrePrerequisites.h"
+
+#include <atomic>
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** Bounded multi-producer multi-consumer FIFO queue that never takes a lock.
+    @remarks
+        Each slot has a sequence number which tells producers and consumers whether
+        the slot is ready to be written or read for the current lap around the buffer.
+        Threads claim a position with a single CAS on the enqueue/dequeue counters,
+        and then publish the slot by bumping its sequence number; so a stalled
+        thread can only delay the slot it has claimed, never the whole queue.
+    @par
+        The queue is bounded: tryPush returns false when it's full and the caller
+        is expected to fall back to a slower path (or retry later).
+    @par
+        T must be cheap to copy (it's meant to hold pointers or small handles).
+    */
+    template <typename T>
+    class MpmcRingBuffer
+    {
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            T                   data;
+        };
+
+        Cell  *mBuffer;
+        size_t mMask;
+
+        /// The padding prevents false cache sharing between producers and consumers.
+        uint8               mPadding0[64];
+        std::atomic<size_t> mEnqueuePos;
+        uint8               mPadding1[64];
+        std::atomic<size_t> mDequeuePos;
+        uint8               mPadding2[64];
+
+        MpmcRingBuffer( const MpmcRingBuffer & );
+        MpmcRingBuffer &operator=( const MpmcRingBuffer & );
+
+    public:
+        /**
+        @param capacity
+            Maximum number of elements. Rounded up to the next power of 2.
+        */
+        explicit MpmcRingBuffer( size_t capacity ) : mBuffer( 0 ), mMask( 0 )
+        {
+            size_t powerOf2 = 2u;
+            while( powerOf2 < capacity )
+                powerOf2 <<= 1u;
+
+            mBuffer = new Cell[powerOf2];
+            mMask = powerOf2 - 1u;
+            for( size_t i = 0; i < powerOf2; ++i )
+                mBuffer[i].sequence.store( i, std::memory_order_relaxed );
+
+            mEnqueuePos.store( 0, std::memory_order_relaxed );
+            mDequeuePos.store( 0, std::memory_order_relaxed );
+        }
+
+        ~MpmcRingBuffer()
+        {
+            delete[] mBuffer;
+            mBuffer = 0;
+        }
+
+        /** Adds an element at the end of the queue.
+        @return
+            False if the queue is full. The element is not added.
+        */
+        bool tryPush( const T &value )
+        {
+            Cell *cell;
+            size_t pos = mEnqueuePos.load( std::memory_order_relaxed );
+            while( true )
+            {
+                cell = &mBuffer[pos & mMask];
+                const size_t seq = cell->sequence.load( std::memory_order_acquire );
+                const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if( diff == 0 )
+                {
+                    if( mEnqueuePos.compare_exchange_weak( pos, pos + 1u,
+                                                           std::memory_order_relaxed ) )
+                    {
+                        break;
+                    }
+                }
+                else if( diff < 0 )
+                {
+                    return false;  // Full
+                }
+                else
+                {
+                    pos = mEnqueuePos.load( std::memory_order_relaxed );
+                }
+            }
+
+            cell->data = value;
+            cell->sequence.store( pos + 1u, std::memory_order_release );
+            return true;
+        }
+
+        /** Removes the element at the front of the queue.
+        @param outValue [out]
+            The removed element. Untouched if we return false.
+        @return
+            False if the queue is empty.
+        */
+        bool tryPop( T &outValue )
+        {
+            Cell *cell;
+            size_t pos = mDequeuePos.load( std::memory_order_relaxed );
+            while( true )
+            {
+                cell = &mBuffer[pos & mMask];
+                const size_t seq = cell->sequence.load( std::memory_order_acquire );
+                const intptr_t diff = (intptr_t)seq - (intptr_t)( pos + 1u );
+                if( diff == 0 )
+                {
+                    if( mDequeuePos.compare_exchange_weak( pos, pos + 1u,
+                                                           std::memory_order_relaxed ) )
+                    {
+                        break;
+                    }
+                }
+                else if( diff < 0 )
+                {
+                    return false;  // Empty
+                }
+                else
+                {
+                    pos = mDequeuePos.load( std::memory_order_relaxed );
+                }
+            }
+
+            outValue = cell->data;
+            cell->sequence.store( pos + mMask + 1u, std::memory_order_release );
+            return true;
+        }
+
+        /** Returns true if the queue looked empty at the time of the call.
+            Other threads may push or pop concurrently, so use it only as a hint.
+        */
+        bool empty() const
+        {
+            const size_t pos = mDequeuePos.load( std::memory_order_acquire );
+            const size_t seq = mBuffer[pos & mMask].sequence.load( std::memory_order_acquire );
+            return (intptr_t)seq - (intptr_t)( pos + 1u ) < 0;
+        }
+
+        size_t capacity() const { return mMask + 1u; }
+    };
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _OgreStageGraph_H_
+#define _OgreStageGraph_H_
+
+#include "OgrePrerequisites.h"
+
+#include "OgreFastArray.h"
+
+#include <atomic>
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** Runs a list of stages on N threads in a single dispatch, without syncing all threads
+        between stages.
+    @remarks
+        Each stage is made of numJobs independent jobs, and may depend on up to two previous
+        stages.
+        Jobs are handed out in order of stage. A thread that gets a job whose stage
+        depends on an unfinished stage waits (spinning) until that stage is finished.
+    @par
+        Because a stage can only depend on an earlier stage, and every job from earlier
+        stages has already been handed to some thread, this can never deadlock (regardless
+        of the number of threads).
+    @par
+        Usage:
+        @code
+            // Main thread
+            graph.clear();
+            size_t a = graph.addStage( numJobsA );
+            graph.addStage( numJobsB, a );
+            graph.finalize();
+            // wake up workers
+
+            // Worker thread
+            size_t stageIdx, jobIdx;
+            while( graph.getNextJob( stageIdx, jobIdx ) )
+            {
+                doWork( stageIdx, jobIdx );
+                graph.jobFinished( stageIdx );
+            }
+        @endcode
+    */
+    class _OgreExport StageGraph
+    {
+    public:
+        static const size_t NoDependency;
+
+    protected:
+        struct Stage
+        {
+            /// Index of the first job of this stage, in global job numbering.
+            uint32 firstJob;
+            uint32 numJobs;
+            uint32 dependency[2];
+        };
+
+        FastArray<Stage> mStages;
+        /// Maps each global job index to its stage.
+        FastArray<uint32> mJobToStage;
+        /// Number of finished jobs per stage.
+        std::atomic<uint32> *mNumJobsDone;
+        size_t               mNumJobsDoneCapacity;
+
+        std::atomic<uint32> mNextJob;
+
+    public:
+        StageGraph();
+        ~StageGraph();
+
+        /// Removes all stages. Must not be called while threads are running.
+        void clear();
+
+        /** Adds a new stage.
+        @param numJobs
+            Number of jobs in this stage. Can be 0.
+        @param dependency
+            Stage that must be finished before any job of this stage can start.
+            Must be a value returned by a previous call to addStage, or NoDependency.
+        @param dependency2
+            Another stage that must be finished too. Same rules as dependency.
+        @return
+            Index of the new stage.
+        */
+        size_t addStage( size_t numJobs, size_t dependency = NoDependency,
+                         size_t dependency2 = NoDependency );
+
+        size_t getNumStages() const { return mStages.size(); }
+
+        /// Must be called after the last addStage and before waking up the threads.
+        void finalize();
+
+        /** Retrieves the next job to process. Blocks until its dependency is met.
+        @param outStageIdx [out]
+            Stage the job belongs to.
+        @param outJobIdx [out]
+            Index of the job within its stage.
+        @return
+            False if there is no more work left.
+        */
+        bool getNextJob( size_t &outStageIdx, size_t &outJobIdx );
+
+        /// Must be called after the job retrieved via getNextJob is done.
+        void jobFinished( size_t stageIdx );
+    };
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -0,0 +1,106 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _OgreWorkStealingScheduler_H_
+#define _OgreWorkStealingScheduler_H_
+
+#include "OgrePrerequisites.h"
+
+#include <atomic>
+
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** Distributes the chunks in range [0; numChunks) among N threads, so that threads
+        that finish their work early take work from those that are still busy.
+    @remarks
+        Each thread initially owns a contiguous subrange of chunks (its deque). It takes
+        chunks from the front of its own subrange, and once it runs out it steals half of
+        what is left from the back of another thread's subrange.
+    @par
+        Each subrange is stored in a single 64-bit atomic ('begin' in the low 32 bits,
+        'end' in the high 32 bits), so popping and stealing are lock-free CAS operations.
+    @par
+        reset() must be called while no other thread is calling getNextChunk()
+        (e.g. from the main thread before waking up the worker threads).
+    */
+    class _OgreExport WorkStealingScheduler
+    {
+        struct PerThreadData
+        {
+            std::atomic<uint64> range;
+            /// Statistics. Written only by the owner thread.
+            uint32 numProcessed;
+            uint32 numStolen;
+            /// The padding prevents false cache sharing when multithreading.
+            uint8 padding[64];
+        };
+
+        PerThreadData *mPerThread;
+        size_t         mNumThreads;
+        size_t         mCapacity;
+
+        static uint64 packRange( uint32 begin, uint32 end )
+        {
+            return uint64( begin ) | ( uint64( end ) << 32u );
+        }
+
+        bool steal( size_t threadIdx, size_t &outChunkIdx );
+
+    public:
+        WorkStealingScheduler();
+        ~WorkStealingScheduler();
+
+        /** Prepares a new batch of work.
+        @param numChunks
+            Number of chunks to distribute.
+        @param numThreads
+            Number of threads that will call getNextChunk().
+        */
+        void reset( size_t numChunks, size_t numThreads );
+
+        /** Retrieves the next chunk the given thread should process.
+        @param threadIdx
+            Thread calling this function. Must be in range [0; numThreads)
+        @param outChunkIdx [out]
+            Index of the chunk to process. Only valid if we returned true.
+        @return
+            False if there is no more work left.
+        */
+        bool getNextChunk( size_t threadIdx, size_t &outChunkIdx );
+
+        /// Number of chunks processed by the given thread since the last reset().
+        uint32 getNumProcessed( size_t threadIdx ) const { return mPerThread[threadIdx].numProcessed; }
+        /// Number of times the given thread stole work from others since the last reset().
+        uint32 getNumStolen( size_t threadIdx ) const { return mPerThread[threadIdx].numStolen; }
+    };
+}  // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -46,7 +46,7 @@ namespace Ogre
         vector<TexBufferPacked *>::type mTexBufferViews;
 
         virtual TexBufferPacked      *getAsTexBufferImpl( PixelFormatGpu pixelFormat ) = 0;
-        virtual ReadOnlyBufferPacked *getAsReadOnlyBufferImpl() = 0;
+        virtual ReadOnlyBufferPacked *getAsReadOnlyBufferImpl( PixelFormatGpu pixelFormat ) = 0;
 
     public:
         UavBufferPacked( size_t internalBufferStartBytes, size_t numElements, uint32 bytesPerElement,
@@ -88,14 +88,21 @@ namespace Ogre
             If this function was already called, it will return the same pointer as the
             last time, otherwise returns a new pointer
         @par
-            Unlike getAsTexBufferView there is no pixelFormat because the returned pointer will always
-            be format-less (e.g. will use UBO in GL & Vullkan, Structure Buffer in D3D11, etc)
+            Only one read-only view exists per buffer. Once created, later calls must request the
+            same pixelFormat.
+        @param pixelFormat
+            PFG_NULL for a format-less view (e.g. will use UBO in GL & Vullkan, Structure Buffer
+            in D3D11, etc).
+            Otherwise the view carries the format just like a buffer created via
+            VaoManager::createReadOnlyBuffer( pixelFormat, ... ) would, for RenderSystems
+            that bind read-only buffers as texture buffers.
+            Note D3D11 always uses a Structured Buffer for UAV buffers and ignores this parameter.
         @return
             A ReadOnlyBufferPacked to be used to bind to the different stages. Do not destroy
             this buffer via VaoManager::destroyReadOnlyBuffer.
             See UavBufferPacked::destroyReadOnlyBufferView
         */
-        ReadOnlyBufferPacked *getAsReadOnlyBufferView();
+        ReadOnlyBufferPacked *getAsReadOnlyBufferView( PixelFormatGpu pixelFormat = PFG_NULL );
 
         /// Frees memory from the view created by getAsReadOnlyBufferView
         /// Does nothing if the view wasn't created
@@ -31,7 +31,9 @@ THE SOFTWARE.
 #include "CommandBuffer/OgreCbTexture.h"
 
 #include "CommandBuffer/OgreCommandBuffer.h"
+#include "OgreDescriptorSetTexture.h"
 #include "OgreRenderSystem.h"
+#include "OgreTextureGpuManager.h"
 
 namespace Ogre
 {
@@ -50,6 +52,12 @@ namespace Ogre
         const CbTexture *cmd = static_cast<const CbTexture *>( _cmd );
         _this->mRenderSystem->_setTexture( cmd->texUnit, cmd->texture, cmd->bDepthReadOnly );
 
+        if( cmd->texture )
+        {
+            cmd->texture->_notifyUsed(
+                _this->mRenderSystem->getTextureGpuManager()->getFrameCount() );
+        }
+
         if( cmd->samplerBlock )
         {
             OGRE_ASSERT_MEDIUM( cmd->texUnit < std::numeric_limits<uint8>::max() );
@@ -70,6 +78,8 @@ namespace Ogre
     {
         const CbTextures *cmd = static_cast<const CbTextures *>( _cmd );
         _this->mRenderSystem->_setTextures( cmd->texUnit, cmd->descSet, cmd->hazardousTexIdx );
+        cmd->descSet->_notifyTexturesUsed(
+            _this->mRenderSystem->getTextureGpuManager()->getFrameCount() );
     }
 
     CbSamplers::CbSamplers( uint16 _texUnit, const DescriptorSetSampler *_descSet ) :
@@ -37,7 +37,8 @@ namespace Ogre
     NodeMemoryManager::NodeMemoryManager() :
         mDummyNode( 0 ),
         mMemoryManagerType( SCENE_DYNAMIC ),
-        mTwinMemoryManager( 0 )
+        mTwinMemoryManager( 0 ),
+        mDirtyTracking( false )
     {
         // Manually allocate the memory for the dummy scene nodes (since we can't pass ourselves
         // or yet another object) We only allocate what's needed to prevent access violations.
@@ -56,6 +57,9 @@ namespace Ogre
             OGRE_MALLOC_SIMD( sizeof( ArrayVector3 ), MEMCATEGORY_SCENE_OBJECTS ) );
         mDummyTransformPtrs.mDerivedTransform = reinterpret_cast<Matrix4 *>(
             OGRE_MALLOC_SIMD( sizeof( Matrix4 ) * ARRAY_PACKED_REALS, MEMCATEGORY_SCENE_OBJECTS ) );
+        // Read by children when dirty tracking is enabled. Never dirty.
+        mDummyTransformPtrs.mDirty = reinterpret_cast<uint8 *>(
+            OGRE_MALLOC_SIMD( sizeof( uint8 ) * ARRAY_PACKED_REALS, MEMCATEGORY_SCENE_OBJECTS ) );
 
         /*mDummyTransformPtrs.mDerivedTransform = reinterpret_cast<ArrayMatrix4*>( OGRE_MALLOC_SIMD(
                                                 sizeof( ArrayMatrix4 ), MEMCATEGORY_SCENE_OBJECTS ) );
@@ -68,7 +72,10 @@ namespace Ogre
         *mDummyTransformPtrs.mDerivedOrientation = ArrayQuaternion::IDENTITY;
         *mDummyTransformPtrs.mDerivedScale = ArrayVector3::UNIT_SCALE;
         for( int i = 0; i < ARRAY_PACKED_REALS; ++i )
+        {
             mDummyTransformPtrs.mDerivedTransform[i] = Matrix4::IDENTITY;
+            mDummyTransformPtrs.mDirty[i] = 0u;
+        }
 
         mDummyNode = new SceneNode( mDummyTransformPtrs );
     }
@@ -98,6 +105,7 @@ namespace Ogre
         OGRE_FREE_SIMD( mDummyTransformPtrs.mDerivedScale, MEMCATEGORY_SCENE_OBJECTS );
 
         OGRE_FREE_SIMD( mDummyTransformPtrs.mDerivedTransform, MEMCATEGORY_SCENE_OBJECTS );
+        OGRE_FREE_SIMD( mDummyTransformPtrs.mDirty, MEMCATEGORY_SCENE_OBJECTS );
         /*OGRE_FREE_SIMD( mDummyTransformPtrs.mInheritOrientation, MEMCATEGORY_SCENE_OBJECTS );
         OGRE_FREE_SIMD( mDummyTransformPtrs.mInheritScale, MEMCATEGORY_SCENE_OBJECTS );*/
         mDummyTransformPtrs = Transform();
@@ -170,6 +178,18 @@ namespace Ogre
         inOutTransform = tmp;
     }
     //-----------------------------------------------------------------------------------
+    void NodeMemoryManager::_clearDirtyFlags()
+    {
+        ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
+        ArrayMemoryManagerVec::iterator endt = mMemoryManagers.end();
+
+        while( itor != endt )
+        {
+            itor->clearDirtyFlags();
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
     void NodeMemoryManager::defragment()
     {
         ArrayMemoryManagerVec::iterator itor = mMemoryManagers.begin();
@@ -0,0 +1,344 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "Math/Array/OgreObjectDataBvh.h"
+
+#include "Math/Array/OgreBooleanMask.h"
+#include "OgrePlane.h"
+
+namespace Ogre
+{
+    /// Merges the lanes of aabb flagged in usedLanes into a single box.
+    /// Null lanes are ignored. The result is infinite if any of the lanes is.
+    static inline void collapseAabb( const ArrayAabb &aabb, ArrayMaskR usedLanes, Aabb &outAabb )
+    {
+        const ArrayReal negInfinity = Mathlib::SetAll( -std::numeric_limits<Real>::infinity() );
+
+        const ArrayVector3 laneMin( aabb.mCenter - aabb.mHalfSize );
+        const ArrayVector3 laneMax( aabb.mCenter + aabb.mHalfSize );
+
+        // CmovRobust because the values may be infinite
+        const ArrayVector3 minimum(
+            Mathlib::CmovRobust( laneMin.mChunkBase[0], Mathlib::INFINITEA, usedLanes ),
+            Mathlib::CmovRobust( laneMin.mChunkBase[1], Mathlib::INFINITEA, usedLanes ),
+            Mathlib::CmovRobust( laneMin.mChunkBase[2], Mathlib::INFINITEA, usedLanes ) );
+        const ArrayVector3 maximum(
+            Mathlib::CmovRobust( laneMax.mChunkBase[0], negInfinity, usedLanes ),
+            Mathlib::CmovRobust( laneMax.mChunkBase[1], negInfinity, usedLanes ),
+            Mathlib::CmovRobust( laneMax.mChunkBase[2], negInfinity, usedLanes ) );
+
+        const Vector3 vMin = minimum.collapseMin();
+        const Vector3 vMax = maximum.collapseMax();
+
+        const Real infinity = std::numeric_limits<Real>::infinity();
+
+        if( vMin.x > vMax.x || vMin.y > vMax.y || vMin.z > vMax.z )
+        {
+            // All lanes were unused or null
+            outAabb = Aabb::BOX_NULL;
+        }
+        else if( vMin.x == -infinity || vMin.y == -infinity || vMin.z == -infinity ||
+                 vMax.x == infinity || vMax.y == infinity || vMax.z == infinity )
+        {
+            outAabb = Aabb::BOX_INFINITE;
+        }
+        else
+        {
+            outAabb.mCenter = ( vMax + vMin ) * 0.5f;
+            outAabb.mHalfSize = ( vMax - vMin ) * 0.5f;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    ObjectDataBvh::ObjectDataBvh() :
+        mNodes( 0 ),
+        mNumNodes( 0 ),
+        mNodesCapacity( 0 ),
+        mNumPacks( 0 ),
+        mNumBuilds( 0 )
+    {
+    }
+    //-----------------------------------------------------------------------------------
+    ObjectDataBvh::~ObjectDataBvh()
+    {
+        if( mNodes )
+        {
+            OGRE_FREE_SIMD( mNodes, MEMCATEGORY_SCENE_OBJECTS );
+            mNodes = 0;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void ObjectDataBvh::build( const ObjectData &objData, size_t numObjs )
+    {
+        mNumPacks = ( numObjs + ARRAY_PACKED_REALS - 1u ) / ARRAY_PACKED_REALS;
+        mLevelOffsets.clear();
+        mNumNodes = 0u;
+        ++mNumBuilds;
+
+        if( !mNumPacks )
+            return;
+
+        // Calculate the number of nodes per level, until we reach a single root
+        size_t numNodesInLevel = mNumPacks;
+        do
+        {
+            numNodesInLevel = ( numNodesInLevel + ARRAY_PACKED_REALS - 1u ) / ARRAY_PACKED_REALS;
+            mLevelOffsets.push_back( mNumNodes );
+            mNumNodes += numNodesInLevel;
+        } while( numNodesInLevel > 1u );
+        mLevelOffsets.push_back( mNumNodes );
+
+        if( mNumNodes > mNodesCapacity )
+        {
+            if( mNodes )
+                OGRE_FREE_SIMD( mNodes, MEMCATEGORY_SCENE_OBJECTS );
+            mNodesCapacity = mNumNodes + ( mNumNodes >> 1u );
+            mNodes = reinterpret_cast<ArrayAabb *>(
+                OGRE_MALLOC_SIMD( sizeof( ArrayAabb ) * mNodesCapacity, MEMCATEGORY_SCENE_OBJECTS ) );
+        }
+
+        refit( objData );
+    }
+    //-----------------------------------------------------------------------------------
+    void ObjectDataBvh::refit( const ObjectData &objData )
+    {
+        refitLeaves( objData, 0u, getNumLeaves() );
+        refitNodes();
+    }
+    //-----------------------------------------------------------------------------------
+    void ObjectDataBvh::refitLeaves( const ObjectData &objData, size_t firstLeaf, size_t numLeaves )
+    {
+        OGRE_ASSERT_LOW( firstLeaf + numLeaves <= getNumLeaves() );
+
+        if( !numLeaves )
+            return;
+
+        // Lane j of leaf i holds the bounds of pack i * ARRAY_PACKED_REALS + j
+        ArrayAabb *RESTRICT_ALIAS leaves = mNodes + mLevelOffsets[0];
+
+        const ArrayAabb *RESTRICT_ALIAS packAabb = objData.mWorldAabb;
+        MovableObject *const *owners = objData.mOwner;
+
+        for( size_t i = firstLeaf; i < firstLeaf + numLeaves; ++i )
+        {
+            for( size_t j = 0; j < ARRAY_PACKED_REALS; ++j )
+            {
+                const size_t packIdx = i * ARRAY_PACKED_REALS + j;
+
+                Aabb aabb( Aabb::BOX_NULL );
+                if( packIdx < mNumPacks )
+                {
+                    // Skip unused slots. Their AABB is garbage
+                    bool usedLanes[ARRAY_PACKED_REALS];
+                    for( size_t k = 0; k < ARRAY_PACKED_REALS; ++k )
+                        usedLanes[k] = owners[packIdx * ARRAY_PACKED_REALS + k] != 0;
+
+                    collapseAabb( packAabb[packIdx], BooleanMask4::getMask( usedLanes ), aabb );
+                }
+                leaves[i].setFromAabb( aabb, j );
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void ObjectDataBvh::refitNodes()
+    {
+        // Inner nodes. Unused lanes of the children are null, no need to mask them
+        const ArrayMaskR allLanes = BooleanMask4::getAllSetMask();
+        const size_t numLevels = getNumLevels();
+
+        for( size_t level = 1u; level < numLevels; ++level )
+        {
+            const ArrayAabb *RESTRICT_ALIAS children = mNodes + mLevelOffsets[level - 1u];
+            const size_t numChildren = mLevelOffsets[level] - mLevelOffsets[level - 1u];
+
+            ArrayAabb *RESTRICT_ALIAS nodes = mNodes + mLevelOffsets[level];
+            const size_t numNodes = mLevelOffsets[level + 1u] - mLevelOffsets[level];
+
+            for( size_t i = 0; i < numNodes; ++i )
+            {
+                for( size_t j = 0; j < ARRAY_PACKED_REALS; ++j )
+                {
+                    const size_t childIdx = i * ARRAY_PACKED_REALS + j;
+
+                    Aabb aabb( Aabb::BOX_NULL );
+                    if( childIdx < numChildren )
+                        collapseAabb( children[childIdx], allLanes, aabb );
+                    nodes[i].setFromAabb( aabb, j );
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void ObjectDataBvh::update( const ObjectData &objData, size_t numObjs )
+    {
+        const size_t numPacks = ( numObjs + ARRAY_PACKED_REALS - 1u ) / ARRAY_PACKED_REALS;
+        if( numPacks != mNumPacks || !mNumBuilds )
+            build( objData, numObjs );
+        else
+            refit( objData );
+    }
+    //-----------------------------------------------------------------------------------
+    inline void ObjectDataBvh::addVisibleRange( size_t firstPack, size_t numPacks,
+                                                uint32 maxPacksPerRange, size_t firstRangeIdx,
+                                                PackRangeArray &outRanges )
+    {
+        // Nodes are visited in order, thus ranges come sorted and can be merged as they arrive
+        if( outRanges.size() > firstRangeIdx )
+        {
+            PackRange &lastRange = outRanges.back();
+            if( lastRange.firstPack + lastRange.numPacks == firstPack &&
+                lastRange.numPacks < maxPacksPerRange )
+            {
+                const size_t toMerge =
+                    std::min<size_t>( numPacks, maxPacksPerRange - lastRange.numPacks );
+                lastRange.numPacks += static_cast<uint32>( toMerge );
+                firstPack += toMerge;
+                numPacks -= toMerge;
+            }
+        }
+
+        while( numPacks )
+        {
+            PackRange range;
+            range.firstPack = static_cast<uint32>( firstPack );
+            range.numPacks = static_cast<uint32>( std::min<size_t>( numPacks, maxPacksPerRange ) );
+            outRanges.push_back( range );
+            firstPack += range.numPacks;
+            numPacks -= range.numPacks;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    size_t ObjectDataBvh::cullFrustum( const Plane *frustumPlanes, uint32 maxPacksPerRange,
+                                       PackRangeArray &outRanges )
+    {
+        if( !mNumPacks )
+            return 0u;
+
+        maxPacksPerRange = std::max( maxPacksPerRange, 1u );
+
+        ArrayVector3 planeNormal[6];
+        ArrayVector3 signFlip[6];
+        ArrayReal planeNegD[6];
+
+        for( size_t i = 0; i < 6u; ++i )
+        {
+            planeNormal[i].setAll( frustumPlanes[i].normal );
+            signFlip[i].setAll( frustumPlanes[i].normal );
+            signFlip[i].setToSign();
+            planeNegD[i] = Mathlib::SetAll( -frustumPlanes[i].d );
+        }
+
+        // Ranges appended by a previous call must not be merged with ours
+        const size_t firstRangeIdx = outRanges.size();
+
+        size_t numVisiblePacks = 0u;
+
+        // The stack holds pairs of (level, index within level). When the level has the
+        // FullyVisible bit set, the entry is a lane of a node of that level whose packs
+        // are all visible; otherwise it is a node to test.
+        const uint32 FullyVisible = 0x80000000u;
+
+        mStack.clear();
+        mStack.push_back( static_cast<uint32>( getNumLevels() - 1u ) );
+        mStack.push_back( 0u );
+
+        while( !mStack.empty() )
+        {
+            const size_t nodeIdx = mStack.back();
+            mStack.pop_back();
+            const uint32 levelAndFlag = mStack.back();
+            mStack.pop_back();
+
+            if( levelAndFlag & FullyVisible )
+            {
+                size_t packsPerLane = 1u;
+                for( size_t i = ( levelAndFlag & ~FullyVisible ); i--; )
+                    packsPerLane *= ARRAY_PACKED_REALS;
+
+                const size_t firstPack = nodeIdx * packsPerLane;
+                if( firstPack < mNumPacks )
+                {
+                    const size_t numPacks = std::min( packsPerLane, mNumPacks - firstPack );
+                    addVisibleRange( firstPack, numPacks, maxPacksPerRange, firstRangeIdx,
+                                     outRanges );
+                    numVisiblePacks += numPacks;
+                }
+                continue;
+            }
+
+            const size_t level = levelAndFlag;
+
+            const ArrayAabb &aabb = mNodes[mLevelOffsets[level] + nodeIdx];
+
+            // Same test as MovableObject::cullFrustum. A box intersects when its corner
+            // closest to the inside of each plane is in front of all of them, and it's
+            // fully inside when the farthest corner is in front of all of them.
+            ArrayMaskR intersects = BooleanMask4::getAllSetMask();
+            ArrayMaskR fullyInside = BooleanMask4::getAllSetMask();
+            for( size_t i = 0; i < 6u; ++i )
+            {
+                const ArrayVector3 flippedHalfSize = aabb.mHalfSize * signFlip[i];
+                ArrayReal dotResult = planeNormal[i].dotProduct( aabb.mCenter + flippedHalfSize );
+                intersects =
+                    Mathlib::And( intersects, Mathlib::CompareGreater( dotResult, planeNegD[i] ) );
+                dotResult = planeNormal[i].dotProduct( aabb.mCenter - flippedHalfSize );
+                fullyInside =
+                    Mathlib::And( fullyInside, Mathlib::CompareGreater( dotResult, planeNegD[i] ) );
+            }
+
+            // Always pass the test if any of the components were
+            // Infinity (dot product above could've caused nans)
+            ArrayMaskR isInfinite =
+                Mathlib::Or( Mathlib::isInfinity( aabb.mHalfSize.mChunkBase[0] ),
+                             Mathlib::isInfinity( aabb.mHalfSize.mChunkBase[1] ) );
+            isInfinite = Mathlib::Or( Mathlib::isInfinity( aabb.mHalfSize.mChunkBase[2] ), isInfinite );
+            intersects = Mathlib::Or( intersects, isInfinite );
+
+            const uint32 intersectMask = BooleanMask4::getScalarMask( intersects );
+            const uint32 insideMask = BooleanMask4::getScalarMask( fullyInside );
+
+            // Children are pushed in reverse order so that they're popped in memory order.
+            // Lanes of leaves are packs, so they're always fully visible.
+            for( size_t j = ARRAY_PACKED_REALS; j--; )
+            {
+                if( IS_BIT_SET( j, intersectMask ) )
+                {
+                    const uint32 childIdx = static_cast<uint32>( nodeIdx * ARRAY_PACKED_REALS + j );
+                    if( !level || IS_BIT_SET( j, insideMask ) )
+                        mStack.push_back( static_cast<uint32>( level ) | FullyVisible );
+                    else
+                        mStack.push_back( static_cast<uint32>( level - 1u ) );
+                    mStack.push_back( childIdx );
+                }
+            }
+        }
+
+        return numVisiblePacks;
+    }
+}  // namespace Ogre
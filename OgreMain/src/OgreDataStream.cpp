@@ -35,6 +35,20 @@ THE SOFTWARE.
 
 #include <fstream>
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#    define WIN32_LEAN_AND_MEAN
+#    if !defined( NOMINMAX ) && defined( _MSC_VER )
+#        define NOMINMAX  // required to stop windows.h messing up std::min
+#    endif
+#    include <windows.h>
+#elif OGRE_PLATFORM != OGRE_PLATFORM_WINRT && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+#    define OGRE_DATASTREAM_HAS_MMAP
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
 namespace Ogre
 {
     //-----------------------------------------------------------------------
@@ -708,6 +722,150 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+    MappedFileDataStream::MappedFileDataStream( const String &name, const String &fullPath ) :
+        DataStream( name, READ ),
+        mData( 0 ),
+        mPos( 0 )
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        ,
+        mFileHandle( 0 ),
+        mMappingHandle( 0 )
+#endif
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        HANDLE fileHandle =
+            CreateFileA( fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+        LARGE_INTEGER fileSize;
+        if( fileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx( fileHandle, &fileSize ) )
+        {
+            if( fileHandle != INVALID_HANDLE_VALUE )
+                CloseHandle( fileHandle );
+            OGRE_EXCEPT( Exception::ERR_FILE_NOT_FOUND, "Cannot open file: " + fullPath,
+                         "MappedFileDataStream::MappedFileDataStream" );
+        }
+
+        mFileHandle = fileHandle;
+        mSize = static_cast<size_t>( fileSize.QuadPart );
+
+        if( mSize > 0u )
+        {
+            // CreateFileMapping fails on empty files, hence the check
+            HANDLE mappingHandle = CreateFileMappingA( fileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+            const void *data = 0;
+            if( mappingHandle )
+                data = MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+            mMappingHandle = mappingHandle;
+            mData = reinterpret_cast<const uchar *>( data );
+            if( !mData )
+            {
+                close();
+                OGRE_EXCEPT( Exception::ERR_FILE_NOT_FOUND, "Cannot map file: " + fullPath,
+                             "MappedFileDataStream::MappedFileDataStream" );
+            }
+        }
+#elif defined( OGRE_DATASTREAM_HAS_MMAP )
+        const int fd = open( fullPath.c_str(), O_RDONLY );
+        struct stat tagStat;
+        if( fd < 0 || fstat( fd, &tagStat ) != 0 )
+        {
+            if( fd >= 0 )
+                ::close( fd );
+            OGRE_EXCEPT( Exception::ERR_FILE_NOT_FOUND, "Cannot open file: " + fullPath,
+                         "MappedFileDataStream::MappedFileDataStream" );
+        }
+
+        mSize = static_cast<size_t>( tagStat.st_size );
+
+        if( mSize > 0u )
+        {
+            // mmap fails on empty files, hence the check
+            void *data = mmap( 0, mSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if( data != MAP_FAILED )
+            {
+                // Start reading ahead now. Consumers read front to back
+                madvise( data, mSize, MADV_SEQUENTIAL );
+                madvise( data, mSize, MADV_WILLNEED );
+                mData = reinterpret_cast<const uchar *>( data );
+            }
+        }
+
+        // The mapping keeps its own reference to the file
+        ::close( fd );
+
+        if( mSize > 0u && !mData )
+        {
+            OGRE_EXCEPT( Exception::ERR_FILE_NOT_FOUND, "Cannot map file: " + fullPath,
+                         "MappedFileDataStream::MappedFileDataStream" );
+        }
+#else
+        OGRE_EXCEPT( Exception::ERR_NOT_IMPLEMENTED,
+                     "Memory mapped files are not supported on this platform. File: " + fullPath,
+                     "MappedFileDataStream::MappedFileDataStream" );
+#endif
+    }
+    //-----------------------------------------------------------------------
+    MappedFileDataStream::~MappedFileDataStream() { close(); }
+    //-----------------------------------------------------------------------
+    bool MappedFileDataStream::isSupported()
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || defined( OGRE_DATASTREAM_HAS_MMAP )
+        return true;
+#else
+        return false;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    size_t MappedFileDataStream::read( void *buf, size_t count )
+    {
+        const size_t cnt = std::min( count, mSize - mPos );
+        if( cnt == 0 )
+            return 0;
+
+        memcpy( buf, mData + mPos, cnt );
+        mPos += cnt;
+        return cnt;
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::skip( long count )
+    {
+        const size_t newpos = static_cast<size_t>( static_cast<long>( mPos ) + count );
+        assert( newpos <= mSize );
+        mPos = std::min( newpos, mSize );
+    }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::seek( size_t pos )
+    {
+        assert( pos <= mSize );
+        mPos = std::min( pos, mSize );
+    }
+    //-----------------------------------------------------------------------
+    size_t MappedFileDataStream::tell() const { return mPos; }
+    //-----------------------------------------------------------------------
+    bool MappedFileDataStream::eof() const { return mPos >= mSize; }
+    //-----------------------------------------------------------------------
+    void MappedFileDataStream::close()
+    {
+        mAccess = 0;
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        if( mData )
+            UnmapViewOfFile( mData );
+        if( mMappingHandle )
+            CloseHandle( mMappingHandle );
+        if( mFileHandle )
+            CloseHandle( mFileHandle );
+        mMappingHandle = 0;
+        mFileHandle = 0;
+#elif defined( OGRE_DATASTREAM_HAS_MMAP )
+        if( mData )
+            munmap( const_cast<uchar *>( mData ), mSize );
+#endif
+        mData = 0;
+        mPos = 0;
+        mSize = 0;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileHandleDataStream::FileHandleDataStream( FILE *handle, uint16 accessMode ) :
         DataStream( accessMode ),
         mFileHandle( handle )
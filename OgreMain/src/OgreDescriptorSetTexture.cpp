@@ -54,6 +54,19 @@ namespace Ogre
 #endif
     }
     //-----------------------------------------------------------------------------------
+    void DescriptorSetTexture::_notifyTexturesUsed( uint32 frameCount ) const
+    {
+        FastArray<const TextureGpu *>::const_iterator itor = mTextures.begin();
+        FastArray<const TextureGpu *>::const_iterator endt = mTextures.end();
+
+        while( itor != endt )
+        {
+            if( *itor )
+                ( *itor )->_notifyUsed( frameCount );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------------------
     bool DescriptorSetTexture2::TextureSlot::formatNeedsReinterpret() const
     {
         return pixelFormat != PFG_UNKNOWN && pixelFormat != texture->getPixelFormat();
@@ -123,4 +136,17 @@ namespace Ogre
             ++itor;
         }
     }
+    //-----------------------------------------------------------------------------------
+    void DescriptorSetTexture2::_notifyTexturesUsed( uint32 frameCount ) const
+    {
+        FastArray<Slot>::const_iterator itor = mTextures.begin();
+        FastArray<Slot>::const_iterator endt = mTextures.end();
+
+        while( itor != endt )
+        {
+            if( itor->isTexture() && itor->getTexture().texture )
+                itor->getTexture().texture->_notifyUsed( frameCount );
+            ++itor;
+        }
+    }
 }  // namespace Ogre
@@ -371,6 +371,9 @@ namespace Ogre
         {
             // read-only stream
             stream = OGRE_NEW FileStreamDataStream( filename, roStream, (size_t)tagStat.st_size, true );
+#ifndef _OGRE_FILESYSTEM_ARCHIVE_UNICODE
+            stream->setFullPath( full_path );
+#endif
         }
         return DataStreamPtr( stream );
     }
@@ -285,6 +285,10 @@ namespace Ogre
 
     Hlms::Hlms( HlmsTypes type, const String &typeName, Archive *dataFolder,
                 ArchiveVec *libraryFolders ) :
+        mStopWarmUp( false ),
+        mWarmUpFinished( false ),
+        mWarmUpInFlightHash( 0u ),
+        mWarmUpInFlight( false ),
         mDataFolder( dataFolder ),
         mHlmsManager( 0 ),
         mShadersGenerated( 0u ),
@@ -405,38 +409,48 @@ namespace Ogre
                            outHash );
     }
     //-----------------------------------------------------------------------------------
-    void Hlms::getTemplateChecksum( uint64 outHash[2] ) const
+    void Hlms::getTemplateChecksum( ShaderType shaderType, uint64 outHash[2] ) const
     {
+        memset( outHash, 0, sizeof( uint64 ) * 2u );
+
+        const String filename = ShaderFiles[shaderType] + mShaderFileExt;
+        if( !mDataFolder || !mDataFolder->exists( filename ) )
+            return;
+
         FastArray<uint8> fileContents;
         fileContents.resize( sizeof( uint64 ) * 2u, 0 );
 
-        for( size_t i = 0; i < NumShaderTypes; ++i )
-        {
-            const String filename = ShaderFiles[i] + mShaderFileExt;
-            if( mDataFolder->exists( filename ) )
-            {
-                // Library piece files first
-                LibraryVec::const_iterator itor = mLibrary.begin();
-                LibraryVec::const_iterator endt = mLibrary.end();
+        // Library piece files first
+        LibraryVec::const_iterator itor = mLibrary.begin();
+        LibraryVec::const_iterator endt = mLibrary.end();
 
-                while( itor != endt )
-                {
-                    hashPieceFiles( itor->dataFolder, itor->pieceFiles[i], fileContents );
-                    ++itor;
-                }
+        while( itor != endt )
+        {
+            hashPieceFiles( itor->dataFolder, itor->pieceFiles[shaderType], fileContents );
+            ++itor;
+        }
 
-                // Main piece files
-                hashPieceFiles( mDataFolder, mPieceFiles[i], fileContents );
+        // Main piece files
+        hashPieceFiles( mDataFolder, mPieceFiles[shaderType], fileContents );
 
-                // The shader file
-                DataStreamPtr inFile = mDataFolder->open( filename );
-                hashFileConcatenate( inFile, fileContents );
-            }
-        }
+        // The shader file
+        DataStreamPtr inFile = mDataFolder->open( filename );
+        hashFileConcatenate( inFile, fileContents );
 
         memcpy( outHash, fileContents.begin(), sizeof( uint64 ) * 2u );
     }
     //-----------------------------------------------------------------------------------
+    void Hlms::getTemplateChecksum( uint64 outHash[2] ) const
+    {
+        uint64 stageHashes[NumShaderTypes][2];
+        for( size_t i = 0; i < NumShaderTypes; ++i )
+            getTemplateChecksum( static_cast<ShaderType>( i ), stageHashes[i] );
+
+        memset( outHash, 0, sizeof( uint64 ) * 2u );
+        OGRE_HASH128_FUNC( stageHashes, static_cast<int>( sizeof( stageHashes ) ), IdString::Seed,
+                           outHash );
+    }
+    //-----------------------------------------------------------------------------------
     void Hlms::enumeratePieceFiles()
     {
         if( !mDataFolder )
@@ -1653,6 +1667,80 @@ namespace Ogre
         return syntaxError;
     }
     //-----------------------------------------------------------------------------------
+    uint32 Hlms::findTemplatePasses( const String &source )
+    {
+        uint32 passes = 0u;
+
+        SubStringRef subString( &source, 0 );
+        size_t pos = subString.find( "@" );
+
+        while( pos != String::npos && passes != TemplatePassAll )
+        {
+            // Same rules parseMath & parseCounter use to tell the keyword apart
+            size_t maxSize = subString.findFirstOf( " \t(", pos + 1 );
+            maxSize = maxSize == String::npos ? subString.getSize() : maxSize;
+            SubStringRef keywordStr( &source, pos + 1, maxSize );
+
+            for( size_t i = 0; i < 8; ++i )
+            {
+                if( keywordStr.matchEqual( c_operations[i].opName ) )
+                    passes |= TemplatePassMath;
+            }
+            for( size_t i = 0; i < 10; ++i )
+            {
+                if( keywordStr.matchEqual( c_counterOperations[i].opName ) )
+                    passes |= TemplatePassCounter;
+            }
+
+            pos = subString.find( "@", pos + 1 );
+        }
+
+        // The rest of the passes search for the directive anywhere
+        if( source.find( "@foreach" ) != String::npos )
+            passes |= TemplatePassForEach;
+        if( source.find( "@property" ) != String::npos )
+            passes |= TemplatePassProperty;
+        if( source.find( "@undefpiece" ) != String::npos )
+            passes |= TemplatePassUndefPiece;
+        if( source.find( "@piece" ) != String::npos )
+            passes |= TemplatePassPiece;
+        if( source.find( "@insertpiece" ) != String::npos )
+            passes |= TemplatePassInsertPiece;
+
+        // @foreach generates text, we can no longer tell which passes are a no-op
+        if( passes & TemplatePassForEach )
+            passes = TemplatePassAll;
+
+        return passes;
+    }
+    //-----------------------------------------------------------------------------------
+    const Hlms::TemplateFile *Hlms::getTemplateFile( Archive *archive, const String &filename )
+    {
+        const String key = archive->getName() + "/" + filename;
+
+        ScopedLock lock( mMutex );
+
+        TemplateFileMap::const_iterator itor = mTemplateFiles.find( key );
+        if( itor == mTemplateFiles.end() )
+        {
+            TemplateFile templateFile;
+            templateFile.passes = 0u;
+            templateFile.bExists = archive->exists( filename );
+            if( templateFile.bExists )
+            {
+                DataStreamPtr inFile = archive->open( filename );
+                templateFile.source.resize( inFile->size() );
+                if( !templateFile.source.empty() )
+                    inFile->read( &templateFile.source[0], inFile->size() );
+                templateFile.passes = findTemplatePasses( templateFile.source );
+            }
+
+            itor = mTemplateFiles.insert( TemplateFileMap::value_type( key, templateFile ) ).first;
+        }
+
+        return itor->second.bExists ? &itor->second : 0;
+    }
+    //-----------------------------------------------------------------------------------
     bool Hlms::parseOffline( const String &filename, String &inString, String &outString,
                              const size_t tid )
     {
@@ -1909,7 +1997,23 @@ namespace Ogre
         return retVal;
     }
     //-----------------------------------------------------------------------------------
-    void Hlms::_setNumThreads( size_t numThreads ) { mT.resize( numThreads ); }
+    void Hlms::_setNumThreads( size_t numThreads )
+    {
+        if( mWarmUpThread )
+        {
+            // The last entry belongs to the warm up thread
+            ++numThreads;
+            if( mT.size() != numThreads )
+            {
+                ScopedLock lock( mWarmUpMutex );
+                mT.resize( numThreads );
+            }
+        }
+        else
+        {
+            mT.resize( numThreads );
+        }
+    }
     //-----------------------------------------------------------------------------------
     void Hlms::_setShadersGenerated( uint32 shadersGenerated ) { mShadersGenerated = shadersGenerated; }
     //-----------------------------------------------------------------------------------
@@ -2084,6 +2188,11 @@ namespace Ogre
     //-----------------------------------------------------------------------------------
     void Hlms::clearShaderCache()
     {
+        stopWarmUpThread();
+        mPendingShaderCode.clear();
+        mPendingShaderCodeIdx.clear();
+        mTemplateFiles.clear();
+
         mPassCache.clear();
 
         // Empty mShaderCache so that mHlmsManager->destroyMacroblock would
@@ -2124,24 +2233,40 @@ namespace Ogre
             const String::size_type extPos1 = itor->find( ".any" );
             if( extPos0 == itor->size() - mShaderFileExt.size() || extPos1 == itor->size() - 4u )
             {
-                DataStreamPtr inFile = archive->open( *itor );
-
-                String inString;
-                String outString;
+                const TemplateFile *templateFile = getTemplateFile( archive, *itor );
 
-                inString.resize( inFile->size() );
-                inFile->read( &inString[0], inFile->size() );
-
-                this->parseMath( inString, outString, tid );
-                while( outString.find( "@foreach" ) != String::npos )
+                // A piece file without directives has nothing to contribute
+                const uint32 passes = templateFile ? templateFile->passes : 0u;
+                if( passes )
                 {
-                    this->parseForEach( outString, inString, tid );
-                    inString.swap( outString );
+                    String inString;
+                    String outString;
+
+                    if( passes & TemplatePassMath )
+                        this->parseMath( templateFile->source, outString, tid );
+                    else
+                        outString = templateFile->source;
+                    while( ( passes & TemplatePassForEach ) &&
+                           outString.find( "@foreach" ) != String::npos )
+                    {
+                        this->parseForEach( outString, inString, tid );
+                        inString.swap( outString );
+                    }
+                    if( passes & TemplatePassProperty )
+                        this->parseProperties( outString, inString, tid );
+                    else
+                        inString.swap( outString );
+                    if( passes & TemplatePassUndefPiece )
+                        this->parseUndefPieces( inString, outString, tid );
+                    else
+                        outString.swap( inString );
+                    if( passes & TemplatePassPiece )
+                        this->collectPieces( outString, inString, tid );
+                    else
+                        inString.swap( outString );
+                    if( passes & TemplatePassCounter )
+                        this->parseCounter( inString, outString, tid );
                 }
-                this->parseProperties( outString, inString, tid );
-                this->parseUndefPieces( inString, outString, tid );
-                this->collectPieces( outString, inString, tid );
-                this->parseCounter( inString, outString, tid );
             }
             ++itor;
         }
@@ -2492,12 +2617,21 @@ namespace Ogre
                                                      const String source[NumShaderTypes],
                                                      const uint32 shaderCounter, const size_t tid )
     {
-        OgreProfileExhaustive( "Hlms::_compileShaderFromPreprocessedSource" );
-
-        const uint32 uniqueName = mType * 100000000u + shaderCounter;
-
         ShaderCodeCache codeCache( mergedCache.pieces );
         codeCache.mergedCache.setProperties = mergedCache.setProperties;
+        compilePreprocessedShaderCode( codeCache, source, shaderCounter, tid );
+
+        // Ensure code didn't accidentally modify mSetProperties
+        OGRE_ASSERT_HIGH( codeCache.mergedCache.setProperties == mergedCache.setProperties );
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::compilePreprocessedShaderCode( ShaderCodeCache &codeCache,
+                                              const String source[NumShaderTypes],
+                                              const uint32 shaderCounter, const size_t tid )
+    {
+        OgreProfileExhaustive( "Hlms::compilePreprocessedShaderCode" );
+
+        const uint32 uniqueName = mType * 100000000u + shaderCounter;
 
         codeCache.mergedCache.setProperties.swap( mT[tid].setProperties );
 
@@ -2531,14 +2665,221 @@ namespace Ogre
 
         codeCache.mergedCache.setProperties.swap( mT[tid].setProperties );
 
-        // Ensure code didn't accidentally modify mSetProperties
-        OGRE_ASSERT_HIGH( codeCache.mergedCache.setProperties == mergedCache.setProperties );
-
         ScopedLock lock( mMutex );
         mShaderCodeCache.push_back( codeCache );
         mShaderCodeCacheDirty = true;
     }
     //-----------------------------------------------------------------------------------
+    size_t Hlms::calculateRenderableCacheHash( const RenderableCache &mergedCache )
+    {
+        // Only has to be cheap and good enough to tell entries apart;
+        // takePendingShaderCode still compares the full mergedCache.
+        size_t hash = mergedCache.setProperties.size();
+
+        HlmsPropertyVec::const_iterator itor = mergedCache.setProperties.begin();
+        HlmsPropertyVec::const_iterator endt = mergedCache.setProperties.end();
+
+        while( itor != endt )
+        {
+            hash = hash * 31u + itor->keyName.mHash;
+            hash = hash * 31u + static_cast<uint32>( itor->value );
+            ++itor;
+        }
+
+        for( size_t i = 0; i < NumShaderTypes; ++i )
+        {
+            PiecesMap::const_iterator itPiece = mergedCache.pieces[i].begin();
+            PiecesMap::const_iterator enPiece = mergedCache.pieces[i].end();
+
+            while( itPiece != enPiece )
+            {
+                hash = hash * 31u + itPiece->first.mHash;
+                hash = hash * 31u + itPiece->second.size();
+                ++itPiece;
+            }
+        }
+
+        return hash;
+    }
+    //-----------------------------------------------------------------------------------
+    bool Hlms::takePendingShaderCode( const RenderableCache &mergedCache, const size_t mergedCacheHash,
+                                      PendingShaderCode &outPendingShaderCode )
+    {
+        std::pair<PendingShaderCodeIdxMap::iterator, PendingShaderCodeIdxMap::iterator> range =
+            mPendingShaderCodeIdx.equal_range( mergedCacheHash );
+
+        PendingShaderCodeIdxMap::iterator itor = range.first;
+        while( itor != range.second && !( mPendingShaderCode[itor->second].mergedCache == mergedCache ) )
+            ++itor;
+
+        if( itor == range.second )
+            return false;
+
+        const size_t idx = itor->second;
+        mPendingShaderCodeIdx.erase( itor );
+
+        const size_t lastIdx = mPendingShaderCode.size() - 1u;
+        if( idx != lastIdx )
+        {
+            // The last entry is about to be moved into idx. Update its index.
+            range = mPendingShaderCodeIdx.equal_range(
+                calculateRenderableCacheHash( mPendingShaderCode[lastIdx].mergedCache ) );
+            itor = range.first;
+            while( itor->second != lastIdx )
+                ++itor;
+            itor->second = idx;
+        }
+
+        std::swap( outPendingShaderCode, mPendingShaderCode[idx] );
+        PendingShaderCodeVec::iterator itPending = mPendingShaderCode.begin() + ptrdiff_t( idx );
+        efficientVectorRemove( mPendingShaderCode, itPending );
+        return true;
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::popPendingShaderCode( PendingShaderCode &outPendingShaderCode )
+    {
+        const size_t lastIdx = mPendingShaderCode.size() - 1u;
+        std::swap( outPendingShaderCode, mPendingShaderCode.back() );
+        mPendingShaderCode.pop_back();
+
+        std::pair<PendingShaderCodeIdxMap::iterator, PendingShaderCodeIdxMap::iterator> range =
+            mPendingShaderCodeIdx.equal_range(
+                calculateRenderableCacheHash( outPendingShaderCode.mergedCache ) );
+        PendingShaderCodeIdxMap::iterator itor = range.first;
+        while( itor->second != lastIdx )
+            ++itor;
+        mPendingShaderCodeIdx.erase( itor );
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::addPendingShaderCode( PendingShaderCodeVec &pendingShaderCode )
+    {
+        ScopedLock lock( mMutex );
+        if( mPendingShaderCode.empty() )
+        {
+            mPendingShaderCode.swap( pendingShaderCode );
+        }
+        else
+        {
+            mPendingShaderCode.insert( mPendingShaderCode.end(), pendingShaderCode.begin(),
+                                       pendingShaderCode.end() );
+            pendingShaderCode.clear();
+        }
+
+        mPendingShaderCodeIdx.clear();
+        mPendingShaderCodeIdx.reserve( mPendingShaderCode.size() );
+        const size_t numPending = mPendingShaderCode.size();
+        for( size_t i = 0u; i < numPending; ++i )
+        {
+            mPendingShaderCodeIdx.insert(
+                { calculateRenderableCacheHash( mPendingShaderCode[i].mergedCache ), i } );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    static unsigned long hlmsWarmUpThread( ThreadHandle *threadHandle )
+    {
+        Threads::SetThreadName( threadHandle, "HlmsWarmUp" );
+        Hlms *hlms = reinterpret_cast<Hlms *>( threadHandle->getUserParam() );
+        hlms->_warmUpThread();
+        return 0u;
+    }
+    THREAD_DECLARE( hlmsWarmUpThread );
+    //-----------------------------------------------------------------------------------
+    void Hlms::startWarmUpThread()
+    {
+        // The previous thread may have stopped on its own. Join it so a new one can be started.
+        if( mWarmUpThread && mWarmUpFinished.load( std::memory_order_acquire ) )
+            stopWarmUpThread();
+
+        if( mWarmUpThread || !mRenderSystem ||
+            !mRenderSystem->supportsMultithreadedShaderCompilation() )
+        {
+            return;
+        }
+
+        if( getNumPendingShaders() == 0u )
+            return;
+
+        mStopWarmUp.store( false, std::memory_order_relaxed );
+        mWarmUpFinished.store( false, std::memory_order_relaxed );
+        mT.resize( mT.size() + 1u );
+        mWarmUpThread = Threads::CreateThread( THREAD_GET( hlmsWarmUpThread ), 0, this );
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::stopWarmUpThread()
+    {
+        if( !mWarmUpThread )
+            return;
+
+        mStopWarmUp.store( true, std::memory_order_relaxed );
+        Threads::WaitForThreads( 1u, &mWarmUpThread );
+        mWarmUpThread.reset();
+        mT.pop_back();
+    }
+    //-----------------------------------------------------------------------------------
+    size_t Hlms::getNumPendingShaders()
+    {
+        ScopedLock lock( mMutex );
+        return mPendingShaderCode.size();
+    }
+    //-----------------------------------------------------------------------------------
+    void Hlms::_warmUpThread()
+    {
+        while( !mStopWarmUp.load( std::memory_order_relaxed ) )
+        {
+            // Taken before picking an entry, so that createShaderCacheEntry can wait
+            // on it for an entry it finds in flight (see mWarmUpInFlight).
+            ScopedLock lock( mWarmUpMutex );
+
+            PendingShaderCode pendingShaderCode;
+            uint32 shaderCounter;
+            {
+                ScopedLock lockPending( mMutex );
+                if( mPendingShaderCode.empty() )
+                    break;
+                popPendingShaderCode( pendingShaderCode );
+                shaderCounter = mShadersGenerated++;
+                mWarmUpInFlightHash = calculateRenderableCacheHash( pendingShaderCode.mergedCache );
+                mWarmUpInFlight = true;
+            }
+
+            ShaderCodeCache codeCache( pendingShaderCode.mergedCache.pieces );
+            codeCache.mergedCache.setProperties.swap( pendingShaderCode.mergedCache.setProperties );
+
+            const size_t tid = mT.size() - 1u;
+#ifdef OGRE_SHADER_THREADING_BACKWARDS_COMPATIBLE_API
+#    ifdef OGRE_SHADER_THREADING_USE_TLS
+            msThreadId = static_cast<uint32>( tid );
+#    endif
+#endif
+
+            try
+            {
+                if( pendingShaderCode.bSourceUpToDate )
+                {
+                    compilePreprocessedShaderCode( codeCache, pendingShaderCode.sourceFile,
+                                                   shaderCounter, tid );
+                }
+                else
+                {
+                    compileShaderCode( codeCache, shaderCounter, tid );
+                }
+            }
+            catch( Exception &e )
+            {
+                // Not fatal. It will be compiled again (and the error raised to the
+                // caller) if the shader is actually needed.
+                LogManager::getSingleton().logMessage(
+                    "Hlms warm up thread failed to compile a shader: " + e.getFullDescription(),
+                    LML_CRITICAL );
+            }
+
+            ScopedLock lockPending( mMutex );
+            mWarmUpInFlight = false;
+        }
+
+        mWarmUpFinished.store( true, std::memory_order_release );
+    }
+    //-----------------------------------------------------------------------------------
     void Hlms::compileShaderCode( ShaderCodeCache &codeCache, const uint32 shaderCounter,
                                   const size_t tid )
     {
@@ -2556,7 +2897,8 @@ namespace Ogre
             mT[tid].pieces = codeCache.mergedCache.pieces[i];
 
             const String filename = ShaderFiles[i] + mShaderFileExt;
-            if( mDataFolder->exists( filename ) )
+            const TemplateFile *templateFile = getTemplateFile( mDataFolder, filename );
+            if( templateFile )
             {
                 if( mShaderProfile == "glsl" || mShaderProfile == "glslvk" )  // TODO: String comparision
                 {
@@ -2648,24 +2990,33 @@ namespace Ogre
                 processPieces( mDataFolder, mPieceFiles[i], tid );
 
                 // Generate the shader file.
-                DataStreamPtr inFile = mDataFolder->open( filename );
+                const uint32 passes = templateFile->passes;
 
                 String inString;
                 String outString;
 
-                inString.resize( inFile->size() );
-                inFile->read( &inString[0], inFile->size() );
-
                 bool syntaxError = false;
 
-                syntaxError |= this->parseMath( inString, outString, tid );
-                while( !syntaxError && outString.find( "@foreach" ) != String::npos )
+                // Passes before pieces get inserted only see the file's own directives,
+                // skip those that would just copy their input.
+                if( passes & TemplatePassMath )
+                    syntaxError |= this->parseMath( templateFile->source, outString, tid );
+                else
+                    outString = templateFile->source;
+                while( !syntaxError && ( passes & TemplatePassForEach ) &&
+                       outString.find( "@foreach" ) != String::npos )
                 {
                     syntaxError |= this->parseForEach( outString, inString, tid );
                     inString.swap( outString );
                 }
-                syntaxError |= this->parseProperties( outString, inString, tid );
-                syntaxError |= this->parseUndefPieces( inString, outString, tid );
+                if( passes & TemplatePassProperty )
+                    syntaxError |= this->parseProperties( outString, inString, tid );
+                else
+                    inString.swap( outString );
+                if( passes & TemplatePassUndefPiece )
+                    syntaxError |= this->parseUndefPieces( inString, outString, tid );
+                else
+                    outString.swap( inString );
                 while( !syntaxError && ( outString.find( "@piece" ) != String::npos ||
                                          outString.find( "@insertpiece" ) != String::npos ) )
                 {
@@ -2783,25 +3134,67 @@ namespace Ogre
         codeCache.mergedCache.setProperties.swap( mT[tid].setProperties );
         {
             bool bIsInCache;
+            bool bIsPending = false;
+            PendingShaderCode pendingShaderCode;
 
             uint32_t shaderCounter = 0u;
+            bool bWaitForWarmUp = true;
+            while( bWaitForWarmUp )
             {
-                ScopedLock lock( mMutex );
-                ShaderCodeCacheVec::iterator itCodeCache =
-                    std::find( mShaderCodeCache.begin(), mShaderCodeCache.end(), codeCache );
-                bIsInCache = itCodeCache != mShaderCodeCache.end();
+                {
+                    bWaitForWarmUp = false;
+
+                    ScopedLock lock( mMutex );
+                    ShaderCodeCacheVec::iterator itCodeCache =
+                        std::find( mShaderCodeCache.begin(), mShaderCodeCache.end(), codeCache );
+                    bIsInCache = itCodeCache != mShaderCodeCache.end();
+
+                    if( bIsInCache )
+                    {
+                        // This requires the mutex as itCodeCache could be invalidated
+                        for( size_t i = 0; i < NumShaderTypes; ++i )
+                            codeCache.shaders[i] = itCodeCache->shaders[i];
+                    }
+                    else if( !mPendingShaderCode.empty() || mWarmUpInFlight )
+                    {
+                        const size_t mergedCacheHash =
+                            calculateRenderableCacheHash( codeCache.mergedCache );
+                        if( mWarmUpInFlight && mWarmUpInFlightHash == mergedCacheHash )
+                        {
+                            // The warm up thread is compiling this very shader (or one whose
+                            // hash collides). Wait for it and look in mShaderCodeCache again
+                            // instead of compiling it twice.
+                            bWaitForWarmUp = true;
+                        }
+                        else
+                        {
+                            shaderCounter = mShadersGenerated++;
+                            bIsPending = takePendingShaderCode( codeCache.mergedCache, mergedCacheHash,
+                                                                pendingShaderCode );
+                        }
+                    }
+                    else
+                    {
+                        shaderCounter = mShadersGenerated++;
+                    }
+                }
 
-                if( bIsInCache )
+                if( bWaitForWarmUp )
                 {
-                    // This requires the mutex as itCodeCache could be invalidated
-                    for( size_t i = 0; i < NumShaderTypes; ++i )
-                        codeCache.shaders[i] = itCodeCache->shaders[i];
+                    // The warm up thread holds mWarmUpMutex until it's done with the entry.
+                    // It must not be taken while holding mMutex.
+                    ScopedLock waitLock( mWarmUpMutex );
                 }
-                else
-                    shaderCounter = mShadersGenerated++;
             }
 
-            if( !bIsInCache )
+            if( !bIsInCache && bIsPending && pendingShaderCode.bSourceUpToDate )
+            {
+                // Restored from HlmsDiskCache and not compiled yet. Skip the preprocessor.
+                compilePreprocessedShaderCode( codeCache, pendingShaderCode.sourceFile, shaderCounter,
+                                               tid );
+                codeCache.mergedCache.setProperties.swap( mT[tid].setProperties );
+            }
+            else if( !bIsInCache )
                 compileShaderCode( codeCache, shaderCounter, tid );
             else
             {
@@ -41,6 +41,7 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreRootLayout.h"
 #include "OgreSceneManager.h"
+#include "OgreTextureGpuManager.h"
 #include "Vao/OgreConstBufferPacked.h"
 #include "Vao/OgreTexBufferPacked.h"
 #include "Vao/OgreUavBufferPacked.h"
@@ -545,7 +546,11 @@ namespace Ogre
         }
 
         if( job->mTexturesDescSet )
+        {
             mRenderSystem->_setTexturesCS( job->getGlTexSlotStart(), job->mTexturesDescSet );
+            job->mTexturesDescSet->_notifyTexturesUsed(
+                mRenderSystem->getTextureGpuManager()->getFrameCount() );
+        }
         if( job->mSamplersDescSet )
             mRenderSystem->_setSamplersCS( job->getGlTexSlotStart(), job->mSamplersDescSet );
         if( job->mUavsDescSet )
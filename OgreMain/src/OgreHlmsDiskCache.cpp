@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreHlmsDiskCache.h"
 
 #include "OgreHlmsManager.h"
+#include "OgreDataStream.h"
 #include "OgreLogManager.h"
 #include "OgreProfiler.h"
 #include "OgreRenderSystem.h"
@@ -41,11 +42,22 @@ THE SOFTWARE.
 #    include "iOS/macUtils.h"
 #endif
 
+#include "Hash/MurmurHash3.h"
+
 #include <atomic>
 
+#if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_32
+#    define OGRE_HASH128_FUNC MurmurHash3_x86_128
+#else
+#    define OGRE_HASH128_FUNC MurmurHash3_x64_128
+#endif
+
 namespace Ogre
 {
-    static const uint16 c_hlmsDiskCacheVersion = 6u;
+    // Version 7 stored each entry with a content key and the templates' checksum.
+    // Version 8 (current) makes that checksum cover only the shader stages and
+    // datablock custom pieces each entry depends on.
+    static const uint16 c_hlmsDiskCacheVersion = 8u;
 
     HlmsDiskCache::HlmsDiskCache( HlmsManager *hlmsManager ) :
         mTemplatesOutOfDate( false ),
@@ -72,9 +84,14 @@ namespace Ogre
     //-----------------------------------------------------------------------------------
     //-----------------------------------------------------------------------------------
     //-----------------------------------------------------------------------------------
-    HlmsDiskCache::SourceCode::SourceCode() : mergedCache( HlmsPropertyVec(), 0 ) {}
+    HlmsDiskCache::SourceCode::SourceCode() : mergedCache( HlmsPropertyVec(), 0 )
+    {
+        memset( templateHash, 0, sizeof( templateHash ) );
+    }
     //-----------------------------------------------------------------------------------
-    HlmsDiskCache::SourceCode::SourceCode( const Hlms::ShaderCodeCache &shaderCodeCache ) :
+    HlmsDiskCache::SourceCode::SourceCode( const Hlms::ShaderCodeCache &shaderCodeCache,
+                                           const Hlms *hlms,
+                                           const uint64 stageTemplateHash[NumShaderTypes][2] ) :
         mergedCache( shaderCodeCache.mergedCache )
     {
         for( size_t i = 0; i < NumShaderTypes; ++i )
@@ -82,6 +99,105 @@ namespace Ogre
             if( shaderCodeCache.shaders[i] )
                 this->sourceFile[i] = shaderCodeCache.shaders[i]->getSource();
         }
+        calculateTemplateHash( hlms, stageTemplateHash, templateHash );
+    }
+    //-----------------------------------------------------------------------------------
+    template <typename T>
+    static void appendToHash( FastArray<uint8> &hashInput, const T &value )
+    {
+        const uint8 *data = reinterpret_cast<const uint8 *>( &value );
+        hashInput.appendPOD( data, data + sizeof( value ) );
+    }
+    //-----------------------------------------------------------------------------------
+    void HlmsDiskCache::SourceCode::getKey( uint64 outKey[2] ) const
+    {
+        FastArray<uint8> hashInput;
+
+        appendToHash( hashInput, templateHash );
+
+        HlmsPropertyVec::const_iterator itor = mergedCache.setProperties.begin();
+        HlmsPropertyVec::const_iterator endt = mergedCache.setProperties.end();
+
+        while( itor != endt )
+        {
+            appendToHash( hashInput, itor->keyName.mHash );
+            appendToHash( hashInput, itor->value );
+            ++itor;
+        }
+
+        for( size_t i = 0; i < NumShaderTypes; ++i )
+        {
+            appendToHash( hashInput, static_cast<uint32>( mergedCache.pieces[i].size() ) );
+
+            PiecesMap::const_iterator itPiece = mergedCache.pieces[i].begin();
+            PiecesMap::const_iterator enPiece = mergedCache.pieces[i].end();
+
+            while( itPiece != enPiece )
+            {
+                const uint8 *pieceData = reinterpret_cast<const uint8 *>( itPiece->second.c_str() );
+                appendToHash( hashInput, itPiece->first.mHash );
+                hashInput.appendPOD( pieceData, pieceData + itPiece->second.size() );
+                ++itPiece;
+            }
+        }
+
+        memset( outKey, 0, sizeof( uint64 ) * 2u );
+        OGRE_HASH128_FUNC( hashInput.begin(), static_cast<int>( hashInput.size() ), IdString::Seed,
+                           outKey );
+    }
+    //-----------------------------------------------------------------------------------
+    void HlmsDiskCache::SourceCode::calculateTemplateHash(
+        const Hlms *hlms, const uint64 stageTemplateHash[NumShaderTypes][2], uint64 outHash[2] ) const
+    {
+        memset( outHash, 0, sizeof( uint64 ) * 2u );
+
+        size_t numStages = NumShaderTypes;
+        while( numStages > 0u && sourceFile[numStages - 1u].empty() )
+            --numStages;
+
+        if( numStages == 0u )
+            return;
+
+        FastArray<uint8> hashInput;
+
+        for( size_t i = 0u; i < numStages; ++i )
+        {
+            appendToHash( hashInput, stageTemplateHash[i][0] );
+            appendToHash( hashInput, stageTemplateHash[i][1] );
+
+            const int32 customPieceName = Hlms::getProperty(
+                mergedCache.setProperties, HlmsBaseProp::_DatablockCustomPieceShaderName[i] );
+            if( customPieceName )
+            {
+                uint64 customPieceHash[2] = { 0u, 0u };
+                const Hlms::DatablockCustomPieceFile *customPieceFile =
+                    hlms->getDatablockCustomPieceData( customPieceName );
+                if( customPieceFile )
+                    customPieceFile->getCodeChecksum( customPieceHash );
+                appendToHash( hashInput, customPieceHash[0] );
+                appendToHash( hashInput, customPieceHash[1] );
+            }
+        }
+
+        OGRE_HASH128_FUNC( hashInput.begin(), static_cast<int>( hashInput.size() ), IdString::Seed,
+                           outHash );
+    }
+    //-----------------------------------------------------------------------------------
+    bool HlmsDiskCache::SourceCode::isSourceUpToDate(
+        const Hlms *hlms, const uint64 stageTemplateHash[NumShaderTypes][2] ) const
+    {
+        if( templateHash[0] == 0u && templateHash[1] == 0u )
+            return false;  // Saved without source code
+
+        uint64 currentTemplateHash[2];
+        calculateTemplateHash( hlms, stageTemplateHash, currentTemplateHash );
+        return templateHash[0] == currentTemplateHash[0] && templateHash[1] == currentTemplateHash[1];
+    }
+    //-----------------------------------------------------------------------------------
+    static void getStageTemplateChecksums( const Hlms *hlms, uint64 outHash[NumShaderTypes][2] )
+    {
+        for( size_t i = 0u; i < NumShaderTypes; ++i )
+            hlms->getTemplateChecksum( static_cast<ShaderType>( i ), outHash[i] );
     }
     //-----------------------------------------------------------------------------------
     HlmsDiskCache::Pso::Pso() : renderableCache( HlmsPropertyVec(), 0 ) {}
@@ -109,6 +225,9 @@ namespace Ogre
         mFastShaderBuildHack = hlms->getFastShaderBuildHack();
         hlms->getTemplateChecksum( mCache.templateHash );
 
+        uint64 stageTemplateHash[NumShaderTypes][2];
+        getStageTemplateChecksums( hlms, stageTemplateHash );
+
         {
             // Copy datablock's custom pieces
             // (Those that came from files. The ones from memory cannot be cached).
@@ -151,13 +270,39 @@ namespace Ogre
 
                 if( bCacheable )
                 {
-                    SourceCode sourceCode( *itor );
+                    SourceCode sourceCode( *itor, hlms, stageTemplateHash );
                     mCache.sourceCode.push_back( sourceCode );
                 }
                 ++itor;
             }
         }
 
+        {
+            // Copy the shaders that were restored from a previous cache but never got compiled,
+            // otherwise they'd be lost. Those that are out of date are saved without source code.
+            ScopedLock lock( hlms->mMutex );
+            mCache.sourceCode.reserve( mCache.sourceCode.size() + hlms->mPendingShaderCode.size() );
+
+            // Hlms takes its entries from the back; restore the original order.
+            Hlms::PendingShaderCodeVec::const_reverse_iterator itor = hlms->mPendingShaderCode.rbegin();
+            Hlms::PendingShaderCodeVec::const_reverse_iterator endt = hlms->mPendingShaderCode.rend();
+
+            while( itor != endt )
+            {
+                SourceCode sourceCode;
+                sourceCode.mergedCache = itor->mergedCache;
+                if( itor->bSourceUpToDate )
+                {
+                    for( size_t i = 0; i < NumShaderTypes; ++i )
+                        sourceCode.sourceFile[i] = itor->sourceFile[i];
+                    sourceCode.calculateTemplateHash( hlms, stageTemplateHash,
+                                                      sourceCode.templateHash );
+                }
+                mCache.sourceCode.push_back( sourceCode );
+                ++itor;
+            }
+        }
+
         {
             // Copy PSOs
             mCache.pso.reserve( hlms->mShaderCache.size() );
@@ -205,12 +350,14 @@ namespace Ogre
         std::atomic<uint32> currentEntry;
         uint32 numEntries;
         const HlmsDiskCache::SourceCode *sourceCode;
+        uint64 stageTemplateHash[NumShaderTypes][2];
         bool templatesOutOfDate;
         bool exceptionFound;                   // GUARDED_BY( mutex )
         std::exception_ptr threadedException;  // GUARDED_BY( mutex )
         LightweightMutex mutex;
 
         CompilerJobParams( Hlms *_hlms, const HlmsDiskCache::SourceCodeVec &_sourceCode,
+                           const uint64 _stageTemplateHash[NumShaderTypes][2],
                            bool _templatesOutOfDate ) :
             hlms( _hlms ),
             currentEntry( 0u ),
@@ -219,6 +366,7 @@ namespace Ogre
             templatesOutOfDate( _templatesOutOfDate ),
             exceptionFound( false )
         {
+            memcpy( stageTemplateHash, _stageTemplateHash, sizeof( stageTemplateHash ) );
         }
     };
     //-----------------------------------------------------------------------------------
@@ -257,7 +405,7 @@ namespace Ogre
             try
             {
                 // Compile shaders
-                if( !templatesOutOfDate )
+                if( !templatesOutOfDate && sourceCode[idx].isSourceUpToDate( hlms, jobParams.stageTemplateHash ) )
                 {
                     // Templates haven't changed, send the Hlms-processed shader code for compilation
                     hlms->_compileShaderFromPreprocessedSource(
@@ -289,7 +437,7 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
-    void HlmsDiskCache::applyTo( Hlms *hlms, const size_t numThreads )
+    void HlmsDiskCache::applyTo( Hlms *hlms, const size_t numThreads, const bool bDeferCompilation )
     {
         LogManager::getSingleton().logMessage( "Applying HlmsDiskCache " +
                                                StringConverter::toString( hlms->getType() ) );
@@ -344,19 +492,6 @@ namespace Ogre
                 "'. This increases loading times." );
         }
 
-        {
-            uint64 currentHash[2];
-            hlms->getTemplateChecksum( currentHash );
-            if( mCache.templateHash[0] != currentHash[0] || mCache.templateHash[1] != currentHash[1] )
-            {
-                mTemplatesOutOfDate = true;
-                LogManager::getSingleton().logMessage(
-                    "WARNING: The cached Hlms is out of date. The templates have changed. "
-                    "We will parse the templates again. If you experience crashes or shader "
-                    "compiler errors, delete the cache." );
-            }
-        }
-
         hlms->clearShaderCache();
 
         for( const DatablockCustomPiecesCache &datablockPiece : mCache.datablockCustomPieceFiles )
@@ -368,13 +503,13 @@ namespace Ogre
             case Hlms::CCPFS_Success:
                 break;  // Everything OK, continue.
             case Hlms::CCPFS_OutOfDate:
-                mTemplatesOutOfDate = true;
+                // The shaders using it will be seen as out of date (see calculateTemplateHash).
                 LogManager::getSingleton().logMessage(
                     "WARNING: The cached Hlms is out of date. Datablock's custom piece file '" +
                     datablockPiece.filename + "' in resource group '" + datablockPiece.resourceGroup +
                     "' has changed. "
-                    "We will parse the templates again. If you experience crashes or shader "
-                    "compiler errors, delete the cache." );
+                    "We will parse the templates again for the shaders using it. If you experience "
+                    "crashes or shader compiler errors, delete the cache." );
                 break;
             case Hlms::CCPFS_CriticalError:
                 // We could in theory recover from this error if we iterate through all the cache
@@ -390,8 +525,65 @@ namespace Ogre
             }
         }
 
+        // Must be done after the custom pieces were added, as they're part of the checksum.
+        uint64 stageTemplateHash[NumShaderTypes][2];
+        getStageTemplateChecksums( hlms, stageTemplateHash );
+        if( !mTemplatesOutOfDate )
+        {
+            size_t numOutOfDate = 0u;
+            SourceCodeVec::const_iterator itor = mCache.sourceCode.begin();
+            SourceCodeVec::const_iterator endt = mCache.sourceCode.end();
+
+            while( itor != endt )
+            {
+                if( !itor->isSourceUpToDate( hlms, stageTemplateHash ) )
+                    ++numOutOfDate;
+                ++itor;
+            }
+
+            if( numOutOfDate > 0u )
+            {
+                LogManager::getSingleton().logMessage(
+                    "WARNING: " + StringConverter::toString( numOutOfDate ) + " out of " +
+                    StringConverter::toString( mCache.sourceCode.size() ) +
+                    " cached shaders are out of date. The templates have changed. "
+                    "We will parse the templates again for those. If you experience crashes or "
+                    "shader compiler errors, delete the cache." );
+            }
+        }
+
+        if( bDeferCompilation )
+        {
+            Hlms::PendingShaderCodeVec pendingShaderCode;
+            pendingShaderCode.resize( mCache.sourceCode.size() );
+
+            // Hlms takes its entries from the back. Reverse them so they get compiled
+            // in the same order they were originally needed.
+            Hlms::PendingShaderCodeVec::iterator itPending = pendingShaderCode.begin();
+            SourceCodeVec::const_reverse_iterator itor = mCache.sourceCode.rbegin();
+            SourceCodeVec::const_reverse_iterator endt = mCache.sourceCode.rend();
+
+            while( itor != endt )
+            {
+                itPending->mergedCache = itor->mergedCache;
+                itPending->bSourceUpToDate =
+                    !mTemplatesOutOfDate && itor->isSourceUpToDate( hlms, stageTemplateHash );
+                if( itPending->bSourceUpToDate )
+                {
+                    for( size_t i = 0; i < NumShaderTypes; ++i )
+                        itPending->sourceFile[i] = itor->sourceFile[i];
+                }
+                ++itPending;
+                ++itor;
+            }
+
+            hlms->addPendingShaderCode( pendingShaderCode );
+            hlms->startWarmUpThread();
+        }
+        else
         {
-            CompilerJobParams jobParams( hlms, mCache.sourceCode, mTemplatesOutOfDate );
+            CompilerJobParams jobParams( hlms, mCache.sourceCode, stageTemplateHash,
+                                         mTemplatesOutOfDate );
 
             // Compile shaders
             if( hlms->getRenderSystem()->supportsMultithreadedShaderCompilation() && numThreads > 1u )
@@ -566,6 +758,10 @@ namespace Ogre
 
             while( itor != endt )
             {
+                uint64 key[2];
+                itor->getKey( key );
+                write( dataStream, key );
+                write( dataStream, itor->templateHash );
                 save( dataStream, itor->mergedCache );
                 for( size_t i = 0; i < NumShaderTypes; ++i )
                     save( dataStream, itor->sourceFile[i] );
@@ -733,12 +929,18 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
-    void HlmsDiskCache::loadFrom( DataStreamPtr &dataStream )
+    void HlmsDiskCache::loadFrom( DataStreamPtr &srcDataStream )
     {
-        LogManager::getSingleton().logMessage( "Loading HlmsDiskCache from " + dataStream->getName() );
+        LogManager::getSingleton().logMessage( "Loading HlmsDiskCache from " +
+                                               srcDataStream->getName() );
 
         clearCache();
 
+        // Read the whole file in one go and parse it from memory, rather than
+        // issuing thousands of small reads against the file.
+        DataStreamPtr dataStream(
+            OGRE_NEW MemoryDataStream( srcDataStream->getName(), srcDataStream, true, true ) );
+
         const uint16 version = read<uint16>( dataStream );
         if( version != c_hlmsDiskCacheVersion )
         {
@@ -796,13 +998,36 @@ namespace Ogre
             uint32 numEntries = read<uint32>( dataStream );
             mCache.sourceCode.reserve( numEntries );
 
+            // Entries are content-addressed. Skip duplicates, and entries whose
+            // key doesn't match their contents (i.e. corrupted).
+            typedef std::pair<uint64, uint64> Key;
+            set<Key>::type loadedKeys;
+
+            size_t numCorrupted = 0u;
+
             SourceCode sourceCode;
             for( size_t i = 0; i < numEntries; ++i )
             {
+                uint64 key[2];
+                read( dataStream, key );
+                read( dataStream, sourceCode.templateHash );
                 load( dataStream, sourceCode.mergedCache );
                 for( size_t j = 0; j < NumShaderTypes; ++j )
                     load( dataStream, sourceCode.sourceFile[j] );
-                mCache.sourceCode.push_back( sourceCode );
+
+                uint64 expectedKey[2];
+                sourceCode.getKey( expectedKey );
+                if( key[0] != expectedKey[0] || key[1] != expectedKey[1] )
+                    ++numCorrupted;
+                else if( loadedKeys.insert( Key( key[0], key[1] ) ).second )
+                    mCache.sourceCode.push_back( sourceCode );
+            }
+
+            if( numCorrupted > 0u )
+            {
+                LogManager::getSingleton().logMessage(
+                    "HlmsDiskCache: Discarded " + StringConverter::toString( numCorrupted ) +
+                    " shader entries whose key doesn't match their contents." );
             }
         }
 
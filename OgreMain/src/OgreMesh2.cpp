@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "Animation/OgreSkeletonDef.h"
 #include "Animation/OgreSkeletonManager.h"
+#include "OgreDataStream.h"
 #include "OgreException.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreIteratorWrappers.h"
@@ -54,6 +55,7 @@ namespace Ogre
 {
     bool Mesh::msOptimizeForShadowMapping = false;
     bool Mesh::msUseTimestampAsHash = false;
+    bool Mesh::msUseMemoryMappedFiles = true;
 
     //-----------------------------------------------------------------------
     Mesh::Mesh( ResourceManager *creator, const String &name, ResourceHandle handle, const String &group,
@@ -157,6 +159,25 @@ namespace Ogre
 
         mFreshFromDisk = ResourceGroupManager::getSingleton().openResource( mName, mGroup, true, this );
 
+        if( msUseMemoryMappedFiles && MappedFileDataStream::isSupported() )
+        {
+            FileStreamDataStream *fileStream =
+                dynamic_cast<FileStreamDataStream *>( mFreshFromDisk.get() );
+            if( fileStream && !fileStream->getFullPath().empty() )
+            {
+                try
+                {
+                    mFreshFromDisk = DataStreamPtr(
+                        OGRE_NEW MappedFileDataStream( mName, fileStream->getFullPath() ) );
+                    return;
+                }
+                catch( Exception & )
+                {
+                    // Fall back to prebuffering from the stream we already have open
+                }
+            }
+        }
+
         // fully prebuffer into host RAM
         mFreshFromDisk = DataStreamPtr( OGRE_NEW MemoryDataStream( mName, mFreshFromDisk ) );
     }
@@ -49,6 +49,10 @@ namespace Ogre
         mVersionData.push_back( OGRE_NEW MeshVersionData( MESH_VERSION_2_1, "[MeshSerializer_v2.1 R2]",
                                                           OGRE_NEW MeshSerializerImpl( vaoManager ) ) );
 
+        mVersionData.push_back( OGRE_NEW MeshVersionData(
+            MESH_VERSION_2_1_PACKED, "[MeshSerializer_v2.1 R2 Packed]",
+            OGRE_NEW MeshSerializerImpl_v2_1_Packed( vaoManager ) ) );
+
         // These formats will be removed on release
         mVersionData.push_back(
             OGRE_NEW MeshVersionData( MESH_VERSION_LEGACY, "[MeshSerializer_v2.1 R1]",
@@ -155,11 +159,13 @@ namespace Ogre
 
         // Find the implementation to use
         MeshSerializerImpl *impl = 0;
+        MeshVersion version = MESH_VERSION_LATEST;
         for( MeshVersionDataList::iterator i = mVersionData.begin(); i != mVersionData.end(); ++i )
         {
             if( ( *i )->versionString == ver )
             {
                 impl = ( *i )->impl;
+                version = ( *i )->version;
                 break;
             }
         }
@@ -175,7 +181,7 @@ namespace Ogre
         // Call implementation
         impl->importMesh( stream, pDest, mListener );
         // Warn on old version of mesh
-        if( ver != mVersionData[0]->versionString )
+        if( version == MESH_VERSION_LEGACY )
         {
             LogManager::getSingleton().logMessage(
                 "WARNING: " + pDest->getName() + " is an older format (" + ver +
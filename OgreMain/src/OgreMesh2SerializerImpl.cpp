@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreAnimation.h"
 #include "OgreAnimationTrack.h"
 #include "OgreBitwise.h"
+#include "OgreDataStream.h"
 #include "OgreDistanceLodStrategy.h"
 #include "OgreException.h"
 #include "OgreHardwareBufferManager.h"
@@ -61,7 +62,11 @@ namespace Ogre
     /// stream overhead = ID + size
     const long MSTREAM_OVERHEAD_SIZE = sizeof( uint16 ) + sizeof( uint32 );
     //---------------------------------------------------------------------
-    MeshSerializerImpl::MeshSerializerImpl( VaoManager *vaoManager ) : mVaoManager( vaoManager )
+    MeshSerializerImpl::MeshSerializerImpl( VaoManager *vaoManager ) :
+        mVaoManager( vaoManager ),
+        mStreamData( 0 ),
+        mZeroCopyVertexData( false ),
+        mZeroCopyIndexData( false )
     {
         // Version number
         mVersion = "[MeshSerializer_v2.1 R2]";
@@ -127,6 +132,22 @@ namespace Ogre
         // Determine endianness (must be the first thing we do!)
         determineEndianness( stream );
 
+        // If the whole file is already in memory and needs no conversion, vertex & index
+        // data get uploaded to the GPU from there instead of going through temporary copies.
+        mStreamData = 0;
+        if( !mFlipEndian )
+        {
+            if( MemoryDataStream *memStream = dynamic_cast<MemoryDataStream *>( stream.get() ) )
+                mStreamData = memStream->getPtr();
+            else if( MappedFileDataStream *mappedStream =
+                         dynamic_cast<MappedFileDataStream *>( stream.get() ) )
+            {
+                mStreamData = mappedStream->getPtr();
+            }
+        }
+        mZeroCopyVertexData = mStreamData && !pMesh->isVertexBufferShadowed();
+        mZeroCopyIndexData = mStreamData && !pMesh->isIndexBufferShadowed();
+
 #if OGRE_SERIALIZER_VALIDATE_CHUNKSIZE
         enableValidation();
 #endif
@@ -139,13 +160,24 @@ namespace Ogre
             streamID = readChunk( stream );
             switch( streamID )
             {
+            case M_PACKED_TABLE_OF_CONTENTS:
+                readPackedTableOfContents( stream );
+                break;
             case M_MESH:
                 readMesh( stream, pMesh, listener );
                 break;
+            case M_PACKED_DATA:
+                // The blobs were already accessed through the table of contents
+                stream->skip( static_cast<long>( mCurrentstreamLen - MSTREAM_OVERHEAD_SIZE ) );
+                break;
             }
         }
         popInnerChunk( stream );
 
+        mStreamData = 0;
+        mZeroCopyVertexData = false;
+        mZeroCopyIndexData = false;
+
         if( !pMesh->hasValidShadowMappingVaos() )
             pMesh->prepareForShadowMapping( false );
     }
@@ -388,25 +420,31 @@ namespace Ogre
                 ( indexBuffer && indexBuffer->getIndexType() == IndexBufferPacked::IT_32BIT );
             writeBools( &idx32bit, 1 );
 
-            // uint16* faceVertexIndices ((indexCount)
             AsyncTicketPtr asyncTicket = indexBuffer->readRequest( 0, indexCount );
-            const void *pIdx = asyncTicket->map();
-            if( idx32bit )
-            {
-                const uint32 *pIdx32 = static_cast<const uint32 *>( pIdx );
-                writeInts( pIdx32, indexCount );
-                addToHash( pIdx32, indexCount * sizeof( uint32 ) );
-            }
-            else
-            {
-                const uint16 *pIdx16 = static_cast<const uint16 *>( pIdx );
-                writeShorts( pIdx16, indexCount );
-                addToHash( pIdx16, indexCount * sizeof( uint16 ) );
-            }
+            writeIndexData( indexBuffer, asyncTicket->map() );
             asyncTicket->unmap();
         }
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeIndexData( const IndexBufferPacked *indexBuffer, const void *pIdx )
+    {
+        const uint32 indexCount = static_cast<uint32>( indexBuffer->getNumElements() );
+
+        // uint16* faceVertexIndices ((indexCount)
+        if( indexBuffer->getIndexType() == IndexBufferPacked::IT_32BIT )
+        {
+            const uint32 *pIdx32 = static_cast<const uint32 *>( pIdx );
+            writeInts( pIdx32, indexCount );
+            addToHash( pIdx32, indexCount * sizeof( uint32 ) );
+        }
+        else
+        {
+            const uint16 *pIdx16 = static_cast<const uint16 *>( pIdx );
+            writeShorts( pIdx16, indexCount );
+            addToHash( pIdx16, indexCount * sizeof( uint16 ) );
+        }
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::writeGeometry( const VertexBufferPackedVec &vertexData )
     {
         // Header
@@ -466,7 +504,7 @@ namespace Ogre
             for( uint8 i = 0; i < numSources; ++i )
             {
                 size_t size =
-                    MSTREAM_OVERHEAD_SIZE + ( sizeof( uint8 ) * 2 ) + vertexData[i]->getTotalSizeBytes();
+                    MSTREAM_OVERHEAD_SIZE + ( sizeof( uint8 ) * 2 ) + calcVertexDataSize( vertexData[i] );
 
                 pushInnerChunk( mStream );
                 writeChunkHeader( M_SUBMESH_M_GEOMETRY_VERTEX_BUFFER, size );
@@ -485,25 +523,7 @@ namespace Ogre
 
                 addToHash( data, vertexData[i]->getTotalSizeBytes() );
 
-                if( mFlipEndian )
-                {
-                    // endian conversion
-                    // Copy data
-                    unsigned char *tempData = OGRE_ALLOC_T(
-                        unsigned char, vertexData[i]->getTotalSizeBytes(), MEMCATEGORY_GEOMETRY );
-                    memcpy( tempData, data, vertexData[i]->getTotalSizeBytes() );
-
-                    flipLittleEndian( tempData, vertexData[i] );
-
-                    writeData( tempData, vertexData[i]->getBytesPerElement(),
-                               vertexData[i]->getNumElements() );
-                    OGRE_FREE( tempData, MEMCATEGORY_GEOMETRY );
-                }
-                else
-                {
-                    writeData( data, vertexData[i]->getBytesPerElement(),
-                               vertexData[i]->getNumElements() );
-                }
+                writeVertexData( vertexData[i], data );
 
                 asyncTicket->unmap();
 
@@ -514,6 +534,28 @@ namespace Ogre
         popInnerChunk( mStream );
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeVertexData( const VertexBufferPacked *vertexBuffer, const void *pData )
+    {
+        if( mFlipEndian )
+        {
+            // endian conversion
+            // Copy data
+            unsigned char *tempData =
+                OGRE_ALLOC_T( unsigned char, vertexBuffer->getTotalSizeBytes(), MEMCATEGORY_GEOMETRY );
+            memcpy( tempData, pData, vertexBuffer->getTotalSizeBytes() );
+
+            flipLittleEndian( tempData, vertexBuffer->getNumElements(),
+                              vertexBuffer->getBytesPerElement(), vertexBuffer->getVertexElements() );
+
+            writeData( tempData, vertexBuffer->getBytesPerElement(), vertexBuffer->getNumElements() );
+            OGRE_FREE( tempData, MEMCATEGORY_GEOMETRY );
+        }
+        else
+        {
+            writeData( pData, vertexBuffer->getBytesPerElement(), vertexBuffer->getNumElements() );
+        }
+    }
+    //---------------------------------------------------------------------
     size_t MeshSerializerImpl::calcSubMeshNameTableSize( const Mesh *pMesh )
     {
         size_t size = MSTREAM_OVERHEAD_SIZE;
@@ -556,6 +598,10 @@ namespace Ogre
             size += calcSkeletonLinkSize( pMesh->getSkeletonName() );
         }
 
+        // LOD thresholds
+        if( pMesh->mLodValues.size() > 1u )
+            size += calcLodLevelSize( pMesh );
+
         size += calcHashForCachesSize();
 
         size += calcBoundsInfoSize( pMesh );
@@ -624,7 +670,7 @@ namespace Ogre
             // bool indexes32bit
             size += sizeof( bool );
 
-            size += indexBuffer->getTotalSizeBytes();
+            size += calcIndexDataSize( indexBuffer );
         }
 
         if( !skipVertexBuffer )
@@ -645,6 +691,16 @@ namespace Ogre
         return MSTREAM_OVERHEAD_SIZE + sizeof( uint16 );
     }
     //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcIndexDataSize( const IndexBufferPacked *indexBuffer )
+    {
+        return indexBuffer->getTotalSizeBytes();
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcVertexDataSize( const VertexBufferPacked *vertexBuffer )
+    {
+        return vertexBuffer->getTotalSizeBytes();
+    }
+    //---------------------------------------------------------------------
     size_t MeshSerializerImpl::calcGeometrySize( const VertexBufferPackedVec &vertexData )
     {
         size_t size = MSTREAM_OVERHEAD_SIZE;
@@ -669,7 +725,7 @@ namespace Ogre
 
             while( itor != endt )
             {
-                size += ( *itor )->getTotalSizeBytes();
+                size += calcVertexDataSize( *itor );
                 ++itor;
             }
         }
@@ -892,27 +948,7 @@ namespace Ogre
         }
         catch( Exception & )
         {
-            SubMeshLodVec::iterator itor = totalSubmeshLods.begin();
-            SubMeshLodVec::iterator endt = totalSubmeshLods.end();
-
-            while( itor != endt )
-            {
-                Uint8Vec::iterator it = itor->vertexBuffers.begin();
-                Uint8Vec::iterator en = itor->vertexBuffers.end();
-
-                while( it != en )
-                    OGRE_FREE_SIMD( *it++, MEMCATEGORY_GEOMETRY );
-
-                itor->vertexBuffers.clear();
-
-                if( itor->indexData )
-                {
-                    OGRE_FREE_SIMD( itor->indexData, MEMCATEGORY_GEOMETRY );
-                    itor->indexData = 0;
-                }
-
-                ++itor;
-            }
+            freeSubMeshLods( totalSubmeshLods );
 
             // TODO: Delete created mVaos. Don't erase the data from those vaos?
 
@@ -948,7 +984,8 @@ namespace Ogre
 
                     if( !sm->mParent->isVertexBufferShadowed() )
                     {
-                        OGRE_FREE_SIMD( submeshLods[i].vertexBuffers[0], MEMCATEGORY_GEOMETRY );
+                        if( !subMeshLod.externalVertexData )
+                            OGRE_FREE_SIMD( submeshLods[i].vertexBuffers[0], MEMCATEGORY_GEOMETRY );
                         submeshLods[i].vertexBuffers.erase( submeshLods[i].vertexBuffers.begin() );
                     }
 
@@ -994,7 +1031,8 @@ namespace Ogre
 
                 if( !sm->mParent->isIndexBufferShadowed() )
                 {
-                    OGRE_FREE_SIMD( subMeshLod.indexData, MEMCATEGORY_GEOMETRY );
+                    if( !subMeshLod.externalIndexData )
+                        OGRE_FREE_SIMD( subMeshLod.indexData, MEMCATEGORY_GEOMETRY );
                     submeshLods[i].indexData = 0;
                 }
             }
@@ -1006,6 +1044,48 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::freeSubMeshLods( SubMeshLodVec &submeshLods )
+    {
+        SubMeshLodVec::iterator itor = submeshLods.begin();
+        SubMeshLodVec::iterator endt = submeshLods.end();
+
+        while( itor != endt )
+        {
+            if( !itor->externalVertexData )
+            {
+                Uint8Vec::iterator it = itor->vertexBuffers.begin();
+                Uint8Vec::iterator en = itor->vertexBuffers.end();
+
+                while( it != en )
+                    OGRE_FREE_SIMD( *it++, MEMCATEGORY_GEOMETRY );
+            }
+
+            itor->vertexBuffers.clear();
+
+            if( itor->indexData && !itor->externalIndexData )
+                OGRE_FREE_SIMD( itor->indexData, MEMCATEGORY_GEOMETRY );
+            itor->indexData = 0;
+
+            ++itor;
+        }
+    }
+    //---------------------------------------------------------------------
+    const uint8 *MeshSerializerImpl::readInPlace( DataStreamPtr &stream, size_t sizeBytes )
+    {
+        OGRE_ASSERT_LOW( mStreamData );
+
+        const size_t offset = stream->tell();
+        if( sizeBytes > stream->size() - offset )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                         "Unexpected end of file in " + stream->getName(),
+                         "MeshSerializerImpl::readInPlace" );
+        }
+
+        stream->skip( static_cast<long>( sizeBytes ) );
+        return mStreamData + offset;
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::readSubMeshLod( DataStreamPtr &stream, Mesh *pMesh, SubMeshLod *subLod,
                                              uint8 currentLod )
     {
@@ -1079,20 +1159,30 @@ namespace Ogre
         if( subLod->numIndices > 0 )
         {
             readBools( stream, &subLod->index32Bit, 1 );
-
-            if( subLod->index32Bit )
-            {
-                subLod->indexData =
-                    OGRE_MALLOC_SIMD( sizeof( uint32 ) * subLod->numIndices, MEMCATEGORY_GEOMETRY );
-                readInts( stream, reinterpret_cast<uint32 *>( subLod->indexData ), subLod->numIndices );
-            }
-            else
-            {
-                subLod->indexData =
-                    OGRE_MALLOC_SIMD( sizeof( uint16 ) * subLod->numIndices, MEMCATEGORY_GEOMETRY );
-                readShorts( stream, reinterpret_cast<uint16 *>( subLod->indexData ),
-                            subLod->numIndices );
-            }
+            readIndexData( stream, subLod );
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readIndexData( DataStreamPtr &stream, SubMeshLod *subLod )
+    {
+        if( mZeroCopyIndexData )
+        {
+            const size_t bytesPerIndex = subLod->index32Bit ? sizeof( uint32 ) : sizeof( uint16 );
+            subLod->indexData =
+                const_cast<uint8 *>( readInPlace( stream, bytesPerIndex * subLod->numIndices ) );
+            subLod->externalIndexData = true;
+        }
+        else if( subLod->index32Bit )
+        {
+            subLod->indexData =
+                OGRE_MALLOC_SIMD( sizeof( uint32 ) * subLod->numIndices, MEMCATEGORY_GEOMETRY );
+            readInts( stream, reinterpret_cast<uint32 *>( subLod->indexData ), subLod->numIndices );
+        }
+        else
+        {
+            subLod->indexData =
+                OGRE_MALLOC_SIMD( sizeof( uint16 ) * subLod->numIndices, MEMCATEGORY_GEOMETRY );
+            readShorts( stream, reinterpret_cast<uint16 *>( subLod->indexData ), subLod->numIndices );
         }
     }
     //---------------------------------------------------------------------
@@ -1187,6 +1277,21 @@ namespace Ogre
                          "MeshSerializerImpl::readVertexBuffer" );
         }
 
+        readVertexData( stream, subLod, source, bytesPerVertex );
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readVertexData( DataStreamPtr &stream, SubMeshLod *subLod, uint8 source,
+                                             size_t bytesPerVertex )
+    {
+        if( mZeroCopyVertexData )
+        {
+            // No endian conversion needed, VaoManager copies it straight to GPU memory
+            subLod->vertexBuffers[source] =
+                const_cast<uint8 *>( readInPlace( stream, bytesPerVertex * subLod->numVertices ) );
+            subLod->externalVertexData = true;
+            return;
+        }
+
         uint8 *vertexData = reinterpret_cast<uint8 *>( OGRE_MALLOC_SIMD(
             sizeof( uint8 ) * bytesPerVertex * subLod->numVertices, MEMCATEGORY_GEOMETRY ) );
         subLod->vertexBuffers[source] = vertexData;
@@ -1194,7 +1299,15 @@ namespace Ogre
         stream->read( vertexData, bytesPerVertex * subLod->numVertices );
 
         // Endian conversion
-        flipLittleEndian( vertexData, subLod->numVertices, bytesPerVertex, vertexElements );
+        flipLittleEndian( vertexData, subLod->numVertices, bytesPerVertex,
+                          subLod->vertexDeclarations[source] );
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readPackedTableOfContents( DataStreamPtr &stream )
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                     "Packed data found in a mesh that isn't in the packed format: " + stream->getName(),
+                     "MeshSerializerImpl::readPackedTableOfContents" );
     }
     //---------------------------------------------------------------------
     void MeshSerializerImpl::readSubMeshLodOperation( DataStreamPtr &stream, SubMeshLod *subLod )
@@ -2287,8 +2400,328 @@ edgeData->triangleFaceNormals.begin(); for ( ; t != edgeData->triangles.end(); +
         lodSource( 0 ),
         index32Bit( false ),
         numIndices( 0 ),
-        indexData( 0 )
+        indexData( 0 ),
+        operationType( OT_TRIANGLE_LIST ),
+        externalVertexData( false ),
+        externalIndexData( false )
+    {
+    }
+
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v2_1_Packed::MeshSerializerImpl_v2_1_Packed( VaoManager *vaoManager,
+                                                                    uint32 alignment ) :
+        MeshSerializerImpl( vaoManager ),
+        mAlignment( alignment ),
+        mBlobsDataSize( 0 ),
+        mBlobsStart( 0 )
+    {
+        OGRE_ASSERT_LOW( alignment > 0u );
+
+        // Version number
+        mVersion = "[MeshSerializer_v2.1 R2 Packed]";
+    }
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v2_1_Packed::~MeshSerializerImpl_v2_1_Packed() {}
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::writeMesh( const Mesh *pMesh )
+    {
+        collectBlobs( pMesh );
+
+        writePackedTableOfContents();
+        MeshSerializerImpl::writeMesh( pMesh );
+        writePackedData();
+
+        mBlobs.clear();
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::collectBlobs( const Mesh *pMesh )
+    {
+        mBlobs.clear();
+        mBlobsDataSize = 0;
+
+        const uint8 numVaoPasses = pMesh->hasIndependentShadowMappingVaos() + 1;
+
+        for( unsigned i = 0; i < pMesh->getNumSubMeshes(); ++i )
+        {
+            const SubMesh *s = pMesh->getSubMesh( i );
+
+            // Same order writeSubMesh follows, so that the blobs of
+            // a submesh (and its LODs) end up next to each other.
+            for( uint8 pass = 0; pass < numVaoPasses; ++pass )
+            {
+                VertexArrayObjectArray::const_iterator itor = s->mVao[pass].begin();
+                VertexArrayObjectArray::const_iterator endt = s->mVao[pass].end();
+
+                while( itor != endt )
+                {
+                    const VertexArrayObject *vao = *itor;
+
+                    if( vao->getIndexBuffer() && vao->getIndexBuffer()->getNumElements() > 0u )
+                        addBlob( vao->getIndexBuffer() );
+
+                    const VertexBufferPackedVec &vertexBuffers = vao->getVertexBuffers();
+                    VertexBufferPackedVec::const_iterator itBuf = vertexBuffers.begin();
+                    VertexBufferPackedVec::const_iterator enBuf = vertexBuffers.end();
+
+                    while( itBuf != enBuf )
+                        addBlob( *itBuf++ );
+
+                    ++itor;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::addBlob( BufferPacked *buffer )
+    {
+        PackedBlobVec::const_iterator itor = mBlobs.begin();
+        PackedBlobVec::const_iterator endt = mBlobs.end();
+
+        while( itor != endt && itor->buffer != buffer )
+            ++itor;
+
+        if( itor == endt )
+        {
+            PackedBlob blob;
+            blob.offset = alignToNextMultiple<uint64>( mBlobsDataSize, mAlignment );
+            blob.size = buffer->getTotalSizeBytes();
+            blob.buffer = buffer;
+            mBlobs.push_back( blob );
+
+            mBlobsDataSize = blob.offset + blob.size;
+        }
+    }
+    //---------------------------------------------------------------------
+    uint32 MeshSerializerImpl_v2_1_Packed::findBlob( const BufferPacked *buffer ) const
+    {
+        PackedBlobVec::const_iterator itor = mBlobs.begin();
+        PackedBlobVec::const_iterator endt = mBlobs.end();
+
+        while( itor != endt && itor->buffer != buffer )
+            ++itor;
+
+        OGRE_ASSERT_LOW( itor != endt && "Buffer wasn't collected by collectBlobs!" );
+
+        return static_cast<uint32>( itor - mBlobs.begin() );
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::writePackedTableOfContents()
+    {
+        const uint32 numBlobs = static_cast<uint32>( mBlobs.size() );
+
+        writeChunkHeader( M_PACKED_TABLE_OF_CONTENTS,
+                          MSTREAM_OVERHEAD_SIZE + sizeof( uint32 ) * 2u + sizeof( uint64 ) +
+                              numBlobs * sizeof( uint64 ) * 2u );
+
+        writeInts( &mAlignment, 1 );
+        writeInts64( &mBlobsDataSize, 1 );
+        writeInts( &numBlobs, 1 );
+
+        PackedBlobVec::const_iterator itor = mBlobs.begin();
+        PackedBlobVec::const_iterator endt = mBlobs.end();
+
+        while( itor != endt )
+        {
+            writeInts64( &itor->offset, 1 );
+            writeInts64( &itor->size, 1 );
+            ++itor;
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::writePackedData()
+    {
+        const size_t chunkStart = mStream->tell();
+        const size_t firstBlob =
+            alignToNextMultiple<size_t>( chunkStart + MSTREAM_OVERHEAD_SIZE, mAlignment );
+        const uint64 chunkSize = ( firstBlob - chunkStart ) + mBlobsDataSize;
+
+        if( chunkSize > std::numeric_limits<uint32>::max() )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                         "Mesh is too big for the packed format. Vertex and index buffers must add up "
+                         "to less than 4GB",
+                         "MeshSerializerImpl_v2_1_Packed::writePackedData" );
+        }
+
+        writeChunkHeader( M_PACKED_DATA, static_cast<size_t>( chunkSize ) );
+        writePadding( firstBlob - chunkStart - MSTREAM_OVERHEAD_SIZE );
+
+        uint64 blobsWritten = 0;
+
+        PackedBlobVec::const_iterator itor = mBlobs.begin();
+        PackedBlobVec::const_iterator endt = mBlobs.end();
+
+        while( itor != endt )
+        {
+            writePadding( static_cast<size_t>( itor->offset - blobsWritten ) );
+
+            BufferPacked *buffer = itor->buffer;
+            AsyncTicketPtr asyncTicket = buffer->readRequest( 0, buffer->getNumElements() );
+            const void *data = asyncTicket->map();
+
+            if( buffer->getBufferPackedType() == BP_TYPE_INDEX )
+            {
+                // writeInts & writeShorts already take care of endianness
+                if( buffer->getBytesPerElement() == sizeof( uint32 ) )
+                {
+                    writeInts( static_cast<const uint32 *>( data ), buffer->getNumElements() );
+                }
+                else
+                {
+                    writeShorts( static_cast<const uint16 *>( data ), buffer->getNumElements() );
+                }
+            }
+            else
+            {
+                MeshSerializerImpl::writeVertexData( static_cast<VertexBufferPacked *>( buffer ),
+                                                     data );
+            }
+
+            asyncTicket->unmap();
+
+            blobsWritten = itor->offset + itor->size;
+            ++itor;
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::writePadding( size_t numBytes )
+    {
+        const uint8 zeroes[64] = {};
+        while( numBytes > 0u )
+        {
+            const size_t bytesToWrite = std::min( numBytes, sizeof( zeroes ) );
+            writeData( zeroes, 1u, bytesToWrite );
+            numBytes -= bytesToWrite;
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::writeIndexData( const IndexBufferPacked *indexBuffer,
+                                                         const void *pIdx )
+    {
+        addToHash( pIdx, indexBuffer->getTotalSizeBytes() );
+
+        const uint32 blobIdx = findBlob( indexBuffer );
+        writeInts( &blobIdx, 1 );
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::writeVertexData( const VertexBufferPacked *vertexBuffer,
+                                                          const void * )
+    {
+        const uint32 blobIdx = findBlob( vertexBuffer );
+        writeInts( &blobIdx, 1 );
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v2_1_Packed::calcIndexDataSize( const IndexBufferPacked * )
     {
+        return sizeof( uint32 );
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v2_1_Packed::calcVertexDataSize( const VertexBufferPacked * )
+    {
+        return sizeof( uint32 );
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::readPackedTableOfContents( DataStreamPtr &stream )
+    {
+        uint32 numBlobs = 0;
+        readInts( stream, &mAlignment, 1 );
+        readInts64( stream, &mBlobsDataSize, 1 );
+        readInts( stream, &numBlobs, 1 );
+
+        if( mBlobsDataSize > stream->size() )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                         "Packed data is bigger than the file. Is it truncated? " + stream->getName(),
+                         "MeshSerializerImpl_v2_1_Packed::readPackedTableOfContents" );
+        }
+
+        // The blobs are always at the end of the file
+        mBlobsStart = stream->size() - mBlobsDataSize;
+
+        mBlobs.clear();
+        mBlobs.resize( numBlobs );
+
+        PackedBlobVec::iterator itor = mBlobs.begin();
+        PackedBlobVec::iterator endt = mBlobs.end();
+
+        while( itor != endt )
+        {
+            readInts64( stream, &itor->offset, 1 );
+            readInts64( stream, &itor->size, 1 );
+            itor->buffer = 0;
+
+            if( itor->offset + itor->size > mBlobsDataSize )
+            {
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                             "Packed data table of contents is corrupt in " + stream->getName(),
+                             "MeshSerializerImpl_v2_1_Packed::readPackedTableOfContents" );
+            }
+            ++itor;
+        }
+    }
+    //---------------------------------------------------------------------
+    uint8 *MeshSerializerImpl_v2_1_Packed::readBlob( DataStreamPtr &stream, uint32 blobIdx,
+                                                     size_t sizeBytes, bool zeroCopy, bool &outExternal )
+    {
+        if( blobIdx >= mBlobs.size() || mBlobs[blobIdx].size != sizeBytes )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                         "Invalid blob reference in " + stream->getName() +
+                             ". Missing table of contents or corrupt file",
+                         "MeshSerializerImpl_v2_1_Packed::readBlob" );
+        }
+
+        const size_t blobStart = static_cast<size_t>( mBlobsStart + mBlobs[blobIdx].offset );
+
+        if( zeroCopy )
+        {
+            outExternal = true;
+            return const_cast<uint8 *>( mStreamData + blobStart );
+        }
+
+        outExternal = false;
+        uint8 *data =
+            reinterpret_cast<uint8 *>( OGRE_MALLOC_SIMD( sizeBytes, MEMCATEGORY_GEOMETRY ) );
+
+        const size_t currentPos = stream->tell();
+        stream->seek( blobStart );
+        stream->read( data, sizeBytes );
+        stream->seek( currentPos );
+
+        return data;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::readIndexData( DataStreamPtr &stream, SubMeshLod *subLod )
+    {
+        uint32 blobIdx = 0;
+        readInts( stream, &blobIdx, 1 );
+
+        const size_t bytesPerIndex = subLod->index32Bit ? sizeof( uint32 ) : sizeof( uint16 );
+        subLod->indexData = readBlob( stream, blobIdx, bytesPerIndex * subLod->numIndices,
+                                      mZeroCopyIndexData, subLod->externalIndexData );
+
+        if( !subLod->externalIndexData )
+            flipFromLittleEndian( subLod->indexData, bytesPerIndex, subLod->numIndices );
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v2_1_Packed::readVertexData( DataStreamPtr &stream, SubMeshLod *subLod,
+                                                         uint8 source, size_t bytesPerVertex )
+    {
+        uint32 blobIdx = 0;
+        readInts( stream, &blobIdx, 1 );
+
+        subLod->vertexBuffers[source] =
+            readBlob( stream, blobIdx, bytesPerVertex * subLod->numVertices, mZeroCopyVertexData,
+                      subLod->externalVertexData );
+
+        if( !subLod->externalVertexData )
+        {
+            flipLittleEndian( subLod->vertexBuffers[source], subLod->numVertices, bytesPerVertex,
+                              subLod->vertexDeclarations[source] );
+        }
     }
 
     //---------------------------------------------------------------------
@@ -2351,27 +2784,7 @@ edgeData->triangleFaceNormals.begin(); for ( ; t != edgeData->triangles.end(); +
         }
         catch( Exception & )
         {
-            SubMeshLodVec::iterator itor = totalSubmeshLods.begin();
-            SubMeshLodVec::iterator endt = totalSubmeshLods.end();
-
-            while( itor != endt )
-            {
-                Uint8Vec::iterator it = itor->vertexBuffers.begin();
-                Uint8Vec::iterator en = itor->vertexBuffers.end();
-
-                while( it != en )
-                    OGRE_FREE_SIMD( *it++, MEMCATEGORY_GEOMETRY );
-
-                itor->vertexBuffers.clear();
-
-                if( itor->indexData )
-                {
-                    OGRE_FREE_SIMD( itor->indexData, MEMCATEGORY_GEOMETRY );
-                    itor->indexData = 0;
-                }
-
-                ++itor;
-            }
+            freeSubMeshLods( totalSubmeshLods );
 
             // TODO: Delete created mVaos. Don't erase the data from those vaos?
 
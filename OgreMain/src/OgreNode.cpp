@@ -394,11 +394,30 @@ namespace Ogre
 #endif
     }
     //-----------------------------------------------------------------------
-    void Node::updateAllTransforms( const size_t numNodes, Transform t )
+    void Node::updateAllTransforms( const size_t numNodes, Transform t, bool bSkipClean )
     {
         ArrayMatrix4 derivedTransform;
         for( size_t i = 0; i < numNodes; i += ARRAY_PACKED_REALS )
         {
+            if( bSkipClean )
+            {
+                // Inherit the parent's dirtiness so our children (next depth level) see it.
+                // Clean slots in a dirty block get updated too, but produce the same result.
+                uint8 dirty = 0u;
+                for( size_t j = 0; j < ARRAY_PACKED_REALS; ++j )
+                {
+                    const Transform &parentTransform = t.mParents[j]->mTransform;
+                    t.mDirty[j] |= parentTransform.mDirty[parentTransform.mIndex];
+                    dirty |= t.mDirty[j];
+                }
+
+                if( !dirty )
+                {
+                    t.advancePack();
+                    continue;
+                }
+            }
+
 #if OGRE_NODE_INHERIT_TRANSFORM
             // determine our transform, without parent part
             ArrayMatrix4 trSoA;
@@ -571,6 +590,7 @@ namespace Ogre
         assert( !q.isNaN() && "Invalid orientation supplied as parameter" );
         q.normalise();
         mTransform.mOrientation->setFromQuaternion( q, mTransform.mIndex );
+        mTransform.mDirty[mTransform.mIndex] = 1u;
         CACHED_TRANSFORM_OUT_OF_DATE();
     }
     //-----------------------------------------------------------------------
@@ -582,6 +602,7 @@ namespace Ogre
     void Node::resetOrientation()
     {
         mTransform.mOrientation->setFromQuaternion( Quaternion::IDENTITY, mTransform.mIndex );
+        mTransform.mDirty[mTransform.mIndex] = 1u;
     }
 
     //-----------------------------------------------------------------------
@@ -589,6 +610,7 @@ namespace Ogre
     {
         assert( !pos.isNaN() && "Invalid vector supplied as parameter" );
         mTransform.mPosition->setFromVector3( pos, mTransform.mIndex );
+        mTransform.mDirty[mTransform.mIndex] = 1u;
         CACHED_TRANSFORM_OUT_OF_DATE();
     }
     //-----------------------------------------------------------------------
@@ -645,6 +667,7 @@ namespace Ogre
         }
 
         mTransform.mPosition->setFromVector3( position, mTransform.mIndex );
+        mTransform.mDirty[mTransform.mIndex] = 1u;
         CACHED_TRANSFORM_OUT_OF_DATE();
     }
     //-----------------------------------------------------------------------
@@ -715,6 +738,7 @@ namespace Ogre
         orientation.normalise();
 
         mTransform.mOrientation->setFromQuaternion( orientation, mTransform.mIndex );
+        mTransform.mDirty[mTransform.mIndex] = 1u;
         CACHED_TRANSFORM_OUT_OF_DATE();
     }
 
@@ -851,6 +875,7 @@ namespace Ogre
     {
         assert( !inScale.isNaN() && "Invalid vector supplied as parameter" );
         mTransform.mScale->setFromVector3( inScale, mTransform.mIndex );
+        mTransform.mDirty[mTransform.mIndex] = 1u;
         CACHED_TRANSFORM_OUT_OF_DATE();
     }
     //-----------------------------------------------------------------------
@@ -861,6 +886,7 @@ namespace Ogre
     void Node::setInheritOrientation( bool inherit )
     {
         mTransform.mInheritOrientation[mTransform.mIndex] = inherit;
+        mTransform.mDirty[mTransform.mIndex] = 1u;
         CACHED_TRANSFORM_OUT_OF_DATE();
     }
     //-----------------------------------------------------------------------
@@ -872,6 +898,7 @@ namespace Ogre
     void Node::setInheritScale( bool inherit )
     {
         mTransform.mInheritScale[mTransform.mIndex] = inherit;
+        mTransform.mDirty[mTransform.mIndex] = 1u;
         CACHED_TRANSFORM_OUT_OF_DATE();
     }
     //-----------------------------------------------------------------------
@@ -881,6 +908,7 @@ namespace Ogre
     {
         mTransform.mScale->setFromVector3(
             mTransform.mScale->getAsVector3( mTransform.mIndex ) * inScale, mTransform.mIndex );
+        mTransform.mDirty[mTransform.mIndex] = 1u;
         CACHED_TRANSFORM_OUT_OF_DATE();
     }
     //-----------------------------------------------------------------------
@@ -206,6 +206,18 @@ namespace Ogre
 
         texture->notifyDataIsReady();
     }
+    //-----------------------------------------------------------------------------------
+    ObjCmdBuffer::NotifyMipLevelReady::NotifyMipLevelReady( TextureGpu *_textureGpu,
+                                                            uint8 _mipLevel ) :
+        texture( _textureGpu ),
+        mipLevel( _mipLevel )
+    {
+    }
+    //-----------------------------------------------------------------------------------
+    void ObjCmdBuffer::NotifyMipLevelReady::execute()
+    {
+        texture->_notifyMipLevelReady( mipLevel );
+    }
 #ifdef OGRE_PROFILING_TEXTURES
     //-----------------------------------------------------------------------------------
     ObjCmdBuffer::LogProfilingData::LogProfilingData( TextureGpu *_textureGpu, uint32 _dstSliceOrDepth,
@@ -44,6 +44,12 @@ namespace Ogre {
 #if __OGRE_HAVE_SSE
     extern OptimisedUtil* _getOptimisedUtilSSE();
 #endif
+#if __OGRE_HAVE_SSE && __OGRE_HAVE_AVX2_DISPATCH
+    extern OptimisedUtil* _getOptimisedUtilAVX2();
+
+    static const uint sAvx2Features =
+        PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA;
+#endif
 #if __OGRE_HAVE_DIRECTXMATH
     extern OptimisedUtil* _getOptimisedUtilDirectXMath();
 #endif
@@ -82,6 +88,9 @@ namespace Ogre {
             IMPL_DEFAULT,
 #if __OGRE_HAVE_SSE
             IMPL_SSE,
+#endif
+#if __OGRE_HAVE_SSE && __OGRE_HAVE_AVX2_DISPATCH
+            IMPL_AVX2,
 #endif
             IMPL_COUNT
         };
@@ -129,6 +138,12 @@ namespace Ogre {
             {
                 mOptimisedUtils.push_back(_getOptimisedUtilSSE());
             }
+#endif
+#if __OGRE_HAVE_SSE && __OGRE_HAVE_AVX2_DISPATCH
+            if ((PlatformInformation::getCpuFeatures() & sAvx2Features) == sAvx2Features)
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX2());
+            }
 #endif
         }
 
@@ -383,6 +398,15 @@ namespace Ogre {
 
 #else   // !__DO_PROFILE__
 
+#if __OGRE_HAVE_SSE && __OGRE_HAVE_AVX2_DISPATCH
+        // The AVX2 implementation is compiled with per-function target attributes,
+        // so it's only safe to pick it once the CPU (and OS) reported support.
+        if ((PlatformInformation::getCpuFeatures() & sAvx2Features) == sAvx2Features)
+        {
+            return _getOptimisedUtilAVX2();
+        }
+        else
+#endif
 #if __OGRE_HAVE_SSE
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
@@ -400,5 +424,19 @@ namespace Ogre {
 
 #endif  // __DO_PROFILE__
     }
+    //---------------------------------------------------------------------
+    OptimisedUtil* OptimisedUtil::_getGeneralImplementation()
+    {
+        return _getOptimisedUtilGeneral();
+    }
+    //---------------------------------------------------------------------
+    OptimisedUtil* OptimisedUtil::_getAvx2Implementation()
+    {
+#if __OGRE_HAVE_SSE && __OGRE_HAVE_AVX2_DISPATCH
+        if ((PlatformInformation::getCpuFeatures() & sAvx2Features) == sAvx2Features)
+            return _getOptimisedUtilAVX2();
+#endif
+        return 0;
+    }
 
 }
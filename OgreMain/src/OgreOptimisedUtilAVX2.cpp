@@ -0,0 +1,349 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+
+#if __OGRE_HAVE_SSE && __OGRE_HAVE_AVX2_DISPATCH
+
+#include "OgreMatrix4.h"
+
+#include <immintrin.h>
+
+// Unlike OgreOptimisedUtilSSE.cpp, this file is NOT compiled with AVX enabled.
+// Every function that touches 256-bit registers is tagged with
+// _OGRE_AVX2_TARGET_ATTRIBUTE and is only reached after OptimisedUtil
+// checked PlatformInformation, so the same binary still runs on SSE2-only CPUs.
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilSSE();
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 + FMA implementation of OptimisedUtil.
+    @remarks
+        Only overrides the routines that benefit from the wider registers;
+        everything else is forwarded to the SSE implementation.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 final : public OptimisedUtil
+    {
+    protected:
+        OptimisedUtil *mFallback;
+
+    public:
+        OptimisedUtilAVX2( OptimisedUtil *fallback ) : mFallback( fallback ) {}
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        void softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals) override
+        {
+            mFallback->softwareVertexMorph( t, srcPos1, srcPos2, dstPos, pos1VSize, pos2VSize,
+                                            dstVSize, numVertices, morphNormals );
+        }
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        void concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        void calculateFaceNormals(
+            const float *positions,
+            const v1::EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles) override
+        {
+            mFallback->calculateFaceNormals( positions, triangles, faceNormals, numTriangles );
+        }
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces) override
+        {
+            mFallback->calculateLightFacing( lightPos, faceNormals, lightFacings, numFaces );
+        }
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices) override
+        {
+            mFallback->extrudeVertices( lightPos, extrudeDist, srcPositions, destPositions,
+                                        numVertices );
+        }
+    };
+    //---------------------------------------------------------------------
+    // Two vertices are processed at a time: the low 128-bit lane belongs to the
+    // first one and the high lane to the second one.
+    static inline _OGRE_AVX2_TARGET_ATTRIBUTE __m256 _loadRowPair( const Matrix4 &a,
+                                                                   const Matrix4 &b, size_t row )
+    {
+        return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( a[row] ) ),
+                                     _mm_loadu_ps( b[row] ), 1 );
+    }
+    //---------------------------------------------------------------------
+    /// Returns (r0.v, r1.v, r2.v, r2.v) for each lane, i.e. a 3x4 matrix * vector4.
+    static inline _OGRE_AVX2_TARGET_ATTRIBUTE __m256 _transformPair( __m256 r0, __m256 r1,
+                                                                     __m256 r2, __m256 v )
+    {
+        const __m256 xy = _mm256_hadd_ps( _mm256_mul_ps( r0, v ), _mm256_mul_ps( r1, v ) );
+        __m256 zz = _mm256_mul_ps( r2, v );
+        zz = _mm256_hadd_ps( zz, zz );
+        return _mm256_hadd_ps( xy, zz );
+    }
+    //---------------------------------------------------------------------
+    /// Same as Vector3::normalise on each lane; vectors of zero length are left untouched.
+    static inline _OGRE_AVX2_TARGET_ATTRIBUTE __m256 _normalisePair( __m256 v )
+    {
+        const __m256 sqLength = _mm256_dp_ps( v, v, 0x77 );
+        const __m256 isValid = _mm256_cmp_ps( sqLength, _mm256_set1_ps( 1e-08f * 1e-08f ),
+                                              _CMP_GT_OQ );
+        const __m256 normalised = _mm256_div_ps( v, _mm256_sqrt_ps( sqLength ) );
+        return _mm256_blendv_ps( v, normalised, isValid );
+    }
+    //---------------------------------------------------------------------
+    static _OGRE_AVX2_TARGET_ATTRIBUTE void softwareVertexSkinning_AVX2(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        OGRE_ALIGNED_DECL( float, results[8], 32 );
+
+        for( size_t i = 0; i < numVertices; i += 2u )
+        {
+            // If there's an odd number of vertices, the last one goes in both lanes
+            const bool bHasSecond = i + 1u < numVertices;
+
+            const float *pSrcPos1 = pSrcPos;
+            const float *pSrcNorm1 = pSrcNorm;
+            const float *pBlendWeight1 = pBlendWeight;
+            const unsigned char *pBlendIndex1 = pBlendIndex;
+            if( bHasSecond )
+            {
+                advanceRawPointer( pSrcPos1, srcPosStride );
+                advanceRawPointer( pBlendWeight1, blendWeightStride );
+                advanceRawPointer( pBlendIndex1, blendIndexStride );
+                if( pSrcNorm )
+                    advanceRawPointer( pSrcNorm1, srcNormStride );
+            }
+
+            // Blend the matrices of both vertices
+            __m256 r0 = _mm256_setzero_ps();
+            __m256 r1 = _mm256_setzero_ps();
+            __m256 r2 = _mm256_setzero_ps();
+            for( size_t j = 0; j < numWeightsPerVertex; ++j )
+            {
+                const Matrix4 &mat0 = *blendMatrices[pBlendIndex[j]];
+                const Matrix4 &mat1 = *blendMatrices[pBlendIndex1[j]];
+                const __m256 weight =
+                    _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_set1_ps( pBlendWeight[j] ) ),
+                                          _mm_set1_ps( pBlendWeight1[j] ), 1 );
+                r0 = _mm256_fmadd_ps( _loadRowPair( mat0, mat1, 0 ), weight, r0 );
+                r1 = _mm256_fmadd_ps( _loadRowPair( mat0, mat1, 1 ), weight, r1 );
+                r2 = _mm256_fmadd_ps( _loadRowPair( mat0, mat1, 2 ), weight, r2 );
+            }
+
+            const __m256 srcPos = _mm256_setr_ps( pSrcPos[0], pSrcPos[1], pSrcPos[2], 1.0f,
+                                                  pSrcPos1[0], pSrcPos1[1], pSrcPos1[2], 1.0f );
+            _mm256_store_ps( results, _transformPair( r0, r1, r2, srcPos ) );
+
+            pDestPos[0] = results[0];
+            pDestPos[1] = results[1];
+            pDestPos[2] = results[2];
+            advanceRawPointer( pDestPos, destPosStride );
+            if( bHasSecond )
+            {
+                pDestPos[0] = results[4];
+                pDestPos[1] = results[5];
+                pDestPos[2] = results[6];
+                advanceRawPointer( pDestPos, destPosStride );
+            }
+
+            if( pSrcNorm )
+            {
+                // We're assuming the 3x3 part of the matrix is orthogonal
+                // (no non-uniform scaling), see OptimisedUtilGeneral
+                const __m256 srcNorm =
+                    _mm256_setr_ps( pSrcNorm[0], pSrcNorm[1], pSrcNorm[2], 0.0f,
+                                    pSrcNorm1[0], pSrcNorm1[1], pSrcNorm1[2], 0.0f );
+                _mm256_store_ps( results,
+                                 _normalisePair( _transformPair( r0, r1, r2, srcNorm ) ) );
+
+                pDestNorm[0] = results[0];
+                pDestNorm[1] = results[1];
+                pDestNorm[2] = results[2];
+                advanceRawPointer( pDestNorm, destNormStride );
+                if( bHasSecond )
+                {
+                    pDestNorm[0] = results[4];
+                    pDestNorm[1] = results[5];
+                    pDestNorm[2] = results[6];
+                    advanceRawPointer( pDestNorm, destNormStride );
+                }
+
+                pSrcNorm = pSrcNorm1;
+                advanceRawPointer( pSrcNorm, srcNormStride );
+            }
+
+            pSrcPos = pSrcPos1;
+            pBlendWeight = pBlendWeight1;
+            pBlendIndex = pBlendIndex1;
+            advanceRawPointer( pSrcPos, srcPosStride );
+            advanceRawPointer( pBlendWeight, blendWeightStride );
+            advanceRawPointer( pBlendIndex, blendIndexStride );
+        }
+
+        // Avoid the AVX -> SSE transition penalty in the caller
+        _mm256_zeroupper();
+    }
+    //---------------------------------------------------------------------
+    static _OGRE_AVX2_TARGET_ATTRIBUTE void concatenateAffineMatrices_AVX2(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        const Matrix4 &m = baseMatrix;
+
+        // Rows 0 & 1 of the result are computed in one register, rows 2 & 3 in another.
+        // d[i] = m[i][0] * s[0] + m[i][1] * s[1] + m[i][2] * s[2] + (0, 0, 0, m[i][3])
+        const __m256 c0_01 = _mm256_setr_ps( m[0][0], m[0][0], m[0][0], m[0][0],
+                                             m[1][0], m[1][0], m[1][0], m[1][0] );
+        const __m256 c1_01 = _mm256_setr_ps( m[0][1], m[0][1], m[0][1], m[0][1],
+                                             m[1][1], m[1][1], m[1][1], m[1][1] );
+        const __m256 c2_01 = _mm256_setr_ps( m[0][2], m[0][2], m[0][2], m[0][2],
+                                             m[1][2], m[1][2], m[1][2], m[1][2] );
+        const __m256 c3_01 = _mm256_setr_ps( 0, 0, 0, m[0][3], 0, 0, 0, m[1][3] );
+
+        const __m256 c0_23 = _mm256_setr_ps( m[2][0], m[2][0], m[2][0], m[2][0], 0, 0, 0, 0 );
+        const __m256 c1_23 = _mm256_setr_ps( m[2][1], m[2][1], m[2][1], m[2][1], 0, 0, 0, 0 );
+        const __m256 c2_23 = _mm256_setr_ps( m[2][2], m[2][2], m[2][2], m[2][2], 0, 0, 0, 0 );
+        const __m256 c3_23 = _mm256_setr_ps( 0, 0, 0, m[2][3], 0, 0, 0, 1 );
+
+        for( size_t i = 0; i < numMatrices; ++i )
+        {
+            const Matrix4 &s = *pSrcMat;
+            float *RESTRICT_ALIAS d = (*pDstMat)[0];
+
+            const __m256 s0 = _mm256_broadcast_ps( reinterpret_cast<const __m128 *>( s[0] ) );
+            const __m256 s1 = _mm256_broadcast_ps( reinterpret_cast<const __m128 *>( s[1] ) );
+            const __m256 s2 = _mm256_broadcast_ps( reinterpret_cast<const __m128 *>( s[2] ) );
+
+            __m256 d01 = _mm256_fmadd_ps( c2_01, s2, c3_01 );
+            d01 = _mm256_fmadd_ps( c1_01, s1, d01 );
+            d01 = _mm256_fmadd_ps( c0_01, s0, d01 );
+
+            __m256 d23 = _mm256_fmadd_ps( c2_23, s2, c3_23 );
+            d23 = _mm256_fmadd_ps( c1_23, s1, d23 );
+            d23 = _mm256_fmadd_ps( c0_23, s0, d23 );
+
+            _mm256_storeu_ps( d, d01 );
+            _mm256_storeu_ps( d + 8, d23 );
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+
+        _mm256_zeroupper();
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        softwareVertexSkinning_AVX2( pSrcPos, pDestPos, pSrcNorm, pDestNorm, pBlendWeight,
+                                     pBlendIndex, blendMatrices, srcPosStride, destPosStride,
+                                     srcNormStride, destNormStride, blendWeightStride,
+                                     blendIndexStride, numWeightsPerVertex, numVertices );
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        concatenateAffineMatrices_AVX2( baseMatrix, pSrcMat, pDstMat, numMatrices );
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX2()
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2( _getOptimisedUtilSSE() );
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // __OGRE_HAVE_SSE && __OGRE_HAVE_AVX2_DISPATCH
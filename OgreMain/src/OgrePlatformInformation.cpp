@@ -210,6 +210,27 @@ namespace Ogre {
 #pragma warning(pop)
 #endif
 
+    //---------------------------------------------------------------------
+    // Reads the XCR0 register, which tells which register states the OS saves on
+    // context switches. Must only be called if CPUID reports OSXSAVE.
+    static uint64 _performXgetbv()
+    {
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC
+    #if _MSC_VER >= 1600
+        return _xgetbv( 0 );
+    #else
+        return 0;
+    #endif
+#elif (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+        uint32 eax, edx;
+        // xgetbv opcode; older assemblers don't know the mnemonic
+        __asm__ __volatile__( ".byte 0x0f, 0x01, 0xd0" : "=a"( eax ), "=d"( edx ) : "c"( 0 ) );
+        return ( static_cast<uint64>( edx ) << 32u ) | eax;
+#else
+        return 0;
+#endif
+    }
+
     //---------------------------------------------------------------------
     // Detect whether or not os support Streaming SIMD Extension.
 #if (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG)
@@ -302,6 +323,16 @@ namespace Ogre {
 #define CPUID_EXT_FAMILY_ID_MASK    0x0F00000   // EAX[23:20] - Bit 23 thru 20 contains extended family processor id
 #define CPUID_PENTIUM4_ID           0x0F00      // Pentium 4 family processor id
 
+#define CPUID_STD_FMA               (1<<12)     // ECX[12]
+#define CPUID_STD_OSXSAVE           (1<<27)     // ECX[27] - OS uses XSAVE/XRSTOR, XGETBV is available
+#define CPUID_STD_AVX               (1<<28)     // ECX[28]
+
+#define CPUID_STD7_AVX2             (1<<5)      // EBX[5] of function 7
+#define CPUID_STD7_AVX512F          (1<<16)     // EBX[16] of function 7
+
+#define XCR0_XMM_YMM                0x06        // SSE & AVX state
+#define XCR0_OPMASK_ZMM             0xE0        // AVX-512 state
+
 #define CPUID_EXT_3DNOW             (1u<<31u)
 #define CPUID_EXT_AMD_3DNOWEXT      (1u<<30u)
 #define CPUID_EXT_AMD_MMXEXT        (1u<<22u)
@@ -314,7 +345,8 @@ namespace Ogre {
             CpuidResult result;
 
             // Has standard feature ?
-            if (_performCpuid(0, result))
+            const uint maxStdFunction = _performCpuid(0, result);
+            if (maxStdFunction)
             {
                 // Check vendor strings
                 if (memcmp(&result._ebx, "GenuineIntel", 12) == 0)
@@ -387,6 +419,32 @@ namespace Ogre {
                             features |= PlatformInformation::CPU_FEATURE_MMXEXT;
                     }
                 }
+
+                // AVX family, vendor independent. The OS must also save the
+                // wider registers, otherwise using them would fault.
+                _performCpuid(1, result);
+                if ((result._ecx & CPUID_STD_OSXSAVE) && (result._ecx & CPUID_STD_AVX))
+                {
+                    const uint64 xcr0 = _performXgetbv();
+                    if ((xcr0 & XCR0_XMM_YMM) == XCR0_XMM_YMM)
+                    {
+                        features |= PlatformInformation::CPU_FEATURE_AVX;
+                        if (result._ecx & CPUID_STD_FMA)
+                            features |= PlatformInformation::CPU_FEATURE_FMA;
+
+                        if (maxStdFunction >= 7)
+                        {
+                            _performCpuid(7, result);
+                            if (result._ebx & CPUID_STD7_AVX2)
+                                features |= PlatformInformation::CPU_FEATURE_AVX2;
+                            if ((result._ebx & CPUID_STD7_AVX512F) &&
+                                (xcr0 & XCR0_OPMASK_ZMM) == XCR0_OPMASK_ZMM)
+                            {
+                                features |= PlatformInformation::CPU_FEATURE_AVX512F;
+                            }
+                        }
+                    }
+                }
             }
         }
 
@@ -398,7 +456,9 @@ namespace Ogre {
         uint features = queryCpuFeatures();
 
         const uint sse_features = PlatformInformation::CPU_FEATURE_SSE |
-            PlatformInformation::CPU_FEATURE_SSE2 | PlatformInformation::CPU_FEATURE_SSE3;
+            PlatformInformation::CPU_FEATURE_SSE2 | PlatformInformation::CPU_FEATURE_SSE3 |
+            PlatformInformation::CPU_FEATURE_AVX | PlatformInformation::CPU_FEATURE_AVX2 |
+            PlatformInformation::CPU_FEATURE_FMA | PlatformInformation::CPU_FEATURE_AVX512F;
         if ((features & sse_features) && !_checkOperatingSystemSupportSSE())
         {
             features &= ~sse_features;
@@ -421,7 +481,8 @@ namespace Ogre {
 
 
             // Has standard feature ?
-            if (_performCpuid(0, result))
+            const uint maxStdFunction = _performCpuid(0, result);
+            if (maxStdFunction)
             {
                 memset(CPUString, 0, sizeof(CPUString));
                 memset(CPUBrandString, 0, sizeof(CPUBrandString));
@@ -619,6 +680,15 @@ namespace Ogre {
 #       if defined(__SSE3__)
             features |= PlatformInformation::CPU_FEATURE_SSE3;
 #       endif
+#       if defined(__AVX__)
+            features |= PlatformInformation::CPU_FEATURE_AVX;
+#       endif
+#       if defined(__AVX2__)
+            features |= PlatformInformation::CPU_FEATURE_AVX2;
+#       endif
+#       if defined(__FMA__)
+            features |= PlatformInformation::CPU_FEATURE_FMA;
+#       endif
 #       if defined(__3dNOW__)
             features |= PlatformInformation::CPU_FEATURE_3DNOW;
 #       endif
@@ -723,6 +793,14 @@ namespace Ogre {
                 " *     SSE2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE2), true));
             pLog->logMessage(
                 " *     SSE3: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE3), true));
+            pLog->logMessage(
+                " *      AVX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX), true));
+            pLog->logMessage(
+                " *     AVX2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX2), true));
+            pLog->logMessage(
+                " *      FMA: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_FMA), true));
+            pLog->logMessage(
+                " *  AVX512F: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX512F), true));
             pLog->logMessage(
                 " *      MMX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_MMX), true));
             pLog->logMessage(
@@ -83,7 +83,8 @@ namespace Ogre
         mCurrentFrame( 0 ),
         mTimer( 0 ),
         mTotalFrameTime( 0 ),
-        mEnabled( OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE ),
+        mEnabled( OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE ||
+                  OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE ),
         mUseStableMarkers( false ),
         mNewEnableState( false ),
         mProfileMask( 0xFFFFFFFF ),
@@ -151,7 +152,7 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void Profiler::setEnabled( bool enabled )
     {
-#if OGRE_PROFILING != OGRE_PROFILING_INTERNAL_OFFLINE
+#if OGRE_PROFILING != OGRE_PROFILING_INTERNAL_OFFLINE && OGRE_PROFILING != OGRE_PROFILING_INTERNAL_TRACE
         if( !mInitialized && enabled )
         {
             for( TProfileSessionListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
@@ -186,7 +187,11 @@ namespace Ogre
         }
 #else
         mEnabled = enabled;
+#    if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE
         mOfflineProfiler.setPaused( !enabled );
+#    else
+        mTraceProfiler.setEnabled( enabled );
+#    endif
 #endif
         // We store this enable/disable request until the frame ends
         // (don't want to screw up any open profiles!)
@@ -220,6 +225,8 @@ namespace Ogre
     {
 #if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE
         mOfflineProfiler.profileBegin( profileName.c_str(), flags );
+#elif OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        mTraceProfiler.profileBeginDynamic( profileName.c_str() );
 #else
         // regardless of whether or not we are enabled, we need the application's root profile (ie the
         // first profile started each frame) we need this so bogus profiles don't show up when users
@@ -283,6 +290,8 @@ namespace Ogre
     {
 #if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE
         mOfflineProfiler.profileEnd();
+#elif OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        mTraceProfiler.profileEnd();
 #else
         if( !mEnabled )
         {
@@ -42,6 +42,7 @@ THE SOFTWARE.
 #include "OgreMovableObject.h"
 #include "OgrePass.h"
 #include "OgreProfiler.h"
+#include "OgreRadixSort.h"
 #include "OgreRoot.h"
 #include "OgreSceneManager.h"
 #include "OgreSceneManagerEnumerator.h"
@@ -195,6 +196,7 @@ namespace Ogre
             while( itor != endt )
             {
                 itor->q.clear();
+                itor->numSorted = 0u;
                 ++itor;
             }
 
@@ -383,6 +385,9 @@ namespace Ogre
 
         mCommandBuffer->setCurrentRenderSystem( rs );
 
+        // Must be done before starting mParallelHlmsCompileQueue, as it may use the worker threads.
+        mergeSortedThreadQueues( firstRq, lastRq );
+
         ParallelHlmsCompileQueue *parallelCompileQueue = 0;
 
         if( rs->supportsMultithreadedShaderCompilation() && mSceneManager->getNumWorkerThreads() > 1u )
@@ -443,25 +448,10 @@ namespace Ogre
                     ++itor;
                 }
 
-                // TODO: Exploit temporal coherence across frames then use insertion sorts.
-                // As explained by L. Spiro in
-                // http://www.gamedev.net/topic/661114-temporal-coherence-and-render-queue-sorting/?view=findpost&p=5181408
-                // Keep a list of sorted indices from the previous frame (one per camera).
-                // If we have the sorted list "5, 1, 4, 3, 2, 0":
-                //  * If it grew from last frame, append: 5, 1, 4, 3, 2, 0, 6, 7 and use insertion sort.
-                //  * If it's the same, leave it as is, and use insertion sort just in case.
-                //  * If it's shorter, reset the indices 0, 1, 2, 3, 4; probably use quicksort or other
-                //  generic sort
-                //
-                // TODO2: Explore sorting first on multiple threads, then merge sort into one.
-                if( mRenderQueues[i].mSortMode == NormalSort )
-                {
-                    std::sort( queuedRenderables.begin(), queuedRenderables.end() );
-                    mRenderQueues[i].mSorted = true;
-                }
-                else if( mRenderQueues[i].mSortMode == StableSort )
+                // NormalSort, StableSort & RadixSort were handled by mergeSortedThreadQueues
+                if( mRenderQueues[i].mSortMode == TemporalSort )
                 {
-                    std::stable_sort( queuedRenderables.begin(), queuedRenderables.end() );
+                    sortTemporal( mRenderQueues[i] );
                     mRenderQueues[i].mSorted = true;
                 }
             }
@@ -533,6 +523,388 @@ namespace Ogre
         OgreProfileEndGroup( "Command Execution", OGREPROF_RENDERING );
     }
     //-----------------------------------------------------------------------
+    void RenderQueue::_sortThreadQueue( ThreadRenderQueue &threadRenderQueue,
+                                        const RqSortMode sortMode )
+    {
+        QueuedRenderableArray &q = threadRenderQueue.q;
+        if( threadRenderQueue.numSorted == q.size() )
+            return;
+
+        QueuedRenderableArray::iterator middle = q.begin() + threadRenderQueue.numSorted;
+        if( sortMode == RadixSort )
+        {
+            const size_t numToSort = static_cast<size_t>( q.end() - middle );
+            QueuedRenderableArray &tmp = threadRenderQueue.radixSortTmp;
+            tmp.resizePOD( numToSort );
+
+            const QueuedRenderable *sorted = radixSortUint64(
+                middle, tmp.begin(), numToSort,
+                []( const QueuedRenderable &queuedRenderable ) { return queuedRenderable.hash; } );
+
+            if( sorted != middle )
+            {
+                if( middle == q.begin() )
+                {
+                    q.swap( tmp );
+                    middle = q.begin();
+                }
+                else
+                {
+                    memcpy( middle, sorted, numToSort * sizeof( QueuedRenderable ) );
+                }
+            }
+        }
+        else if( sortMode == StableSort )
+            std::stable_sort( middle, q.end() );
+        else
+            std::sort( middle, q.end() );
+
+        if( middle != q.begin() )
+            std::inplace_merge( q.begin(), middle, q.end() );
+
+        threadRenderQueue.numSorted = q.size();
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::_sortThreadRenderQueue( size_t threadIdx, uint8 rqId )
+    {
+        RenderQueueGroup &renderQueueGroup = mRenderQueues[rqId];
+        if( renderQueueGroup.mSortMode == NormalSort || renderQueueGroup.mSortMode == StableSort ||
+            renderQueueGroup.mSortMode == RadixSort )
+        {
+            _sortThreadQueue( renderQueueGroup.mQueuedRenderablesPerThread[threadIdx],
+                              renderQueueGroup.mSortMode );
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::mergeSortedThreadQueues( const uint8 firstRq, const uint8 lastRq )
+    {
+        OgreProfileGroupAggregate( "Sorting", OGREPROF_RENDERING );
+
+        mPendingMerges.clear();
+        size_t totalRenderables = 0u;
+
+        for( size_t i = firstRq; i < lastRq; ++i )
+        {
+            RenderQueueGroup &renderQueueGroup = mRenderQueues[i];
+
+            if( renderQueueGroup.mSorted || ( renderQueueGroup.mSortMode != NormalSort &&
+                                              renderQueueGroup.mSortMode != StableSort &&
+                                              renderQueueGroup.mSortMode != RadixSort ) )
+            {
+                continue;
+            }
+
+            size_t numRenderables = 0u;
+            for( ThreadRenderQueue &threadRenderQueue : renderQueueGroup.mQueuedRenderablesPerThread )
+            {
+                // Usually a no-op. Except for entries added from the main thread (i.e. v1 objects)
+                _sortThreadQueue( threadRenderQueue, renderQueueGroup.mSortMode );
+                numRenderables += threadRenderQueue.q.size();
+            }
+
+            renderQueueGroup.mQueuedRenderables.resizePOD( numRenderables );
+            renderQueueGroup.mSorted = true;
+
+            if( numRenderables > 0u )
+            {
+                mPendingMerges.push_back( static_cast<uint8>( i ) );
+                totalRenderables += numRenderables;
+            }
+        }
+
+        if( mPendingMerges.empty() )
+            return;
+
+        // Waking up the worker threads isn't free. Don't bother for small queues.
+        const size_t c_minRenderablesForParallelMerge = 4096u;
+
+        if( mSceneManager->getNumWorkerThreads() > 1u &&
+            totalRenderables >= c_minRenderablesForParallelMerge )
+        {
+            mSceneManager->_fireMergeRenderQueues();
+        }
+        else
+        {
+            _mergeRenderQueuesThread( 0u, 1u );
+        }
+
+        mPendingMerges.clear();
+    }
+    //-----------------------------------------------------------------------
+    namespace
+    {
+        struct MergeHead
+        {
+            uint64 hash;
+            size_t queueIdx;
+
+            MergeHead( uint64 _hash, size_t _queueIdx ) : hash( _hash ), queueIdx( _queueIdx ) {}
+
+            /// Ties are resolved by queue index to keep StableSort stable.
+            bool operator>( const MergeHead &_r ) const
+            {
+                return this->hash > _r.hash ||
+                       ( this->hash == _r.hash && this->queueIdx > _r.queueIdx );
+            }
+        };
+    }  // namespace
+    //-----------------------------------------------------------------------
+    void RenderQueue::_mergeRenderQueuesThread( const size_t threadIdx, const size_t numThreads )
+    {
+        FastArray<uint8>::const_iterator itor = mPendingMerges.begin();
+        FastArray<uint8>::const_iterator endt = mPendingMerges.end();
+
+        while( itor != endt )
+        {
+            RenderQueueGroup &renderQueueGroup = mRenderQueues[*itor];
+            _mergeThreadQueues( renderQueueGroup.mQueuedRenderablesPerThread,
+                                renderQueueGroup.mQueuedRenderables, threadIdx, numThreads );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::_mergeThreadQueues( const QueuedRenderableArrayPerThread &perThreadQueue,
+                                          QueuedRenderableArray &outQueuedRenderables,
+                                          const size_t threadIdx, const size_t numThreads )
+    {
+        // For each per-thread queue, finds how many of its entries have a hash lower than
+        // the hash of the entry at position 'rank' in the merged output.
+        // All threads evaluate the same ranks, so the ranges they get never overlap.
+        auto findMergeSplit = []( const QueuedRenderableArrayPerThread &perThreadQueue,
+                                  const size_t rank, const size_t numRenderables, size_t *outSplit )
+        {
+            const size_t numQueues = perThreadQueue.size();
+
+            if( rank == 0u || rank >= numRenderables )
+            {
+                for( size_t i = 0u; i < numQueues; ++i )
+                    outSplit[i] = rank == 0u ? 0u : perThreadQueue[i].q.size();
+                return;
+            }
+
+            // Binary search the smallest hash for which more than 'rank' entries are <= to it.
+            uint64 lo = 0u;
+            uint64 hi = std::numeric_limits<uint64>::max();
+            while( lo < hi )
+            {
+                const uint64 mid = lo + ( ( hi - lo ) >> 1u );
+                const QueuedRenderable midValue( mid, 0, 0 );
+
+                size_t count = 0u;
+                for( size_t i = 0u; i < numQueues; ++i )
+                {
+                    const QueuedRenderableArray &q = perThreadQueue[i].q;
+                    count += static_cast<size_t>( std::upper_bound( q.begin(), q.end(), midValue ) -
+                                                  q.begin() );
+                }
+
+                if( count > rank )
+                    hi = mid;
+                else
+                    lo = mid + 1u;
+            }
+
+            const QueuedRenderable splitValue( lo, 0, 0 );
+            for( size_t i = 0u; i < numQueues; ++i )
+            {
+                const QueuedRenderableArray &q = perThreadQueue[i].q;
+                outSplit[i] = static_cast<size_t>(
+                    std::lower_bound( q.begin(), q.end(), splitValue ) - q.begin() );
+            }
+        };
+
+        const std::greater<MergeHead> heapCmp;
+
+        FastArray<size_t> splitStart;
+        FastArray<size_t> splitEnd;
+        FastArray<MergeHead> heap;
+
+        const size_t numQueues = perThreadQueue.size();
+        const size_t numRenderables = outQueuedRenderables.size();
+
+        splitStart.resizePOD( numQueues );
+        splitEnd.resizePOD( numQueues );
+
+        findMergeSplit( perThreadQueue, ( numRenderables * threadIdx ) / numThreads,
+                        numRenderables, splitStart.begin() );
+        findMergeSplit( perThreadQueue, ( numRenderables * ( threadIdx + 1u ) ) / numThreads,
+                        numRenderables, splitEnd.begin() );
+
+        size_t outOffset = 0u;
+        for( size_t i = 0u; i < numQueues; ++i )
+        {
+            outOffset += splitStart[i];
+            if( splitStart[i] < splitEnd[i] )
+                heap.push_back( MergeHead( perThreadQueue[i].q[splitStart[i]].hash, i ) );
+        }
+
+        QueuedRenderable *RESTRICT_ALIAS dst = outQueuedRenderables.begin() + outOffset;
+
+        std::make_heap( heap.begin(), heap.end(), heapCmp );
+
+        while( !heap.empty() )
+        {
+            std::pop_heap( heap.begin(), heap.end(), heapCmp );
+            MergeHead &head = heap.back();
+
+            const QueuedRenderable *RESTRICT_ALIAS src = perThreadQueue[head.queueIdx].q.begin();
+            size_t pos = splitStart[head.queueIdx];
+            const size_t end = splitEnd[head.queueIdx];
+
+            // Copy the whole run of entries that come before the next queue's head.
+            *dst++ = src[pos++];
+            if( heap.size() == 1u )
+            {
+                while( pos < end )
+                    *dst++ = src[pos++];
+            }
+            else
+            {
+                const MergeHead &next = heap.front();
+                while( pos < end && next > MergeHead( src[pos].hash, head.queueIdx ) )
+                    *dst++ = src[pos++];
+            }
+
+            splitStart[head.queueIdx] = pos;
+
+            if( pos < end )
+            {
+                head.hash = src[pos].hash;
+                std::push_heap( heap.begin(), heap.end(), heapCmp );
+            }
+            else
+            {
+                heap.pop_back();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::sortTemporal( RenderQueueGroup &renderQueueGroup )
+    {
+        const Camera *camera = mSceneManager->getCamerasInProgress().cullingCamera;
+        TemporalSortCache &cache = renderQueueGroup.mTemporalSortCache[camera];
+        cache.usedThisFrame = true;
+
+        _sortTemporal( renderQueueGroup.mQueuedRenderables, cache.sortedIndices,
+                       mTemporalSortSource, mTemporalSortKept, mTemporalSortDisplaced );
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::_sortTemporal( QueuedRenderableArray &queuedRenderables,
+                                     FastArray<uint32> &sortedIndices,
+                                     QueuedRenderableArray &tmpSource,
+                                     TemporalSortEntryArray &tmpKept,
+                                     TemporalSortEntryArray &tmpDisplaced )
+    {
+        // Exploit temporal coherence across frames, as explained by L. Spiro in
+        // http://www.gamedev.net/topic/661114-temporal-coherence-and-render-queue-sorting/?view=findpost&p=5181408
+        // Keep a list of sorted indices from the previous frame (one per camera).
+        // If we have the sorted list "5, 1, 4, 3, 2, 0":
+        //  * If it grew from last frame, append: 5, 1, 4, 3, 2, 0, 6, 7
+        //  * If it's the same, leave it as is.
+        //  * If it's shorter, drop the indices that no longer exist.
+        // Then repair the order. Culling walks the ObjectMemoryManager in the same order
+        // every frame, so for a mostly static scene index N refers to the same Renderable.
+        // When that's not true we just end up doing more work; the result is always sorted.
+        const uint32 numRenderables = static_cast<uint32>( queuedRenderables.size() );
+
+        tmpKept.clear();
+        tmpDisplaced.clear();
+        tmpKept.reserve( numRenderables );
+
+        // Past this many displaced entries, a full sort is cheaper than sort + merge.
+        const size_t maxDisplaced = numRenderables >> 2u;
+
+        bool bNeedsFullSort = sortedIndices.empty();
+
+        // Splits entries into a non-decreasing run (tmpKept) and the ones that
+        // break it (tmpDisplaced). When the entry breaks the run but the last kept
+        // entry is the one out of place (i.e. its hash grew), the last kept entry is displaced
+        // instead; so a single outlier doesn't throw away the rest of the run.
+        const QueuedRenderable *RESTRICT_ALIAS srcRenderables = queuedRenderables.begin();
+        uint32 numProcessed = 0u;
+
+        FastArray<uint32>::const_iterator itor = sortedIndices.begin();
+        FastArray<uint32>::const_iterator endt = sortedIndices.end();
+
+        while( !bNeedsFullSort && numProcessed < numRenderables )
+        {
+            uint32 idx;
+            if( itor != endt )
+            {
+                idx = *itor++;
+                if( idx >= numRenderables )
+                    continue;  // Queue shrank since last frame
+            }
+            else
+            {
+                // Queue grew since last frame. sortedIndices is a permutation of
+                // [0; numProcessed) so append the rest in order.
+                idx = numProcessed;
+            }
+
+            const TemporalSortEntry entry( srcRenderables[idx].hash, idx );
+            ++numProcessed;
+
+            const size_t numKept = tmpKept.size();
+            if( !numKept || tmpKept.back().hash <= entry.hash )
+            {
+                tmpKept.push_back( entry );
+            }
+            else if( numKept == 1u || tmpKept[numKept - 2u].hash <= entry.hash )
+            {
+                tmpDisplaced.push_back( tmpKept.back() );
+                tmpKept.back() = entry;
+            }
+            else
+            {
+                tmpDisplaced.push_back( entry );
+            }
+
+            bNeedsFullSort = tmpDisplaced.size() > maxDisplaced;
+        }
+
+        if( bNeedsFullSort )
+        {
+            tmpKept.clear();
+            tmpDisplaced.clear();
+            for( uint32 i = 0u; i < numRenderables; ++i )
+                tmpKept.push_back( TemporalSortEntry( srcRenderables[i].hash, i ) );
+            std::sort( tmpKept.begin(), tmpKept.end() );
+        }
+        else
+        {
+            std::sort( tmpDisplaced.begin(), tmpDisplaced.end() );
+        }
+
+        // Gather the renderables in their new order, merging both sorted lists.
+        tmpSource.swap( queuedRenderables );
+        queuedRenderables.resizePOD( numRenderables );
+        sortedIndices.resizePOD( numRenderables );
+
+        srcRenderables = tmpSource.begin();
+        QueuedRenderable *RESTRICT_ALIAS dstRenderables = queuedRenderables.begin();
+        uint32 *RESTRICT_ALIAS dstIndices = sortedIndices.begin();
+
+        TemporalSortEntryArray::const_iterator itKept = tmpKept.begin();
+        TemporalSortEntryArray::const_iterator enKept = tmpKept.end();
+        TemporalSortEntryArray::const_iterator itDisp = tmpDisplaced.begin();
+        TemporalSortEntryArray::const_iterator enDisp = tmpDisplaced.end();
+
+        while( itKept != enKept || itDisp != enDisp )
+        {
+            uint32 idx;
+            if( itDisp == enDisp || ( itKept != enKept && !( *itDisp < *itKept ) ) )
+                idx = ( itKept++ )->idx;
+            else
+                idx = ( itDisp++ )->idx;
+
+            *dstRenderables++ = srcRenderables[idx];
+            *dstIndices++ = idx;
+        }
+
+        tmpSource.clear();
+    }
+    //-----------------------------------------------------------------------
     void RenderQueue::warmUpShadersCollect( const uint8 firstRq, const uint8 lastRq,
                                             const bool casterPass )
     {
@@ -1466,6 +1838,28 @@ namespace Ogre
         mFreeIndirectBuffers.insert( mFreeIndirectBuffers.end(), mUsedIndirectBuffers.begin(),
                                      mUsedIndirectBuffers.end() );
         mUsedIndirectBuffers.clear();
+
+        // Forget the sorted order of cameras that didn't render this frame
+        // (they may have been destroyed, and their pointer could be reused).
+        for( size_t i = 0; i < 256; ++i )
+        {
+            TemporalSortCacheMap &temporalSortCache = mRenderQueues[i].mTemporalSortCache;
+            TemporalSortCacheMap::iterator itor = temporalSortCache.begin();
+            TemporalSortCacheMap::iterator endt = temporalSortCache.end();
+
+            while( itor != endt )
+            {
+                if( !itor->second.usedThisFrame )
+                {
+                    temporalSortCache.erase( itor++ );
+                }
+                else
+                {
+                    itor->second.usedThisFrame = false;
+                    ++itor;
+                }
+            }
+        }
     }
     //-----------------------------------------------------------------------
     void RenderQueue::setRenderQueueMode( uint8 rqId, Modes newMode )
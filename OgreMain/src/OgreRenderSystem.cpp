@@ -270,6 +270,9 @@ namespace Ogre
         TextureGpu *tex = tl._getTexturePtr();
         bool isValidBinding = false;
 
+        if( tex )
+            tex->_notifyUsed( mTextureGpuManager->getFrameCount() );
+
         if( mCurrentCapabilities->hasCapability( RSC_COMPLETE_TEXTURE_BINDING ) )
             _setBindingType( tl.getBindingType() );
 
@@ -1317,6 +1320,7 @@ namespace Ogre
         mBarrierSolver.reset();
 
         mTextureGpuManager->_update( false );
+        mTextureGpuManager->_updateResidency();
         mVaoManager->_update();
     }
     //---------------------------------------------------------------------
@@ -338,7 +338,8 @@ namespace Ogre
             << "Best time: \t" << mFrameStats->getBestTime() << " ms\n"
             << "Worst time: \t" << mFrameStats->getWorstTime() << " ms";
 
-#if OGRE_PROFILING && OGRE_PROFILING != OGRE_PROFILING_INTERNAL_OFFLINE
+#if OGRE_PROFILING && OGRE_PROFILING != OGRE_PROFILING_INTERNAL_OFFLINE && \
+    OGRE_PROFILING != OGRE_PROFILING_INTERNAL_TRACE
         OGRE_DELETE mProfiler;
 #endif
 
@@ -439,7 +440,7 @@ namespace Ogre
         mAutoWindow = 0;
         mFirstTimePostWindowInit = false;
 
-#if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE
+#if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_OFFLINE || OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
         OGRE_DELETE mProfiler;
 #endif
 
@@ -908,6 +909,9 @@ namespace Ogre
     //-----------------------------------------------------------------------
     bool Root::_fireFrameStarted( FrameEvent &evt )
     {
+#if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        mProfiler->getTraceProfiler()._frameStarted();
+#endif
 #if OGRE_PROFILING
         if( OgreProfilerUseStableMarkers )
         {
@@ -1006,6 +1010,9 @@ namespace Ogre
             OgreProfileEndGroup( frameNum.c_str(), OGREPROF_GENERAL );
         }
 #endif
+#if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        mProfiler->getTraceProfiler()._frameEnded();
+#endif
 
         return ret;
     }
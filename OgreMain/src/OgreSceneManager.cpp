@@ -55,6 +55,7 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreLogManager.h"
+#include "OgreLwString.h"
 #include "OgreManualObject.h"
 #include "OgreManualObject2.h"
 #include "OgreMaterialManager.h"
@@ -79,10 +80,13 @@ THE SOFTWARE.
 #include "ParticleSystem/OgreParticleSystem2.h"
 #include "ParticleSystem/OgreParticleSystemManager2.h"
 #include "Threading/OgreBarrier.h"
+#include "Threading/OgreStageGraph.h"
 #include "Threading/OgreUniformScalableTask.h"
+#include "Threading/OgreWorkStealingScheduler.h"
 
 // This class implements the most basic scene manager
 
+#include <chrono>
 #include <cstdio>
 
 namespace Ogre
@@ -105,6 +109,33 @@ namespace Ogre
 
     void NullAtmosphereComponent::_update( SceneManager *, Camera * ) {}
 
+    /// Below this many objects, _calculateCurrentCastersBox doesn't use the worker threads
+    static const size_t c_minObjectsForThreadedCastersBox = 2048u;
+
+#if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+    /// One trace event per worker thread request, so the stalls show up in the trace
+    static const TraceMarker c_workerRequestTraceMarkers[SceneManager::NUM_REQUESTS] = {
+        "CULL_FRUSTUM",
+        "UPDATE_ALL_ANIMATIONS",
+        "UPDATE_ALL_TRANSFORMS",
+        "UPDATE_ALL_BONE_TO_TAG_TRANSFORMS",
+        "UPDATE_ALL_TAG_ON_TAG_TRANSFORMS",
+        "UPDATE_ALL_BOUNDS",
+        "UPDATE_SCENE_GRAPH_STAGES",
+        "UPDATE_ALL_LODS",
+        "CALCULATE_CASTERS_BOX",
+        "BUILD_LIGHT_LIST01",
+        "BUILD_LIGHT_LIST02",
+        "WARM_UP_SHADERS",
+        "WARM_UP_SHADERS_COMPILE",
+        "PARALLEL_HLMS_COMPILE",
+        "MERGE_RENDER_QUEUES",
+        "PARTICLE_SYSTEM_MANAGER2",
+        "USER_UNIFORM_SCALABLE_TASK",
+        "STOP_THREADS",
+    };
+#endif
+
     static NullAtmosphereComponent c_nullAtmosphere;
 
     //-----------------------------------------------------------------------
@@ -174,6 +205,13 @@ namespace Ogre
         mUserTask( 0 ),
         mRequestType( NUM_REQUESTS ),
         mWorkerThreadsBarrier( 0 ),
+        mWorkStealing( false ),
+        mObjectsPerChunk( 512u ),
+        mWorkStealingScheduler( 0 ),
+        mUpdateStageGraph( false ),
+        mStageGraph( 0 ),
+        mBvhCulling( false ),
+        mBvhMinObjects( 4096u ),
         mSuppressRenderStateChanges( false ),
         mLastLightHash( 0 ),
         mLastLightLimit( 0 ),
@@ -212,8 +250,13 @@ namespace Ogre
 
         mGlobalLightListPerThread.resize( mNumWorkerThreads );
         mBuildLightListRequestPerThread.resize( mNumWorkerThreads );
+        mCastersBoxPerThread.resize( mNumWorkerThreads );
         mVisibleObjects.resize( mNumWorkerThreads );
         mTmpVisibleObjects.resize( mNumWorkerThreads );
+        mWorkerThreadStats.resize( mNumWorkerThreads );
+
+        mWorkStealingScheduler = new WorkStealingScheduler();
+        mStageGraph = new StageGraph();
 
         startWorkerThreads();
 
@@ -322,6 +365,13 @@ namespace Ogre
         delete mParticleSystemManager2;
 
         stopWorkerThreads();
+
+        destroyCullBvhs();
+
+        delete mStageGraph;
+        mStageGraph = 0;
+        delete mWorkStealingScheduler;
+        mWorkStealingScheduler = 0;
     }
     //-----------------------------------------------------------------------
     SceneManager::MovableObjectVec SceneManager::findMovableObjects( const String &type,
@@ -1721,6 +1771,19 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------
+    void SceneManager::_fireMergeRenderQueues()
+    {
+        mRequestType = MERGE_RENDER_QUEUES;
+
+        if( mForceMainThread )
+            updateWorkerThreadImpl( 0 );
+        else
+        {
+            mWorkerThreadsBarrier->sync();  // Fire threads
+            mWorkerThreadsBarrier->sync();  // Wait them to complete
+        }
+    }
+    //-----------------------------------------------------------------------
     void SceneManager::_fireParticleSystemManager2Update()
     {
         mRequestType = PARTICLE_SYSTEM_MANAGER2;
@@ -1732,6 +1795,8 @@ namespace Ogre
             mWorkerThreadsBarrier->sync();  // Fire threads.
             mWorkerThreadsBarrier->sync();  // Wait them to complete stage 01.
             mWorkerThreadsBarrier->sync();  // Wait them to complete stage 02.
+            if( mParticleSystemManager2->_needsUpdateParallel03() )
+                mWorkerThreadsBarrier->sync();  // Wait them to complete stage 03.
         }
     }
     //-----------------------------------------------------------------------
@@ -1909,7 +1974,7 @@ namespace Ogre
         const size_t numNodes = std::min( request.numNodesPerThread, request.numTotalNodes - toAdvance );
         t.advancePack( toAdvance / ARRAY_PACKED_REALS );
 
-        Node::updateAllTransforms( numNodes, t );
+        Node::updateAllTransforms( numNodes, t, request.skipClean );
     }
     //-----------------------------------------------------------------------
     void SceneManager::updateAllTransforms()
@@ -1942,7 +2007,8 @@ namespace Ogre
                 {
                     // Send them to worker threads. We need to go depth by depth because
                     // we may depend on parents which could be processed by different threads.
-                    mUpdateTransformRequest = UpdateTransformRequest( t, nodesPerThread, numNodes );
+                    mUpdateTransformRequest = UpdateTransformRequest(
+                        t, nodesPerThread, numNodes, nodeMemoryManager->getDirtyTracking() );
                     fireWorkerThreadsAndWait();
                     // Node::updateAllTransforms( numNodes, t );
                 }
@@ -1951,6 +2017,8 @@ namespace Ogre
             ++it;
         }
 
+        clearNodeDirtyFlags();
+
         // Call all listeners
         SceneNodeList::const_iterator itor = mSceneNodesWithListeners.begin();
         SceneNodeList::const_iterator endt = mSceneNodesWithListeners.end();
@@ -1962,6 +2030,21 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------
+    void SceneManager::clearNodeDirtyFlags()
+    {
+        // Must be done after all managers were updated, as
+        // the children may live in a different manager
+        NodeMemoryManagerVec::const_iterator it = mNodeMemoryManagerUpdateList.begin();
+        NodeMemoryManagerVec::const_iterator en = mNodeMemoryManagerUpdateList.end();
+
+        while( it != en )
+        {
+            if( ( *it )->getDirtyTracking() )
+                ( *it )->_clearDirtyFlags();
+            ++it;
+        }
+    }
+    //-----------------------------------------------------------------------
     void SceneManager::updateAllTagPoints()
     {
         NodeMemoryManagerVec::const_iterator it = mTagPointNodeMemoryManagerUpdateList.begin();
@@ -2032,6 +2115,15 @@ namespace Ogre
     void SceneManager::updateAllBoundsThread( const ObjectMemoryManagerVec &objectMemManager,
                                               size_t threadIdx )
     {
+        if( mWorkStealing )
+        {
+            ObjectData objData;
+            const ObjectDataChunk *chunk;
+            while( ( chunk = getNextObjectDataChunk( threadIdx, objData ) ) != 0 )
+                MovableObject::updateAllBounds( chunk->numObjs, objData );
+            return;
+        }
+
         ObjectMemoryManagerVec::const_iterator it = objectMemManager.begin();
         ObjectMemoryManagerVec::const_iterator en = objectMemManager.end();
 
@@ -2069,7 +2161,230 @@ namespace Ogre
     {
         mUpdateBoundsRequest = &objectMemManager;
         mRequestType = UPDATE_ALL_BOUNDS;
+        prepareObjectDataChunks( objectMemManager, 0u, std::numeric_limits<size_t>::max() );
+        finishObjectDataChunks();
+        fireWorkerThreadsAndWait();
+
+        markCullBvhsDirty( objectMemManager );
+        refitCullBvhs( objectMemManager );
+    }
+    //-----------------------------------------------------------------------
+    size_t SceneManager::addSceneGraphStage( SceneGraphStageType type, size_t numTotal,
+                                             size_t objectsPerJob, size_t dependency,
+                                             size_t dependency2 )
+    {
+        SceneGraphStage stage;
+        stage.type = type;
+        stage.numTotal = numTotal;
+        stage.objectsPerJob = objectsPerJob;
+        stage.skipClean = false;
+        stage.bvh = 0;
+        mSceneGraphStages.push_back( stage );
+
+        return mStageGraph->addStage( ( numTotal + objectsPerJob - 1u ) / objectsPerJob, dependency,
+                                      dependency2 );
+    }
+    //-----------------------------------------------------------------------
+    size_t SceneManager::addNodeStages( NodeMemoryManager *nodeMemoryManager, size_t firstDepth,
+                                        SceneGraphStageType firstType, SceneGraphStageType type,
+                                        size_t dependency, size_t dependency2 )
+    {
+        const size_t numDepths = nodeMemoryManager->getNumDepths();
+
+        for( size_t i = firstDepth; i < numDepths; ++i )
+        {
+            Transform t;
+            const size_t numNodes = nodeMemoryManager->getFirstNode( t, i );
+
+            if( numNodes )
+            {
+                // Each level depends on its parents, which could be anywhere in the previous level
+                dependency = addSceneGraphStage( i == 0u ? firstType : type, numNodes,
+                                                 mObjectsPerChunk, dependency, dependency2 );
+                dependency2 = StageGraph::NoDependency;
+                mSceneGraphStages.back().t = t;
+                mSceneGraphStages.back().skipClean = nodeMemoryManager->getDirtyTracking();
+            }
+        }
+
+        return dependency;
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::addBoundsStages( const ObjectMemoryManagerVec &objectMemManager,
+                                        size_t dependency, size_t dependency2 )
+    {
+        ObjectMemoryManagerVec::const_iterator it = objectMemManager.begin();
+        ObjectMemoryManagerVec::const_iterator en = objectMemManager.end();
+
+        while( it != en )
+        {
+            ObjectMemoryManager *memoryManager = *it;
+            const size_t numRenderQueues = memoryManager->getNumRenderQueues();
+
+            for( size_t i = 0; i < numRenderQueues; ++i )
+            {
+                ObjectData objData;
+                const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
+
+                if( totalObjs )
+                {
+                    const size_t boundsStage = addSceneGraphStage( SgsBounds, totalObjs,
+                                                                   mObjectsPerChunk, dependency,
+                                                                   dependency2 );
+                    mSceneGraphStages.back().objData = objData;
+                    addCullBvhRefitStages( memoryManager, static_cast<uint8>( i ), objData,
+                                           totalObjs, boundsStage );
+                }
+            }
+
+            ++it;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::updateSceneGraphStages()
+    {
+        mStageGraph->clear();
+        mSceneGraphStages.clear();
+
+        size_t lastStage = StageGraph::NoDependency;
+
+        {
+            NodeMemoryManagerVec::const_iterator it = mNodeMemoryManagerUpdateList.begin();
+            NodeMemoryManagerVec::const_iterator en = mNodeMemoryManagerUpdateList.end();
+
+            while( it != en )
+            {
+                NodeMemoryManager *nodeMemoryManager = *it;
+                // Start from the zeroth level (root) unless static (start from first dirty)
+                const size_t start = nodeMemoryManager->getMemoryManagerType() == SCENE_STATIC
+                                         ? mStaticMinDepthLevelDirty
+                                         : 0;
+                lastStage =
+                    addNodeStages( nodeMemoryManager, start, SgsTransforms, SgsTransforms, lastStage );
+                ++it;
+            }
+        }
+
+        if( !mSceneNodesWithListeners.empty() )
+        {
+            // Listeners must see the updated transforms, but run before anything else
+            // does (as in updateAllTransforms). Flush the transforms first.
+            mStageGraph->finalize();
+            mRequestType = UPDATE_SCENE_GRAPH_STAGES;
+            fireWorkerThreadsAndWait();
+
+            mStageGraph->clear();
+            mSceneGraphStages.clear();
+            lastStage = StageGraph::NoDependency;
+
+            // Call all listeners
+            SceneNodeList::const_iterator itor = mSceneNodesWithListeners.begin();
+            SceneNodeList::const_iterator endt = mSceneNodesWithListeners.end();
+
+            while( itor != endt )
+            {
+                ( *itor )->getListener()->nodeUpdated( *itor );
+                ++itor;
+            }
+        }
+
+        const size_t transformsStage = lastStage;
+
+        // Animations were already partitioned per thread. Each job is one partition.
+        lastStage = addSceneGraphStage( SgsAnimations, mNumWorkerThreads, 1u, transformsStage );
+
+        // Particle preparation only needs the transforms, so it runs along the animations.
+        // But the tag points & bounds below must wait for it.
+        size_t particleStage = StageGraph::NoDependency;
+        if( mPrepareParticleFx )
+        {
+            particleStage =
+                addSceneGraphStage( SgsParticlePrepare, mNumWorkerThreads, 1u, transformsStage );
+        }
+
+        {
+            NodeMemoryManagerVec::const_iterator it = mTagPointNodeMemoryManagerUpdateList.begin();
+            NodeMemoryManagerVec::const_iterator en = mTagPointNodeMemoryManagerUpdateList.end();
+
+            while( it != en )
+            {
+                lastStage =
+                    addNodeStages( *it, 0u, SgsBoneToTag, SgsTagOnTag, lastStage, particleStage );
+                ++it;
+            }
+        }
+
+        // BVHs that can be refit get cleared again while adding their stages
+        markCullBvhsDirty( mEntitiesMemoryManagerUpdateList );
+        markCullBvhsDirty( mLightsMemoryManagerCulledList );
+
+        addBoundsStages( mEntitiesMemoryManagerUpdateList, lastStage, particleStage );
+        addBoundsStages( mLightsMemoryManagerCulledList, lastStage, particleStage );
+
+        mStageGraph->finalize();
+
+        mRequestType = UPDATE_SCENE_GRAPH_STAGES;
         fireWorkerThreadsAndWait();
+
+        clearNodeDirtyFlags();
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::updateSceneGraphStagesThread( size_t threadIdx )
+    {
+        size_t stageIdx, jobIdx;
+        while( mStageGraph->getNextJob( stageIdx, jobIdx ) )
+        {
+            const SceneGraphStage &stage = mSceneGraphStages[stageIdx];
+
+            const size_t firstObj = jobIdx * stage.objectsPerJob;
+            const size_t numObjs = std::min( stage.objectsPerJob, stage.numTotal - firstObj );
+
+            switch( stage.type )
+            {
+            case SgsTransforms:
+            {
+                Transform t( stage.t );
+                t.advancePack( firstObj / ARRAY_PACKED_REALS );
+                Node::updateAllTransforms( numObjs, t, stage.skipClean );
+                break;
+            }
+            case SgsAnimations:
+                updateAllAnimationsThread( jobIdx );
+                break;
+            case SgsParticlePrepare:
+                mParticleSystemManager2->_prepareParallel();
+                break;
+            case SgsBoneToTag:
+            {
+                Transform t( stage.t );
+                t.advancePack( firstObj / ARRAY_PACKED_REALS );
+                TagPoint::updateAllTransformsBoneToTag( numObjs, t );
+                break;
+            }
+            case SgsTagOnTag:
+            {
+                Transform t( stage.t );
+                t.advancePack( firstObj / ARRAY_PACKED_REALS );
+                TagPoint::updateAllTransformsTagOnTag( numObjs, t );
+                break;
+            }
+            case SgsBounds:
+            {
+                ObjectData objData( stage.objData );
+                objData.advancePack( firstObj / ARRAY_PACKED_REALS );
+                MovableObject::updateAllBounds( numObjs, objData );
+                break;
+            }
+            case SgsBvhRefitLeaves:
+                stage.bvh->refitLeaves( stage.objData, firstObj, numObjs );
+                break;
+            case SgsBvhRefitNodes:
+                stage.bvh->refitNodes();
+                break;
+            }
+
+            mStageGraph->jobFinished( stageIdx );
+        }
     }
     //-----------------------------------------------------------------------
     void SceneManager::updateAllLodsThread( const UpdateLodRequest &request, size_t threadIdx )
@@ -2077,6 +2392,16 @@ namespace Ogre
         LodStrategy *lodStrategy = LodStrategyManager::getSingleton().getDefaultStrategy();
 
         const Camera *lodCamera = request.lodCamera;
+
+        if( mWorkStealing )
+        {
+            ObjectData objData;
+            const ObjectDataChunk *chunk;
+            while( ( chunk = getNextObjectDataChunk( threadIdx, objData ) ) != 0 )
+                lodStrategy->lodUpdateImpl( chunk->numObjs, objData, lodCamera, request.lodBias );
+            return;
+        }
+
         ObjectMemoryManagerVec::const_iterator it = request.objectMemManager->begin();
         ObjectMemoryManagerVec::const_iterator en = request.objectMemManager->end();
 
@@ -2123,6 +2448,9 @@ namespace Ogre
         mUpdateLodRequest.camera->getFrustumPlanes();
         mUpdateLodRequest.lodCamera->getFrustumPlanes();
 
+        prepareObjectDataChunks( mEntitiesMemoryManagerCulledList, firstRq, lastRq );
+        finishObjectDataChunks();
+
         fireWorkerThreadsAndWait();
     }
     //-----------------------------------------------------------------------
@@ -2154,6 +2482,19 @@ namespace Ogre
         CullFrustumPreparedData preparedData;
         MovableObject::cullFrustumPrepare( camera, visibilityMask, lodCamera, preparedData );
 
+        const bool bUseChunks = mWorkStealing || mBvhCulling;
+
+        if( bUseChunks )
+        {
+            ObjectData objData;
+            const ObjectDataChunk *chunk;
+            while( ( chunk = getNextObjectDataChunk( threadIdx, objData ) ) != 0 )
+            {
+                cullFrustumObjects( request, threadIdx, chunk->rqId, chunk->numObjs, objData,
+                                    preparedData, *( visibleObjectsPerRq.begin() + chunk->rqId ) );
+            }
+        }
+
         ObjectMemoryManagerVec::const_iterator it = request.objectMemManager->begin();
         ObjectMemoryManagerVec::const_iterator en = request.objectMemManager->end();
 
@@ -2167,61 +2508,32 @@ namespace Ogre
 
             for( size_t i = firstRq; i < lastRq; ++i )
             {
-                MovableObject::MovableObjectArray &outVisibleObjects =
-                    *( visibleObjectsPerRq.begin() + i );
-
-                ObjectData objData;
-                const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
-
                 const uint8 currRqId = static_cast<uint8>( i );
 
-                // Skip if totalObjs == 0u. Profiling shows there is considerable gains.
-                // Too much (255 queues, most of them empty, multiples scene passes...)
-                if( totalObjs > 0u )
+                if( !bUseChunks )
                 {
-                    // Distribute the work evenly across all threads (not perfect), taking into
-                    // account we need to distribute in multiples of ARRAY_PACKED_REALS
-                    size_t numObjs = ( totalObjs + ( mNumWorkerThreads - 1 ) ) / mNumWorkerThreads;
-                    numObjs = ( ( numObjs + ARRAY_PACKED_REALS - 1 ) / ARRAY_PACKED_REALS ) *
-                              ARRAY_PACKED_REALS;
-
-                    const size_t toAdvance = std::min( threadIdx * numObjs, totalObjs );
-
-                    // Prevent going out of bounds (usually in the last threadIdx, or
-                    // when there are less entities than ARRAY_PACKED_REALS
-                    numObjs = std::min( numObjs, totalObjs - toAdvance );
-                    objData.advancePack( toAdvance / ARRAY_PACKED_REALS );
-
-                    MovableObject::cullFrustum( numObjs, objData, camera, outVisibleObjects,
-                                                preparedData );
+                    ObjectData objData;
+                    const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
 
-                    if( mRenderQueue->getRenderQueueMode( currRqId ) == RenderQueue::FAST &&
-                        request.addToRenderQueue )
+                    // Skip if totalObjs == 0u. Profiling shows there is considerable gains.
+                    // Too much (255 queues, most of them empty, multiples scene passes...)
+                    if( totalObjs > 0u )
                     {
-                        // V2 meshes can be added to the render queue in parallel
-                        bool casterPass = request.casterPass;
-                        MovableObject::MovableObjectArray::const_iterator itor =
-                            outVisibleObjects.begin();
-                        MovableObject::MovableObjectArray::const_iterator endt = outVisibleObjects.end();
+                        // Distribute the work evenly across all threads (not perfect), taking into
+                        // account we need to distribute in multiples of ARRAY_PACKED_REALS
+                        size_t numObjs = ( totalObjs + ( mNumWorkerThreads - 1 ) ) / mNumWorkerThreads;
+                        numObjs = ( ( numObjs + ARRAY_PACKED_REALS - 1 ) / ARRAY_PACKED_REALS ) *
+                                  ARRAY_PACKED_REALS;
 
-                        while( itor != endt )
-                        {
-                            RenderableArray::const_iterator itRend = ( *itor )->mRenderables.begin();
-                            RenderableArray::const_iterator enRend = ( *itor )->mRenderables.end();
+                        const size_t toAdvance = std::min( threadIdx * numObjs, totalObjs );
 
-                            while( itRend != enRend )
-                            {
-                                if( ( *itRend )->mRenderableVisible )
-                                {
-                                    mRenderQueue->addRenderableV2( threadIdx, currRqId, casterPass,
-                                                                   *itRend, *itor );
-                                }
-                                ++itRend;
-                            }
-                            ++itor;
-                        }
+                        // Prevent going out of bounds (usually in the last threadIdx, or
+                        // when there are less entities than ARRAY_PACKED_REALS
+                        numObjs = std::min( numObjs, totalObjs - toAdvance );
+                        objData.advancePack( toAdvance / ARRAY_PACKED_REALS );
 
-                        outVisibleObjects.clear();
+                        cullFrustumObjects( request, threadIdx, currRqId, numObjs, objData,
+                                            preparedData, *( visibleObjectsPerRq.begin() + i ) );
                     }
                 }
 
@@ -2236,6 +2548,338 @@ namespace Ogre
 
             ++it;
         }
+
+        if( request.addToRenderQueue )
+        {
+            // Sort what we've just added while we're still in parallel.
+            // RenderQueue::render only needs to merge the results.
+            for( size_t i = request.firstRq; i < request.lastRq; ++i )
+                mRenderQueue->_sortThreadRenderQueue( threadIdx, static_cast<uint8>( i ) );
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::cullFrustumObjects( const CullFrustumRequest &request, size_t threadIdx,
+                                           uint8 rqId, size_t numObjs, const ObjectData &objData,
+                                           const CullFrustumPreparedData &preparedData,
+                                           MovableObject::MovableObjectArray &outVisibleObjects )
+    {
+        MovableObject::cullFrustum( numObjs, objData, request.camera, outVisibleObjects,
+                                    preparedData );
+
+        if( mRenderQueue->getRenderQueueMode( rqId ) == RenderQueue::FAST && request.addToRenderQueue )
+        {
+            // V2 meshes can be added to the render queue in parallel
+            bool casterPass = request.casterPass;
+            MovableObject::MovableObjectArray::const_iterator itor = outVisibleObjects.begin();
+            MovableObject::MovableObjectArray::const_iterator endt = outVisibleObjects.end();
+
+            while( itor != endt )
+            {
+                RenderableArray::const_iterator itRend = ( *itor )->mRenderables.begin();
+                RenderableArray::const_iterator enRend = ( *itor )->mRenderables.end();
+
+                while( itRend != enRend )
+                {
+                    if( ( *itRend )->mRenderableVisible )
+                        mRenderQueue->addRenderableV2( threadIdx, rqId, casterPass, *itRend, *itor );
+                    ++itRend;
+                }
+                ++itor;
+            }
+
+            outVisibleObjects.clear();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::WorkerThreadStats::reset()
+    {
+        memset( microseconds, 0, sizeof( microseconds ) );
+        memset( numRuns, 0, sizeof( numRuns ) );
+        numChunksProcessed = 0u;
+        numChunksStolen = 0u;
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::setWorkStealing( bool bWorkStealing, uint32 objectsPerChunk )
+    {
+        mWorkStealing = bWorkStealing;
+        objectsPerChunk = std::max<uint32>( objectsPerChunk, 1u );
+        mObjectsPerChunk =
+            ( ( objectsPerChunk + ARRAY_PACKED_REALS - 1u ) / ARRAY_PACKED_REALS ) * ARRAY_PACKED_REALS;
+        mObjectDataChunks.clear();
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::resetWorkerThreadStats()
+    {
+        FastArray<WorkerThreadStats>::iterator itor = mWorkerThreadStats.begin();
+        FastArray<WorkerThreadStats>::iterator endt = mWorkerThreadStats.end();
+
+        while( itor != endt )
+        {
+            itor->reset();
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::prepareObjectDataChunks( const ObjectMemoryManagerVec &objectMemManager,
+                                                size_t firstRq, size_t lastRq )
+    {
+        mObjectDataChunks.clear();
+
+        if( !mWorkStealing )
+            return;
+
+        ObjectMemoryManagerVec::const_iterator itor = objectMemManager.begin();
+        ObjectMemoryManagerVec::const_iterator endt = objectMemManager.end();
+
+        while( itor != endt )
+        {
+            addObjectDataChunks( *itor, firstRq, lastRq );
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::addObjectDataChunks( ObjectMemoryManager *memoryManager, size_t firstRq,
+                                            size_t lastRq )
+    {
+        if( !mWorkStealing )
+            return;
+
+        const size_t numRenderQueues = memoryManager->getNumRenderQueues();
+
+        firstRq = std::min<size_t>( firstRq, numRenderQueues );
+        lastRq = std::min<size_t>( lastRq, numRenderQueues );
+
+        for( size_t i = firstRq; i < lastRq; ++i )
+        {
+            ObjectData objData;
+            const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
+            addRenderQueueChunks( memoryManager, static_cast<uint8>( i ), totalObjs );
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::addRenderQueueChunks( ObjectMemoryManager *memoryManager, uint8 rqId,
+                                             size_t totalObjs )
+    {
+        for( size_t firstObj = 0u; firstObj < totalObjs; firstObj += mObjectsPerChunk )
+        {
+            ObjectDataChunk chunk;
+            chunk.memoryManager = memoryManager;
+            chunk.rqId = rqId;
+            chunk.firstObj = firstObj;
+            chunk.numObjs = std::min<size_t>( mObjectsPerChunk, totalObjs - firstObj );
+            mObjectDataChunks.push_back( chunk );
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::finishObjectDataChunks()
+    {
+        if( mWorkStealing || mBvhCulling )
+            mWorkStealingScheduler->reset( mObjectDataChunks.size(), mNumWorkerThreads );
+    }
+    //-----------------------------------------------------------------------
+    const SceneManager::ObjectDataChunk *SceneManager::getNextObjectDataChunk( size_t threadIdx,
+                                                                              ObjectData &outObjData )
+    {
+        size_t chunkIdx;
+        if( !mWorkStealingScheduler->getNextChunk( threadIdx, chunkIdx ) )
+            return 0;
+
+        const ObjectDataChunk *chunk = &mObjectDataChunks[chunkIdx];
+        chunk->memoryManager->getFirstObjectData( outObjData, chunk->rqId );
+        outObjData.advancePack( chunk->firstObj / ARRAY_PACKED_REALS );
+        return chunk;
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::prepareBvhCullChunks( const CullFrustumRequest &request )
+    {
+        mObjectDataChunks.clear();
+
+        const Plane *frustumPlanes = request.camera->_getCachedFrustumPlanes();
+        const uint32 maxPacksPerRange = mObjectsPerChunk / ARRAY_PACKED_REALS;
+
+        ObjectMemoryManagerVec::const_iterator itor = request.objectMemManager->begin();
+        ObjectMemoryManagerVec::const_iterator endt = request.objectMemManager->end();
+
+        while( itor != endt )
+        {
+            ObjectMemoryManager *memoryManager = *itor;
+            const size_t numRenderQueues = memoryManager->getNumRenderQueues();
+
+            const size_t firstRq = std::min<size_t>( request.firstRq, numRenderQueues );
+            const size_t lastRq = std::min<size_t>( request.lastRq, numRenderQueues );
+
+            for( size_t i = firstRq; i < lastRq; ++i )
+            {
+                const uint8 rqId = static_cast<uint8>( i );
+
+                ObjectData objData;
+                const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
+
+                if( totalObjs < mBvhMinObjects )
+                {
+                    addRenderQueueChunks( memoryManager, rqId, totalObjs );
+                }
+                else
+                {
+                    ObjectDataBvh *bvh = getCullBvh( memoryManager, rqId, objData, totalObjs );
+
+                    mBvhPackRanges.clear();
+                    bvh->cullFrustum( frustumPlanes, maxPacksPerRange, mBvhPackRanges );
+
+                    ObjectDataBvh::PackRangeArray::const_iterator itRange = mBvhPackRanges.begin();
+                    ObjectDataBvh::PackRangeArray::const_iterator enRange = mBvhPackRanges.end();
+
+                    while( itRange != enRange )
+                    {
+                        ObjectDataChunk chunk;
+                        chunk.memoryManager = memoryManager;
+                        chunk.rqId = rqId;
+                        chunk.firstObj = itRange->firstPack * ARRAY_PACKED_REALS;
+                        chunk.numObjs = std::min<size_t>( itRange->numPacks * ARRAY_PACKED_REALS,
+                                                          totalObjs - chunk.firstObj );
+                        mObjectDataChunks.push_back( chunk );
+                        ++itRange;
+                    }
+                }
+            }
+
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------
+    ObjectDataBvh *SceneManager::getCullBvh( ObjectMemoryManager *memoryManager, uint8 rqId,
+                                             const ObjectData &objData, size_t totalObjs )
+    {
+        CullBvhVec::iterator itor = mCullBvhs.begin();
+        CullBvhVec::iterator endt = mCullBvhs.end();
+
+        while( itor != endt && ( itor->memoryManager != memoryManager || itor->rqId != rqId ) )
+            ++itor;
+
+        if( itor == endt )
+        {
+            CullBvh cullBvh;
+            cullBvh.memoryManager = memoryManager;
+            cullBvh.rqId = rqId;
+            cullBvh.boundsDirty = true;
+            cullBvh.bvh = OGRE_NEW ObjectDataBvh();
+            mCullBvhs.push_back( cullBvh );
+            itor = mCullBvhs.end() - 1u;
+        }
+
+        const size_t numPacks = ( totalObjs + ARRAY_PACKED_REALS - 1u ) / ARRAY_PACKED_REALS;
+        if( itor->boundsDirty || itor->bvh->getNumPacks() != numPacks )
+        {
+            itor->bvh->update( objData, totalObjs );
+            itor->boundsDirty = false;
+        }
+
+        return itor->bvh;
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::markCullBvhsDirty( const ObjectMemoryManagerVec &objectMemManager )
+    {
+        CullBvhVec::iterator itor = mCullBvhs.begin();
+        CullBvhVec::iterator endt = mCullBvhs.end();
+
+        while( itor != endt )
+        {
+            if( std::find( objectMemManager.begin(), objectMemManager.end(), itor->memoryManager ) !=
+                objectMemManager.end() )
+            {
+                itor->boundsDirty = true;
+            }
+            ++itor;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::addCullBvhRefitStages( ObjectMemoryManager *memoryManager, uint8 rqId,
+                                              const ObjectData &objData, size_t totalObjs,
+                                              size_t dependency )
+    {
+        if( totalObjs < mBvhMinObjects )
+            return;  // Won't be used for culling. Stays dirty.
+
+        CullBvhVec::iterator itor = mCullBvhs.begin();
+        CullBvhVec::iterator endt = mCullBvhs.end();
+
+        while( itor != endt && ( itor->memoryManager != memoryManager || itor->rqId != rqId ) )
+            ++itor;
+
+        const size_t numPacks = ( totalObjs + ARRAY_PACKED_REALS - 1u ) / ARRAY_PACKED_REALS;
+        if( itor == endt || !itor->bvh->getNumBuilds() || itor->bvh->getNumPacks() != numPacks )
+            return;  // Needs a (serial) rebuild. getCullBvh will take care of it.
+
+        // Each leaf covers ARRAY_PACKED_REALS packs
+        const size_t leavesPerJob =
+            std::max<size_t>( mObjectsPerChunk / ( ARRAY_PACKED_REALS * ARRAY_PACKED_REALS ), 1u );
+
+        const size_t leavesStage = addSceneGraphStage(
+            SgsBvhRefitLeaves, itor->bvh->getNumLeaves(), leavesPerJob, dependency );
+        mSceneGraphStages.back().objData = objData;
+        mSceneGraphStages.back().bvh = itor->bvh;
+
+        addSceneGraphStage( SgsBvhRefitNodes, 1u, 1u, leavesStage );
+        mSceneGraphStages.back().bvh = itor->bvh;
+
+        itor->boundsDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::refitCullBvhs( const ObjectMemoryManagerVec &objectMemManager )
+    {
+        if( mCullBvhs.empty() )
+            return;
+
+        mStageGraph->clear();
+        mSceneGraphStages.clear();
+
+        ObjectMemoryManagerVec::const_iterator itor = objectMemManager.begin();
+        ObjectMemoryManagerVec::const_iterator endt = objectMemManager.end();
+
+        while( itor != endt )
+        {
+            ObjectMemoryManager *memoryManager = *itor;
+            const size_t numRenderQueues = memoryManager->getNumRenderQueues();
+
+            for( size_t i = 0; i < numRenderQueues; ++i )
+            {
+                ObjectData objData;
+                const size_t totalObjs = memoryManager->getFirstObjectData( objData, i );
+                addCullBvhRefitStages( memoryManager, static_cast<uint8>( i ), objData, totalObjs,
+                                       StageGraph::NoDependency );
+            }
+
+            ++itor;
+        }
+
+        if( mStageGraph->getNumStages() )
+        {
+            mStageGraph->finalize();
+            mRequestType = UPDATE_SCENE_GRAPH_STAGES;
+            fireWorkerThreadsAndWait();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::destroyCullBvhs()
+    {
+        CullBvhVec::const_iterator itor = mCullBvhs.begin();
+        CullBvhVec::const_iterator endt = mCullBvhs.end();
+
+        while( itor != endt )
+        {
+            OGRE_DELETE itor->bvh;
+            ++itor;
+        }
+
+        mCullBvhs.clear();
+    }
+    //-----------------------------------------------------------------------
+    void SceneManager::setBvhCulling( bool bEnabled, uint32 minObjects )
+    {
+        mBvhCulling = bEnabled;
+        mBvhMinObjects = minObjects;
+        if( !bEnabled )
+            destroyCullBvhs();
     }
     //-----------------------------------------------------------------------
     inline bool OrderLightByShadowCastThenId( const Light *_l, const Light *_r )
@@ -2727,11 +3371,16 @@ namespace Ogre
 
         highLevelCull();
         _applySceneAnimations();
-        updateAllTransforms();
-        updateAllAnimations();
-        updateAllTagPoints();
-        updateAllBounds( mEntitiesMemoryManagerUpdateList );
-        updateAllBounds( mLightsMemoryManagerCulledList );
+        if( mUpdateStageGraph )
+            updateSceneGraphStages();
+        else
+        {
+            updateAllTransforms();
+            updateAllAnimations();
+            updateAllTagPoints();
+            updateAllBounds( mEntitiesMemoryManagerUpdateList );
+            updateAllBounds( mLightsMemoryManagerCulledList );
+        }
 
         mPrepareParticleFx = false;
 
@@ -3734,70 +4383,152 @@ namespace Ogre
     }
     //---------------------------------------------------------------------
     AxisAlignedBox SceneManager::_calculateCurrentCastersBox( uint32 viewportVisibilityMask,
-                                                              uint8 _firstRq, uint8 _lastRq ) const
+                                                              uint8 firstRq, uint8 lastRq ) const
     {
-        AxisAlignedBox retVal;
+        const CastersBoxRequest request(
+            firstRq, lastRq,
+            ( viewportVisibilityMask & getVisibilityMask() ) |
+                ( viewportVisibilityMask & ~VisibilityFlags::RESERVED_VISIBILITY_FLAGS ) );
 
-        ObjectMemoryManagerVec::const_iterator it = mEntitiesMemoryManagerCulledList.begin();
-        ObjectMemoryManagerVec::const_iterator en = mEntitiesMemoryManagerCulledList.end();
+        // Everything will be treated as const (we have no ConstObjectData structure).
+        ObjectMemoryManager *particleMemoryManager =
+            const_cast<ObjectMemoryManager *>( &mParticleSysDefMemoryManager );
 
-        while( it != en )
+        const size_t numMemoryManagers = mEntitiesMemoryManagerCulledList.size() + 1u;
+
+        size_t totalObjs = 0u;
+        for( size_t j = 0; j < numMemoryManagers; ++j )
         {
-            ObjectMemoryManager *objMemoryManager = *it;
+            // The last one is for the particles
+            ObjectMemoryManager *objMemoryManager =
+                j < mEntitiesMemoryManagerCulledList.size() ? mEntitiesMemoryManagerCulledList[j]
+                                                            : particleMemoryManager;
             const size_t numRenderQueues = objMemoryManager->getNumRenderQueues();
+            const size_t rqEnd = std::min<size_t>( lastRq, numRenderQueues );
+            for( size_t i = std::min<size_t>( firstRq, numRenderQueues ); i < rqEnd; ++i )
+            {
+                ObjectData objData;
+                totalObjs += objMemoryManager->getFirstObjectData( objData, i );
+            }
+        }
 
-            // TODO: Send this to worker threads (dark_sylinc)
-
-            size_t firstRq = std::min<size_t>( _firstRq, numRenderQueues );
-            size_t lastRq = std::min<size_t>( _lastRq, numRenderQueues );
+        AxisAlignedBox retVal;
 
-            for( size_t i = firstRq; i < lastRq; ++i )
+        if( mNumWorkerThreads <= 1u || totalObjs < c_minObjectsForThreadedCastersBox )
+        {
+            // Waking up the worker threads would cost more than what they'd save us
+            for( size_t j = 0; j < numMemoryManagers; ++j )
             {
-                AxisAlignedBox tmpBox;
+                ObjectMemoryManager *objMemoryManager =
+                    j < mEntitiesMemoryManagerCulledList.size() ? mEntitiesMemoryManagerCulledList[j]
+                                                                : particleMemoryManager;
+                const size_t numRenderQueues = objMemoryManager->getNumRenderQueues();
+                const size_t rqEnd = std::min<size_t>( lastRq, numRenderQueues );
+                for( size_t i = std::min<size_t>( firstRq, numRenderQueues ); i < rqEnd; ++i )
+                {
+                    AxisAlignedBox tmpBox;
 
-                ObjectData objData;
-                const size_t numObjs = objMemoryManager->getFirstObjectData( objData, i );
-
-                MovableObject::calculateCastersBox(
-                    numObjs, objData,
-                    ( viewportVisibilityMask & getVisibilityMask() ) |
-                        ( viewportVisibilityMask & ~VisibilityFlags::RESERVED_VISIBILITY_FLAGS ),
-                    &tmpBox );
-                retVal.merge( tmpBox );
+                    ObjectData objData;
+                    const size_t numObjs = objMemoryManager->getFirstObjectData( objData, i );
+
+                    MovableObject::calculateCastersBox( numObjs, objData, request.visibilityMask,
+                                                        &tmpBox );
+                    retVal.merge( tmpBox );
+                }
             }
 
-            ++it;
+            return retVal;
         }
 
-        {
-            // Calculate the particles
-            // Everything will be treated as const (we have no ConstObjectData structure).
-            ObjectMemoryManager *objMemoryManager =
-                const_cast<ObjectMemoryManager *>( &mParticleSysDefMemoryManager );
-            const size_t numRenderQueues = objMemoryManager->getNumRenderQueues();
+        // Firing the worker threads doesn't modify the scene, only the request
+        // and the per-thread results; hence the const_cast.
+        return const_cast<SceneManager *>( this )->_calculateCurrentCastersBoxThreaded( request );
+    }
+    //---------------------------------------------------------------------
+    AxisAlignedBox SceneManager::_calculateCurrentCastersBoxThreaded(
+        const CastersBoxRequest &request )
+    {
+        mCastersBoxRequest = request;
+        mRequestType = CALCULATE_CASTERS_BOX;
+        prepareObjectDataChunks( mEntitiesMemoryManagerCulledList, request.firstRq,
+                                 request.lastRq );
+        addObjectDataChunks( &mParticleSysDefMemoryManager, request.firstRq, request.lastRq );
+        finishObjectDataChunks();
+        fireWorkerThreadsAndWait();
 
-            // TODO: Send this to worker threads (dark_sylinc)
+        AxisAlignedBox retVal;
+        for( size_t i = 0; i < mNumWorkerThreads; ++i )
+            retVal.merge( mCastersBoxPerThread[i] );
 
-            size_t firstRq = std::min<size_t>( _firstRq, numRenderQueues );
-            size_t lastRq = std::min<size_t>( _lastRq, numRenderQueues );
+        return retVal;
+    }
+    //---------------------------------------------------------------------
+    void SceneManager::calculateCastersBoxThread( const CastersBoxRequest &request,
+                                                  size_t threadIdx )
+    {
+        AxisAlignedBox &outBox = mCastersBoxPerThread[threadIdx];
+        outBox.setNull();
 
-            for( size_t i = firstRq; i < lastRq; ++i )
+        if( mWorkStealing )
+        {
+            ObjectData objData;
+            const ObjectDataChunk *chunk;
+            while( ( chunk = getNextObjectDataChunk( threadIdx, objData ) ) != 0 )
             {
                 AxisAlignedBox tmpBox;
+                MovableObject::calculateCastersBox( chunk->numObjs, objData, request.visibilityMask,
+                                                    &tmpBox );
+                outBox.merge( tmpBox );
+            }
+            return;
+        }
+
+        // Everything will be treated as const (we have no ConstObjectData structure).
+        ObjectMemoryManager *particleMemoryManager = &mParticleSysDefMemoryManager;
+
+        const size_t numMemoryManagers = mEntitiesMemoryManagerCulledList.size() + 1u;
+
+        for( size_t j = 0; j < numMemoryManagers; ++j )
+        {
+            // The last one is for the particles
+            ObjectMemoryManager *objMemoryManager = j < mEntitiesMemoryManagerCulledList.size()
+                                                        ? mEntitiesMemoryManagerCulledList[j]
+                                                        : particleMemoryManager;
+            const size_t numRenderQueues = objMemoryManager->getNumRenderQueues();
+
+            size_t firstRq = std::min<size_t>( request.firstRq, numRenderQueues );
+            size_t lastRq = std::min<size_t>( request.lastRq, numRenderQueues );
 
+            for( size_t i = firstRq; i < lastRq; ++i )
+            {
                 ObjectData objData;
-                const size_t numObjs = objMemoryManager->getFirstObjectData( objData, i );
-
-                MovableObject::calculateCastersBox(
-                    numObjs, objData,
-                    ( viewportVisibilityMask & getVisibilityMask() ) |
-                        ( viewportVisibilityMask & ~VisibilityFlags::RESERVED_VISIBILITY_FLAGS ),
-                    &tmpBox );
-                retVal.merge( tmpBox );
+                const size_t totalObjs = objMemoryManager->getFirstObjectData( objData, i );
+
+                if( totalObjs == 0u )
+                    continue;
+
+                // Distribute the work evenly across all threads (not perfect), taking into
+                // account we need to distribute in multiples of ARRAY_PACKED_REALS
+                size_t numObjs = ( totalObjs + ( mNumWorkerThreads - 1 ) ) / mNumWorkerThreads;
+                numObjs =
+                    ( ( numObjs + ARRAY_PACKED_REALS - 1 ) / ARRAY_PACKED_REALS ) * ARRAY_PACKED_REALS;
+
+                const size_t toAdvance = std::min( threadIdx * numObjs, totalObjs );
+
+                // Prevent going out of bounds (usually in the last threadIdx, or
+                // when there are less entities than ARRAY_PACKED_REALS
+                numObjs = std::min( numObjs, totalObjs - toAdvance );
+                objData.advancePack( toAdvance / ARRAY_PACKED_REALS );
+
+                if( numObjs > 0u )
+                {
+                    AxisAlignedBox tmpBox;
+                    MovableObject::calculateCastersBox( numObjs, objData, request.visibilityMask,
+                                                        &tmpBox );
+                    outBox.merge( tmpBox );
+                }
             }
         }
-
-        return retVal;
     }
     //---------------------------------------------------------------------
     void SceneManager::propagateRelativeOrigin( SceneNode *sceneNode, const Vector3 &relativeOrigin )
@@ -4652,6 +5383,11 @@ namespace Ogre
         // in case they weren't up to date.
         mCurrentCullFrustumRequest.camera->getFrustumPlanes();
         mCurrentCullFrustumRequest.lodCamera->getFrustumPlanes();
+        if( mBvhCulling )
+            prepareBvhCullChunks( request );
+        else
+            prepareObjectDataChunks( *request.objectMemManager, request.firstRq, request.lastRq );
+        finishObjectDataChunks();
         fireWorkerThreadsAndWait();
     }
     //---------------------------------------------------------------------
@@ -4721,6 +5457,14 @@ namespace Ogre
     {
         bool exitThread = false;
         size_t threadIdx = threadHandle->getThreadIdx();
+#if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        {
+            char tmpBuffer[64];
+            LwString threadName( LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
+            threadName.a( "SceneManager Worker ", (uint32)threadIdx );
+            Profiler::getSingleton().getTraceProfiler().setThreadName( threadName.c_str() );
+        }
+#endif
         while( !exitThread )
         {
             mWorkerThreadsBarrier->sync();
@@ -4735,7 +5479,17 @@ namespace Ogre
     {
         bool exitThread = false;
 
-        switch( mRequestType )
+        const RequestType requestType = mRequestType;
+        const bool bCollectStats = mWorkStealing;
+#if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        TraceScope traceScope( Profiler::getSingleton().getTraceProfiler(),
+                               c_workerRequestTraceMarkers[requestType] );
+#endif
+        std::chrono::steady_clock::time_point startTime;
+        if( bCollectStats )
+            startTime = std::chrono::steady_clock::now();
+
+        switch( requestType )
         {
         case CULL_FRUSTUM:
             cullFrustum( mCurrentCullFrustumRequest, threadIdx );
@@ -4757,9 +5511,15 @@ namespace Ogre
         case UPDATE_ALL_BOUNDS:
             updateAllBoundsThread( *mUpdateBoundsRequest, threadIdx );
             break;
+        case UPDATE_SCENE_GRAPH_STAGES:
+            updateSceneGraphStagesThread( threadIdx );
+            break;
         case UPDATE_ALL_LODS:
             updateAllLodsThread( mUpdateLodRequest, threadIdx );
             break;
+        case CALCULATE_CASTERS_BOX:
+            calculateCastersBoxThread( mCastersBoxRequest, threadIdx );
+            break;
         case BUILD_LIGHT_LIST01:
             buildLightListThread01( mBuildLightListRequestPerThread[threadIdx], threadIdx );
             break;
@@ -4775,11 +5535,20 @@ namespace Ogre
         case PARALLEL_HLMS_COMPILE:
             mRenderQueue->_compileShadersThread( threadIdx );
             break;
+        case MERGE_RENDER_QUEUES:
+            mRenderQueue->_mergeRenderQueuesThread( threadIdx, mNumWorkerThreads );
+            break;
         case PARTICLE_SYSTEM_MANAGER2:
             mParticleSystemManager2->_updateParallel01( threadIdx, mNumWorkerThreads );
             if( !mForceMainThread )
                 mWorkerThreadsBarrier->sync();
             mParticleSystemManager2->_updateParallel02( threadIdx, mNumWorkerThreads );
+            if( mParticleSystemManager2->_needsUpdateParallel03() )
+            {
+                if( !mForceMainThread )
+                    mWorkerThreadsBarrier->sync();
+                mParticleSystemManager2->_updateParallel03( threadIdx, mNumWorkerThreads );
+            }
             break;
         case USER_UNIFORM_SCALABLE_TASK:
             mUserTask->execute( threadIdx, mNumWorkerThreads );
@@ -4791,6 +5560,23 @@ namespace Ogre
             break;
         }
 
+        if( bCollectStats && !exitThread )
+        {
+            WorkerThreadStats &stats = mWorkerThreadStats[threadIdx];
+            stats.microseconds[requestType] += static_cast<uint64>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - startTime )
+                    .count() );
+            ++stats.numRuns[requestType];
+
+            if( requestType == CULL_FRUSTUM || requestType == UPDATE_ALL_BOUNDS ||
+                requestType == UPDATE_ALL_LODS || requestType == CALCULATE_CASTERS_BOX )
+            {
+                stats.numChunksProcessed += mWorkStealingScheduler->getNumProcessed( threadIdx );
+                stats.numChunksStolen += mWorkStealingScheduler->getNumStolen( threadIdx );
+            }
+        }
+
         return exitThread;
     }
     SceneManagerFactory::~SceneManagerFactory() {}
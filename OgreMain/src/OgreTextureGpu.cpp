@@ -67,7 +67,8 @@ namespace Ogre
         mPoolId( 0 ),
         mSysRamCopy( 0 ),
         mTextureManager( textureManager ),
-        mTexturePool( 0 )
+        mTexturePool( 0 ),
+        mLastFrameUsed( 0u )
     {
         assert( !hasAutomaticBatching() ||
                 ( hasAutomaticBatching() && isTexture() && !isRenderToTexture() && !isUav() ) );
@@ -601,6 +602,11 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    void TextureGpu::_notifyMipLevelReady( uint8 mipLevel )
+    {
+        notifyAllListenersTextureChanged( TextureGpuListener::MipLevelReady, &mipLevel );
+    }
+    //-----------------------------------------------------------------------------------
     void TextureGpu::_syncGpuResidentToSystemRam()
     {
         if( !isDataReady() )
@@ -870,6 +876,25 @@ namespace Ogre
         mInternalSliceStart = slice;
     }
     //-----------------------------------------------------------------------------------
+    void TextureGpu::_notifyTexturePoolMasterChanged()
+    {
+        OGRE_ASSERT_LOW( mTexturePool );
+
+        const bool bWasDataReady = _isDataReadyImpl();
+
+        _notifyTextureSlotChanged( mTexturePool, mInternalSliceStart );
+
+        if( bWasDataReady )
+        {
+            // _notifyTextureSlotChanged switched us to the dummy texture, but our
+            // contents were copied to the new master. Display them again.
+            OGRE_ASSERT_LOW( mDataPreparationsPending < std::numeric_limits<uint8>::max() &&
+                             "Overflow. Too many transitions queued up" );
+            ++mDataPreparationsPending;
+            notifyDataIsReady();
+        }
+    }
+    //-----------------------------------------------------------------------------------
     void TextureGpu::setTexturePoolId( uint32 poolId )
     {
         OGRE_ASSERT_LOW( mResidencyStatus != GpuResidency::Resident );
@@ -83,8 +83,6 @@ THE SOFTWARE.
 //#define OGRE_FORCE_TEXTURE_STREAMING_ON_MAIN_THREAD 1
 //#define OGRE_DEBUG_MEMORY_CONSUMPTION 1
 
-#define TODO_grow_pool
-
 namespace Ogre
 {
     static const int c_mainThread = 0;
@@ -110,6 +108,14 @@ namespace Ogre
         mAddedNewLoadRequests( false ),
         mMultiLoadsSemaphore( 0u ),
         mPendingMultiLoads( 0u ),
+        mMultiLoadPendingBytes( 0u ),
+        mMultiLoadMaxPendingBytes( 0u ),
+        mMaxTexturePoolSlices( 256u ),
+        mFrameCount( 0u ),
+        mResidencyBudgetBytes( 0u ),
+        mResidencyFramesUnused( 60u ),
+        mResidencyEvictTo( GpuResidency::OnStorage ),
+        mResidencyUsedBytes( 0u ),
         mEntriesToProcessPerIteration( 3u ),
         mMaxPreloadBytes( 256u * 1024u * 1024u ),  // A value of 512MB begins to shake driver bugs.
         mTextureGpuManagerListener( &sDefaultTextureGpuManagerListener ),
@@ -174,11 +180,14 @@ namespace Ogre
         mMaxPreloadBytes = 128u * 1024u * 1024u;
 #    endif
 #endif
+        mMultiLoadMaxPendingBytes = mMaxPreloadBytes;
 
         // Starts as true so fullfillBudget can run at least once
         mStreamingData.workerThreadRan = true;
         mStreamingData.bytesPreloaded = 0;
         mStreamingData.maxPerStagingTextureRequestBytes = 64u * 1024u * 1024u;
+        mStreamingData.maxUploadBytesPerFrame = 0u;
+        mStreamingData.mipTailMaxResolution = 256u;
 
         for( int i = 0; i < 2; ++i )
             mThreadData[i].objCmdBuffer = new ObjCmdBuffer();
@@ -236,6 +245,16 @@ namespace Ogre
         ThreadData &workerData = mThreadData[c_workerThread];
         ThreadData &mainData = mThreadData[c_mainThread];
         mLoadRequestsMutex.lock();
+        for( int i = 0; i < 2; ++i )
+        {
+            LoadRequestVec::const_iterator itor = mThreadData[i].loadRequests.begin();
+            LoadRequestVec::const_iterator endt = mThreadData[i].loadRequests.end();
+            while( itor != endt )
+            {
+                mMultiLoadPendingBytes -= itor->multiLoadBytes;
+                ++itor;
+            }
+        }
         mainData.loadRequests
             .clear();  // TODO: if( loadRequest.autoDeleteImage ) delete loadRequest.image;
         mainData.objCmdBuffer->clear();
@@ -1199,6 +1218,152 @@ namespace Ogre
         outTextureBytesGpu = textureBytesGpu;
     }
     //-----------------------------------------------------------------------------------
+    void TextureGpuManager::getTexturePoolMemoryStats( TexturePoolMemoryStatsVec &outStats ) const
+    {
+        TexturePoolList::const_iterator itPool = mTexturePool.begin();
+        TexturePoolList::const_iterator enPool = mTexturePool.end();
+
+        while( itPool != enPool )
+        {
+            const TexturePool &pool = *itPool;
+
+            TexturePoolMemoryStats stats;
+            stats.masterTexture = pool.masterTexture;
+            stats.bytes = pool.masterTexture->getSizeBytes();
+            stats.numSlices = (uint16)pool.masterTexture->getNumSlices();
+            stats.numUsedSlices = (uint16)pool.usedSlots.size();
+            stats.usedBytes = stats.bytes / stats.numSlices * stats.numUsedSlices;
+            outStats.push_back( stats );
+
+            ++itPool;
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    void TextureGpuManager::setResidencyBudget( size_t budgetBytes, uint32 framesUnused,
+                                                GpuResidency::GpuResidency evictTo )
+    {
+        if( evictTo == GpuResidency::Resident )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                         "evictTo must be GpuResidency::OnStorage or GpuResidency::OnSystemRam",
+                         "TextureGpuManager::setResidencyBudget" );
+        }
+
+        mResidencyBudgetBytes = budgetBytes;
+        mResidencyFramesUnused = framesUnused;
+        mResidencyEvictTo = evictTo;
+        mResidencyUsedBytes = 0u;
+    }
+    //-----------------------------------------------------------------------------------
+    void TextureGpuManager::prefetchTexture( TextureGpu *texture )
+    {
+        texture->_notifyUsed( mFrameCount );
+        if( texture->getNextResidencyStatus() != GpuResidency::Resident )
+            texture->scheduleTransitionTo( GpuResidency::Resident );
+    }
+    //-----------------------------------------------------------------------------------
+    static bool OrderTextureByLastFrameUsed( const TextureGpu *a, const TextureGpu *b )
+    {
+        return a->getLastFrameUsed() < b->getLastFrameUsed();
+    }
+    //-----------------------------------------------------------------------------------
+    void TextureGpuManager::_updateResidency()
+    {
+        ++mFrameCount;
+
+        if( !mResidencyBudgetBytes )
+            return;
+
+        OgreProfileExhaustive( "TextureGpuManager::_updateResidency" );
+
+        // Textures bound last frame have mLastFrameUsed = mFrameCount - 1
+        const uint32 lastFrame = mFrameCount - 1u;
+
+        size_t usedBytes = 0u;
+
+        ResourceEntryMap::const_iterator itor = mEntries.begin();
+        ResourceEntryMap::const_iterator endt = mEntries.end();
+
+        while( itor != endt )
+        {
+            TextureGpu *texture = itor->second.texture;
+
+            const GpuResidency::GpuResidency residency = texture->getResidencyStatus();
+            // Pooled textures are counted below, as part of their pool
+            if( residency == GpuResidency::Resident && !texture->hasAutomaticBatching() )
+                usedBytes += texture->getSizeBytes();
+
+            const bool bManaged = !itor->second.destroyRequested &&
+                                  texture->getSourceType() == TextureSourceType::Standard &&
+                                  !texture->isRenderToTexture() && !texture->isUav() &&
+                                  !texture->_isManualTextureFlagPresent() &&
+                                  texture->getPendingResidencyChanges() == 0u;
+
+            if( bManaged )
+            {
+                const uint32 framesSinceUsed = mFrameCount - texture->getLastFrameUsed();
+                if( residency == GpuResidency::Resident )
+                {
+                    // Evicting a pooled texture only frees its slice for other textures of
+                    // the pool; the memory is released once the whole pool is empty.
+                    if( framesSinceUsed > mResidencyFramesUnused && texture->isDataReady() &&
+                        !texture->hasAutomaticBatching() )
+                    {
+                        mTmpEvictionCandidates.push_back( texture );
+                    }
+                }
+                else if( texture->getLastFrameUsed() == lastFrame && mFrameCount > 1u )
+                {
+                    // It got bound while not being resident. Probably we evicted it.
+                    mTmpRestoreCandidates.push_back( texture );
+                }
+            }
+
+            ++itor;
+        }
+
+        TexturePoolList::const_iterator itPool = mTexturePool.begin();
+        TexturePoolList::const_iterator enPool = mTexturePool.end();
+
+        while( itPool != enPool )
+        {
+            usedBytes += itPool->masterTexture->getSizeBytes();
+            ++itPool;
+        }
+
+        TextureGpuVec::const_iterator itTex = mTmpRestoreCandidates.begin();
+        TextureGpuVec::const_iterator enTex = mTmpRestoreCandidates.end();
+
+        while( itTex != enTex )
+        {
+            ( *itTex )->scheduleTransitionTo( GpuResidency::Resident );
+            ++itTex;
+        }
+
+        if( usedBytes > mResidencyBudgetBytes )
+        {
+            // Least recently used first
+            std::sort( mTmpEvictionCandidates.begin(), mTmpEvictionCandidates.end(),
+                       OrderTextureByLastFrameUsed );
+
+            itTex = mTmpEvictionCandidates.begin();
+            enTex = mTmpEvictionCandidates.end();
+
+            while( itTex != enTex && usedBytes > mResidencyBudgetBytes )
+            {
+                TextureGpu *texture = *itTex;
+                usedBytes -= texture->getSizeBytes();
+                texture->scheduleTransitionTo( mResidencyEvictTo );
+                ++itTex;
+            }
+        }
+
+        mResidencyUsedBytes = usedBytes;
+
+        mTmpEvictionCandidates.clear();
+        mTmpRestoreCandidates.clear();
+    }
+    //-----------------------------------------------------------------------------------
     void TextureGpuManager::dumpStats() const
     {
         char tmpBuffer[512];
@@ -1360,6 +1525,15 @@ namespace Ogre
         mMaxPreloadBytes = std::max<size_t>( 1u, maxPreloadBytes );
     }
     //-----------------------------------------------------------------------------------
+    void TextureGpuManager::setProgressiveStreaming( size_t maxUploadBytesPerFrame,
+                                                     uint32 mipTailMaxResolution )
+    {
+        mMutex.lock();
+        mStreamingData.maxUploadBytesPerFrame = maxUploadBytesPerFrame;
+        mStreamingData.mipTailMaxResolution = mipTailMaxResolution;
+        mMutex.unlock();
+    }
+    //-----------------------------------------------------------------------------------
     void TextureGpuManager::setWorkerThreadMaxPerStagingTextureRequestBytes(
         size_t maxPerStagingTextureRequestBytes )
     {
@@ -1396,6 +1570,16 @@ namespace Ogre
 #endif
     }
     //-----------------------------------------------------------------------------------
+    void TextureGpuManager::setMultiLoadMaxPendingBytes( size_t maxPendingBytes )
+    {
+        mMultiLoadMaxPendingBytes = maxPendingBytes;
+    }
+    //-----------------------------------------------------------------------------------
+    void TextureGpuManager::setMaxTexturePoolSlices( uint16 maxSlices )
+    {
+        mMaxTexturePoolSlices = maxSlices;
+    }
+    //-----------------------------------------------------------------------------------
     void TextureGpuManager::setWorkerThreadMinimumBudget( const BudgetEntryVec &budget,
                                                           uint32 maxSplitResolution )
     {
@@ -1632,6 +1816,14 @@ namespace Ogre
     void TextureGpuManager::notifyTextureChanged( TextureGpu *texture, TextureGpuListener::Reason reason,
                                                   void *extraData )
     {
+        if( reason == TextureGpuListener::GainedResidency ||
+            reason == TextureGpuListener::ReadyForRendering )
+        {
+            // Otherwise a texture that just finished loading counts as unused since it was
+            // last bound and _updateResidency would evict it right away.
+            texture->_notifyUsed( mFrameCount );
+        }
+
         notifyTextureChanged( texture, reason, false );
         mTextureGpuManagerListener->notifyTextureChanged( texture, reason, extraData );
 
@@ -2112,6 +2304,72 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
+    static bool isTexturePoolCompatible( const TexturePool &pool, TextureGpu *texture )
+    {
+        return pool.masterTexture->getWidth() == texture->getWidth() &&
+               pool.masterTexture->getHeight() == texture->getHeight() &&
+               pool.masterTexture->getPixelFormat() == texture->getPixelFormat() &&
+               pool.masterTexture->getNumMipmaps() == texture->getNumMipmaps() &&
+               pool.masterTexture->getTexturePoolId() == texture->getTexturePoolId();
+    }
+    //-----------------------------------------------------------------------------------
+    TextureGpu *TextureGpuManager::createTexturePoolMaster( TextureGpu *texture, uint32 numSlices )
+    {
+        IdType newId = Id::generateNewId<TextureGpuManager>();
+        char tmpBuffer[64];
+        LwString texName( LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
+        texName.a( "_InternalTex", newId );
+
+        TextureGpu *master = createTextureImpl( GpuPageOutStrategy::Discard, texName.c_str(),
+                                                TextureFlags::PoolOwner, TextureTypes::Type2DArray );
+        master->_setSourceType( TextureSourceType::PoolOwner );
+        master->setResolution( texture->getWidth(), texture->getHeight(), numSlices );
+        master->setPixelFormat( texture->getPixelFormat() );
+        master->setNumMipmaps( texture->getNumMipmaps() );
+        master->setTexturePoolId( texture->getTexturePoolId() );
+
+        master->_transitionTo( GpuResidency::Resident, 0 );
+        master->notifyDataIsReady();
+
+        return master;
+    }
+    //-----------------------------------------------------------------------------------
+    void TextureGpuManager::growTexturePool( TexturePool &pool, TextureGpu *texture,
+                                             uint32 numSlicesToAdd )
+    {
+        OGRE_ASSERT_LOW( !pool.manuallyReserved && !pool.hasFreeSlot() );
+
+        TextureGpu *oldMaster = pool.masterTexture;
+        const uint32 numSlices =
+            std::min<uint32>( oldMaster->getNumSlices() + numSlicesToAdd, mMaxTexturePoolSlices );
+
+        TextureGpu *newMaster = createTexturePoolMaster( texture, numSlices );
+
+        // Copy on the GPU. There's no need to stall: the copy is ordered after
+        // any upload to the old pool that has already been issued, and uploads issued
+        // from now on will go to the new pool (since we change the slot below).
+        for( uint8 mip = 0u; mip < oldMaster->getNumMipmaps(); ++mip )
+        {
+            TextureBox box = oldMaster->getEmptyBox( mip );
+            box.numSlices = pool.usedMemory;
+            oldMaster->copyTo( newMaster, box, mip, box, mip );
+        }
+
+        pool.masterTexture = newMaster;
+        pool.usedSlots.reserve( numSlices );
+
+        TextureGpuVec::const_iterator itor = pool.usedSlots.begin();
+        TextureGpuVec::const_iterator endt = pool.usedSlots.end();
+
+        while( itor != endt )
+        {
+            ( *itor )->_notifyTexturePoolMasterChanged();
+            ++itor;
+        }
+
+        delete oldMaster;
+    }
+    //-----------------------------------------------------------------------------------
     void TextureGpuManager::_reserveSlotForTexture( TextureGpu *texture )
     {
         bool matchFound = false;
@@ -2122,48 +2380,47 @@ namespace Ogre
         while( itor != endt && !matchFound )
         {
             const TexturePool &pool = *itor;
-
-            matchFound = pool.hasFreeSlot() && pool.masterTexture->getWidth() == texture->getWidth() &&
-                         pool.masterTexture->getHeight() == texture->getHeight() &&
-                         pool.masterTexture->getPixelFormat() == texture->getPixelFormat() &&
-                         pool.masterTexture->getNumMipmaps() == texture->getNumMipmaps() &&
-                         pool.masterTexture->getTexturePoolId() == texture->getTexturePoolId();
-
-            TODO_grow_pool;
-
+            matchFound = pool.hasFreeSlot() && isTexturePoolCompatible( pool, texture );
             if( !matchFound )
                 ++itor;
         }
 
+        uint16 numSlices = 0u;
+
         if( itor == endt )
         {
-            IdType newId = Id::generateNewId<TextureGpuManager>();
-            char tmpBuffer[64];
-            LwString texName( LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
-            texName.a( "_InternalTex", newId );
+            numSlices = (uint16)mTextureGpuManagerListener->getNumSlicesFor( texture, this );
 
-            TexturePool newPool;
-            newPool.masterTexture =
-                createTextureImpl( GpuPageOutStrategy::Discard, texName.c_str(), TextureFlags::PoolOwner,
-                                   TextureTypes::Type2DArray );
-            const uint16 numSlices =
-                (uint16)mTextureGpuManagerListener->getNumSlicesFor( texture, this );
-            newPool.masterTexture->_setSourceType( TextureSourceType::PoolOwner );
+            if( numSlices > 1u )
+            {
+                // All compatible pools are full. Grow one of them instead of creating a new
+                // pool, otherwise batches get split across array textures.
+                itor = mTexturePool.begin();
+                while( itor != endt && !matchFound )
+                {
+                    const TexturePool &pool = *itor;
+                    matchFound = !pool.manuallyReserved &&
+                                 pool.masterTexture->getNumSlices() < mMaxTexturePoolSlices &&
+                                 isTexturePoolCompatible( pool, texture );
+                    if( !matchFound )
+                        ++itor;
+                }
+
+                if( itor != endt )
+                    growTexturePool( *itor, texture, numSlices );
+            }
+        }
 
+        if( itor == endt )
+        {
+            TexturePool newPool;
+            newPool.masterTexture = createTexturePoolMaster( texture, numSlices );
             newPool.manuallyReserved = false;
             newPool.usedMemory = 0;
             newPool.usedSlots.reserve( numSlices );
 
-            newPool.masterTexture->setResolution( texture->getWidth(), texture->getHeight(), numSlices );
-            newPool.masterTexture->setPixelFormat( texture->getPixelFormat() );
-            newPool.masterTexture->setNumMipmaps( texture->getNumMipmaps() );
-            newPool.masterTexture->setTexturePoolId( texture->getTexturePoolId() );
-
             mTexturePool.push_back( newPool );
             itor = --mTexturePool.end();
-
-            itor->masterTexture->_transitionTo( GpuResidency::Resident, 0 );
-            itor->masterTexture->notifyDataIsReady();
         }
 
         uint16 sliceIdx = 0;
@@ -2581,13 +2838,31 @@ namespace Ogre
         const uint8 firstMip = queuedImage.getMinMipLevel();
         const uint8 numMips = queuedImage.getMaxMipLevelPlusOne();
 
-        for( uint8 i = firstMip; i < numMips; ++i )
+        // MipLevelReady only makes sense if this image covers the whole texture
+        const bool bNotifyMips =
+            streamingData.maxUploadBytesPerFrame != 0u &&
+            queuedImage.dstSliceOrDepth == std::numeric_limits<uint32>::max();
+
+        // Upload from the smallest mip to the biggest, so that if we run out of
+        // budget (or staging memory) what's been uploaded is a usable mip tail.
+        bool bTailComplete = true;
+        for( uint8 i = numMips; i-- > firstMip; )
         {
             TextureBox srcBox = img.getData( i );
             const uint32 imgDepthOrSlices = srcBox.getDepthOrSlices();
 
             OGRE_ASSERT_MEDIUM( imgDepthOrSlices < std::numeric_limits<uint8>::max() );
 
+            if( streamingData.maxUploadBytesPerFrame != 0u &&
+                streamingData.bytesPreloaded >= streamingData.maxUploadBytesPerFrame &&
+                std::max( srcBox.width, srcBox.height ) > streamingData.mipTailMaxResolution )
+            {
+                // Out of budget for this frame. Bigger mips will have to wait.
+                break;
+            }
+
+            bool bMipUploaded = false;
+
             for( uint32 z = 0; z < imgDepthOrSlices; ++z )
             {
                 if( queuedImage.isMipSliceQueued( i, (uint8)z ) )
@@ -2619,9 +2894,23 @@ namespace Ogre
                                                                              texture, srcBox, i );
                         // This mip has been processed, flag it as done.
                         queuedImage.unqueueMipSlice( i, (uint8)z );
+                        bMipUploaded = true;
                     }
                 }
             }
+
+            if( bNotifyMips )
+            {
+                for( uint32 z = 0; z < imgDepthOrSlices && bTailComplete; ++z )
+                    bTailComplete = !queuedImage.isMipSliceQueued( i, (uint8)z );
+
+                if( bTailComplete && bMipUploaded && !queuedImage.empty() )
+                {
+                    ObjCmdBuffer::NotifyMipLevelReady *cmd =
+                        commandBuffer->addCommand<ObjCmdBuffer::NotifyMipLevelReady>();
+                    new( cmd ) ObjCmdBuffer::NotifyMipLevelReady( texture, i );
+                }
+            }
         }
 
         if( queuedImage.empty() )
@@ -2712,13 +3001,23 @@ namespace Ogre
         {
             mMultiLoadsSemaphore.decrementOrWait();
 
+            // Don't decode further ahead than the streaming thread can keep up with.
+            // Otherwise during big level loads decoded images pile up in RAM.
+            while( mMultiLoadPendingBytes.load( std::memory_order_relaxed ) >
+                       mMultiLoadMaxPendingBytes.load( std::memory_order_relaxed ) &&
+                   mUseMultiload.load( std::memory_order_relaxed ) )
+            {
+                mWorkerWaitableEvent.wake();
+                Threads::Sleep( 1 );
+            }
+
             bool bWorkGrabbed = false;
 
             mMultiLoadsMutex.lock();
             if( !mMultiLoads.empty() )
             {
-                loadRequest = std::move( mMultiLoads.back() );
-                mMultiLoads.pop_back();
+                loadRequest = std::move( mMultiLoads.front() );
+                mMultiLoads.pop_front();
                 bWorkGrabbed = true;
             }
             bStillHasWork = !mMultiLoads.empty();
@@ -2785,8 +3084,11 @@ namespace Ogre
                 mainData.loadRequests.push_back( loadRequest );
                 if( data )
                 {
-                    mainData.loadRequests.back().image = img;
-                    mainData.loadRequests.back().autoDeleteImage = true;
+                    LoadRequest &decodedRequest = mainData.loadRequests.back();
+                    decodedRequest.image = img;
+                    decodedRequest.autoDeleteImage = true;
+                    decodedRequest.multiLoadBytes = img->getSizeBytes();
+                    mMultiLoadPendingBytes += decodedRequest.multiLoadBytes;
                 }
                 mLoadRequestsMutex.unlock();
                 mWorkerWaitableEvent.wake();
@@ -3261,6 +3563,7 @@ namespace Ogre
                mStreamingData.bytesPreloaded < mMaxPreloadBytes )
         {
             processLoadRequest( commandBuffer, workerData, *itor );
+            mMultiLoadPendingBytes -= itor->multiLoadBytes;
             ++entriesProcessed;
             ++itor;
         }
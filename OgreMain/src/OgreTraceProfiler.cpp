@@ -0,0 +1,399 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreTraceProfiler.h"
+
+#include "OgreBitwise.h"
+#include "OgreLogManager.h"
+#include "OgreLwString.h"
+
+#include <chrono>
+#include <fstream>
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Maps the hashes of all the names ever seen to their strings. Must be usable
+        /// before any TraceProfiler exists, because TraceMarkers are usually static objects.
+        struct TraceNameRegistry
+        {
+            LightweightMutex          mutex;
+            map<uint32, String>::type names;
+
+            static TraceNameRegistry &get()
+            {
+                static TraceNameRegistry registry;
+                return registry;
+            }
+
+            uint32 registerName( const char *name )
+            {
+                const uint32 nameHash = IdString( name ).getU32Value();
+                mutex.lock();
+                map<uint32, String>::type::iterator itor = names.find( nameHash );
+                if( itor == names.end() )
+                    names[nameHash] = name;
+                mutex.unlock();
+                return nameHash;
+            }
+        };
+
+        void appendJsonEscaped( const String &str, String &outJson )
+        {
+            const size_t length = str.size();
+            for( size_t i = 0u; i < length; ++i )
+            {
+                const char c = str[i];
+                if( c == '"' || c == '\\' )
+                {
+                    outJson.push_back( '\\' );
+                    outJson.push_back( c );
+                }
+                else if( static_cast<unsigned char>( c ) < 0x20u )
+                    outJson.push_back( ' ' );
+                else
+                    outJson.push_back( c );
+            }
+        }
+
+        /// Writes nanoseconds as microseconds with 3 decimals (Chrome's unit)
+        void appendTimestamp( uint64 nsTimestamp, LwString &tmpStr )
+        {
+            const uint32 fraction = static_cast<uint32>( nsTimestamp % 1000u );
+            tmpStr.a( nsTimestamp / 1000u, "." );
+            if( fraction < 100u )
+                tmpStr.a( "0" );
+            if( fraction < 10u )
+                tmpStr.a( "0" );
+            tmpStr.a( fraction );
+        }
+
+        /// Closes all the events that are still open, at the given time
+        void closeOpenEvents( size_t &numOpenEvents, uint32 threadIdx, uint64 nsTimestamp,
+                              LwString &tmpStr, String &outJson )
+        {
+            while( numOpenEvents > 0u )
+            {
+                tmpStr.clear();
+                tmpStr.a( ",\n{\"ph\":\"E\",\"pid\":0,\"tid\":", threadIdx, ",\"ts\":" );
+                appendTimestamp( nsTimestamp, tmpStr );
+                tmpStr.a( "}" );
+                outJson += tmpStr.c_str();
+                --numOpenEvents;
+            }
+        }
+    }  // namespace
+
+    TraceMarker::TraceMarker( const char *_name ) :
+        nameHash( TraceNameRegistry::get().registerName( _name ) )
+    {
+    }
+    //-----------------------------------------------------------------------------------
+    //-----------------------------------------------------------------------------------
+    //-----------------------------------------------------------------------------------
+    TraceProfiler::ThreadBuffer::ThreadBuffer( size_t capacity, uint32 threadIdx ) :
+        mEvents( 0 ),
+        mCapacityMask( capacity - 1u ),
+        mWriteIdx( 0u ),
+        mReadStartIdx( 0u ),
+        mThreadIdx( threadIdx )
+    {
+        mEvents = reinterpret_cast<TraceEvent *>(
+            OGRE_MALLOC( capacity * sizeof( TraceEvent ), MEMCATEGORY_GENERAL ) );
+    }
+    //-----------------------------------------------------------------------------------
+    TraceProfiler::ThreadBuffer::~ThreadBuffer()
+    {
+        OGRE_FREE( mEvents, MEMCATEGORY_GENERAL );
+        mEvents = 0;
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::ThreadBuffer::copyEvents( FastArray<TraceEvent> &outEvents ) const
+    {
+        const uint64 capacity = mCapacityMask + 1u;
+
+        const uint64 writeIdx = mWriteIdx.load( std::memory_order_acquire );
+        uint64 readIdx = writeIdx > capacity ? ( writeIdx - capacity ) : 0u;
+        readIdx = std::max( readIdx, mReadStartIdx );
+
+        const size_t prevSize = outEvents.size();
+        outEvents.resizePOD( prevSize + static_cast<size_t>( writeIdx - readIdx ) );
+        for( uint64 i = readIdx; i < writeIdx; ++i )
+            outEvents[prevSize + static_cast<size_t>( i - readIdx )] = mEvents[i & mCapacityMask];
+
+        // The owner thread may have lapped us while we were copying. Drop
+        // anything that could've been overwritten during the copy.
+        std::atomic_thread_fence( std::memory_order_acquire );
+        const uint64 newWriteIdx = mWriteIdx.load( std::memory_order_relaxed );
+        if( newWriteIdx - readIdx > capacity )
+        {
+            const size_t numOverwritten =
+                static_cast<size_t>( std::min( newWriteIdx - readIdx - capacity, writeIdx - readIdx ) );
+            outEvents.erasePOD( outEvents.begin() + static_cast<ptrdiff_t>( prevSize ),
+                             outEvents.begin() + static_cast<ptrdiff_t>( prevSize + numOverwritten ) );
+        }
+    }
+    //-----------------------------------------------------------------------------------
+    //-----------------------------------------------------------------------------------
+    //-----------------------------------------------------------------------------------
+    TraceProfiler::TraceProfiler() :
+        mCapturing( false ),
+        mEnabled( true ),
+        mCaptureIdx( 0u ),
+        mSampleFrequency( 1u ),
+        mFrameCount( 0u ),
+        mEventsPerThread( 1u << 16u ),
+        mTlsHandle( OGRE_TLS_INVALID_HANDLE )
+    {
+        Threads::CreateTls( &mTlsHandle );
+    }
+    //-----------------------------------------------------------------------------------
+    TraceProfiler::~TraceProfiler()
+    {
+        mCapturing.store( false, std::memory_order_relaxed );
+
+        if( !mThreadBuffers.empty() && !mOnShutdownPath.empty() )
+            dumpChromeTrace( mOnShutdownPath );
+
+        mMutex.lock();
+        ThreadBufferArray::const_iterator itor = mThreadBuffers.begin();
+        ThreadBufferArray::const_iterator endt = mThreadBuffers.end();
+
+        while( itor != endt )
+            delete *itor++;
+        mThreadBuffers.clear();
+        mMutex.unlock();
+
+        Threads::DestroyTls( mTlsHandle );
+        mTlsHandle = OGRE_TLS_INVALID_HANDLE;
+    }
+    //-----------------------------------------------------------------------------------
+    TraceProfiler::ThreadBuffer *TraceProfiler::getThreadBuffer()
+    {
+        ThreadBuffer *threadBuffer = reinterpret_cast<ThreadBuffer *>( Threads::GetTls( mTlsHandle ) );
+        if( !threadBuffer )
+            threadBuffer = allocateThreadBuffer();
+        return threadBuffer;
+    }
+    //-----------------------------------------------------------------------------------
+    TraceProfiler::ThreadBuffer *TraceProfiler::allocateThreadBuffer()
+    {
+        mMutex.lock();
+        ThreadBuffer *threadBuffer =
+            new ThreadBuffer( mEventsPerThread, static_cast<uint32>( mThreadBuffers.size() ) );
+        mThreadBuffers.push_back( threadBuffer );
+        mMutex.unlock();
+
+        Threads::SetTls( mTlsHandle, threadBuffer );
+
+        return threadBuffer;
+    }
+    //-----------------------------------------------------------------------------------
+    uint64 TraceProfiler::getNanoseconds() const
+    {
+        return static_cast<uint64>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch() )
+                                        .count() );
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::profileBeginDynamic( const char *name )
+    {
+        if( !mCapturing.load( std::memory_order_relaxed ) )
+            return;
+        profileBegin( TraceNameRegistry::get().registerName( name ) );
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::setEnabled( bool bEnabled ) { mEnabled = bEnabled; }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::setSampleFrequency( uint32 everyNthFrame )
+    {
+        mSampleFrequency = std::max( everyNthFrame, 1u );
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::setEventsPerThread( size_t numEvents )
+    {
+        mEventsPerThread = std::max<size_t>( Bitwise::firstPO2From( static_cast<uint32>( numEvents ) ), 2u );
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::setThreadName( const char *name )
+    {
+        ThreadBuffer *threadBuffer = getThreadBuffer();
+        mMutex.lock();
+        threadBuffer->mThreadName = name;
+        mMutex.unlock();
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::_frameStarted()
+    {
+        const bool bCapture = mEnabled && ( mFrameCount % mSampleFrequency ) == 0u;
+        if( bCapture )
+            mCaptureIdx.fetch_add( 1u, std::memory_order_relaxed );
+        mCapturing.store( bCapture, std::memory_order_relaxed );
+        ++mFrameCount;
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::_frameEnded() { mCapturing.store( false, std::memory_order_relaxed ); }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::reset()
+    {
+        mMutex.lock();
+        ThreadBufferArray::const_iterator itor = mThreadBuffers.begin();
+        ThreadBufferArray::const_iterator endt = mThreadBuffers.end();
+
+        while( itor != endt )
+        {
+            ( *itor )->mReadStartIdx = ( *itor )->mWriteIdx.load( std::memory_order_acquire );
+            ++itor;
+        }
+        mMutex.unlock();
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::exportChromeTrace( String &outJson )
+    {
+        TraceNameRegistry &registry = TraceNameRegistry::get();
+
+        char tmpBuffer[128];
+        LwString tmpStr( LwString::FromEmptyPointer( tmpBuffer, sizeof( tmpBuffer ) ) );
+
+        String json;
+        json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool bFirstEvent = true;
+
+        FastArray<TraceEvent> events;
+
+        mMutex.lock();
+        registry.mutex.lock();
+
+        ThreadBufferArray::const_iterator itor = mThreadBuffers.begin();
+        ThreadBufferArray::const_iterator endt = mThreadBuffers.end();
+
+        while( itor != endt )
+        {
+            const ThreadBuffer *threadBuffer = *itor;
+
+            tmpStr.clear();
+            tmpStr.a( bFirstEvent ? "\n" : ",\n" );
+            tmpStr.a( "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":",
+                      threadBuffer->mThreadIdx, ",\"args\":{\"name\":\"" );
+            if( threadBuffer->mThreadName.empty() )
+                tmpStr.a( "Thread ", threadBuffer->mThreadIdx );
+            json += tmpStr.c_str();
+            appendJsonEscaped( threadBuffer->mThreadName, json );
+            json += "\"}}";
+            bFirstEvent = false;
+
+            events.clear();
+            threadBuffer->copyEvents( events );
+
+            // The ring buffer may have dropped the beginning of an event, and capturing
+            // may have started or stopped in the middle of one. Drop ends without a
+            // begin, and close begins without an end. Begins and ends are only paired
+            // within the same captured frame.
+            size_t numOpenEvents = 0u;
+            uint64 lastTimestamp = 0u;
+            uint16 lastCaptureIdx = events.empty() ? 0u : events.begin()->captureIdx;
+
+            FastArray<TraceEvent>::const_iterator itEvent = events.begin();
+            FastArray<TraceEvent>::const_iterator enEvent = events.end();
+
+            while( itEvent != enEvent )
+            {
+                const TraceEvent &traceEvent = *itEvent;
+                if( traceEvent.captureIdx != lastCaptureIdx )
+                {
+                    closeOpenEvents( numOpenEvents, threadBuffer->mThreadIdx, lastTimestamp, tmpStr,
+                                     json );
+                    lastCaptureIdx = traceEvent.captureIdx;
+                }
+
+                if( traceEvent.type == TraceEventBegin || numOpenEvents > 0u )
+                {
+                    lastTimestamp = traceEvent.nsTimestamp;
+
+                    tmpStr.clear();
+                    tmpStr.a( ",\n{\"ph\":\"", traceEvent.type == TraceEventBegin ? "B" : "E",
+                              "\",\"pid\":0,\"tid\":", threadBuffer->mThreadIdx, ",\"ts\":" );
+                    appendTimestamp( traceEvent.nsTimestamp, tmpStr );
+                    json += tmpStr.c_str();
+
+                    if( traceEvent.type == TraceEventBegin )
+                    {
+                        json += ",\"name\":\"";
+                        map<uint32, String>::type::const_iterator itName =
+                            registry.names.find( traceEvent.nameHash );
+                        if( itName != registry.names.end() )
+                            appendJsonEscaped( itName->second, json );
+                        else
+                            json += IdString( traceEvent.nameHash ).getReleaseText();
+                        json += "\"";
+                        ++numOpenEvents;
+                    }
+                    else
+                    {
+                        --numOpenEvents;
+                    }
+                    json += "}";
+                }
+                ++itEvent;
+            }
+
+            closeOpenEvents( numOpenEvents, threadBuffer->mThreadIdx, lastTimestamp, tmpStr, json );
+
+            ++itor;
+        }
+
+        registry.mutex.unlock();
+        mMutex.unlock();
+
+        json += "\n]}\n";
+        outJson.swap( json );
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::dumpChromeTrace( const String &fullPath )
+    {
+        String json;
+        exportChromeTrace( json );
+
+        std::ofstream outFile( fullPath.c_str(), std::ios::binary | std::ios::out );
+        outFile.write( json.c_str(), static_cast<std::streamsize>( json.size() ) );
+        outFile.close();
+    }
+    //-----------------------------------------------------------------------------------
+    void TraceProfiler::setDumpPathOnShutdown( const String &fullPath )
+    {
+        mOnShutdownPath = fullPath;
+
+        if( !fullPath.empty() )
+        {
+            LogManager::getSingleton().logMessage( "[INFO] Will dump trace on shutdown to " +
+                                                   fullPath );
+        }
+    }
+}  // namespace Ogre
@@ -37,6 +37,36 @@ THE SOFTWARE.
 
 namespace Ogre
 {
+    namespace
+    {
+        /// Freed Request blocks, ready to be reused.
+        struct RequestPool
+        {
+            MpmcRingBuffer<void *> freeBlocks;
+
+            RequestPool() : freeBlocks( 1024u ) {}
+            ~RequestPool()
+            {
+                void *ptr;
+                while( freeBlocks.tryPop( ptr ) )
+                    OGRE_FREE( ptr, MEMCATEGORY_GENERAL );
+            }
+        };
+
+        RequestPool &getRequestPool()
+        {
+            static RequestPool pool;
+            return pool;
+        }
+
+        void *allocateRequest( size_t sz )
+        {
+            void *ptr = 0;
+            if( sz != sizeof( WorkQueue::Request ) || !getRequestPool().freeBlocks.tryPop( ptr ) )
+                ptr = OGRE_MALLOC( sz, MEMCATEGORY_GENERAL );
+            return ptr;
+        }
+    }  // namespace
     //---------------------------------------------------------------------
     uint16 WorkQueue::getChannel( const String &channelName )
     {
@@ -63,6 +93,24 @@ namespace Ogre
     //---------------------------------------------------------------------
     WorkQueue::Request::~Request() {}
     //---------------------------------------------------------------------
+    void *WorkQueue::Request::operator new( size_t sz ) { return allocateRequest( sz ); }
+    //---------------------------------------------------------------------
+    void *WorkQueue::Request::operator new( size_t sz, const char *, int, const char * )
+    {
+        return allocateRequest( sz );
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::Request::operator delete( void *ptr, size_t sz )
+    {
+        if( ptr && ( sz != sizeof( Request ) || !getRequestPool().freeBlocks.tryPush( ptr ) ) )
+            OGRE_FREE( ptr, MEMCATEGORY_GENERAL );
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::Request::operator delete( void *ptr, const char *, int, const char * )
+    {
+        OGRE_FREE( ptr, MEMCATEGORY_GENERAL );
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     WorkQueue::Response::Response( const Request *rq, bool success, const Any &data,
                                    const String &msg ) :
@@ -76,12 +124,38 @@ namespace Ogre
     WorkQueue::Response::~Response() { OGRE_DELETE mRequest; }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
+    bool DefaultWorkQueueBase::AbortRecords::matches( const Request *r ) const
+    {
+        const RequestID rid = r->getID();
+        if( rid <= allRid )
+            return true;
+
+        map<uint16, RequestID>::type::const_iterator itor = channelRid.find( r->getChannel() );
+        if( itor != channelRid.end() && rid <= itor->second )
+            return true;
+
+        return ids.find( rid ) != ids.end();
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::AbortRecords::clear()
+    {
+        allRid = 0;
+        channelRid.clear();
+        ids.clear();
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
     DefaultWorkQueueBase::DefaultWorkQueueBase( const String &name ) :
         mName( name ),
         mWorkerThreadCount( 1 ),
         mWorkerRenderSystemAccess( false ),
         mIsRunning( false ),
         mResposeTimeLimitMS( 8 ),
+        mRequestRing( 1024u ),
+        mNumOverflowRequests( 0u ),
+        mNumUndispatchedRequests( 0u ),
+        mResponseAbortCount( 0u ),
+        mProcessingResponses( false ),
         mWorkerFunc( 0 ),
         mRequestCount( 0 ),
         mPaused( false ),
@@ -112,11 +186,17 @@ namespace Ogre
     {
         // shutdown(); // can't call here; abstract function
 
+        Request *request;
+        while( mRequestRing.tryPop( request ) )
+            OGRE_DELETE request;
+
         for( RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i )
         {
             OGRE_DELETE( *i );
         }
         mRequestQueue.clear();
+        mNumOverflowRequests = 0u;
+        mNumUndispatchedRequests = 0u;
 
         for( ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i )
         {
@@ -196,36 +276,34 @@ namespace Ogre
                                                            const Any &rData, uint8 retryCount,
                                                            bool forceSynchronous, bool idleThread )
     {
-        Request *req = 0;
-        RequestID rid = 0;
-
-        {
-            // lock to acquire rid and push request to the queue
-            OGRE_LOCK_MUTEX( mRequestMutex );
+        if( !mAcceptRequests || mShuttingDown )
+            return 0;
 
-            if( !mAcceptRequests || mShuttingDown )
-                return 0;
+#if OGRE_THREAD_SUPPORT
+        // Counted before the RequestID is handed out, so that once mNumUndispatchedRequests
+        // reaches 0 no request covered by mPendingAborts can still be on its way to the ring.
+        if( !forceSynchronous && !idleThread )
+            ++mNumUndispatchedRequests;
+#endif
 
-            rid = ++mRequestCount;
-            req = OGRE_NEW Request( channel, requestType, rData, retryCount, rid );
+        const RequestID rid = ++mRequestCount;
+        Request *req = OGRE_NEW Request( channel, requestType, rData, retryCount, rid );
 
-            LogManager::getSingleton().stream( LML_TRIVIAL )
-                << "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" <<
+        LogManager::getSingleton().stream( LML_TRIVIAL )
+            << "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" <<
 #if OGRE_THREAD_SUPPORT
-                OGRE_THREAD_CURRENT_ID
+            OGRE_THREAD_CURRENT_ID
 #else
-                "main"
+            "main"
 #endif
-                << "): ID=" << rid << " channel=" << channel << " requestType=" << requestType;
+            << "): ID=" << rid << " channel=" << channel << " requestType=" << requestType;
 #if OGRE_THREAD_SUPPORT
-            if( !forceSynchronous && !idleThread )
-            {
-                mRequestQueue.push_back( req );
-                notifyWorkers();
-                return rid;
-            }
-#endif
+        if( !forceSynchronous && !idleThread )
+        {
+            pushRequest( req );
+            return rid;
         }
+#endif
         if( OGRE_THREAD_SUPPORT && idleThread )
         {
             OGRE_LOCK_MUTEX( mIdleMutex );
@@ -246,9 +324,6 @@ namespace Ogre
                                                   uint16 requestType, const Any &rData,
                                                   uint8 retryCount )
     {
-        // lock to push request to the queue
-        OGRE_LOCK_MUTEX( mRequestMutex );
-
         if( mShuttingDown )
             return;
 
@@ -263,38 +338,54 @@ namespace Ogre
 #endif
             << "): ID=" << rid << " channel=" << channel << " requestType=" << requestType;
 #if OGRE_THREAD_SUPPORT
-        mRequestQueue.push_back( req );
-        notifyWorkers();
+        ++mNumUndispatchedRequests;
+        pushRequest( req );
 #else
         processRequestResponse( req, true );
 #endif
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::pushRequest( Request *req )
+    {
+        if( mNumOverflowRequests.load( std::memory_order_relaxed ) != 0u ||
+            !mRequestRing.tryPush( req ) )
+        {
+            OGRE_LOCK_MUTEX( mRequestMutex );
+            mRequestQueue.push_back( req );
+            ++mNumOverflowRequests;
+        }
+        notifyWorkers();
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::abortRequest( RequestID id )
     {
         OGRE_LOCK_MUTEX( mProcessMutex );
 
-        // NOTE: Pending requests are exist any of RequestQueue, ProcessQueue and
-        // ResponseQueue when keeping ProcessMutex, so we check all of these queues.
+        // NOTE: Pending requests are exist any of RequestRing, RequestQueue, ProcessQueue,
+        // ResponseQueue and ResponseBatch when keeping ProcessMutex, so we check all of these
+        // queues. The ring and the batch can't be iterated, so the abort gets recorded instead.
+        bool found = false;
 
-        for( RequestQueue::iterator i = mProcessQueue.begin(); i != mProcessQueue.end(); ++i )
+        for( RequestQueue::iterator i = mProcessQueue.begin(); i != mProcessQueue.end() && !found;
+             ++i )
         {
             if( ( *i )->getID() == id )
             {
                 ( *i )->abortRequest();
-                break;
+                found = true;
             }
         }
 
         {
             OGRE_LOCK_MUTEX( mRequestMutex );
 
-            for( RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i )
+            for( RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end() && !found;
+                 ++i )
             {
                 if( ( *i )->getID() == id )
                 {
                     ( *i )->abortRequest();
-                    break;
+                    found = true;
                 }
             }
         }
@@ -316,14 +407,30 @@ namespace Ogre
         {
             OGRE_LOCK_MUTEX( mResponseMutex );
 
-            for( ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i )
+            for( ResponseQueue::iterator i = mResponseQueue.begin();
+                 i != mResponseQueue.end() && !found; ++i )
             {
                 if( ( *i )->getRequest()->getID() == id )
                 {
                     ( *i )->abortRequest();
-                    break;
+                    found = true;
                 }
             }
+
+            if( mProcessingResponses )
+            {
+                mResponseAborts.ids.insert( id );
+                ++mResponseAbortCount;
+            }
+        }
+
+        // Only requests still in the ring, or popped but not in mProcessQueue yet, can
+        // miss the abort. Recording ids that were never issued or that already finished
+        // would keep them in mPendingAborts forever (or abort an unrelated future request).
+        if( !found && id != 0u && id <= mRequestCount.load() &&
+            mNumUndispatchedRequests.load() != 0u )
+        {
+            mPendingAborts.ids.insert( id );
         }
     }
     //---------------------------------------------------------------------
@@ -331,6 +438,9 @@ namespace Ogre
     {
         OGRE_LOCK_MUTEX( mProcessMutex );
 
+        const RequestID lastRid = mRequestCount.load();
+        mPendingAborts.channelRid[channel] = lastRid;
+
         for( RequestQueue::iterator i = mProcessQueue.begin(); i != mProcessQueue.end(); ++i )
         {
             if( ( *i )->getChannel() == channel )
@@ -378,11 +488,21 @@ namespace Ogre
                     ( *i )->abortRequest();
                 }
             }
+
+            if( mProcessingResponses )
+            {
+                mResponseAborts.channelRid[channel] = lastRid;
+                ++mResponseAbortCount;
+            }
         }
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::abortPendingRequestsByChannel( uint16 channel )
     {
+        OGRE_LOCK_MUTEX( mProcessMutex );
+
+        mPendingAborts.channelRid[channel] = mRequestCount.load();
+
         {
             OGRE_LOCK_MUTEX( mRequestMutex );
             for( RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i )
@@ -410,6 +530,11 @@ namespace Ogre
     void DefaultWorkQueueBase::abortAllRequests()
     {
         OGRE_LOCK_MUTEX( mProcessMutex );
+
+        // Supersedes all previous records
+        const RequestID lastRid = mRequestCount.load();
+        mPendingAborts.clear();
+        mPendingAborts.allRid = lastRid;
         {
             for( RequestQueue::iterator i = mProcessQueue.begin(); i != mProcessQueue.end(); ++i )
             {
@@ -448,6 +573,13 @@ namespace Ogre
             {
                 ( *i )->abortRequest();
             }
+
+            if( mProcessingResponses )
+            {
+                mResponseAborts.clear();
+                mResponseAborts.allRid = lastRid;
+                ++mResponseAbortCount;
+            }
         }
     }
     //---------------------------------------------------------------------
@@ -477,23 +609,38 @@ namespace Ogre
             return;
         }
         Request *request = 0;
+        if( !mRequestRing.tryPop( request ) &&
+            mNumOverflowRequests.load( std::memory_order_relaxed ) != 0u )
         {
-            // scoped to only lock while retrieving the next request
-            OGRE_LOCK_MUTEX( mProcessMutex );
-            {
-                OGRE_LOCK_MUTEX( mRequestMutex );
+            OGRE_LOCK_MUTEX( mRequestMutex );
 
-                if( !mRequestQueue.empty() )
-                {
-                    request = mRequestQueue.front();
-                    mRequestQueue.pop_front();
-                    mProcessQueue.push_back( request );
-                }
+            if( !mRequestQueue.empty() )
+            {
+                request = mRequestQueue.front();
+                mRequestQueue.pop_front();
+                --mNumOverflowRequests;
             }
         }
 
         if( request )
         {
+            {
+                OGRE_LOCK_MUTEX( mProcessMutex );
+                mProcessQueue.push_back( request );
+
+                // The request may have been aborted while nobody could see it
+                if( !mPendingAborts.empty() && mPendingAborts.matches( request ) )
+                {
+                    request->abortRequest();
+                    mPendingAborts.ids.erase( request->getID() );
+                }
+
+                // Every request issued so far has been checked; whatever is left only
+                // covers requests that were already dispatched when they got aborted.
+                if( --mNumUndispatchedRequests == 0u )
+                    mPendingAborts.clear();
+            }
+
             processRequestResponse( request, false );
         }
     }
@@ -523,7 +670,7 @@ namespace Ogre
             {
                 // Failed, should we retry?
                 const Request *req = response->getRequest();
-                if( req->getRetryCount() )
+                if( req->getRetryCount() && !req->getAborted() )
                 {
                     addRequestWithRID( req->getID(), req->getChannel(), req->getType(), req->getData(),
                                        req->getRetryCount() - 1 );
@@ -565,31 +712,40 @@ namespace Ogre
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processResponses()
     {
+        uint32 abortCount;
+        {
+            // Take all responses at once, so that workers pushing new responses
+            // don't compete with us for the mutex for every single one of them
+            OGRE_LOCK_MUTEX( mResponseMutex );
+
+            if( mResponseQueue.empty() )
+                return;
+
+            mResponseBatch.swap( mResponseQueue );
+            mProcessingResponses = true;
+            abortCount = mResponseAbortCount.load( std::memory_order_relaxed );
+        }
+
         const uint64 msStart = Root::getSingleton().getTimer()->getMilliseconds();
         uint64 msCurrent = 0;
 
         // keep going until we run out of responses or out of time
-        while( true )
+        while( !mResponseBatch.empty() )
         {
-            Response *response = 0;
+            if( mResponseAbortCount.load( std::memory_order_acquire ) != abortCount )
             {
+                // Someone (possibly a response handler) aborted requests in the batch
                 OGRE_LOCK_MUTEX( mResponseMutex );
-
-                if( mResponseQueue.empty() )
-                    break;  // exit loop
-                else
-                {
-                    response = mResponseQueue.front();
-                    mResponseQueue.pop_front();
-                }
+                abortCount = mResponseAbortCount.load( std::memory_order_relaxed );
+                applyResponseAborts();
             }
 
-            if( response )
-            {
-                processResponse( response );
+            Response *response = mResponseBatch.front();
+            mResponseBatch.pop_front();
 
-                OGRE_DELETE response;
-            }
+            processResponse( response );
+
+            OGRE_DELETE response;
 
             // time limit
             if( mResposeTimeLimitMS )
@@ -599,6 +755,29 @@ namespace Ogre
                     break;
             }
         }
+
+        {
+            OGRE_LOCK_MUTEX( mResponseMutex );
+
+            if( mResponseAbortCount.load( std::memory_order_relaxed ) != abortCount )
+                applyResponseAborts();
+
+            // What we didn't get to goes back in front of newer responses
+            mResponseQueue.insert( mResponseQueue.begin(), mResponseBatch.begin(),
+                                   mResponseBatch.end() );
+            mResponseBatch.clear();
+            mResponseAborts.clear();
+            mProcessingResponses = false;
+        }
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::applyResponseAborts()
+    {
+        for( ResponseQueue::iterator i = mResponseBatch.begin(); i != mResponseBatch.end(); ++i )
+        {
+            if( mResponseAborts.matches( ( *i )->getRequest() ) )
+                ( *i )->abortRequest();
+        }
     }
     //---------------------------------------------------------------------
     WorkQueue::Response *DefaultWorkQueueBase::processRequest( Request *r )
@@ -41,8 +41,12 @@ Billboard BillboardSet::allocBillboard()
     Billboard retVal( handle, this );
     retVal.setVisible( true );
 
-    mVaoPerLod[0].back()->setPrimitiveRange( 0u,
-                                             static_cast<uint32>( getParticlesToRenderTighter() * 6u ) );
+    // Sorted sets only render their visible billboards. See ParticleSystemManager2::updateSerialPos.
+    if( !mSortedIndexBuffer )
+    {
+        mVaoPerLod[0].back()->setPrimitiveRange(
+            0u, static_cast<uint32>( getParticlesToRenderTighter() * 6u ) );
+    }
 
     return Billboard( handle, this );
 }
@@ -52,6 +56,10 @@ void BillboardSet::deallocBillboard( Billboard billboard )
     billboard.setVisible( false );
     deallocParticle( billboard.mHandle );
 
-    mVaoPerLod[0].back()->setPrimitiveRange( 0u,
-                                             static_cast<uint32>( getParticlesToRenderTighter() * 6u ) );
+    // Sorted sets only render their visible billboards. See ParticleSystemManager2::updateSerialPos.
+    if( !mSortedIndexBuffer )
+    {
+        mVaoPerLod[0].back()->setPrimitiveRange(
+            0u, static_cast<uint32>( getParticlesToRenderTighter() * 6u ) );
+    }
 }
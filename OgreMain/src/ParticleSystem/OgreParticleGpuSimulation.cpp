@@ -0,0 +1,561 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
+
+#include "Math/Array/OgreArrayAabb.h"
+#include "OgreHlmsCompute.h"
+#include "OgreHlmsComputeJob.h"
+#include "OgreRenderSystem.h"
+#include "OgreRenderSystemCapabilities.h"
+#include "OgreStringConverter.h"
+#include "ParticleSystem/OgreParticleAffector2.h"
+#include "ParticleSystem/OgreParticleSystem2.h"
+#include "ParticleSystem/OgreParticleSystemManager2.h"
+#include "Vao/OgreAsyncTicket.h"
+#include "Vao/OgreUavBufferPacked.h"
+#include "Vao/OgreVaoManager.h"
+
+#include <cfloat>
+#include <cmath>
+
+using namespace Ogre;
+
+namespace
+{
+    // See ParticleSystemManager2::_tickParticles
+    const float kColourRange = 124.0f;
+    const float kMinColourValue = -4.0f;
+
+    inline int16 toSnorm16( float value )
+    {
+        const float v = std::nearbyint( value * 32767.5f );
+        return static_cast<int16>( Math::Clamp( v, -32768.0f, 32767.0f ) );
+    }
+
+    inline int8 toSnorm8( float value )
+    {
+        const float v = std::nearbyint( value * 127.5f );
+        return static_cast<int8>( Math::Clamp( v, -128.0f, 127.0f ) );
+    }
+
+    /// Same as ArrayRadian::wrapToRangeNPI_PI
+    inline float wrapToRangeNPI_PI( float rad )
+    {
+        const float signedPi = std::copysign( Math::PI, rad );
+        const float x = rad + signedPi;
+        const float integerQuot = std::trunc( x * ( 1.0f / Math::TWO_PI ) );
+        return ( x - integerQuot * Math::TWO_PI ) - signedPi;
+    }
+
+    void encodeGpuData( const ParticleGpuState &state, ParticleGpuData &outGpuData )
+    {
+        if( state.mTimeToLive <= 0.0f )
+        {
+            memset( &outGpuData, 0, sizeof( outGpuData ) );
+            return;
+        }
+
+        outGpuData.mWidth = state.mDimensions[0];
+        outGpuData.mHeight = state.mDimensions[1];
+        for( size_t i = 0u; i < 3u; ++i )
+            outGpuData.mPos[i] = state.mPos[i];
+
+        const float sqLength = state.mDirection[0] * state.mDirection[0] +
+                               state.mDirection[1] * state.mDirection[1] +
+                               state.mDirection[2] * state.mDirection[2];
+        const float invLength = sqLength > FLT_MIN ? 1.0f / std::sqrt( sqLength ) : 1.0f;
+        for( size_t i = 0u; i < 3u; ++i )
+            outGpuData.mDirection[i] = toSnorm8( state.mDirection[i] * invLength );
+
+        outGpuData.mRotation = toSnorm16( state.mRotation * ( 1.0f / Math::PI ) );
+
+        for( size_t i = 0u; i < 3u; ++i )
+        {
+            outGpuData.mColourRgb[i] = toSnorm16( state.mColour[i] * ( 1.0f / kColourRange ) +
+                                                  -kMinColourValue / kColourRange );
+        }
+        outGpuData.mColourAlpha = toSnorm8( state.mColour[3] * 2.0f - 1.0f );
+    }
+
+    void applyAffector( ParticleGpuState &state, const ParticleGpuAffector &affector,
+                        const float timeSinceLast )
+    {
+        switch( affector.op )
+        {
+        case ParticleGpuAffectorOp::LinearForceAdd:
+            for( size_t i = 0u; i < 3u; ++i )
+                state.mDirection[i] += affector.params[0][i] * timeSinceLast;
+            break;
+        case ParticleGpuAffectorOp::LinearForceAverage:
+            for( size_t i = 0u; i < 3u; ++i )
+                state.mDirection[i] = ( state.mDirection[i] + affector.params[0][i] ) * 0.5f;
+            break;
+        case ParticleGpuAffectorOp::ColourFade:
+            for( size_t i = 0u; i < 4u; ++i )
+            {
+                state.mColour[i] =
+                    std::min( std::max( state.mColour[i] + affector.params[0][i] * timeSinceLast,
+                                        affector.params[1][i] ),
+                              affector.params[2][i] );
+            }
+            break;
+        case ParticleGpuAffectorOp::ColourFadeTwoStates:
+        {
+            const Vector4 &colourAdj =
+                state.mTimeToLive > affector.stateChange ? affector.params[0] : affector.params[1];
+            for( size_t i = 0u; i < 4u; ++i )
+            {
+                state.mColour[i] = std::min( std::max( state.mColour[i] + colourAdj[i] * timeSinceLast,
+                                                       affector.params[2][i] ),
+                                             affector.params[3][i] );
+            }
+            break;
+        }
+        case ParticleGpuAffectorOp::ScaleAdd:
+            state.mDimensions[0] += affector.params[0].x * timeSinceLast;
+            state.mDimensions[1] += affector.params[0].x * timeSinceLast;
+            break;
+        case ParticleGpuAffectorOp::ScaleMultiply:
+        {
+            const float deltaScale = std::pow( affector.params[0].x, timeSinceLast );
+            state.mDimensions[0] *= deltaScale;
+            state.mDimensions[1] *= deltaScale;
+            break;
+        }
+        case ParticleGpuAffectorOp::Rotate:
+            state.mRotation =
+                wrapToRangeNPI_PI( state.mRotation + state.mRotationSpeed * timeSinceLast );
+            break;
+        }
+    }
+
+    inline bool isWithinUlp( int a, int b ) { return std::abs( a - b ) <= 1; }
+
+    /// Compares two simulations of the same particles. Returns the number of particles that
+    /// didn't match. See ParticleGpuSimulation::compareWithCpu.
+    size_t compareSimulations( const ParticleGpuState *statesA, const ParticleGpuData *gpuDataA,
+                               const char *nameA, const ParticleGpuState *statesB,
+                               const ParticleGpuData *gpuDataB, const char *nameB,
+                               const size_t numParticles, const float tolerance, String *outReport )
+    {
+        size_t numMismatches = 0u;
+        for( size_t i = 0u; i < numParticles; ++i )
+        {
+            const float *a = reinterpret_cast<const float *>( &statesA[i] );
+            const float *b = reinterpret_cast<const float *>( &statesB[i] );
+            bool bMatches = true;
+            for( size_t j = 0u; j < sizeof( ParticleGpuState ) / sizeof( float ) && bMatches; ++j )
+                bMatches = std::abs( a[j] - b[j] ) <= tolerance;
+
+            const ParticleGpuData &ga = gpuDataA[i];
+            const ParticleGpuData &gb = gpuDataB[i];
+            bMatches = bMatches && std::abs( ga.mWidth - gb.mWidth ) <= tolerance &&
+                       std::abs( ga.mHeight - gb.mHeight ) <= tolerance &&
+                       isWithinUlp( ga.mColourAlpha, gb.mColourAlpha ) &&
+                       isWithinUlp( ga.mRotation, gb.mRotation );
+            for( size_t j = 0u; j < 3u && bMatches; ++j )
+            {
+                bMatches = std::abs( ga.mPos[j] - gb.mPos[j] ) <= tolerance &&
+                           isWithinUlp( ga.mDirection[j], gb.mDirection[j] ) &&
+                           isWithinUlp( ga.mColourRgb[j], gb.mColourRgb[j] );
+            }
+
+            if( !bMatches )
+            {
+                if( numMismatches == 0u && outReport )
+                {
+                    *outReport = "Particle " + StringConverter::toString( i ) + " differs. Position " +
+                                 nameA + ": " + StringConverter::toString( statesA[i].mPos[0] ) +
+                                 " " + StringConverter::toString( statesA[i].mPos[1] ) + " " +
+                                 StringConverter::toString( statesA[i].mPos[2] ) + " " + nameB +
+                                 ": " + StringConverter::toString( statesB[i].mPos[0] ) + " " +
+                                 StringConverter::toString( statesB[i].mPos[1] ) + " " +
+                                 StringConverter::toString( statesB[i].mPos[2] );
+                }
+                ++numMismatches;
+            }
+        }
+
+        return numMismatches;
+    }
+}  // namespace
+
+//-----------------------------------------------------------------------------
+ParticleGpuSimulation::ParticleGpuSimulation( HlmsCompute *hlmsCompute ) :
+    mHlmsCompute( hlmsCompute ),
+    mSpawnJob( 0 ),
+    mSimulateJob( 0 )
+{
+    mSpawnJob = mHlmsCompute->findComputeJobNoThrow( "Compute/ParticleFX2/Spawn" );
+    mSimulateJob = mHlmsCompute->findComputeJobNoThrow( "Compute/ParticleFX2/Simulate" );
+
+    if( !mSpawnJob || !mSimulateJob )
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                     "To simulate particles on the GPU, Ogre must be build with JSON support "
+                     "and you must include the resources bundled at "
+                     "Samples/Media/Compute/ParticleFX2",
+                     "ParticleGpuSimulation::ParticleGpuSimulation" );
+    }
+
+    mSimulateJob->setProperty( "max_affectors_x_stride",
+                               static_cast<int32>( MaxAffectors * AffectorStride ) );
+}
+//-----------------------------------------------------------------------------
+void ParticleGpuSimulation::simulate( ParticleSystemDef *systemDef, const uint32 numSpawns,
+                                      const float timeSinceLast )
+{
+    OGRE_ASSERT_LOW( systemDef->isGpuSimulated() );
+
+    RenderSystem *renderSystem = mHlmsCompute->getRenderSystem();
+
+    if( systemDef->mGpuPoolNeedsReset )
+    {
+        // All particles were killed from the CPU side. Kill them in the GPU too.
+        const size_t poolSize = systemDef->mGpuPool->getTotalSizeBytes();
+        void *zeroes = OGRE_MALLOC( poolSize, MEMCATEGORY_GENERAL );
+        memset( zeroes, 0, poolSize );
+        systemDef->mGpuPool->upload( zeroes, 0u, systemDef->mGpuPool->getNumElements() );
+        OGRE_FREE( zeroes, MEMCATEGORY_GENERAL );
+        systemDef->mGpuPoolNeedsReset = false;
+    }
+
+    DescriptorSetUav::BufferSlot bufferSlot( DescriptorSetUav::BufferSlot::makeEmpty() );
+
+    if( numSpawns > 0u )
+    {
+        systemDef->mGpuSpawnBuffer->upload( systemDef->mGpuSpawns.begin(), 0u, numSpawns );
+
+        bufferSlot.buffer = systemDef->mGpuPool;
+        bufferSlot.access = ResourceAccess::Write;
+        mSpawnJob->_setUavBuffer( 0, bufferSlot );
+        bufferSlot.buffer = systemDef->mGpuSpawnBuffer;
+        bufferSlot.access = ResourceAccess::Read;
+        mSpawnJob->_setUavBuffer( 1, bufferSlot );
+
+        ShaderParams::Param paramNumSpawns;
+        paramNumSpawns.name = "numSpawns";
+        paramNumSpawns.setManualValue( numSpawns );
+
+        ShaderParams &shaderParams = mSpawnJob->getShaderParams( "default" );
+        shaderParams.mParams.clear();
+        shaderParams.mParams.push_back( paramNumSpawns );
+        shaderParams.setDirty();
+
+        const uint32 threadsPerGroupX = mSpawnJob->getThreadsPerGroupX();
+        mSpawnJob->setNumThreadGroups( ( numSpawns + threadsPerGroupX - 1u ) / threadsPerGroupX,
+                                       1u, 1u );
+
+        mSpawnJob->analyzeBarriers( mResourceTransitions );
+        renderSystem->executeResourceTransition( mResourceTransitions );
+        mHlmsCompute->dispatch( mSpawnJob, 0, 0 );
+    }
+
+    // The affectors' parameters may have changed since last frame.
+    FastArray<ParticleGpuAffector> &gpuAffectors = systemDef->mGpuAffectors;
+    gpuAffectors.clear();
+    getGpuAffectors( systemDef->mAffectors, gpuAffectors );
+
+    // The pool is walked as a whole (instead of only getNumSimdActiveParticles) because
+    // particles keep being simulated on the GPU until their time to live reaches 0, even if the
+    // CPU already recycled the range.
+    dispatchSimulate( systemDef->mGpuPool, systemDef->mGpuRenderData, systemDef->getQuota(),
+                      gpuAffectors, timeSinceLast );
+
+    // The vertex shader reads what we've just written.
+    BarrierSolver &barrierSolver = renderSystem->getBarrierSolver();
+    ResourceTransitionArray &barrier = barrierSolver.getNewResourceTransitionsArrayTmp();
+    barrierSolver.resolveTransition( barrier, systemDef->mGpuRenderData, ResourceAccess::Read,
+                                     1u << GPT_VERTEX_PROGRAM );
+    renderSystem->executeResourceTransition( barrier );
+}
+//-----------------------------------------------------------------------------
+void ParticleGpuSimulation::dispatchSimulate( UavBufferPacked *pool, UavBufferPacked *renderData,
+                                              const uint32 numParticles,
+                                              const FastArray<ParticleGpuAffector> &gpuAffectors,
+                                              const float timeSinceLast )
+{
+    RenderSystem *renderSystem = mHlmsCompute->getRenderSystem();
+
+    const size_t numAffectors = gpuAffectors.size();
+    mAffectorData.resizePOD( MaxAffectors * AffectorStride * 4u );
+    memset( mAffectorData.begin(), 0, mAffectorData.size() * sizeof( float ) );
+    float *affectorData = mAffectorData.begin();
+    for( const ParticleGpuAffector &affector : gpuAffectors )
+    {
+        affectorData[0] = static_cast<float>( affector.op );
+        affectorData[1] = affector.stateChange;
+        for( size_t i = 0u; i < 4u; ++i )
+        {
+            for( size_t j = 0u; j < 4u; ++j )
+                affectorData[4u + i * 4u + j] = static_cast<float>( affector.params[i][j] );
+        }
+        affectorData += AffectorStride * 4u;
+    }
+
+    DescriptorSetUav::BufferSlot bufferSlot( DescriptorSetUav::BufferSlot::makeEmpty() );
+    bufferSlot.buffer = pool;
+    bufferSlot.access = ResourceAccess::ReadWrite;
+    mSimulateJob->_setUavBuffer( 0, bufferSlot );
+    bufferSlot.buffer = renderData;
+    bufferSlot.access = ResourceAccess::Write;
+    mSimulateJob->_setUavBuffer( 1, bufferSlot );
+
+    ShaderParams::Param paramCounts;
+    paramCounts.name = "numParticles_numAffectors";
+    const uint32 counts[2] = { numParticles, static_cast<uint32>( numAffectors ) };
+    paramCounts.setManualValue( counts, 2u );
+
+    ShaderParams::Param paramTimeSinceLast;
+    paramTimeSinceLast.name = "timeSinceLast";
+    paramTimeSinceLast.setManualValue( timeSinceLast );
+
+    ShaderParams::Param paramAffectors;
+    paramAffectors.name = "affectorData";
+    paramAffectors.setManualValueEx( mAffectorData.begin(),
+                                     static_cast<uint32>( mAffectorData.size() ) );
+
+    ShaderParams &shaderParams = mSimulateJob->getShaderParams( "default" );
+    shaderParams.mParams.clear();
+    shaderParams.mParams.push_back( paramCounts );
+    shaderParams.mParams.push_back( paramTimeSinceLast );
+    shaderParams.mParams.push_back( paramAffectors );
+    shaderParams.setDirty();
+
+    const uint32 threadsPerGroupX = mSimulateJob->getThreadsPerGroupX();
+    mSimulateJob->setNumThreadGroups( ( numParticles + threadsPerGroupX - 1u ) / threadsPerGroupX,
+                                      1u, 1u );
+
+    mSimulateJob->analyzeBarriers( mResourceTransitions );
+    renderSystem->executeResourceTransition( mResourceTransitions );
+    mHlmsCompute->dispatch( mSimulateJob, 0, 0 );
+}
+//-----------------------------------------------------------------------------
+bool ParticleGpuSimulation::getGpuAffectors( const FastArray<ParticleAffector2 *> &affectors,
+                                             FastArray<ParticleGpuAffector> &outAffectors )
+{
+    if( affectors.size() > MaxAffectors )
+        return false;
+
+    for( const ParticleAffector2 *affector : affectors )
+    {
+        ParticleGpuAffector gpuAffector;
+        if( !affector->getGpuAffector( gpuAffector ) )
+            return false;
+        outAffectors.push_back( gpuAffector );
+    }
+
+    return true;
+}
+//-----------------------------------------------------------------------------
+void ParticleGpuSimulation::packState( const ParticleCpuData &cpuData, const uint32 handle,
+                                       ParticleGpuState &outState )
+{
+    const size_t packIdx = handle / ARRAY_PACKED_REALS;
+    const size_t lane = handle % ARRAY_PACKED_REALS;
+
+    Vector3 vec3;
+    cpuData.mPosition[packIdx].getAsVector3( vec3, lane );
+    outState.mPos[0] = static_cast<float>( vec3.x );
+    outState.mPos[1] = static_cast<float>( vec3.y );
+    outState.mPos[2] = static_cast<float>( vec3.z );
+    cpuData.mDirection[packIdx].getAsVector3( vec3, lane );
+    outState.mDirection[0] = static_cast<float>( vec3.x );
+    outState.mDirection[1] = static_cast<float>( vec3.y );
+    outState.mDirection[2] = static_cast<float>( vec3.z );
+
+    Vector2 dim;
+    cpuData.mDimensions[packIdx].getAsVector2( dim, lane );
+    outState.mDimensions[0] = static_cast<float>( dim.x );
+    outState.mDimensions[1] = static_cast<float>( dim.y );
+
+    Vector4 colour;
+    cpuData.mColour[packIdx].getAsVector4( colour, lane );
+    for( size_t i = 0u; i < 4u; ++i )
+        outState.mColour[i] = static_cast<float>( colour[i] );
+
+    outState.mRotation = static_cast<float>(
+        reinterpret_cast<const Radian * RESTRICT_ALIAS>( cpuData.mRotation )[handle].valueRadians() );
+    outState.mRotationSpeed = static_cast<float>(
+        reinterpret_cast<const Radian * RESTRICT_ALIAS>( cpuData.mRotationSpeed )[handle]
+            .valueRadians() );
+    outState.mTimeToLive = static_cast<float>(
+        reinterpret_cast<const Real * RESTRICT_ALIAS>( cpuData.mTimeToLive )[handle] );
+    outState.mTotalTimeToLive = static_cast<float>(
+        reinterpret_cast<const Real * RESTRICT_ALIAS>( cpuData.mTotalTimeToLive )[handle] );
+}
+//-----------------------------------------------------------------------------
+void ParticleGpuSimulation::simulateReference( ParticleGpuState *particles,
+                                               ParticleGpuData *outGpuData, const size_t numParticles,
+                                               const ParticleGpuAffector *affectors,
+                                               const size_t numAffectors, const float timeSinceLast )
+{
+    for( size_t i = 0u; i < numParticles; ++i )
+    {
+        ParticleGpuState &state = particles[i];
+
+        for( size_t j = 0u; j < numAffectors; ++j )
+            applyAffector( state, affectors[j], timeSinceLast );
+
+        for( size_t j = 0u; j < 3u; ++j )
+            state.mPos[j] += state.mDirection[j] * timeSinceLast;
+        state.mTimeToLive = std::max( state.mTimeToLive - timeSinceLast, 0.0f );
+
+        encodeGpuData( state, outGpuData[i] );
+    }
+}
+//-----------------------------------------------------------------------------
+size_t ParticleGpuSimulation::compareWithCpu( ParticleCpuData cpuData, const size_t numParticles,
+                                              const FastArray<ParticleAffector2 *> &affectors,
+                                              const float timeSinceLast, const uint32 numFrames,
+                                              const float tolerance, String *outReport )
+{
+    OGRE_ASSERT_LOW( numParticles % ARRAY_PACKED_REALS == 0u );
+
+    FastArray<ParticleGpuAffector> gpuAffectors;
+    if( !getGpuAffectors( affectors, gpuAffectors ) )
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                     "All affectors must support running on the GPU (see "
+                     "ParticleAffector2::getGpuAffector)",
+                     "ParticleGpuSimulation::compareWithCpu" );
+    }
+
+    FastArray<ParticleGpuState> states;
+    states.resizePOD( numParticles );
+    for( size_t i = 0u; i < numParticles; ++i )
+        packState( cpuData, static_cast<uint32>( i ), states[i] );
+
+    FastArray<ParticleGpuData> cpuGpuData;
+    FastArray<ParticleGpuData> refGpuData;
+    cpuGpuData.resizePOD( numParticles );
+    refGpuData.resizePOD( numParticles );
+
+    const ArrayReal arrayTimeSinceLast = Mathlib::SetAll( timeSinceLast );
+
+    for( uint32 frame = 0u; frame < numFrames; ++frame )
+    {
+        for( const ParticleAffector2 *affector : affectors )
+            affector->run( cpuData, numParticles, arrayTimeSinceLast );
+        ArrayAabb aabb = ArrayAabb::BOX_NULL;
+        ParticleSystemManager2::_tickParticles( arrayTimeSinceLast, cpuData, cpuGpuData.begin(),
+                                                numParticles, 0, 0, aabb );
+
+        simulateReference( states.begin(), refGpuData.begin(), numParticles, gpuAffectors.begin(),
+                           gpuAffectors.size(), timeSinceLast );
+    }
+
+    FastArray<ParticleGpuState> cpuStates;
+    cpuStates.resizePOD( numParticles );
+    for( size_t i = 0u; i < numParticles; ++i )
+        packState( cpuData, static_cast<uint32>( i ), cpuStates[i] );
+
+    return compareSimulations( cpuStates.begin(), cpuGpuData.begin(), "CPU", states.begin(),
+                               refGpuData.begin(), "Reference", numParticles, tolerance, outReport );
+}
+//-----------------------------------------------------------------------------
+size_t ParticleGpuSimulation::compareWithGpu( const ParticleCpuData &cpuData,
+                                              const size_t numParticles,
+                                              const FastArray<ParticleAffector2 *> &affectors,
+                                              const float timeSinceLast, const uint32 numFrames,
+                                              const float tolerance, String *outReport )
+{
+    RenderSystem *renderSystem = mHlmsCompute->getRenderSystem();
+    if( !renderSystem->getCapabilities()->hasCapability( RSC_COMPUTE_PROGRAM ) )
+    {
+        OGRE_EXCEPT( Exception::ERR_RENDERINGAPI_ERROR,
+                     "The RenderSystem doesn't support compute shaders",
+                     "ParticleGpuSimulation::compareWithGpu" );
+    }
+
+    FastArray<ParticleGpuAffector> gpuAffectors;
+    if( !getGpuAffectors( affectors, gpuAffectors ) )
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS,
+                     "All affectors must support running on the GPU (see "
+                     "ParticleAffector2::getGpuAffector)",
+                     "ParticleGpuSimulation::compareWithGpu" );
+    }
+
+    FastArray<ParticleGpuState> states;
+    states.resizePOD( numParticles );
+    for( size_t i = 0u; i < numParticles; ++i )
+        packState( cpuData, static_cast<uint32>( i ), states[i] );
+
+    VaoManager *vaoManager = renderSystem->getVaoManager();
+    UavBufferPacked *pool = vaoManager->createUavBuffer( numParticles, sizeof( ParticleGpuState ),
+                                                         0u, states.begin(), false );
+    UavBufferPacked *renderData =
+        vaoManager->createUavBuffer( numParticles, sizeof( ParticleGpuData ), 0u, 0, false );
+
+    for( uint32 frame = 0u; frame < numFrames; ++frame )
+    {
+        dispatchSimulate( pool, renderData, static_cast<uint32>( numParticles ), gpuAffectors,
+                          timeSinceLast );
+    }
+
+    BarrierSolver &barrierSolver = renderSystem->getBarrierSolver();
+    ResourceTransitionArray &barrier = barrierSolver.getNewResourceTransitionsArrayTmp();
+    barrierSolver.resolveTransition( barrier, pool, ResourceAccess::Read, 0u );
+    barrierSolver.resolveTransition( barrier, renderData, ResourceAccess::Read, 0u );
+    renderSystem->executeResourceTransition( barrier );
+
+    FastArray<ParticleGpuState> gpuStates;
+    FastArray<ParticleGpuData> gpuGpuData;
+    gpuStates.resizePOD( numParticles );
+    gpuGpuData.resizePOD( numParticles );
+
+    AsyncTicketPtr stateTicket = pool->readRequest( 0u, numParticles );
+    AsyncTicketPtr gpuDataTicket = renderData->readRequest( 0u, numParticles );
+    memcpy( gpuStates.begin(), stateTicket->map(), numParticles * sizeof( ParticleGpuState ) );
+    stateTicket->unmap();
+    memcpy( gpuGpuData.begin(), gpuDataTicket->map(), numParticles * sizeof( ParticleGpuData ) );
+    gpuDataTicket->unmap();
+
+    // Don't let the job's descriptor reference the buffers we're about to destroy.
+    const DescriptorSetUav::BufferSlot emptySlot( DescriptorSetUav::BufferSlot::makeEmpty() );
+    mSimulateJob->_setUavBuffer( 0, emptySlot );
+    mSimulateJob->_setUavBuffer( 1, emptySlot );
+
+    vaoManager->destroyUavBuffer( renderData );
+    vaoManager->destroyUavBuffer( pool );
+
+    FastArray<ParticleGpuData> refGpuData;
+    refGpuData.resizePOD( numParticles );
+    for( uint32 frame = 0u; frame < numFrames; ++frame )
+    {
+        simulateReference( states.begin(), refGpuData.begin(), numParticles, gpuAffectors.begin(),
+                           gpuAffectors.size(), timeSinceLast );
+    }
+
+    return compareSimulations( gpuStates.begin(), gpuGpuData.begin(), "GPU", states.begin(),
+                               refGpuData.begin(), "Reference", numParticles, tolerance, outReport );
+}
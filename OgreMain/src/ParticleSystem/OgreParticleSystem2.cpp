@@ -30,18 +30,26 @@ THE SOFTWARE.
 
 #include "ParticleSystem/OgreParticleSystem2.h"
 
+#include "Math/Array/OgreBooleanMask.h"
 #include "OgreBitset.inl"
 #include "OgreException.h"
 #include "OgreHlms.h"
 #include "OgreHlmsManager.h"
+#include "OgreLogManager.h"
+#include "OgreRadixSort.h"
+#include "OgreRenderSystem.h"
 #include "OgreRoot.h"
 #include "OgreSceneManager.h"
 #include "ParticleSystem/OgreEmitter2.h"
 #include "ParticleSystem/OgreParticleAffector2.h"
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
 #include "ParticleSystem/OgreParticleSystemManager2.h"
 #include "Vao/OgreConstBufferPacked.h"
+#include "Vao/OgreIndexBufferPacked.h"
 #include "Vao/OgreReadOnlyBufferPacked.h"
+#include "Vao/OgreUavBufferPacked.h"
 #include "Vao/OgreVaoManager.h"
+#include "Vao/OgreVertexArrayObject.h"
 
 using namespace Ogre;
 
@@ -68,6 +76,7 @@ ParticleSystemDef::CmdBillboardOrigin ParticleSystemDef::msBillboardOriginCmd;
 ParticleSystemDef::CmdBillboardRotationType ParticleSystemDef::msBillboardRotationTypeCmd;
 ParticleSystemDef::CmdCommonDirection ParticleSystemDef::msCommonDirectionCmd;
 ParticleSystemDef::CmdCommonUpVector ParticleSystemDef::msCommonUpVectorCmd;
+ParticleSystemDef::CmdGpuSimulation ParticleSystemDef::msGpuSimulationCmd;
 
 ParticleSystemDef::ParticleSystemDef( IdType id, ObjectMemoryManager *objectMemoryManager,
                                       SceneManager *manager,
@@ -86,6 +95,14 @@ ParticleSystemDef::ParticleSystemDef( IdType id, ObjectMemoryManager *objectMemo
     mParticleQuotaFull( false ),
     mIsBillboardSet( bIsBillboardSet ),
     mRotationType( ParticleRotationType::None ),
+    mSortedIndexBuffer( 0 ),
+    mSortedIndices( 0 ),
+    mNumSortedParticles( 0u ),
+    mGpuSimulation( false ),
+    mGpuPoolNeedsReset( false ),
+    mGpuPool( 0 ),
+    mGpuRenderData( 0 ),
+    mGpuSpawnBuffer( 0 ),
     mParticleType( ParticleType::Point )
 {
     memset( &mParticleCpuData, 0, sizeof( mParticleCpuData ) );
@@ -156,6 +173,12 @@ ParticleSystemDef::ParticleSystemDef( IdType id, ObjectMemoryManager *objectMemo
                                           "the player and parallel to the ground).",
                                           PT_VECTOR3 ),
                             &msCommonUpVectorCmd );
+
+        dict->addParameter( ParameterDef( "gpu_simulation",
+                                          "When true, particles are simulated with compute shaders "
+                                          "if the RenderSystem and all the affectors support it.",
+                                          PT_BOOL ),
+                            &msGpuSimulationCmd );
     }
 }
 //-----------------------------------------------------------------------------
@@ -236,14 +259,56 @@ void ParticleSystemDef::init( VaoManager *vaoManager )
     mGpuCommonData =
         vaoManager->createConstBuffer( sizeof( GpuParticleCommon ), BT_DEFAULT, &particleCommon, false );
 
-    mGpuData = vaoManager->createReadOnlyBuffer(
-        PFG_RGBA32_UINT, sizeof( ParticleGpuData ) * numParticles, BT_DYNAMIC_PERSISTENT, 0, false );
+    if( mGpuSimulation && canSimulateOnGpu() )
+    {
+        // Everything starts dead (i.e. time to live = 0).
+        const size_t zeroesSize = sizeof( ParticleGpuState ) * numParticles;
+        void *zeroes = OGRE_MALLOC( zeroesSize, MEMCATEGORY_GEOMETRY );
+        memset( zeroes, 0, zeroesSize );
+
+        mGpuPool = vaoManager->createUavBuffer( numParticles, sizeof( ParticleGpuState ), 0u, zeroes,
+                                                false );
+        mGpuRenderData = vaoManager->createUavBuffer( numParticles, sizeof( ParticleGpuData ),
+                                                      BB_FLAG_READONLY, zeroes, false );
+        mGpuSpawnBuffer =
+            vaoManager->createUavBuffer( numParticles, sizeof( ParticleGpuSpawn ), 0u, 0, false );
+        mGpuData = mGpuRenderData->getAsReadOnlyBufferView( PFG_RGBA32_UINT );
+        mGpuPoolNeedsReset = false;
+
+        OGRE_FREE( zeroes, MEMCATEGORY_GEOMETRY );
+    }
+    else
+    {
+        mGpuData = vaoManager->createReadOnlyBuffer( PFG_RGBA32_UINT,
+                                                     sizeof( ParticleGpuData ) * numParticles,
+                                                     BT_DYNAMIC_PERSISTENT, 0, false );
+    }
 
-    mVaoPerLod[VpNormal].push_back( vaoManager->createVertexArrayObject(
-        {}, mParticleSystemManager->_getSharedIndexBuffer( numParticles, vaoManager ),
-        OT_TRIANGLE_LIST ) );
+    IndexBufferPacked *indexBuffer;
+    if( mSorted )
+    {
+        const bool bUse16BitIndices = numParticles * 4u <= std::numeric_limits<uint16>::max();
+        mSortedIndexBuffer = vaoManager->createIndexBuffer(
+            bUse16BitIndices ? IndexBufferPacked::IT_16BIT : IndexBufferPacked::IT_32BIT,
+            numParticles * 6u, BT_DYNAMIC_PERSISTENT, 0, false );
+        mNumSortedParticles = 0u;
+        mDepthSortKeys.resizePOD( numParticles );
+        mDepthSortTmp.resizePOD( numParticles );
+        indexBuffer = mSortedIndexBuffer;
+    }
+    else
+    {
+        indexBuffer = mParticleSystemManager->_getSharedIndexBuffer( numParticles, vaoManager );
+    }
+
+    mVaoPerLod[VpNormal].push_back(
+        vaoManager->createVertexArrayObject( {}, indexBuffer, OT_TRIANGLE_LIST ) );
     mVaoPerLod[VpShadow] = mVaoPerLod[VpNormal];
 
+    // Nothing has been sorted yet (the buffer contains garbage).
+    if( mSortedIndexBuffer )
+        mVaoPerLod[VpNormal].back()->setPrimitiveRange( 0u, 0u );
+
     HlmsManager *hlmsManager = Root::getSingleton().getHlmsManager();
     HlmsDatablock *datablock = hlmsManager->getDatablockNoDefault( mMaterialName );
     if( datablock )
@@ -278,15 +343,54 @@ void ParticleSystemDef::_destroy( VaoManager *vaoManager )
 
         mParticleCpuData.mPosition = 0;
 
-        if( mGpuData->getMappingState() != MS_UNMAPPED )
+        if( !mGpuPool && mGpuData->getMappingState() != MS_UNMAPPED )
         {
             mGpuData->unmap( UO_UNMAP_ALL );
             mParticleGpuData = 0;
         }
 
+        if( mSortedIndexBuffer )
+        {
+            if( mSortedIndexBuffer->getMappingState() != MS_UNMAPPED )
+            {
+                mSortedIndexBuffer->unmap( UO_UNMAP_ALL );
+                mSortedIndices = 0;
+            }
+
+            if( vaoManager )
+            {
+                for( VertexArrayObject *vao : mVaoPerLod[VpNormal] )
+                    vaoManager->destroyVertexArrayObject( vao );
+                mVaoPerLod[VpNormal].clear();
+                mVaoPerLod[VpShadow].clear();
+
+                vaoManager->destroyIndexBuffer( mSortedIndexBuffer );
+                mSortedIndexBuffer = 0;
+            }
+
+            mDepthSortKeys.destroy();
+            mDepthSortTmp.destroy();
+        }
+
         if( vaoManager )
         {
-            vaoManager->destroyReadOnlyBuffer( mGpuData );
+            if( mGpuPool )
+            {
+                // mGpuData is a view of mGpuRenderData.
+                mGpuRenderData->destroyAllBufferViews();
+                vaoManager->destroyUavBuffer( mGpuSpawnBuffer );
+                vaoManager->destroyUavBuffer( mGpuRenderData );
+                vaoManager->destroyUavBuffer( mGpuPool );
+                mGpuSpawnBuffer = 0;
+                mGpuRenderData = 0;
+                mGpuPool = 0;
+                mGpuSpawns.destroy();
+                mGpuAffectors.destroy();
+            }
+            else
+            {
+                vaoManager->destroyReadOnlyBuffer( mGpuData );
+            }
             mGpuData = 0;
 
             vaoManager->destroyConstBuffer( mGpuCommonData );
@@ -305,6 +409,40 @@ void ParticleSystemDef::_destroy( VaoManager *vaoManager )
     mAffectors.clear();
 }
 //-----------------------------------------------------------------------------
+bool ParticleSystemDef::canSimulateOnGpu() const
+{
+    const char *reason = 0;
+
+    FastArray<ParticleGpuAffector> gpuAffectors;
+
+    const RenderSystem *renderSystem = Root::getSingleton().getRenderSystem();
+    if( mIsBillboardSet )
+        reason = "BillboardSets can't be simulated on the GPU";
+    else if( mSorted )
+        reason = "Sorting is enabled";
+    else if( !renderSystem || !renderSystem->getCapabilities()->hasCapability( RSC_COMPUTE_PROGRAM ) ||
+             !Root::getSingleton().getHlmsManager()->getComputeHlms() )
+    {
+        reason = "The RenderSystem does not support compute shaders";
+    }
+    else if( !ParticleGpuSimulation::getGpuAffectors( mAffectors, gpuAffectors ) )
+        reason = "Not all of its affectors can run on the GPU";
+
+    if( reason )
+    {
+        LogManager::getSingleton().logMessage( "ParticleSystemDef '" + mName +
+                                                   "' will be simulated on the CPU. Reason: " + reason,
+                                               LML_CRITICAL );
+    }
+
+    return reason == 0;
+}
+//-----------------------------------------------------------------------------
+void ParticleSystemDef::setGpuSimulation( bool bGpuSimulation )
+{
+    mGpuSimulation = bGpuSimulation;
+}
+//-----------------------------------------------------------------------------
 bool ParticleSystemDef::isInitialized() const
 {
     return mParticleCpuData.mPosition != nullptr;
@@ -468,6 +606,10 @@ void ParticleSystemDef::_destroyAllParticleSystems()
     mLastParticleIdx = 0u;
     mParticleQuotaFull = false;
     mActiveParticles.clear();
+
+    // The GPU has its own copy of the particles, which must be killed too.
+    if( mGpuPool )
+        mGpuPoolNeedsReset = true;
 }
 //-----------------------------------------------------------------------------
 uint32 ParticleSystemDef::allocParticle()
@@ -501,6 +643,7 @@ uint32 ParticleSystemDef::allocParticle()
                 return InvalidHandle;
             }
 
+            mActiveParticles.set( newIdx );
             return static_cast<uint32>( newIdx );
         }
         else
@@ -527,6 +670,7 @@ uint32 ParticleSystemDef::allocParticle()
                 }
             }
 
+            mActiveParticles.set( newIdx );
             return static_cast<uint32>( newIdx );
         }
     }
@@ -547,6 +691,46 @@ uint32 ParticleSystemDef::allocParticle()
     }
 }
 //-----------------------------------------------------------------------------
+uint32 ParticleSystemDef::allocParticles( const uint32 numParticles, uint32 &outFirstHandle )
+{
+    OGRE_ASSERT_MEDIUM( mLastParticleIdx >= mFirstParticleIdx );
+
+    if( numParticles == 0u )
+        return 0u;
+
+    const uint32 quota = getQuota();
+    const uint32 distance = mLastParticleIdx - mFirstParticleIdx;
+
+    if( distance == quota )
+    {
+        // Hard case. Free slots (if any) are scattered between mFirstParticleIdx & mLastParticleIdx.
+        // This should be rare, so just hand them out one at a time.
+        const uint32 handle = allocParticle();
+        if( handle == InvalidHandle )
+            return 0u;
+        outFirstHandle = handle;
+        return 1u;
+    }
+
+    // Easy case. Everything after mLastParticleIdx is free; but handles
+    // can only be consecutive until we wrap around the quota.
+    OGRE_ASSERT_MEDIUM( distance < quota );
+
+    const uint32 firstHandle = mLastParticleIdx % quota;
+    const uint32 numAllocated =
+        std::min( std::min( numParticles, quota - distance ), quota - firstHandle );
+
+    OGRE_ASSERT_HIGH( mActiveParticles.numBitsSet( firstHandle + numAllocated ) ==
+                      mActiveParticles.numBitsSet( firstHandle ) );
+    mActiveParticles.setRange( firstHandle, numAllocated );
+    mLastParticleIdx += numAllocated;
+
+    OGRE_ASSERT_MEDIUM( mLastParticleIdx < quota * 2u );
+
+    outFirstHandle = firstHandle;
+    return numAllocated;
+}
+//-----------------------------------------------------------------------------
 void ParticleSystemDef::deallocParticle( uint32 handle )
 {
     const uint32 quota = getQuota();
@@ -612,6 +796,90 @@ uint32 ParticleSystemDef::getHandle( const ParticleCpuData &cpuData, size_t idx
     return handle;
 }
 //-----------------------------------------------------------------------------
+void ParticleSystemDef::_calculateDepthSortKeys( const ParticleCpuData &cpuData,
+                                                 const size_t numParticles, const ArrayVector3 &camPos,
+                                                 const uint32 firstSlot,
+                                                 uint64 *RESTRICT_ALIAS outKeys )
+{
+    OGRE_ASSERT_MEDIUM( numParticles % ARRAY_PACKED_REALS == 0u );
+
+    const size_t numPacks = numParticles / ARRAY_PACKED_REALS;
+    for( size_t i = 0u; i < numPacks; ++i )
+    {
+        const ArrayReal sqDistance = cpuData.mPosition[i].squaredDistance( camPos );
+        const ArrayMaskR isDead =
+            Mathlib::CompareLessEqual( cpuData.mTimeToLive[i], ARRAY_REAL_ZERO );
+        const uint32 scalarIsDead = BooleanMask4::getScalarMask( isDead );
+
+        OGRE_ALIGNED_DECL( Real, sqDistances[ARRAY_PACKED_REALS], OGRE_SIMD_ALIGNMENT );
+        CastArrayToReal( sqDistances, sqDistance );
+
+        for( size_t j = 0u; j < ARRAY_PACKED_REALS; ++j )
+        {
+            uint32 key = 0xFFFFFFFFu;
+            if( !IS_BIT_SET( j, scalarIsDead ) )
+            {
+                // Positive floats sort like unsigned integers. Invert them so the farthest
+                // particle comes first, and keep them below the key of dead particles.
+                const float sqDistanceF = static_cast<float>( sqDistances[j] );
+                uint32 bits;
+                memcpy( &bits, &sqDistanceF, sizeof( bits ) );
+                key = 0x7FFFFFFFu - ( bits & 0x7FFFFFFFu );
+            }
+
+            const uint64 slot = firstSlot + i * ARRAY_PACKED_REALS + j;
+            outKeys[i * ARRAY_PACKED_REALS + j] = ( slot << 32u ) | key;
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+struct ParticleDepthSortKey
+{
+    uint64 operator()( const uint64 value ) const { return value & 0xFFFFFFFFu; }
+};
+
+template <typename T>
+static void writeSortedParticleIndices( const uint64 *RESTRICT_ALIAS sortedKeys,
+                                        const size_t numParticles, T *RESTRICT_ALIAS outIndices )
+{
+    // Same layout as ParticleSystemManager2::createSharedIndexBuffers
+    for( size_t i = 0u; i < numParticles; ++i )
+    {
+        const size_t vertex = static_cast<size_t>( sortedKeys[i] >> 32u ) * 4u;
+        outIndices[0] = static_cast<T>( vertex + 0u );  // A
+        outIndices[1] = static_cast<T>( vertex + 1u );  // B
+        outIndices[2] = static_cast<T>( vertex + 2u );  // C
+        outIndices[3] = static_cast<T>( vertex + 1u );  // B
+        outIndices[4] = static_cast<T>( vertex + 3u );  // D
+        outIndices[5] = static_cast<T>( vertex + 2u );  // C
+        outIndices += 6u;
+    }
+}
+
+uint32 ParticleSystemDef::_sortParticlesBackToFront( uint64 *keys, uint64 *tmp,
+                                                     const size_t numParticles,
+                                                     const bool bUse16BitIndices, void *outIndices )
+{
+    const uint64 *sortedKeys = radixSortUint64( keys, tmp, numParticles, ParticleDepthSortKey() );
+
+    // Dead particles were sorted last. Don't render them.
+    const uint64 *firstDead =
+        std::lower_bound( sortedKeys, sortedKeys + numParticles, 0xFFFFFFFFu,
+                          []( const uint64 a, const uint32 b ) { return uint32( a ) < b; } );
+    const size_t numAlive = static_cast<size_t>( firstDead - sortedKeys );
+
+    if( bUse16BitIndices )
+    {
+        writeSortedParticleIndices( sortedKeys, numAlive, reinterpret_cast<uint16 *>( outIndices ) );
+    }
+    else
+    {
+        writeSortedParticleIndices( sortedKeys, numAlive, reinterpret_cast<uint32 *>( outIndices ) );
+    }
+
+    return static_cast<uint32>( numAlive );
+}
+//-----------------------------------------------------------------------------
 struct SortParticlesByDistanceToCamera
 {
     const Vector3 camPos;
@@ -645,6 +913,7 @@ void ParticleSystemDef::cloneTo( ParticleSystemDef *toClone )
     toClone->mCommonUpVector = this->mCommonUpVector;
     toClone->mRotationType = this->mRotationType;
     toClone->mParticleType = this->mParticleType;
+    toClone->mGpuSimulation = this->mGpuSimulation;
     toClone->setParticleQuota( this->getQuota() );
 
     toClone->mEmitters.reserve( this->mEmitters.size() );
@@ -711,7 +980,6 @@ ParticleSystem2::ParticleSystem2( IdType id, ObjectMemoryManager *objectMemoryMa
     mParentDefGlobalIdx( std::numeric_limits<size_t>::max() )
 {
     const size_t numEmitters = creator->getNumEmitters();
-    mNewParticlesPerEmitter.resizePOD( numEmitters, 0u );
     mEmitterInstanceData.resize( numEmitters );
 
     const FastArray<EmitterDefData *> &emitterDefs = creator->getEmitters();
@@ -926,3 +1194,14 @@ void ParticleSystemDef::CmdCommonUpVector::doSet( void *target, const String &va
     static_cast<ParticleSystemDef *>( target )->setCommonUpVector(
         StringConverter::parseVector3( val ) );
 }
+//-----------------------------------------------------------------------------
+String ParticleSystemDef::CmdGpuSimulation::doGet( const void *target ) const
+{
+    return StringConverter::toString(
+        static_cast<const ParticleSystemDef *>( target )->getGpuSimulation() );
+}
+//-----------------------------------------------------------------------------
+void ParticleSystemDef::CmdGpuSimulation::doSet( void *target, const String &val )
+{
+    static_cast<ParticleSystemDef *>( target )->setGpuSimulation( StringConverter::parseBool( val ) );
+}
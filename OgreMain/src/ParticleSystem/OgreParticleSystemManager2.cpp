@@ -32,12 +32,15 @@ THE SOFTWARE.
 
 #include "Math/Array/OgreArrayConfig.h"
 #include "Math/Array/OgreBooleanMask.h"
+#include "OgreHlmsManager.h"
 #include "OgreRenderQueue.h"
+#include "OgreRoot.h"
 #include "OgreSceneManager.h"
 #include "ParticleSystem/OgreBillboardSet2.h"
 #include "ParticleSystem/OgreEmitter2.h"
 #include "ParticleSystem/OgreParticle2.h"
 #include "ParticleSystem/OgreParticleAffector2.h"
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
 #include "ParticleSystem/OgreParticleSystem2.h"
 #include "Vao/OgreIndexBufferPacked.h"
 #include "Vao/OgreReadOnlyBufferPacked.h"
@@ -58,7 +61,9 @@ ParticleSystemManager2::ParticleSystemManager2( SceneManager *sceneManager,
     mHighestPossibleQuota32( 0u ),
     mTimeSinceLast( 0 ),
     mMaster( master ),
-    mCameraPos( Vector3::ZERO )
+    mCameraPos( Vector3::ZERO ),
+    mNextDefToPrepare( 0u ),
+    mGpuSimulation( 0 )
 {
     if( sceneManager )
         mMemoryManager = &sceneManager->_getParticleSysDefMemoryManager();
@@ -82,15 +87,19 @@ ParticleSystemManager2::~ParticleSystemManager2()
     mActiveParticleSystemDefs.clear();
     mParticleSystemDefMap.clear();
 
+    delete mGpuSimulation;
+    mGpuSimulation = 0;
+
     if( !mSceneManager )
         delete mMemoryManager;
     mMemoryManager = 0;
 }
 //-----------------------------------------------------------------------------
-void ParticleSystemManager2::tickParticles( const size_t threadIdx, const ArrayReal timeSinceLast,
-                                            ParticleCpuData cpuData, ParticleGpuData *gpuData,
-                                            const size_t numParticles, ParticleSystemDef *systemDef,
-                                            ArrayAabb &inOutAabb )
+void ParticleSystemManager2::_tickParticles( const ArrayReal timeSinceLast, ParticleCpuData cpuData,
+                                             ParticleGpuData *gpuData, const size_t numParticles,
+                                             const ParticleSystemDef *systemDef,
+                                             FastArray<uint32> *outParticlesToKill,
+                                             ArrayAabb &inOutAabb )
 {
     const ArrayReal invPi = Mathlib::SetAll( 1.0f / Math::PI );
 
@@ -159,11 +168,8 @@ void ParticleSystemManager2::tickParticles( const size_t threadIdx, const ArrayR
         {
             if( IS_BIT_SET( j, scalarIsDead ) )
             {
-                if( !IS_BIT_SET( j, scalarWasDead ) )
-                {
-                    systemDef->mParticlesToKill[threadIdx].push_back(
-                        systemDef->getHandle( cpuData, j ) );
-                }
+                if( !IS_BIT_SET( j, scalarWasDead ) && outParticlesToKill )
+                    outParticlesToKill->push_back( systemDef->getHandle( cpuData, j ) );
                 // Should we use NaN? GPU is supposed to reject them faster.
                 gpuData->mWidth = 0.0f;
                 gpuData->mHeight = 0.0f;
@@ -203,51 +209,100 @@ void ParticleSystemManager2::tickParticles( const size_t threadIdx, const ArrayR
     inOutAabb = aabb;
 }
 //-----------------------------------------------------------------------------
+void ParticleSystemManager2::tickTimeToLive( const ArrayReal timeSinceLast, ParticleCpuData cpuData,
+                                             const size_t numParticles, ParticleSystemDef *systemDef,
+                                             FastArray<uint32> &outParticlesToKill )
+{
+    // Must match what _tickParticles does, so that we kill the particles
+    // the same frame the GPU does.
+    for( size_t i = 0u; i < numParticles; i += ARRAY_PACKED_REALS )
+    {
+        const ArrayMaskR wasDead = Mathlib::CompareLessEqual( *cpuData.mTimeToLive, ARRAY_REAL_ZERO );
+        *cpuData.mTimeToLive = Mathlib::Max( *cpuData.mTimeToLive - timeSinceLast, ARRAY_REAL_ZERO );
+        const ArrayMaskR isDead = Mathlib::CompareLessEqual( *cpuData.mTimeToLive, ARRAY_REAL_ZERO );
+
+        const uint32 scalarJustDied =
+            BooleanMask4::getScalarMask( isDead ) & ~BooleanMask4::getScalarMask( wasDead );
+
+        if( scalarJustDied )
+        {
+            for( size_t j = 0; j < ARRAY_PACKED_REALS; ++j )
+            {
+                if( IS_BIT_SET( j, scalarJustDied ) )
+                    outParticlesToKill.push_back( systemDef->getHandle( cpuData, j ) );
+            }
+        }
+
+        cpuData.advancePack();
+    }
+}
+//-----------------------------------------------------------------------------
 void ParticleSystemManager2::sortAndPrepare( ParticleSystemDef *systemDef, const Vector3 &camPos,
                                              const float timeSinceLast )
 {
     systemDef->sortByDistanceTo( camPos );
 
-    // Emit new particles
+    // Emit new particles. Only reserve their handles here (in priority order);
+    // _updateParallel01 fills mNewParticles from all threads.
     const size_t numEmitters = systemDef->mEmitters.size();
-    systemDef->mNewParticles.clear();
+    systemDef->mEmissionBursts.clear();
+    uint32 numNewParticles = 0u;
 
     for( ParticleSystem2 *system : systemDef->mActiveParticleSystems )
     {
+        const Node *instanceNode = system->getParentNode();
+        const Vector3 instancePos = instanceNode->_getDerivedPosition();
+        const Quaternion instanceRot = instanceNode->_getDerivedOrientation();
+
         for( size_t i = 0u; i < numEmitters; ++i )
         {
-            const uint32 numRequestedParticles = systemDef->mEmitters[i]->genEmissionCount(
+            uint32 numRequestedParticles = systemDef->mEmitters[i]->genEmissionCount(
                 timeSinceLast, system->mEmitterInstanceData[i] );
-            system->mNewParticlesPerEmitter[i] = numRequestedParticles;
-
-            const Node *instanceNode = system->getParentNode();
-            const Vector3 instancePos = instanceNode->_getDerivedPosition();
-            const Quaternion instanceRot = instanceNode->_getDerivedOrientation();
 
-            for( uint32 j = 0u; j < numRequestedParticles; ++j )
+            while( numRequestedParticles > 0u )
             {
-                const uint32 handle = systemDef->allocParticle();
-                if( handle != ParticleSystemDef::InvalidHandle )
-                {
-                    systemDef->mNewParticles.push_back( { handle, instancePos, instanceRot } );
-                }
-                else
+                uint32 firstHandle;
+                const uint32 numAllocated =
+                    systemDef->allocParticles( numRequestedParticles, firstHandle );
+                if( numAllocated == 0u )
                 {
                     // The pool run out of particles.
                     // It won't be handling more while in _prepareParallel()
-                    system->mNewParticlesPerEmitter[i] = j;
                     break;
                 }
+
+                systemDef->mEmissionBursts.push_back( { firstHandle, numAllocated,
+                                                        static_cast<uint32>( i ), numNewParticles,
+                                                        instancePos, instanceRot } );
+                numNewParticles += numAllocated;
+                numRequestedParticles -= numAllocated;
             }
         }
 
-        systemDef->mVaoPerLod[0].back()->setPrimitiveRange(
-            0u, static_cast<uint32>( systemDef->getParticlesToRenderTighter() * 6u ) );
+        // Sorted systems only render their alive particles. See updateSerialPos().
+        if( !systemDef->mSortedIndexBuffer )
+        {
+            systemDef->mVaoPerLod[0].back()->setPrimitiveRange(
+                0u, static_cast<uint32>( systemDef->getParticlesToRenderTighter() * 6u ) );
+        }
     }
+
+    systemDef->mNewParticles.resizePOD( numNewParticles );
+    if( systemDef->mGpuPool )
+        systemDef->mGpuSpawns.resizePOD( numNewParticles );
 }
 //-----------------------------------------------------------------------------
 void ParticleSystemManager2::updateSerialPos()
 {
+    for( ParticleSystemDef *systemDef : mDepthSortedDefs )
+    {
+        const uint32 numIndices = systemDef->mNumSortedParticles * 6u;
+        systemDef->mSortedIndexBuffer->unmap( UO_KEEP_PERSISTENT, 0u, numIndices );
+        systemDef->mSortedIndices = 0;
+        systemDef->mVaoPerLod[0].back()->setPrimitiveRange( 0u, numIndices );
+    }
+    mDepthSortedDefs.clear();
+
     for( BillboardSet *billboardSet : mBillboardSets )
     {
         if( billboardSet->mParticleGpuData )
@@ -284,6 +339,17 @@ void ParticleSystemManager2::updateSerialPos()
             systemDef->mParticleGpuData = 0;
         }
 
+        if( systemDef->mGpuPool )
+        {
+            if( !mGpuSimulation )
+            {
+                mGpuSimulation =
+                    new ParticleGpuSimulation( Root::getSingleton().getHlmsManager()->getComputeHlms() );
+            }
+            mGpuSimulation->simulate( systemDef, static_cast<uint32>( systemDef->mGpuSpawns.size() ),
+                                      mTimeSinceLast );
+        }
+
         for( FastArray<uint32> &threadParticlesToKill : systemDef->mParticlesToKill )
         {
             for( const uint32 handle : threadParticlesToKill )
@@ -309,30 +375,17 @@ void ParticleSystemManager2::updateSerialPos()
 //-----------------------------------------------------------------------------
 void ParticleSystemManager2::_prepareParallel()
 {
-    if( mActiveParticleSystemDefs.empty() )
-        return;
-
-    ParticleSystemDef *systemDef = 0;
+    const size_t numActiveParticleSystemDefs = mActiveParticleSystemDefs.size();
 
     const Vector3 camPos = mCameraPos;
     const float timeSinceLast = mTimeSinceLast;
 
-    bool bStillHasWork = true;
-    while( bStillHasWork )
+    // Each thread grabs the next ParticleSystemDef that nobody has prepared yet.
+    size_t defIdx = mNextDefToPrepare.fetch_add( 1u, std::memory_order_relaxed );
+    while( defIdx < numActiveParticleSystemDefs )
     {
-        mSortMutex.lock();
-        if( !mActiveParticlesLeftToSort.empty() )
-        {
-            systemDef = std::move( mActiveParticlesLeftToSort.back() );
-            mActiveParticlesLeftToSort.pop_back();
-            bStillHasWork = true;
-        }
-        else
-            bStillHasWork = false;
-        mSortMutex.unlock();
-
-        if( bStillHasWork )
-            sortAndPrepare( systemDef, camPos, timeSinceLast );
+        sortAndPrepare( mActiveParticleSystemDefs[defIdx], camPos, timeSinceLast );
+        defIdx = mNextDefToPrepare.fetch_add( 1u, std::memory_order_relaxed );
     }
 }
 //-----------------------------------------------------------------------------
@@ -340,45 +393,50 @@ void ParticleSystemManager2::_updateParallel01( const size_t threadIdx, const si
 {
     for( ParticleSystemDef *systemDef : mActiveParticleSystemDefs )
     {
-        const size_t numEmitters = systemDef->mEmitters.size();
-
-        // We split particle systems.
-        size_t currOffset = 0u;
-
         ParticleCpuData cpuData = systemDef->getParticleCpuData();
 
-        for( const ParticleSystem2 *system : systemDef->mActiveParticleSystems )
+        // We split each burst across all threads.
+        for( const ParticleSystemDef::EmissionBurst &burst : systemDef->mEmissionBursts )
         {
-            for( size_t i = 0u; i < numEmitters; ++i )
-            {
-                const size_t newParticlesPerEmitter = system->mNewParticlesPerEmitter[i];
+            const size_t particlesPerThread = ( burst.numParticles + numThreads - 1u ) / numThreads;
+
+            const size_t toAdvance =
+                std::min<size_t>( threadIdx * particlesPerThread, burst.numParticles );
+            const size_t numParticlesToProcess =
+                std::min( particlesPerThread, burst.numParticles - toAdvance );
+
+            if( numParticlesToProcess == 0u )
+                continue;
+
+            EmittedParticle *newParticles =
+                systemDef->mNewParticles.begin() + burst.newParticlesOffset + toAdvance;
 
-                const size_t particlesPerThread =
-                    ( newParticlesPerEmitter + numThreads - 1u ) / numThreads;
+            const uint32 firstHandle = burst.firstHandle + static_cast<uint32>( toAdvance );
+            for( size_t j = 0u; j < numParticlesToProcess; ++j )
+            {
+                newParticles[j].handle = firstHandle + static_cast<uint32>( j );
+                newParticles[j].pos = burst.instancePos;
+                newParticles[j].rot = burst.instanceRot;
+            }
 
-                const size_t toAdvance =
-                    std::min( threadIdx * particlesPerThread, newParticlesPerEmitter );
-                const size_t numParticlesToProcess =
-                    std::min( particlesPerThread, newParticlesPerEmitter - toAdvance );
+            systemDef->mEmitters[burst.emitterIdx]->initEmittedParticles( cpuData, newParticles,
+                                                                          numParticlesToProcess );
 
-                systemDef->mEmitters[i]->initEmittedParticles(
-                    cpuData, systemDef->mNewParticles.begin() + currOffset + toAdvance,
-                    numParticlesToProcess );
+            for( const ParticleAffector2 *affector : systemDef->mInitializableAffectors )
+                affector->initEmittedParticles( cpuData, newParticles, numParticlesToProcess );
 
-                for( const ParticleAffector2 *affector : systemDef->mInitializableAffectors )
+            if( systemDef->mGpuPool )
+            {
+                // Send the initialized particles to the GPU. See ParticleGpuSimulation.
+                ParticleGpuSpawn *spawns =
+                    systemDef->mGpuSpawns.begin() + burst.newParticlesOffset + toAdvance;
+                for( size_t j = 0u; j < numParticlesToProcess; ++j )
                 {
-                    affector->initEmittedParticles(
-                        cpuData, systemDef->mNewParticles.begin() + currOffset + toAdvance,
-                        numParticlesToProcess );
+                    spawns[j].mHandle = newParticles[j].handle;
+                    spawns[j].mPadding[0] = spawns[j].mPadding[1] = spawns[j].mPadding[2] = 0u;
+                    ParticleGpuSimulation::packState( cpuData, newParticles[j].handle,
+                                                      spawns[j].mState );
                 }
-
-                // We've processed numParticlesToProcess but we need to skip newParticlesPerEmitter
-                // because the gap "newParticlesPerEmitter - numParticlesToProcess" is being
-                // processed by other threads.
-                //
-                // We need to move on to the next set of particles requested by the next
-                // emitter during _prepareParallel().
-                currOffset += newParticlesPerEmitter;
             }
         }
     }
@@ -388,6 +446,9 @@ void ParticleSystemManager2::_updateParallel02( const size_t threadIdx, const si
 {
     const ArrayReal timeSinceLast = Mathlib::SetAll( mTimeSinceLast );
 
+    ArrayVector3 camPos;
+    camPos.setAll( mCameraPos );
+
     for( ParticleSystemDef *systemDef : mActiveParticleSystemDefs )
     {
         // We split particle systems.
@@ -460,13 +521,30 @@ void ParticleSystemManager2::_updateParallel02( const size_t threadIdx, const si
             OGRE_ASSERT_MEDIUM( threadAdvance <= quota || numParticlesToProcess == 0u );
             cpuData.advancePack( threadAdvance / ARRAY_PACKED_REALS );
 
-            ParticleGpuData *gpuData = systemDef->mParticleGpuData + gpuAdvance;
+            if( !systemDef->mGpuPool )
+            {
+                ParticleGpuData *gpuData = systemDef->mParticleGpuData + gpuAdvance;
 
-            for( const ParticleAffector2 *affector : systemDef->mAffectors )
-                affector->run( cpuData, numParticlesToProcess, timeSinceLast );
+                for( const ParticleAffector2 *affector : systemDef->mAffectors )
+                    affector->run( cpuData, numParticlesToProcess, timeSinceLast );
 
-            tickParticles( threadIdx, timeSinceLast, cpuData, gpuData, numParticlesToProcess, systemDef,
-                           aabb );
+                _tickParticles( timeSinceLast, cpuData, gpuData, numParticlesToProcess, systemDef,
+                                &systemDef->mParticlesToKill[threadIdx], aabb );
+            }
+            else
+            {
+                // Affectors & the rest of the simulation run in updateSerialPos(). The AABB
+                // is left null (which becomes infinite) since positions only live on the GPU.
+                tickTimeToLive( timeSinceLast, cpuData, numParticlesToProcess, systemDef,
+                                systemDef->mParticlesToKill[threadIdx] );
+            }
+
+            if( systemDef->mSortedIndexBuffer )
+            {
+                ParticleSystemDef::_calculateDepthSortKeys(
+                    cpuData, numParticlesToProcess, camPos, static_cast<uint32>( gpuAdvance ),
+                    systemDef->mDepthSortKeys.begin() + gpuAdvance );
+            }
 
             gpuAdvance += numParticlesToProcess;
             totalThreadNumParticlesToProcess = particleExcess;
@@ -540,8 +618,15 @@ void ParticleSystemManager2::_updateParallel02( const size_t threadIdx, const si
             cpuData.advancePack( threadAdvance / ARRAY_PACKED_REALS );
 
             ParticleGpuData *gpuData = billboardSet->mParticleGpuData + gpuAdvance;
-            tickParticles( threadIdx, ARRAY_REAL_ZERO, cpuData, gpuData, numParticlesToProcess,
-                           billboardSet, aabb );
+            _tickParticles( ARRAY_REAL_ZERO, cpuData, gpuData, numParticlesToProcess, billboardSet,
+                            &billboardSet->mParticlesToKill[threadIdx], aabb );
+
+            if( billboardSet->mSortedIndexBuffer )
+            {
+                ParticleSystemDef::_calculateDepthSortKeys(
+                    cpuData, numParticlesToProcess, camPos, static_cast<uint32>( gpuAdvance ),
+                    billboardSet->mDepthSortKeys.begin() + gpuAdvance );
+            }
 
             gpuAdvance += numParticlesToProcess;
             totalThreadNumParticlesToProcess = particleExcess;
@@ -565,6 +650,22 @@ void ParticleSystemManager2::_updateParallel02( const size_t threadIdx, const si
     }
 }
 //-----------------------------------------------------------------------------
+void ParticleSystemManager2::_updateParallel03( const size_t threadIdx, const size_t numThreads )
+{
+    // The keys were built by all threads in _updateParallel02. The sort itself is not split,
+    // thus just distribute the ParticleSystemDefs across threads.
+    const size_t numDepthSortedDefs = mDepthSortedDefs.size();
+    for( size_t i = threadIdx; i < numDepthSortedDefs; i += numThreads )
+    {
+        ParticleSystemDef *systemDef = mDepthSortedDefs[i];
+        systemDef->mNumSortedParticles = ParticleSystemDef::_sortParticlesBackToFront(
+            systemDef->mDepthSortKeys.begin(), systemDef->mDepthSortTmp.begin(),
+            systemDef->getNumSimdActiveParticles(),
+            systemDef->mSortedIndexBuffer->getIndexType() == IndexBufferPacked::IT_16BIT,
+            systemDef->mSortedIndices );
+    }
+}
+//-----------------------------------------------------------------------------
 void ParticleSystemManager2::addEmitterFactory( ParticleEmitterDefDataFactory *factory )
 {
     const auto insertionResult = sEmitterDefFactories.insert( { factory->getName(), factory } );
@@ -943,24 +1044,41 @@ IndexBufferPacked *ParticleSystemManager2::_getSharedIndexBuffer( size_t maxQuot
 //-----------------------------------------------------------------------------
 void ParticleSystemManager2::prepareForUpdate( const Real timeSinceLast )
 {
-    mActiveParticlesLeftToSort.clear();
+    mNextDefToPrepare.store( 0u, std::memory_order_relaxed );
+    mDepthSortedDefs.clear();
     if( mActiveParticleSystemDefs.empty() && mBillboardSets.empty() )
         return;
 
     mTimeSinceLast = timeSinceLast;
-    mActiveParticlesLeftToSort.appendPOD( mActiveParticleSystemDefs.begin(),
-                                          mActiveParticleSystemDefs.end() );
 
     for( ParticleSystemDef *systemDef : mActiveParticleSystemDefs )
     {
-        systemDef->mParticleGpuData = reinterpret_cast<ParticleGpuData *>(
-            systemDef->mGpuData->map( 0u, systemDef->mGpuData->getNumElements() ) );
+        // GPU simulated systems don't write mGpuData from the CPU.
+        if( !systemDef->mGpuPool )
+        {
+            systemDef->mParticleGpuData = reinterpret_cast<ParticleGpuData *>(
+                systemDef->mGpuData->map( 0u, systemDef->mGpuData->getNumElements() ) );
+        }
+
+        if( systemDef->mSortedIndexBuffer )
+        {
+            systemDef->mSortedIndices = systemDef->mSortedIndexBuffer->map(
+                0u, systemDef->mSortedIndexBuffer->getNumElements() );
+            mDepthSortedDefs.push_back( systemDef );
+        }
     }
 
     for( BillboardSet *billboardSet : mBillboardSets )
     {
         billboardSet->mParticleGpuData = reinterpret_cast<ParticleGpuData *>(
             billboardSet->mGpuData->map( 0u, billboardSet->mGpuData->getNumElements() ) );
+
+        if( billboardSet->mSortedIndexBuffer )
+        {
+            billboardSet->mSortedIndices = billboardSet->mSortedIndexBuffer->map(
+                0u, billboardSet->mSortedIndexBuffer->getNumElements() );
+            mDepthSortedDefs.push_back( billboardSet );
+        }
     }
 }
 //-----------------------------------------------------------------------------
@@ -41,7 +41,8 @@ namespace Ogre
     //---------------------------------------------------------------------
     DefaultWorkQueue::DefaultWorkQueue( const String &name ) :
         DefaultWorkQueueBase( name ),
-        mNumThreadsRegisteredWithRS( 0 )
+        mNumThreadsRegisteredWithRS( 0 ),
+        mNumWaitingWorkers( 0u )
     {
     }
     //---------------------------------------------------------------------
@@ -142,8 +143,17 @@ namespace Ogre
     //---------------------------------------------------------------------
     void DefaultWorkQueue::notifyWorkers()
     {
-        // wake up waiting thread
-        OGRE_THREAD_NOTIFY_ONE( mRequestCondition );
+        // Pairs with the fence in waitForNextRequest: either the worker sees the
+        // new request, or we see the worker is (about to start) waiting.
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( mNumWaitingWorkers.load( std::memory_order_relaxed ) != 0u )
+        {
+            // The worker holds the lock until it's actually waiting; taking it
+            // guarantees the notification isn't lost.
+            OGRE_LOCK_MUTEX( mRequestMutex );
+            // wake up waiting thread
+            OGRE_THREAD_NOTIFY_ONE( mRequestCondition );
+        }
     }
 
     //---------------------------------------------------------------------
@@ -152,11 +162,14 @@ namespace Ogre
 #if OGRE_THREAD_SUPPORT
         // Lock; note that OGRE_THREAD_WAIT will free the lock
         OGRE_LOCK_MUTEX_NAMED( mRequestMutex, queueLock );
-        if( mRequestQueue.empty() )
+        ++mNumWaitingWorkers;
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( mRequestRing.empty() && mRequestQueue.empty() )
         {
             // frees lock and suspends the thread
             OGRE_THREAD_WAIT( mRequestCondition, mRequestMutex, queueLock );
         }
+        --mNumWaitingWorkers;
         // When we get back here, it's because we've been notified
         // and thus the thread has been woken up. Lock has also been
         // re-acquired, but we won't use it. It's safe to try processing and fail
@@ -0,0 +1,123 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "Threading/OgreStageGraph.h"
+
+#include <thread>
+
+namespace Ogre
+{
+    const size_t StageGraph::NoDependency = std::numeric_limits<size_t>::max();
+    //-----------------------------------------------------------------------------------
+    StageGraph::StageGraph() : mNumJobsDone( 0 ), mNumJobsDoneCapacity( 0 ), mNextJob( 0u ) {}
+    //-----------------------------------------------------------------------------------
+    StageGraph::~StageGraph()
+    {
+        delete[] mNumJobsDone;
+        mNumJobsDone = 0;
+    }
+    //-----------------------------------------------------------------------------------
+    void StageGraph::clear()
+    {
+        mStages.clear();
+        mJobToStage.clear();
+    }
+    //-----------------------------------------------------------------------------------
+    size_t StageGraph::addStage( size_t numJobs, size_t dependency, size_t dependency2 )
+    {
+        OGRE_ASSERT_LOW( dependency == NoDependency || dependency < mStages.size() );
+        OGRE_ASSERT_LOW( dependency2 == NoDependency || dependency2 < mStages.size() );
+
+        Stage stage;
+        stage.firstJob = static_cast<uint32>( mJobToStage.size() );
+        stage.numJobs = static_cast<uint32>( numJobs );
+        stage.dependency[0] = dependency == NoDependency ? std::numeric_limits<uint32>::max()
+                                                         : static_cast<uint32>( dependency );
+        stage.dependency[1] = dependency2 == NoDependency ? std::numeric_limits<uint32>::max()
+                                                          : static_cast<uint32>( dependency2 );
+        mStages.push_back( stage );
+
+        mJobToStage.resize( mJobToStage.size() + numJobs, static_cast<uint32>( mStages.size() - 1u ) );
+
+        return mStages.size() - 1u;
+    }
+    //-----------------------------------------------------------------------------------
+    void StageGraph::finalize()
+    {
+        if( mStages.size() > mNumJobsDoneCapacity )
+        {
+            delete[] mNumJobsDone;
+            mNumJobsDoneCapacity = mStages.size();
+            mNumJobsDone = new std::atomic<uint32>[mNumJobsDoneCapacity];
+        }
+
+        for( size_t i = 0u; i < mStages.size(); ++i )
+            mNumJobsDone[i].store( 0u, std::memory_order_relaxed );
+
+        mNextJob.store( 0u, std::memory_order_release );
+    }
+    //-----------------------------------------------------------------------------------
+    bool StageGraph::getNextJob( size_t &outStageIdx, size_t &outJobIdx )
+    {
+        const uint32 jobIdx = mNextJob.fetch_add( 1u, std::memory_order_relaxed );
+        if( jobIdx >= mJobToStage.size() )
+            return false;
+
+        const uint32 stageIdx = mJobToStage[jobIdx];
+        const Stage &stage = mStages[stageIdx];
+
+        for( size_t i = 0u; i < 2u; ++i )
+        {
+            if( stage.dependency[i] == std::numeric_limits<uint32>::max() )
+                continue;
+
+            const Stage &dependency = mStages[stage.dependency[i]];
+            const std::atomic<uint32> &numJobsDone = mNumJobsDone[stage.dependency[i]];
+
+            // The jobs we're waiting for are already being processed by other
+            // threads and are usually short. Spin, but let others run if we can't.
+            uint32 numSpins = 0u;
+            while( numJobsDone.load( std::memory_order_acquire ) != dependency.numJobs )
+            {
+                if( ++numSpins > 64u )
+                    std::this_thread::yield();
+            }
+        }
+
+        outStageIdx = stageIdx;
+        outJobIdx = jobIdx - stage.firstJob;
+        return true;
+    }
+    //-----------------------------------------------------------------------------------
+    void StageGraph::jobFinished( size_t stageIdx )
+    {
+        mNumJobsDone[stageIdx].fetch_add( 1u, std::memory_order_release );
+    }
+}  // namespace Ogre
@@ -0,0 +1,138 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+
+#include "Threading/OgreWorkStealingScheduler.h"
+
+namespace Ogre
+{
+    WorkStealingScheduler::WorkStealingScheduler() : mPerThread( 0 ), mNumThreads( 0 ), mCapacity( 0 )
+    {
+    }
+    //-----------------------------------------------------------------------------------
+    WorkStealingScheduler::~WorkStealingScheduler()
+    {
+        delete[] mPerThread;
+        mPerThread = 0;
+    }
+    //-----------------------------------------------------------------------------------
+    void WorkStealingScheduler::reset( size_t numChunks, size_t numThreads )
+    {
+        OGRE_ASSERT_LOW( numChunks <= std::numeric_limits<uint32>::max() );
+        OGRE_ASSERT_LOW( numThreads > 0u );
+
+        if( numThreads > mCapacity )
+        {
+            delete[] mPerThread;
+            mPerThread = new PerThreadData[numThreads];
+            mCapacity = numThreads;
+        }
+
+        mNumThreads = numThreads;
+
+        // Same distribution as the static split (i.e. if nobody steals,
+        // every thread processes the same chunks it would've anyway).
+        const size_t chunksPerThread = ( numChunks + numThreads - 1u ) / numThreads;
+        for( size_t i = 0u; i < numThreads; ++i )
+        {
+            const uint32 begin = static_cast<uint32>( std::min( i * chunksPerThread, numChunks ) );
+            const uint32 end =
+                static_cast<uint32>( std::min( ( i + 1u ) * chunksPerThread, numChunks ) );
+            mPerThread[i].range.store( packRange( begin, end ), std::memory_order_relaxed );
+            mPerThread[i].numProcessed = 0u;
+            mPerThread[i].numStolen = 0u;
+        }
+
+        // Publish the ranges before the worker threads are woken up.
+        std::atomic_thread_fence( std::memory_order_release );
+    }
+    //-----------------------------------------------------------------------------------
+    bool WorkStealingScheduler::getNextChunk( size_t threadIdx, size_t &outChunkIdx )
+    {
+        PerThreadData &ownData = mPerThread[threadIdx];
+
+        // Pop from the front of our own range
+        uint64 range = ownData.range.load( std::memory_order_acquire );
+        uint32 begin = static_cast<uint32>( range );
+        uint32 end = static_cast<uint32>( range >> 32u );
+        while( begin < end )
+        {
+            if( ownData.range.compare_exchange_weak( range, packRange( begin + 1u, end ),
+                                                     std::memory_order_acq_rel ) )
+            {
+                outChunkIdx = begin;
+                ++ownData.numProcessed;
+                return true;
+            }
+            begin = static_cast<uint32>( range );
+            end = static_cast<uint32>( range >> 32u );
+        }
+
+        return steal( threadIdx, outChunkIdx );
+    }
+    //-----------------------------------------------------------------------------------
+    bool WorkStealingScheduler::steal( size_t threadIdx, size_t &outChunkIdx )
+    {
+        PerThreadData &ownData = mPerThread[threadIdx];
+
+        // Start with our neighbour so not every thread goes after thread 0
+        for( size_t i = 1u; i < mNumThreads; ++i )
+        {
+            PerThreadData &victim = mPerThread[( threadIdx + i ) % mNumThreads];
+
+            uint64 range = victim.range.load( std::memory_order_acquire );
+            uint32 begin = static_cast<uint32>( range );
+            uint32 end = static_cast<uint32>( range >> 32u );
+
+            while( begin < end )
+            {
+                // Take the back half (rounded up, so we always take at least one).
+                const uint32 newEnd = end - ( end - begin + 1u ) / 2u;
+                if( victim.range.compare_exchange_weak( range, packRange( begin, newEnd ),
+                                                        std::memory_order_acq_rel ) )
+                {
+                    // The stolen chunks become our own range, so others can steal from us.
+                    // Our range is empty, thus nobody else can be modifying it right now
+                    // (their CAS will fail if they read the old value).
+                    ownData.range.store( packRange( newEnd + 1u, end ),
+                                         std::memory_order_release );
+                    outChunkIdx = newEnd;
+                    ++ownData.numProcessed;
+                    ++ownData.numStolen;
+                    return true;
+                }
+
+                begin = static_cast<uint32>( range );
+                end = static_cast<uint32>( range >> 32u );
+            }
+        }
+
+        return false;
+    }
+}  // namespace Ogre
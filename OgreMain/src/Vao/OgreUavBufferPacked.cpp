@@ -95,7 +95,7 @@ namespace Ogre
         }
     }
     //-----------------------------------------------------------------------------------
-    ReadOnlyBufferPacked *UavBufferPacked::getAsReadOnlyBufferView()
+    ReadOnlyBufferPacked *UavBufferPacked::getAsReadOnlyBufferView( PixelFormatGpu pixelFormat )
     {
         OGRE_ASSERT_LOW( mBindFlags & BB_FLAG_READONLY &&
                          "Buffer must've been created with BB_FLAG_READONLY" );
@@ -108,10 +108,12 @@ namespace Ogre
             // ReadOnlyBufferPacked is always kept at the front
             OGRE_ASSERT_HIGH( dynamic_cast<ReadOnlyBufferPacked *>( mTexBufferViews.front() ) );
             retVal = static_cast<ReadOnlyBufferPacked *>( mTexBufferViews.front() );
+            OGRE_ASSERT_LOW( retVal->getPixelFormat() == pixelFormat &&
+                             "The read-only view was already created with a different format" );
         }
         else
         {
-            retVal = getAsReadOnlyBufferImpl();
+            retVal = getAsReadOnlyBufferImpl( pixelFormat );
             // Keep always at front
             mTexBufferViews.insert( mTexBufferViews.begin(), retVal );
         }
@@ -156,6 +156,8 @@ namespace Ogre
 
         void run( ParticleCpuData cpuData, size_t numParticles, ArrayReal timeSinceLast ) const override;
 
+        bool getGpuAffector( ParticleGpuAffector &outAffector ) const override;
+
         /** Sets the minimum value to which the particles will be clamped against.
         @param rgba
             RGBA components stored in xyzw.
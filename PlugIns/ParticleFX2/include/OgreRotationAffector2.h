@@ -101,6 +101,8 @@ namespace Ogre
 
         void run( ParticleCpuData cpuData, size_t numParticles, ArrayReal timeSinceLast ) const override;
 
+        bool getGpuAffector( ParticleGpuAffector &outAffector ) const override;
+
         /// Sets the minimum rotation speed of particles to be emitted.
         void setRotationSpeedRangeStart( const Radian &angle );
         /// Sets the maximum rotation speed of particles to be emitted.
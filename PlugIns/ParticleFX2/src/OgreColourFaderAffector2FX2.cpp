@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreColourFaderAffector2FX2.h"
 
 #include "OgreStringConverter.h"
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
 
 using namespace Ogre;
 
@@ -154,6 +155,17 @@ void ColourFaderAffector2FX2::run( ParticleCpuData cpuData, const size_t numPart
     }
 }
 //-----------------------------------------------------------------------------
+bool ColourFaderAffector2FX2::getGpuAffector( ParticleGpuAffector &outAffector ) const
+{
+    outAffector.op = ParticleGpuAffectorOp::ColourFadeTwoStates;
+    outAffector.stateChange = mStateChangeVal;
+    outAffector.params[0] = mColourAdj1;
+    outAffector.params[1] = mColourAdj2;
+    outAffector.params[2] = mMinColour;
+    outAffector.params[3] = mMaxColour;
+    return true;
+}
+//-----------------------------------------------------------------------------
 void ColourFaderAffector2FX2::setMaxColour( const Vector4 &rgba )
 {
     mMaxColour = rgba;
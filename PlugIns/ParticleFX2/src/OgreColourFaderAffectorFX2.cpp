@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreColourFaderAffectorFX2.h"
 
 #include "OgreStringConverter.h"
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
 
 using namespace Ogre;
 
@@ -97,6 +98,15 @@ void ColourFaderAffectorFX2::run( ParticleCpuData cpuData, const size_t numParti
     }
 }
 //-----------------------------------------------------------------------------
+bool ColourFaderAffectorFX2::getGpuAffector( ParticleGpuAffector &outAffector ) const
+{
+    outAffector.op = ParticleGpuAffectorOp::ColourFade;
+    outAffector.params[0] = mColourAdj;
+    outAffector.params[1] = mMinColour;
+    outAffector.params[2] = mMaxColour;
+    return true;
+}
+//-----------------------------------------------------------------------------
 void ColourFaderAffectorFX2::setMaxColour( const Vector4 &rgba )
 {
     mMaxColour = rgba;
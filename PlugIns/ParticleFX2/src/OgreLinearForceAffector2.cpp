@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreLinearForceAffector2.h"
 
 #include "OgreStringConverter.h"
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
 
 using namespace Ogre;
 
@@ -80,6 +81,14 @@ void LinearForceAffector2::run( ParticleCpuData cpuData, const size_t numParticl
     }
 }
 //-----------------------------------------------------------------------------
+bool LinearForceAffector2::getGpuAffector( ParticleGpuAffector &outAffector ) const
+{
+    outAffector.op = mForceApplication == FA_ADD ? ParticleGpuAffectorOp::LinearForceAdd
+                                                 : ParticleGpuAffectorOp::LinearForceAverage;
+    outAffector.params[0] = Vector4( mForceVector, 0.0f );
+    return true;
+}
+//-----------------------------------------------------------------------------
 void LinearForceAffector2::setForceVector( const Vector3 &force )
 {
     mForceVector = force;
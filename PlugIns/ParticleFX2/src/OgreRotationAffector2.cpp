@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreRotationAffector2.h"
 
 #include "OgreStringConverter.h"
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
 
 using namespace Ogre;
 
@@ -109,6 +110,12 @@ void RotationAffector2::run( ParticleCpuData cpuData, const size_t numParticles,
     }
 }
 //-----------------------------------------------------------------------------
+bool RotationAffector2::getGpuAffector( ParticleGpuAffector &outAffector ) const
+{
+    outAffector.op = ParticleGpuAffectorOp::Rotate;
+    return true;
+}
+//-----------------------------------------------------------------------------
 const Radian &RotationAffector2::getRotationSpeedRangeStart() const
 {
     return mRotationSpeedRangeStart;
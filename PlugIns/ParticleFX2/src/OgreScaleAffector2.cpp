@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreScaleAffector2.h"
 
 #include "OgreStringConverter.h"
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
 
 using namespace Ogre;
 
@@ -84,6 +85,14 @@ void ScaleAffector2::run( ParticleCpuData cpuData, const size_t numParticles,
     }
 }
 //-----------------------------------------------------------------------------
+bool ScaleAffector2::getGpuAffector( ParticleGpuAffector &outAffector ) const
+{
+    outAffector.op =
+        mMultiplyMode ? ParticleGpuAffectorOp::ScaleMultiply : ParticleGpuAffectorOp::ScaleAdd;
+    outAffector.params[0] = Vector4( mScaleAdj, 0.0f, 0.0f, 0.0f );
+    return true;
+}
+//-----------------------------------------------------------------------------
 void ScaleAffector2::setAdjust( Real rate )
 {
     mScaleAdj = rate;
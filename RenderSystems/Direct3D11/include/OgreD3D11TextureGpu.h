@@ -91,6 +91,7 @@ namespace Ogre
         ~D3D11TextureGpu() override;
 
         void notifyDataIsReady() override;
+        void _notifyMipLevelReady( uint8 mipLevel ) override;
         bool _isDataReadyImpl() const override;
 
         void setTextureType( TextureTypes::TextureTypes textureType ) override;
@@ -56,7 +56,7 @@ namespace Ogre
         uint8              mCurrentCacheCursor;
 
         TexBufferPacked      *getAsTexBufferImpl( PixelFormatGpu pixelFormat ) override;
-        ReadOnlyBufferPacked *getAsReadOnlyBufferImpl() override;
+        ReadOnlyBufferPacked *getAsReadOnlyBufferImpl( PixelFormatGpu pixelFormat ) override;
 
         ID3D11UnorderedAccessView *createResourceView( int cacheIdx, uint32 offset, uint32 sizeBytes );
 
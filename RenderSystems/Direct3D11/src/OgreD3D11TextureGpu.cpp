@@ -392,6 +392,24 @@ namespace Ogre
         notifyAllListenersTextureChanged( TextureGpuListener::ReadyForRendering );
     }
     //-----------------------------------------------------------------------------------
+    void D3D11TextureGpu::_notifyMipLevelReady( uint8 mipLevel )
+    {
+        // Pooled textures share their resource with the rest of the pool; keep
+        // displaying the dummy texture until we're fully loaded.
+        if( mFinalTextureName && isTexture() && !hasAutomaticBatching() )
+        {
+            // Display the real texture, but only sample the mips that are already there
+            mDisplayTextureName = mFinalTextureName.Get();
+
+            DescriptorSetTexture2::TextureSlot texSlot(
+                DescriptorSetTexture2::TextureSlot::makeEmpty() );
+            texSlot.mipmapLevel = mipLevel;
+            mDefaultDisplaySrv = createSrv( texSlot );
+        }
+
+        TextureGpu::_notifyMipLevelReady( mipLevel );
+    }
+    //-----------------------------------------------------------------------------------
     bool D3D11TextureGpu::_isDataReadyImpl() const
     {
         return mDisplayTextureName == mFinalTextureName.Get() && mDataPreparationsPending == 0u;
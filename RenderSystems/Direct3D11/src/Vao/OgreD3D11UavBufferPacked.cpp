@@ -81,7 +81,7 @@ namespace Ogre
         return retVal;
     }
     //-----------------------------------------------------------------------------------
-    ReadOnlyBufferPacked *D3D11UavBufferPacked::getAsReadOnlyBufferImpl()
+    ReadOnlyBufferPacked *D3D11UavBufferPacked::getAsReadOnlyBufferImpl( PixelFormatGpu pixelFormat )
     {
         OGRE_ASSERT_HIGH( dynamic_cast<D3D11CompatBufferInterface *>( mBufferInterface ) );
 
@@ -90,7 +90,7 @@ namespace Ogre
 
         ReadOnlyBufferPacked *retVal = OGRE_NEW D3D11ReadOnlyBufferPacked(
             mInternalBufferStart * mBytesPerElement, mNumElements, mBytesPerElement, 0, mBufferType,
-            (void *)0, false, (VaoManager *)0, bufferInterface, PFG_NULL, true, mDevice );
+            (void *)0, false, (VaoManager *)0, bufferInterface, pixelFormat, true, mDevice );
         // We were overridden by the BufferPacked we just created. Restore this back!
         bufferInterface->_notifyBuffer( this );
 
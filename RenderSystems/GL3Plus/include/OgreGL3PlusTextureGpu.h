@@ -100,6 +100,7 @@ namespace Ogre
         void getSubsampleLocations( vector<Vector2>::type locations ) override;
 
         void notifyDataIsReady() override;
+        void _notifyMipLevelReady( uint8 mipLevel ) override;
         bool _isDataReadyImpl() const override;
 
         void _setToDisplayDummyTexture() override;
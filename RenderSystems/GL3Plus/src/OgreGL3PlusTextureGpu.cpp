@@ -257,11 +257,34 @@ namespace Ogre
                          "See https://github.com/OGRECave/ogre-next/issues/101" );
         --mDataPreparationsPending;
 
+        if( mDisplayTextureName == mFinalTextureName && isTexture() && !hasAutomaticBatching() &&
+            !isRenderbuffer() )
+        {
+            // _notifyMipLevelReady may have restricted the mips we sample from
+            OCGE( glBindTexture( mGlTextureTarget, mFinalTextureName ) );
+            OCGE( glTexParameteri( mGlTextureTarget, GL_TEXTURE_BASE_LEVEL, 0 ) );
+        }
+
         mDisplayTextureName = mFinalTextureName;
 
         notifyAllListenersTextureChanged( TextureGpuListener::ReadyForRendering );
     }
     //-----------------------------------------------------------------------------------
+    void GL3PlusTextureGpu::_notifyMipLevelReady( uint8 mipLevel )
+    {
+        // Pooled textures share their GL texture with the rest of the pool,
+        // we can't restrict its mips just for us.
+        if( mFinalTextureName && isTexture() && !hasAutomaticBatching() && !isRenderbuffer() )
+        {
+            // Display the real texture, but only sample the mips that are already there
+            mDisplayTextureName = mFinalTextureName;
+            OCGE( glBindTexture( mGlTextureTarget, mFinalTextureName ) );
+            OCGE( glTexParameteri( mGlTextureTarget, GL_TEXTURE_BASE_LEVEL, mipLevel ) );
+        }
+
+        TextureGpu::_notifyMipLevelReady( mipLevel );
+    }
+    //-----------------------------------------------------------------------------------
     bool GL3PlusTextureGpu::_isDataReadyImpl() const
     {
         return mDisplayTextureName == mFinalTextureName && mDataPreparationsPending == 0u;
@@ -67,7 +67,7 @@ namespace Ogre
         return retVal;
     }
     //-----------------------------------------------------------------------------------
-    ReadOnlyBufferPacked *MetalUavBufferPacked::getAsReadOnlyBufferImpl()
+    ReadOnlyBufferPacked *MetalUavBufferPacked::getAsReadOnlyBufferImpl( PixelFormatGpu pixelFormat )
     {
         OGRE_ASSERT_HIGH( dynamic_cast<MetalBufferInterface *>( mBufferInterface ) );
 
@@ -75,7 +75,7 @@ namespace Ogre
 
         ReadOnlyBufferPacked *retVal = OGRE_NEW MetalReadOnlyBufferPacked(
             mInternalBufferStart * mBytesPerElement, mNumElements, mBytesPerElement, 0, mBufferType,
-            (void *)0, false, (VaoManager *)0, bufferInterface, PFG_NULL, mDevice );
+            (void *)0, false, (VaoManager *)0, bufferInterface, pixelFormat, mDevice );
         // We were overridden by the BufferPacked we just created. Restore this back!
         bufferInterface->_notifyBuffer( this );
 
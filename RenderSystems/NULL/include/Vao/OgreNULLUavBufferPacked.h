@@ -41,7 +41,7 @@ namespace Ogre
     {
     protected:
         TexBufferPacked      *getAsTexBufferImpl( PixelFormatGpu pixelFormat ) override;
-        ReadOnlyBufferPacked *getAsReadOnlyBufferImpl() override;
+        ReadOnlyBufferPacked *getAsReadOnlyBufferImpl( PixelFormatGpu pixelFormat ) override;
 
     public:
         NULLUavBufferPacked( size_t internalBufStartBytes, size_t numElements, uint32 bytesPerElement,
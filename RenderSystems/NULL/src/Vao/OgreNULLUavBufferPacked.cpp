@@ -60,7 +60,7 @@ namespace Ogre
         return retVal;
     }
     //-----------------------------------------------------------------------------------
-    ReadOnlyBufferPacked *NULLUavBufferPacked::getAsReadOnlyBufferImpl()
+    ReadOnlyBufferPacked *NULLUavBufferPacked::getAsReadOnlyBufferImpl( PixelFormatGpu pixelFormat )
     {
         OGRE_ASSERT_HIGH( dynamic_cast<NULLBufferInterface *>( mBufferInterface ) );
 
@@ -68,7 +68,7 @@ namespace Ogre
 
         ReadOnlyBufferPacked *retVal = OGRE_NEW NULLReadOnlyBufferPacked(
             mInternalBufferStart * mBytesPerElement, mNumElements, mBytesPerElement, 0, mBufferType,
-            (void *)0, false, (VaoManager *)0, bufferInterface, PFG_NULL );
+            (void *)0, false, (VaoManager *)0, bufferInterface, pixelFormat );
         // We were overridden by the BufferPacked we just created. Restore this back!
         bufferInterface->_notifyBuffer( this );
 
@@ -43,7 +43,7 @@ namespace Ogre
     {
     protected:
         TexBufferPacked *getAsTexBufferImpl( PixelFormatGpu pixelFormat ) override;
-        ReadOnlyBufferPacked *getAsReadOnlyBufferImpl() override;
+        ReadOnlyBufferPacked *getAsReadOnlyBufferImpl( PixelFormatGpu pixelFormat ) override;
 
     public:
         VulkanUavBufferPacked( size_t internalBufStartBytes, size_t numElements, uint32 bytesPerElement,
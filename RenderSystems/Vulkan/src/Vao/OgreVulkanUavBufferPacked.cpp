@@ -65,7 +65,7 @@ namespace Ogre
         return retVal;
     }
     //-----------------------------------------------------------------------------------
-    ReadOnlyBufferPacked *VulkanUavBufferPacked::getAsReadOnlyBufferImpl()
+    ReadOnlyBufferPacked *VulkanUavBufferPacked::getAsReadOnlyBufferImpl( PixelFormatGpu pixelFormat )
     {
 #ifdef OGRE_VK_WORKAROUND_ADRENO_6xx_READONLY_IS_TBUFFER
         if( Workarounds::mAdreno6xxReadOnlyIsTBuffer )
@@ -86,7 +86,7 @@ namespace Ogre
 
         ReadOnlyBufferPacked *retVal = OGRE_NEW VulkanReadOnlyBufferPacked(
             mInternalBufferStart * mBytesPerElement, mNumElements, mBytesPerElement, 0, mBufferType,
-            (void *)0, false, vkRenderSystem, mVaoManager, bufferInterface, PFG_NULL );
+            (void *)0, false, vkRenderSystem, mVaoManager, bufferInterface, pixelFormat );
         // We were overridden by the BufferPacked we just created. Restore this back!
         bufferInterface->_notifyBuffer( this );
 
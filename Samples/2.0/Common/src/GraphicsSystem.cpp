@@ -356,6 +356,10 @@ namespace Demo
         Ogre::Profiler::getSingleton().getOfflineProfiler().setDumpPathsOnShutdown(
             mWriteAccessFolder + "ProfilePerFrame", mWriteAccessFolder + "ProfileAccum" );
 #    endif
+#    if OGRE_PROFILING == OGRE_PROFILING_INTERNAL_TRACE
+        Ogre::Profiler::getSingleton().getTraceProfiler().setDumpPathOnShutdown(
+            mWriteAccessFolder + "Trace.json" );
+#    endif
 #endif
     }
     //-----------------------------------------------------------------------------------
@@ -645,7 +649,9 @@ namespace Demo
                         {
                             Ogre::DataStreamPtr diskCacheFile = rwAccessFolderArchive->open( filename );
                             diskCache.loadFrom( diskCacheFile );
-                            diskCache.applyTo( hlms, numThreads );
+                            // Don't stall loading. Compile the shaders as they're
+                            // needed, and the rest in the background.
+                            diskCache.applyTo( hlms, numThreads, true );
                         }
                     }
                     catch( Ogre::Exception & )
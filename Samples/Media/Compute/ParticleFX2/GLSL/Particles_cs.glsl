@@ -0,0 +1,58 @@
+@insertpiece( SetCrossPlatformSettings )
+
+@insertpiece( PreBindingsHeaderCS )
+
+@property( syntax == glsl )
+	#define ogre_U0 binding = 0
+	#define ogre_U1 binding = 1
+@end
+
+layout( std430, ogre_U0 ) restrict buffer particlePoolLayout
+{
+	ParticleState particlePool[];
+};
+
+@property( spawn )
+	layout( std430, ogre_U1 ) readonly restrict buffer spawnsLayout
+	{
+		ParticleSpawn spawns[];
+	};
+@else
+	layout( std430, ogre_U1 ) writeonly restrict buffer outGpuDataLayout
+	{
+		uint4 outGpuData[];
+	};
+@end
+
+layout( local_size_x = @value( threads_per_group_x ),
+		local_size_y = @value( threads_per_group_y ),
+		local_size_z = @value( threads_per_group_z ) ) in;
+
+vulkan( layout( ogre_P0 ) uniform Params { )
+@property( spawn )
+	uniform uint numSpawns;
+@else
+	uniform uint2 numParticles_numAffectors;
+	uniform float timeSinceLast;
+	uniform float4 affectorData[@value( max_affectors_x_stride )];
+@end
+vulkan( }; )
+
+#define p_numSpawns numSpawns
+#define p_numParticles numParticles_numAffectors.x
+#define p_numAffectors numParticles_numAffectors.y
+#define p_timeSinceLast timeSinceLast
+#define p_affectorData affectorData
+
+@insertpiece( HeaderCS )
+
+//in uvec3 gl_NumWorkGroups;
+//in uvec3 gl_WorkGroupID;
+//in uvec3 gl_LocalInvocationID;
+//in uvec3 gl_GlobalInvocationID;
+//in uint  gl_LocalInvocationIndex;
+
+void main()
+{
+	@insertpiece( BodyCS )
+}
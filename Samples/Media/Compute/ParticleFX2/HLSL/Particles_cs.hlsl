@@ -0,0 +1,40 @@
+@insertpiece( SetCrossPlatformSettings )
+
+#define roundEven round
+
+@insertpiece( PreBindingsHeaderCS )
+
+RWStructuredBuffer<ParticleState> particlePool	: register(u0);
+@property( spawn )
+	RWStructuredBuffer<ParticleSpawn> spawns	: register(u1);
+@else
+	RWStructuredBuffer<uint4> outGpuData		: register(u1);
+@end
+
+@property( spawn )
+	uniform uint numSpawns;
+@else
+	uniform uint2 numParticles_numAffectors;
+	uniform float timeSinceLast;
+	uniform float4 affectorData[@value( max_affectors_x_stride )];
+@end
+
+#define p_numSpawns numSpawns
+#define p_numParticles numParticles_numAffectors.x
+#define p_numAffectors numParticles_numAffectors.y
+#define p_timeSinceLast timeSinceLast
+#define p_affectorData affectorData
+
+@insertpiece( HeaderCS )
+
+//in uvec3 gl_NumWorkGroups;
+//in uvec3 gl_WorkGroupID;
+//in uvec3 gl_LocalInvocationID;
+//in uvec3 gl_GlobalInvocationID;
+//in uint  gl_LocalInvocationIndex;
+
+[numthreads(@value( threads_per_group_x ), @value( threads_per_group_y ), @value( threads_per_group_z ))]
+void main( uint3 gl_GlobalInvocationID : SV_DispatchThreadId )
+{
+	@insertpiece( BodyCS )
+}
@@ -0,0 +1,47 @@
+@insertpiece( SetCrossPlatformSettings )
+
+#define roundEven rint
+
+struct Params
+{
+@property( spawn )
+	uint numSpawns;
+@else
+	uint2 numParticles_numAffectors;
+	float timeSinceLast;
+	float4 affectorData[@value( max_affectors_x_stride )];
+@end
+};
+
+#define p_numSpawns p.numSpawns
+#define p_numParticles p.numParticles_numAffectors.x
+#define p_numAffectors p.numParticles_numAffectors.y
+#define p_timeSinceLast p.timeSinceLast
+#define p_affectorData p.affectorData
+
+@insertpiece( PreBindingsHeaderCS )
+
+@insertpiece( HeaderCS )
+
+//in uvec3 gl_NumWorkGroups;
+//in uvec3 gl_WorkGroupID;
+//in uvec3 gl_LocalInvocationID;
+//in uvec3 gl_GlobalInvocationID;
+//in uint  gl_LocalInvocationIndex;
+
+kernel void main_metal
+(
+	device ParticleState *particlePool	[[buffer(UAV_SLOT_START+0)]],
+@property( spawn )
+	device ParticleSpawn *spawns		[[buffer(UAV_SLOT_START+1)]],
+@else
+	device uint4 *outGpuData			[[buffer(UAV_SLOT_START+1)]],
+@end
+
+	constant Params &p					[[buffer(PARAMETER_SLOT)]],
+
+	uint3 gl_GlobalInvocationID			[[thread_position_in_grid]]
+)
+{
+	@insertpiece( BodyCS )
+}
@@ -51,6 +51,7 @@ class MeshSerializerTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testMesh_Version_1_4);
     CPPUNIT_TEST(testMesh_Version_1_3);
     CPPUNIT_TEST(testMesh_Version_1_2);
+    CPPUNIT_TEST(testMesh_Version_2_1_Packed);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
@@ -74,6 +75,8 @@ public:
     void testMesh_Version_1_4();
     void testMesh_Version_1_3();
     void testMesh_Version_1_2();
+    // Writes a v2 mesh in the packed format and reads it back
+    void testMesh_Version_2_1_Packed();
     void testMesh_XML();
     void testMesh(MeshVersion version);
     void assertMeshClone(Mesh* a, Mesh* b, MeshVersion version = MESH_VERSION_LATEST);
@@ -0,0 +1,131 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ParticleTestHelpers_H__
+#define __ParticleTestHelpers_H__
+
+#include "OgrePrerequisites.h"
+
+#include "ParticleSystem/OgreParticle2.h"
+
+/// SoA particle data shared by the particle tests. Every channel is allocated.
+struct TestParticles
+{
+    size_t numParticles;
+    Ogre::ParticleCpuData cpuData;
+    Ogre::uint32 seed;
+
+    TestParticles(size_t _numParticles) : numParticles(_numParticles), seed(12345u)
+    {
+        using namespace Ogre;
+        OGRE_ASSERT_LOW(numParticles % ARRAY_PACKED_REALS == 0u);
+        memset(&cpuData, 0, sizeof(cpuData));
+        cpuData.mPosition = alloc<ArrayVector3>(sizeof(Vector3));
+        cpuData.mDirection = alloc<ArrayVector3>(sizeof(Vector3));
+        cpuData.mDimensions = alloc<ArrayVector2>(sizeof(Vector2));
+        cpuData.mRotation = alloc<ArrayRadian>(sizeof(Radian));
+        cpuData.mRotationSpeed = alloc<ArrayRadian>(sizeof(Radian));
+        cpuData.mTotalTimeToLive = alloc<ArrayReal>(sizeof(Real));
+        cpuData.mTimeToLive = alloc<ArrayReal>(sizeof(Real));
+        cpuData.mColour = alloc<ArrayVector4>(sizeof(Vector4));
+    }
+    ~TestParticles()
+    {
+        using namespace Ogre;
+        OGRE_FREE_SIMD(cpuData.mColour, MEMCATEGORY_GEOMETRY);
+        OGRE_FREE_SIMD(cpuData.mTimeToLive, MEMCATEGORY_GEOMETRY);
+        OGRE_FREE_SIMD(cpuData.mTotalTimeToLive, MEMCATEGORY_GEOMETRY);
+        OGRE_FREE_SIMD(cpuData.mRotationSpeed, MEMCATEGORY_GEOMETRY);
+        OGRE_FREE_SIMD(cpuData.mRotation, MEMCATEGORY_GEOMETRY);
+        OGRE_FREE_SIMD(cpuData.mDimensions, MEMCATEGORY_GEOMETRY);
+        OGRE_FREE_SIMD(cpuData.mDirection, MEMCATEGORY_GEOMETRY);
+        OGRE_FREE_SIMD(cpuData.mPosition, MEMCATEGORY_GEOMETRY);
+    }
+
+    template <typename T> T* alloc(size_t bytesPerParticle)
+    {
+        T* retVal = reinterpret_cast<T*>(
+            OGRE_MALLOC_SIMD(numParticles * bytesPerParticle, Ogre::MEMCATEGORY_GEOMETRY));
+        memset(retVal, 0, numParticles * bytesPerParticle);
+        return retVal;
+    }
+
+    Ogre::Real random()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<Ogre::Real>(seed >> 8u) / static_cast<Ogre::Real>(1u << 24u);
+    }
+
+    void setPosition(size_t idx, const Ogre::Vector3& pos)
+    {
+        cpuData.mPosition[idx / ARRAY_PACKED_REALS].setFromVector3(pos, idx % ARRAY_PACKED_REALS);
+    }
+
+    Ogre::Vector3 getPosition(size_t idx) const
+    {
+        Ogre::Vector3 retVal;
+        cpuData.mPosition[idx / ARRAY_PACKED_REALS].getAsVector3(retVal, idx % ARRAY_PACKED_REALS);
+        return retVal;
+    }
+
+    void setTimeToLive(size_t idx, Ogre::Real timeToLive)
+    {
+        reinterpret_cast<Ogre::Real*>(cpuData.mTimeToLive)[idx] = timeToLive;
+        reinterpret_cast<Ogre::Real*>(cpuData.mTotalTimeToLive)[idx] = timeToLive;
+    }
+
+    bool isAlive(size_t idx) const
+    {
+        return reinterpret_cast<const Ogre::Real*>(cpuData.mTimeToLive)[idx] > 0.0f;
+    }
+
+    /// Random particles in every channel. Every 8th particle is dead,
+    /// the rest have random lifetimes so that some die mid-simulation.
+    void fill()
+    {
+        using namespace Ogre;
+        for (size_t i = 0; i < numParticles; ++i)
+        {
+            const size_t packIdx = i / ARRAY_PACKED_REALS;
+            const size_t lane = i % ARRAY_PACKED_REALS;
+            setPosition(i, Vector3(random() * 100.0f, random() * 100.0f, random() * 100.0f));
+            cpuData.mDirection[packIdx].setFromVector3(
+                Vector3(random() - 0.5f, random() * 10.0f, random() - 0.5f), lane);
+            cpuData.mDimensions[packIdx].setFromVector2(Vector2(random() + 0.5f, random() + 0.5f),
+                                                        lane);
+            cpuData.mColour[packIdx].setFromVector4(Vector4(random(), random(), random(), random()),
+                                                    lane);
+
+            reinterpret_cast<Radian*>(cpuData.mRotation)[i] =
+                Radian((random() * 2.0f - 1.0f) * Math::PI);
+            reinterpret_cast<Radian*>(cpuData.mRotationSpeed)[i] = Radian((random() - 0.5f) * 10.0f);
+            setTimeToLive(i, (i % 8u) == 7u ? 0.0f : random() * 2.0f);
+        }
+    }
+};
+
+#endif
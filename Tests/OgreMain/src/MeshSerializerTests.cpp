@@ -45,6 +45,11 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreSkeleton.h"
+#include "OgreMesh2.h"
+#include "OgreMesh2Serializer.h"
+#include "OgreSubMesh2.h"
+#include "Vao/OgreNULLVaoManager.h"
+#include "Vao/OgreVertexArrayObject.h"
 
 #include "UnitTestSuite.h"
 
@@ -307,6 +312,106 @@ void MeshSerializerTests::testMesh_Version_1_2()
 #endif /* ifdef I_HAVE_LOT_OF_FREE_TIME */
 }
 //--------------------------------------------------------------------------
+/// Creates a v2 mesh with one submesh: a few vertices with positions & normals, 16-bit indices.
+static Ogre::MeshPtr createTestMeshV2(VaoManager* vaoManager, const String& name)
+{
+    Ogre::MeshPtr mesh(OGRE_NEW Ogre::Mesh(0, name, 0, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+                                           vaoManager, true));
+
+    const size_t numVertices = 5u;
+    const size_t numIndices = 9u;
+
+    float* vertexData = reinterpret_cast<float*>(
+        OGRE_MALLOC_SIMD(sizeof(float) * 6u * numVertices, MEMCATEGORY_GEOMETRY));
+    for (size_t i = 0; i < numVertices * 6u; ++i)
+        vertexData[i] = (float)i * 0.5f - 3.0f;
+
+    uint16* indexData = reinterpret_cast<uint16*>(
+        OGRE_MALLOC_SIMD(sizeof(uint16) * numIndices, MEMCATEGORY_GEOMETRY));
+    const uint16 indices[numIndices] = { 0, 1, 2, 2, 1, 3, 3, 4, 0 };
+    memcpy(indexData, indices, sizeof(indices));
+
+    VertexElement2Vec vertexElements;
+    vertexElements.push_back(VertexElement2(VET_FLOAT3, VES_POSITION));
+    vertexElements.push_back(VertexElement2(VET_FLOAT3, VES_NORMAL));
+
+    VertexBufferPackedVec vertexBuffers;
+    vertexBuffers.push_back(vaoManager->createVertexBuffer(vertexElements, numVertices, BT_IMMUTABLE,
+                                                           vertexData, true));
+    IndexBufferPacked* indexBuffer = vaoManager->createIndexBuffer(
+        IndexBufferPacked::IT_16BIT, numIndices, BT_IMMUTABLE, indexData, true);
+
+    VertexArrayObject* vao =
+        vaoManager->createVertexArrayObject(vertexBuffers, indexBuffer, OT_TRIANGLE_LIST);
+
+    Ogre::SubMesh* subMesh = mesh->createSubMesh();
+    subMesh->mVao[VpNormal].push_back(vao);
+    subMesh->mVao[VpShadow].push_back(vao);
+
+    mesh->_setBounds(Aabb(Vector3::ZERO, Vector3(10.0f, 10.0f, 10.0f)), false);
+    mesh->_setBoundingSphereRadius(20.0f);
+
+    return mesh;
+}
+//--------------------------------------------------------------------------
+void MeshSerializerTests::testMesh_Version_2_1_Packed()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    NULLVaoManager vaoManager;
+
+    Ogre::MeshPtr origMesh = createTestMeshV2(&vaoManager, "PackedRoundtrip.orig.mesh");
+
+    Ogre::MeshSerializer serializer(&vaoManager);
+
+    // Large enough for the header plus the page aligned blobs
+    const size_t maxFileSize = 1024u * 1024u;
+    DataStreamPtr exported(OGRE_NEW MemoryDataStream(maxFileSize));
+    serializer.exportMesh(origMesh.get(), exported, Ogre::MESH_VERSION_2_1_PACKED);
+
+    const size_t fileSize = exported->tell();
+    CPPUNIT_ASSERT(fileSize > 0u && fileSize < maxFileSize);
+
+    MemoryDataStream* exportedMemory = static_cast<MemoryDataStream*>(exported.get());
+    DataStreamPtr imported(OGRE_NEW MemoryDataStream(exportedMemory->getPtr(), fileSize));
+
+    Ogre::MeshPtr mesh(OGRE_NEW Ogre::Mesh(0, "PackedRoundtrip.mesh", 0,
+                                           ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
+                                           &vaoManager, true));
+    serializer.importMesh(imported, mesh.get());
+
+    CPPUNIT_ASSERT_EQUAL(origMesh->getNumSubMeshes(), mesh->getNumSubMeshes());
+    CPPUNIT_ASSERT_EQUAL(origMesh->getBoundingSphereRadius(), mesh->getBoundingSphereRadius());
+
+    const Ogre::SubMesh* origSubMesh = origMesh->getSubMesh(0);
+    const Ogre::SubMesh* subMesh = mesh->getSubMesh(0);
+    CPPUNIT_ASSERT_EQUAL(origSubMesh->mVao[VpNormal].size(), subMesh->mVao[VpNormal].size());
+    CPPUNIT_ASSERT_EQUAL(origSubMesh->mVao[VpShadow].size(), subMesh->mVao[VpShadow].size());
+
+    const VertexArrayObject* origVao = origSubMesh->mVao[VpNormal][0];
+    const VertexArrayObject* vao = subMesh->mVao[VpNormal][0];
+    CPPUNIT_ASSERT_EQUAL(origVao->getOperationType(), vao->getOperationType());
+    CPPUNIT_ASSERT_EQUAL(origVao->getVertexBuffers().size(), vao->getVertexBuffers().size());
+
+    const VertexBufferPacked* origVertexBuffer = origVao->getVertexBuffers()[0];
+    const VertexBufferPacked* vertexBuffer = vao->getVertexBuffers()[0];
+    CPPUNIT_ASSERT_EQUAL(origVertexBuffer->getNumElements(), vertexBuffer->getNumElements());
+    CPPUNIT_ASSERT(origVertexBuffer->getVertexElements() == vertexBuffer->getVertexElements());
+    CPPUNIT_ASSERT(memcmp(origVertexBuffer->getShadowCopy(), vertexBuffer->getShadowCopy(),
+                          origVertexBuffer->getTotalSizeBytes()) == 0);
+
+    const IndexBufferPacked* origIndexBuffer = origVao->getIndexBuffer();
+    const IndexBufferPacked* indexBuffer = vao->getIndexBuffer();
+    CPPUNIT_ASSERT(indexBuffer);
+    CPPUNIT_ASSERT_EQUAL(origIndexBuffer->getIndexType(), indexBuffer->getIndexType());
+    CPPUNIT_ASSERT_EQUAL(origIndexBuffer->getNumElements(), indexBuffer->getNumElements());
+    CPPUNIT_ASSERT(memcmp(origIndexBuffer->getShadowCopy(), indexBuffer->getShadowCopy(),
+                          origIndexBuffer->getTotalSizeBytes()) == 0);
+
+    mesh.reset();
+    origMesh.reset();
+}
+//--------------------------------------------------------------------------
 void MeshSerializerTests::testMesh_XML()
 {
 #ifdef OGRE_TEST_XMLSERIALIZER
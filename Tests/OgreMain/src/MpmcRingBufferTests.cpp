@@ -0,0 +1,164 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "MpmcRingBufferTests.h"
+#include "Threading/OgreMpmcRingBuffer.h"
+
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(MpmcRingBufferTests);
+
+//--------------------------------------------------------------------------
+void MpmcRingBufferTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void MpmcRingBufferTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void MpmcRingBufferTests::testSingleThread()
+{
+    // Rounded up to a power of 2
+    MpmcRingBuffer<size_t> ring(5u);
+    CPPUNIT_ASSERT_EQUAL((size_t)8u, ring.capacity());
+    CPPUNIT_ASSERT(ring.empty());
+
+    size_t value = 1234u;
+    CPPUNIT_ASSERT(!ring.tryPop(value));
+    CPPUNIT_ASSERT_EQUAL((size_t)1234u, value);
+
+    for (size_t i = 0; i < 8u; ++i)
+        CPPUNIT_ASSERT(ring.tryPush(i));
+    CPPUNIT_ASSERT(!ring.tryPush(8u));
+    CPPUNIT_ASSERT(!ring.empty());
+
+    // FIFO order
+    for (size_t i = 0; i < 8u; ++i)
+    {
+        CPPUNIT_ASSERT(ring.tryPop(value));
+        CPPUNIT_ASSERT_EQUAL(i, value);
+    }
+    CPPUNIT_ASSERT(!ring.tryPop(value));
+    CPPUNIT_ASSERT(ring.empty());
+}
+//--------------------------------------------------------------------------
+void MpmcRingBufferTests::testWrapAround()
+{
+    MpmcRingBuffer<size_t> ring(4u);
+
+    // Go around the buffer many times. 3 isn't a divisor of the capacity,
+    // so the pushes and pops straddle the end of the buffer
+    size_t nextPush = 0u;
+    size_t nextPop = 0u;
+    for (size_t lap = 0; lap < 100u; ++lap)
+    {
+        for (size_t i = 0; i < 3u; ++i)
+            CPPUNIT_ASSERT(ring.tryPush(nextPush++));
+        for (size_t i = 0; i < 3u; ++i)
+        {
+            size_t value;
+            CPPUNIT_ASSERT(ring.tryPop(value));
+            CPPUNIT_ASSERT_EQUAL(nextPop++, value);
+        }
+        CPPUNIT_ASSERT(ring.empty());
+    }
+    CPPUNIT_ASSERT_EQUAL(nextPush, nextPop);
+}
+//--------------------------------------------------------------------------
+void MpmcRingBufferTests::testMultiThreaded()
+{
+    const size_t numProducers = 4u;
+    const size_t numConsumers = 4u;
+    const size_t numPerProducer = 20000u;
+    const size_t numValues = numProducers * numPerProducer;
+
+    // Small on purpose, so that producers often find it full
+    MpmcRingBuffer<size_t> ring(64u);
+
+    std::vector<std::atomic<uint32> > timesPopped(numValues);
+    for (size_t i = 0; i < numValues; ++i)
+        timesPopped[i] = 0u;
+    std::atomic<size_t> numPopped(0u);
+
+    std::vector<std::thread> threads;
+    for (size_t threadIdx = 0; threadIdx < numProducers; ++threadIdx)
+    {
+        threads.push_back(std::thread([&, threadIdx]() {
+            for (size_t i = 0; i < numPerProducer; ++i)
+            {
+                while (!ring.tryPush(threadIdx * numPerProducer + i))
+                    std::this_thread::yield();
+            }
+        }));
+    }
+    for (size_t threadIdx = 0; threadIdx < numConsumers; ++threadIdx)
+    {
+        threads.push_back(std::thread([&]() {
+            size_t lastValue[numProducers];
+            for (size_t i = 0; i < numProducers; ++i)
+                lastValue[i] = std::numeric_limits<size_t>::max();
+
+            while (numPopped.load() < numValues)
+            {
+                size_t value;
+                if (ring.tryPop(value))
+                {
+                    ++timesPopped[value];
+                    ++numPopped;
+
+                    // Values from the same producer must come out in the order they went in
+                    const size_t producerIdx = value / numPerProducer;
+                    CPPUNIT_ASSERT(lastValue[producerIdx] == std::numeric_limits<size_t>::max() ||
+                                   lastValue[producerIdx] < value);
+                    lastValue[producerIdx] = value;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+
+    // Every value must be popped exactly once
+    for (size_t i = 0; i < numValues; ++i)
+        CPPUNIT_ASSERT_EQUAL(1u, timesPopped[i].load());
+    CPPUNIT_ASSERT(ring.empty());
+}
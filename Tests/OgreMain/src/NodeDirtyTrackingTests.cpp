@@ -0,0 +1,203 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "NodeDirtyTrackingTests.h"
+#include "Math/Array/OgreNodeMemoryManager.h"
+#include "OgreSceneNode.h"
+
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(NodeDirtyTrackingTests);
+
+namespace
+{
+    /// A small scene graph: a root, a few parents, many children (so
+    /// there are several SIMD blocks per depth level) and one grandchild each.
+    struct NodeHierarchy
+    {
+        NodeMemoryManager nodeMemoryManager;
+        std::vector<SceneNode*> nodes;
+        SceneNode* root;
+        std::vector<SceneNode*> parents;
+        std::vector<SceneNode*> children;
+        std::vector<SceneNode*> grandChildren;
+
+        SceneNode* createNode(SceneNode* parent, const Vector3& position)
+        {
+            SceneNode* node = new SceneNode(nodes.size(), 0, &nodeMemoryManager, 0);
+            node->setPosition(position);
+            if (parent)
+                parent->addChild(node);
+            nodes.push_back(node);
+            return node;
+        }
+
+        explicit NodeHierarchy(bool bDirtyTracking)
+        {
+            nodeMemoryManager.setDirtyTracking(bDirtyTracking);
+
+            root = createNode(0, Vector3(1, 2, 3));
+            for (size_t i = 0; i < 3u; ++i)
+            {
+                parents.push_back(createNode(root, Vector3((Real)i * 10.0f, 0, 0)));
+                for (size_t j = 0; j < ARRAY_PACKED_REALS * 2u + 1u; ++j)
+                {
+                    children.push_back(createNode(parents.back(), Vector3(0, (Real)j, 0)));
+                    grandChildren.push_back(createNode(children.back(), Vector3(0, 0, (Real)j)));
+                }
+            }
+        }
+
+        ~NodeHierarchy()
+        {
+            // Leaves first, so nobody needs to be detached from its parent
+            std::vector<SceneNode*>::const_reverse_iterator itor = nodes.rbegin();
+            std::vector<SceneNode*>::const_reverse_iterator endt = nodes.rend();
+            while (itor != endt)
+                delete *itor++;
+        }
+
+        /// Same as SceneManager::updateAllTransforms, followed by clearNodeDirtyFlags.
+        void update()
+        {
+            const size_t numDepths = nodeMemoryManager.getNumDepths();
+            for (size_t i = 0; i < numDepths; ++i)
+            {
+                Transform t;
+                const size_t numNodes = nodeMemoryManager.getFirstNode(t, i);
+                Node::updateAllTransforms(numNodes, t, nodeMemoryManager.getDirtyTracking());
+            }
+            nodeMemoryManager._clearDirtyFlags();
+        }
+    };
+}
+//--------------------------------------------------------------------------
+void NodeDirtyTrackingTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void NodeDirtyTrackingTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+/// Checks that skipping clean nodes produced the same result as updating everything.
+static void checkSameDerivedTransforms(const NodeHierarchy& tracked, const NodeHierarchy& reference)
+{
+    CPPUNIT_ASSERT_EQUAL(reference.nodes.size(), tracked.nodes.size());
+    for (size_t i = 0; i < tracked.nodes.size(); ++i)
+    {
+        CPPUNIT_ASSERT(tracked.nodes[i]->_getDerivedPosition().positionEquals(
+            reference.nodes[i]->_getDerivedPosition(), 1e-4f));
+        CPPUNIT_ASSERT(tracked.nodes[i]->_getDerivedOrientation().equals(
+            reference.nodes[i]->_getDerivedOrientation(), Radian(1e-4f)));
+        CPPUNIT_ASSERT(tracked.nodes[i]->_getDerivedScale().positionEquals(
+            reference.nodes[i]->_getDerivedScale(), 1e-4f));
+    }
+}
+//--------------------------------------------------------------------------
+void NodeDirtyTrackingTests::testParentMoved()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    NodeHierarchy tracked(true);
+    NodeHierarchy reference(false);
+
+    tracked.update();
+    reference.update();
+    checkSameDerivedTransforms(tracked, reference);
+
+    // Only the middle parent moves. Its children and grandchildren weren't
+    // touched, but must still follow.
+    const Vector3 oldPos = tracked.grandChildren[ARRAY_PACKED_REALS * 3u]->_getDerivedPosition();
+    tracked.parents[1]->setPosition(Vector3(0, 50, 0));
+    reference.parents[1]->setPosition(Vector3(0, 50, 0));
+    tracked.update();
+    reference.update();
+    checkSameDerivedTransforms(tracked, reference);
+    CPPUNIT_ASSERT(!oldPos.positionEquals(
+        tracked.grandChildren[ARRAY_PACKED_REALS * 3u]->_getDerivedPosition(), 1e-4f));
+
+    // Nothing changed (everything gets skipped)
+    tracked.update();
+    reference.update();
+    checkSameDerivedTransforms(tracked, reference);
+
+    // The root rotates and scales; every node must be updated
+    tracked.root->setOrientation(Quaternion(Degree(45), Vector3::UNIT_Y));
+    reference.root->setOrientation(Quaternion(Degree(45), Vector3::UNIT_Y));
+    tracked.root->setScale(Vector3(2, 2, 2));
+    reference.root->setScale(Vector3(2, 2, 2));
+    tracked.update();
+    reference.update();
+    checkSameDerivedTransforms(tracked, reference);
+}
+//--------------------------------------------------------------------------
+void NodeDirtyTrackingTests::testChildMoved()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    NodeHierarchy tracked(true);
+    NodeHierarchy reference(false);
+
+    tracked.update();
+    reference.update();
+
+    // A single child in the middle of a SIMD block moves, then another one the next frame.
+    // Dirtiness from the previous frame must not leak into the next one.
+    const size_t idx[2] = { ARRAY_PACKED_REALS + 1u, ARRAY_PACKED_REALS * 4u };
+    for (size_t i = 0; i < 2u; ++i)
+    {
+        tracked.children[idx[i]]->setPosition(Vector3(5, 5, 5));
+        reference.children[idx[i]]->setPosition(Vector3(5, 5, 5));
+        tracked.children[idx[i]]->setScale(Vector3(1, 3, 1));
+        reference.children[idx[i]]->setScale(Vector3(1, 3, 1));
+        tracked.update();
+        reference.update();
+        checkSameDerivedTransforms(tracked, reference);
+    }
+
+    // Toggling tracking at any time must be fine
+    tracked.nodeMemoryManager.setDirtyTracking(false);
+    tracked.grandChildren[0]->setPosition(Vector3(-1, -1, -1));
+    reference.grandChildren[0]->setPosition(Vector3(-1, -1, -1));
+    tracked.update();
+    reference.update();
+    checkSameDerivedTransforms(tracked, reference);
+
+    tracked.nodeMemoryManager.setDirtyTracking(true);
+    tracked.parents[2]->setPosition(Vector3(-7, 0, 0));
+    reference.parents[2]->setPosition(Vector3(-7, 0, 0));
+    tracked.update();
+    reference.update();
+    checkSameDerivedTransforms(tracked, reference);
+}
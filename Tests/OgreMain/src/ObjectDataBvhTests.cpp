@@ -0,0 +1,336 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ObjectDataBvhTests.h"
+#include "Math/Array/OgreBooleanMask.h"
+#include "Math/Array/OgreObjectDataBvh.h"
+#include "OgrePlane.h"
+
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ObjectDataBvhTests);
+
+namespace
+{
+    /// Fake memory layout of a render queue. Only world AABBs and owners are used.
+    struct TestObjects
+    {
+        size_t numObjs;
+        ArrayAabb* worldAabb;
+        std::vector<MovableObject*> owners;
+        ObjectData objData;
+        uint32 seed;
+
+        TestObjects(size_t _numObjs) : numObjs(_numObjs), seed(12345u)
+        {
+            const size_t numPacks = (numObjs + ARRAY_PACKED_REALS - 1u) / ARRAY_PACKED_REALS;
+            worldAabb = reinterpret_cast<ArrayAabb*>(
+                OGRE_MALLOC_SIMD(sizeof(ArrayAabb) * std::max<size_t>(numPacks, 1u),
+                                 MEMCATEGORY_SCENE_OBJECTS));
+            owners.resize(std::max<size_t>(numPacks, 1u) * ARRAY_PACKED_REALS, 0);
+            for (size_t i = 0; i < numPacks; ++i)
+                worldAabb[i] = ArrayAabb::BOX_ZERO;
+
+            memset(&objData, 0, sizeof(objData));
+            objData.mWorldAabb = worldAabb;
+            objData.mOwner = &owners[0];
+        }
+        ~TestObjects() { OGRE_FREE_SIMD(worldAabb, MEMCATEGORY_SCENE_OBJECTS); }
+
+        Real random()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<Real>(seed >> 8u) / static_cast<Real>(1u << 24u);
+        }
+
+        void setAabb(size_t idx, const Aabb& aabb)
+        {
+            worldAabb[idx / ARRAY_PACKED_REALS].setFromAabb(aabb, idx % ARRAY_PACKED_REALS);
+            // Any non-null pointer will do
+            owners[idx] = reinterpret_cast<MovableObject*>(this);
+        }
+
+        void removeObject(size_t idx)
+        {
+            worldAabb[idx / ARRAY_PACKED_REALS].setFromAabb(Aabb::BOX_ZERO, idx % ARRAY_PACKED_REALS);
+            owners[idx] = 0;
+        }
+
+        /// Objects are laid out in rows, the way they'd usually be created when loading a level.
+        void fillCoherent(Real worldSize)
+        {
+            const size_t objsPerRow = static_cast<size_t>(Math::Sqrt(Real(numObjs))) + 1u;
+            const Real spacing = worldSize / Real(objsPerRow);
+            for (size_t i = 0; i < numObjs; ++i)
+            {
+                const Vector3 center(Real(i % objsPerRow) * spacing, random() * 10.0f,
+                                     Real(i / objsPerRow) * spacing);
+                setAabb(i, Aabb(center, Vector3(0.25f + random()) * spacing * 0.5f));
+            }
+        }
+
+        void fillRandom(Real worldSize)
+        {
+            for (size_t i = 0; i < numObjs; ++i)
+            {
+                const Vector3 center(random() * worldSize, random() * worldSize, random() * worldSize);
+                setAabb(i, Aabb(center, Vector3(random(), random(), random()) + 0.1f));
+            }
+        }
+    };
+
+    /// Frustum shaped like a box. Normals point inwards, like Frustum's planes.
+    void makeBoxPlanes(const Vector3& minCorner, const Vector3& maxCorner, Plane outPlanes[6])
+    {
+        outPlanes[0] = Plane(Vector3::UNIT_X, minCorner);
+        outPlanes[1] = Plane(Vector3::NEGATIVE_UNIT_X, maxCorner);
+        outPlanes[2] = Plane(Vector3::UNIT_Y, minCorner);
+        outPlanes[3] = Plane(Vector3::NEGATIVE_UNIT_Y, maxCorner);
+        outPlanes[4] = Plane(Vector3::UNIT_Z, minCorner);
+        outPlanes[5] = Plane(Vector3::NEGATIVE_UNIT_Z, maxCorner);
+    }
+
+    /// Same test as MovableObject::cullFrustum, without the flags & distance checks.
+    /// Returns the number of visible objects; and flags them in outVisible.
+    size_t cullLinear(const TestObjects& objects, size_t firstPack, size_t numPacks,
+                      const Plane planes[6], std::vector<uint8>& outVisible)
+    {
+        ArrayVector3 planeNormal[6];
+        ArrayVector3 signFlip[6];
+        ArrayReal planeNegD[6];
+        for (size_t i = 0; i < 6u; ++i)
+        {
+            planeNormal[i].setAll(planes[i].normal);
+            signFlip[i].setAll(planes[i].normal);
+            signFlip[i].setToSign();
+            planeNegD[i] = Mathlib::SetAll(-planes[i].d);
+        }
+
+        size_t numVisible = 0u;
+        for (size_t i = firstPack; i < firstPack + numPacks; ++i)
+        {
+            const ArrayAabb& aabb = objects.worldAabb[i];
+            ArrayMaskR mask = BooleanMask4::getAllSetMask();
+            for (size_t j = 0; j < 6u; ++j)
+            {
+                const ArrayReal dotResult =
+                    planeNormal[j].dotProduct(aabb.mCenter + aabb.mHalfSize * signFlip[j]);
+                mask = Mathlib::And(mask, Mathlib::CompareGreater(dotResult, planeNegD[j]));
+            }
+            ArrayMaskR isInfinite = Mathlib::Or(Mathlib::isInfinity(aabb.mHalfSize.mChunkBase[0]),
+                                                Mathlib::isInfinity(aabb.mHalfSize.mChunkBase[1]));
+            isInfinite = Mathlib::Or(Mathlib::isInfinity(aabb.mHalfSize.mChunkBase[2]), isInfinite);
+            const uint32 scalarMask = BooleanMask4::getScalarMask(Mathlib::Or(mask, isInfinite));
+
+            for (size_t j = 0; j < ARRAY_PACKED_REALS; ++j)
+            {
+                const size_t idx = i * ARRAY_PACKED_REALS + j;
+                if (IS_BIT_SET(j, scalarMask) && objects.owners[idx])
+                {
+                    outVisible[idx] = 1u;
+                    ++numVisible;
+                }
+            }
+        }
+
+        return numVisible;
+    }
+
+    size_t cullWithBvh(ObjectDataBvh& bvh, const TestObjects& objects, const Plane planes[6],
+                       std::vector<uint8>& outVisible)
+    {
+        ObjectDataBvh::PackRangeArray ranges;
+        bvh.cullFrustum(planes, 128u, ranges);
+
+        size_t numVisible = 0u;
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            CPPUNIT_ASSERT(ranges[i].numPacks <= 128u);
+            numVisible += cullLinear(objects, ranges[i].firstPack, ranges[i].numPacks, planes,
+                                     outVisible);
+        }
+        return numVisible;
+    }
+
+    void checkMatchesLinear(ObjectDataBvh& bvh, const TestObjects& objects, const Plane planes[6])
+    {
+        const size_t numPacks = (objects.numObjs + ARRAY_PACKED_REALS - 1u) / ARRAY_PACKED_REALS;
+
+        std::vector<uint8> visibleLinear(objects.owners.size(), 0u);
+        std::vector<uint8> visibleBvh(objects.owners.size(), 0u);
+
+        const size_t numLinear = cullLinear(objects, 0u, numPacks, planes, visibleLinear);
+        const size_t numBvh = cullWithBvh(bvh, objects, planes, visibleBvh);
+
+        CPPUNIT_ASSERT_EQUAL(numLinear, numBvh);
+        CPPUNIT_ASSERT(visibleLinear == visibleBvh);
+    }
+}
+//--------------------------------------------------------------------------
+void ObjectDataBvhTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void ObjectDataBvhTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void ObjectDataBvhTests::testEmpty()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TestObjects objects(0u);
+    ObjectDataBvh bvh;
+    bvh.build(objects.objData, 0u);
+
+    Plane planes[6];
+    makeBoxPlanes(Vector3(-1.0f), Vector3(1.0f), planes);
+
+    ObjectDataBvh::PackRangeArray ranges;
+    CPPUNIT_ASSERT_EQUAL(size_t(0u), bvh.cullFrustum(planes, 16u, ranges));
+    CPPUNIT_ASSERT(ranges.empty());
+}
+//--------------------------------------------------------------------------
+void ObjectDataBvhTests::testMatchesLinearCull()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    // Not a multiple of ARRAY_PACKED_REALS on purpose
+    TestObjects objects(10003u);
+    objects.fillRandom(1000.0f);
+
+    // Unused slots must never be returned, infinite boxes must always be.
+    for (size_t i = 0; i < objects.numObjs; i += 7u)
+        objects.removeObject(i);
+    objects.setAabb(5u, Aabb::BOX_INFINITE);
+    objects.setAabb(9001u, Aabb::BOX_INFINITE);
+    objects.setAabb(9002u, Aabb::BOX_NULL);
+
+    ObjectDataBvh bvh;
+    bvh.build(objects.objData, objects.numObjs);
+    CPPUNIT_ASSERT_EQUAL(size_t(2501u), bvh.getNumPacks());
+
+    Plane planes[6];
+    makeBoxPlanes(Vector3(100.0f), Vector3(300.0f), planes);
+    checkMatchesLinear(bvh, objects, planes);
+
+    // Everything inside
+    makeBoxPlanes(Vector3(-10.0f), Vector3(1010.0f), planes);
+    checkMatchesLinear(bvh, objects, planes);
+
+    // Nothing but the infinite boxes
+    makeBoxPlanes(Vector3(-300.0f), Vector3(-200.0f), planes);
+    checkMatchesLinear(bvh, objects, planes);
+
+    TestObjects coherent(4096u);
+    coherent.fillCoherent(1000.0f);
+    bvh.build(coherent.objData, coherent.numObjs);
+    makeBoxPlanes(Vector3(250.0f, -10.0f, 0.0f), Vector3(500.0f, 10.0f, 300.0f), planes);
+    checkMatchesLinear(bvh, coherent, planes);
+}
+//--------------------------------------------------------------------------
+void ObjectDataBvhTests::testRefit()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TestObjects objects(2000u);
+    objects.fillCoherent(1000.0f);
+
+    ObjectDataBvh bvh;
+    bvh.update(objects.objData, objects.numObjs);
+    CPPUNIT_ASSERT_EQUAL(uint32(1u), bvh.getNumBuilds());
+
+    // Slightly move everything. Must refit, not rebuild.
+    for (size_t i = 0; i < objects.numObjs; ++i)
+    {
+        Aabb aabb = objects.worldAabb[i / ARRAY_PACKED_REALS].getAsAabb(i % ARRAY_PACKED_REALS);
+        aabb.mCenter += Vector3(1.0f, 0.0f, 0.0f);
+        objects.setAabb(i, aabb);
+    }
+    bvh.update(objects.objData, objects.numObjs);
+    CPPUNIT_ASSERT_EQUAL(uint32(1u), bvh.getNumBuilds());
+
+    Plane planes[6];
+    makeBoxPlanes(Vector3(0.0f, -10.0f, 0.0f), Vector3(200.0f, 10.0f, 200.0f), planes);
+    checkMatchesLinear(bvh, objects, planes);
+
+    // Scatter them. Refitting must still be correct.
+    objects.fillRandom(1000.0f);
+    bvh.update(objects.objData, objects.numObjs);
+    CPPUNIT_ASSERT_EQUAL(uint32(1u), bvh.getNumBuilds());
+    checkMatchesLinear(bvh, objects, planes);
+
+    // A different number of packs always rebuilds
+    objects.numObjs -= ARRAY_PACKED_REALS;
+    bvh.update(objects.objData, objects.numObjs);
+    CPPUNIT_ASSERT_EQUAL(uint32(2u), bvh.getNumBuilds());
+    checkMatchesLinear(bvh, objects, planes);
+}
+//--------------------------------------------------------------------------
+void ObjectDataBvhTests::testRefitLeafRanges()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TestObjects objects(20000u);
+    objects.fillCoherent(1000.0f);
+
+    ObjectDataBvh bvh;
+    bvh.build(objects.objData, objects.numObjs);
+
+    const size_t numLeaves = bvh.getNumLeaves();
+    CPPUNIT_ASSERT(numLeaves > 3u);
+
+    Plane planes[6];
+    makeBoxPlanes(Vector3(300.0f, -10.0f, 300.0f), Vector3(600.0f, 10.0f, 600.0f), planes);
+
+    // Refit the leaves in uneven ranges, out of order (like worker threads would), then the nodes
+    objects.fillRandom(1000.0f);
+    const size_t split[3] = { 1u, numLeaves / 3u, numLeaves - 1u };
+    bvh.refitLeaves(objects.objData, split[1], split[2] - split[1]);
+    bvh.refitLeaves(objects.objData, split[2], numLeaves - split[2]);
+    bvh.refitLeaves(objects.objData, 0u, split[0]);
+    bvh.refitLeaves(objects.objData, split[0], split[1] - split[0]);
+    bvh.refitLeaves(objects.objData, numLeaves, 0u);
+    bvh.refitNodes();
+
+    CPPUNIT_ASSERT_EQUAL(uint32(1u), bvh.getNumBuilds());
+    checkMatchesLinear(bvh, objects, planes);
+
+    // Removed objects must not be visible through stale leaves
+    for (size_t i = 0; i < objects.numObjs; i += 3u)
+        objects.removeObject(i);
+    bvh.refitLeaves(objects.objData, 0u, numLeaves);
+    bvh.refitNodes();
+    checkMatchesLinear(bvh, objects, planes);
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,185 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OptimisedUtilTests.h"
+#include "OgreMatrix4.h"
+#include "OgreOptimisedUtil.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(OptimisedUtilTests);
+
+namespace
+{
+    /// Deterministic values in [minValue; maxValue)
+    struct TestRandom
+    {
+        uint32 state;
+
+        TestRandom() : state(12345u) {}
+
+        float next(float minValue, float maxValue)
+        {
+            state = state * 1664525u + 1013904223u;
+            return minValue + (maxValue - minValue) * (float)(state >> 8u) / (float)(1u << 24u);
+        }
+
+        /// An affine transform with uniform scale, so normals can be skinned with it.
+        Matrix4 nextTransform()
+        {
+            Quaternion orientation(next(-1.0f, 1.0f), next(-1.0f, 1.0f), next(-1.0f, 1.0f),
+                                   next(-1.0f, 1.0f));
+            orientation.normalise();
+            const float scale = next(0.5f, 2.0f);
+
+            Matrix4 retVal;
+            retVal.makeTransform(Vector3(next(-10.0f, 10.0f), next(-10.0f, 10.0f),
+                                         next(-10.0f, 10.0f)),
+                                 Vector3(scale, scale, scale), orientation);
+            return retVal;
+        }
+    };
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+static void checkSameFloats(const std::vector<float>& values, const std::vector<float>& reference)
+{
+    CPPUNIT_ASSERT_EQUAL(reference.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        const float tolerance = 1e-4f * std::max(1.0f, std::abs(reference[i]));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(reference[i], values[i], tolerance);
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testAvx2SoftwareVertexSkinning()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    OptimisedUtil* avx2 = OptimisedUtil::_getAvx2Implementation();
+    if (!avx2)
+        return;
+    OptimisedUtil* general = OptimisedUtil::_getGeneralImplementation();
+
+    TestRandom random;
+
+    const size_t numMatrices = 8u;
+    Matrix4 matrices[numMatrices];
+    const Matrix4* blendMatrices[numMatrices];
+    for (size_t i = 0; i < numMatrices; ++i)
+    {
+        matrices[i] = random.nextTransform();
+        blendMatrices[i] = &matrices[i];
+    }
+
+    // Odd, so the AVX2 path (two vertices at a time) has a leftover vertex
+    const size_t numVertices = 17u;
+    const size_t maxWeights = 4u;
+
+    // Interleaved position + normal + padding, like a shared vertex buffer
+    const size_t vertexStride = 8u * sizeof(float);
+    std::vector<float> srcVertices(numVertices * 8u);
+    std::vector<float> blendWeights(numVertices * maxWeights);
+    std::vector<unsigned char> blendIndices(numVertices * maxWeights);
+
+    for (size_t i = 0; i < srcVertices.size(); ++i)
+        srcVertices[i] = random.next(-5.0f, 5.0f);
+    for (size_t i = 0; i < blendIndices.size(); ++i)
+    {
+        blendWeights[i] = random.next(0.0f, 1.0f);
+        blendIndices[i] = (unsigned char)(random.next(0.0f, (float)numMatrices));
+    }
+
+    for (size_t numWeights = 1u; numWeights <= maxWeights; ++numWeights)
+    {
+        for (size_t withNormals = 0u; withNormals < 2u; ++withNormals)
+        {
+            std::vector<float> dstVertices(srcVertices.size(), 0.0f);
+            std::vector<float> dstReference(srcVertices.size(), 0.0f);
+
+            const float* srcNorm = withNormals ? &srcVertices[3] : 0;
+
+            avx2->softwareVertexSkinning(
+                &srcVertices[0], &dstVertices[0], srcNorm, withNormals ? &dstVertices[3] : 0,
+                &blendWeights[0], &blendIndices[0], blendMatrices, vertexStride, vertexStride,
+                vertexStride, vertexStride, maxWeights * sizeof(float), maxWeights, numWeights,
+                numVertices);
+            general->softwareVertexSkinning(
+                &srcVertices[0], &dstReference[0], srcNorm, withNormals ? &dstReference[3] : 0,
+                &blendWeights[0], &blendIndices[0], blendMatrices, vertexStride, vertexStride,
+                vertexStride, vertexStride, maxWeights * sizeof(float), maxWeights, numWeights,
+                numVertices);
+
+            checkSameFloats(dstVertices, dstReference);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void OptimisedUtilTests::testAvx2ConcatenateAffineMatrices()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    OptimisedUtil* avx2 = OptimisedUtil::_getAvx2Implementation();
+    if (!avx2)
+        return;
+    OptimisedUtil* general = OptimisedUtil::_getGeneralImplementation();
+
+    TestRandom random;
+
+    const size_t numMatrices = 9u;
+    const Matrix4 baseMatrix = random.nextTransform();
+    Matrix4 srcMatrices[numMatrices];
+    Matrix4 dstMatrices[numMatrices];
+    Matrix4 dstReference[numMatrices];
+    for (size_t i = 0; i < numMatrices; ++i)
+        srcMatrices[i] = random.nextTransform();
+
+    avx2->concatenateAffineMatrices(baseMatrix, srcMatrices, dstMatrices, numMatrices);
+    general->concatenateAffineMatrices(baseMatrix, srcMatrices, dstReference, numMatrices);
+
+    for (size_t i = 0; i < numMatrices; ++i)
+    {
+        const std::vector<float> values(dstMatrices[i][0], dstMatrices[i][0] + 16u);
+        const std::vector<float> reference(dstReference[i][0], dstReference[i][0] + 16u);
+        checkSameFloats(values, reference);
+    }
+}
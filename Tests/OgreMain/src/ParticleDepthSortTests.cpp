@@ -0,0 +1,185 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ParticleDepthSortTests.h"
+#include "ParticleSystem/OgreParticleSystem2.h"
+#include "ParticleTestHelpers.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ParticleDepthSortTests);
+
+namespace
+{
+    /// A cloud of smoke where every 4th particle is dead.
+    void fillSmokeCloud(TestParticles& particles, Real size)
+    {
+        for (size_t i = 0; i < particles.numParticles; ++i)
+        {
+            const Vector3 pos(particles.random() * size, particles.random() * size,
+                              particles.random() * size);
+            particles.setPosition(i, pos);
+            particles.setTimeToLive(i, (i % 4u) == 3u ? 0.0f : particles.random() + 0.1f);
+        }
+    }
+
+    /// Calculates the keys the same way ParticleSystemManager2::_updateParallel02 does,
+    /// i.e. split in chunks (one per thread).
+    void calculateKeys(const TestParticles& particles, const Vector3& camPos, size_t numThreads,
+                       std::vector<uint64>& outKeys)
+    {
+        ArrayVector3 arrayCamPos;
+        arrayCamPos.setAll(camPos);
+
+        outKeys.resize(particles.numParticles);
+
+        size_t particlesPerThread = (particles.numParticles + numThreads - 1u) / numThreads;
+        particlesPerThread =
+            ((particlesPerThread + ARRAY_PACKED_REALS - 1u) / ARRAY_PACKED_REALS) * ARRAY_PACKED_REALS;
+
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            const size_t firstParticle = std::min(i * particlesPerThread, particles.numParticles);
+            const size_t numParticles =
+                std::min(particlesPerThread, particles.numParticles - firstParticle);
+
+            ParticleCpuData cpuData = particles.cpuData;
+            cpuData.mPosition += firstParticle / ARRAY_PACKED_REALS;
+            cpuData.mTimeToLive += firstParticle / ARRAY_PACKED_REALS;
+            ParticleSystemDef::_calculateDepthSortKeys(cpuData, numParticles, arrayCamPos,
+                                                       static_cast<uint32>(firstParticle),
+                                                       &outKeys[firstParticle]);
+        }
+    }
+
+    struct SortByDistanceDesc
+    {
+        const TestParticles& particles;
+        Vector3 camPos;
+
+        SortByDistanceDesc(const TestParticles& _particles, const Vector3& _camPos) :
+            particles(_particles), camPos(_camPos)
+        {
+        }
+
+        bool operator()(uint32 a, uint32 b) const
+        {
+            return particles.getPosition(a).squaredDistance(camPos) >
+                   particles.getPosition(b).squaredDistance(camPos);
+        }
+    };
+}  // namespace
+
+//--------------------------------------------------------------------------
+void ParticleDepthSortTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void ParticleDepthSortTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void ParticleDepthSortTests::testBackToFront()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TestParticles particles(ARRAY_PACKED_REALS * 1000u);
+    fillSmokeCloud(particles, 100.0f);
+    // The camera is in the middle of the cloud
+    const Vector3 camPos(50.0f, 50.0f, 50.0f);
+
+    std::vector<uint64> keys;
+    calculateKeys(particles, camPos, 3u, keys);
+
+    std::vector<uint64> tmp(keys.size());
+    std::vector<uint32> indices(keys.size() * 6u);
+    const uint32 numSorted = ParticleSystemDef::_sortParticlesBackToFront(
+        &keys[0], &tmp[0], keys.size(), false, &indices[0]);
+
+    std::vector<uint32> expected;
+    for (uint32 i = 0; i < particles.numParticles; ++i)
+    {
+        if (particles.isAlive(i))
+            expected.push_back(i);
+    }
+    std::stable_sort(expected.begin(), expected.end(), SortByDistanceDesc(particles, camPos));
+
+    // Dead particles must not be rendered
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32>(expected.size()), numSorted);
+
+    for (size_t i = 0; i < numSorted; ++i)
+    {
+        const uint32 particleIdx = indices[i * 6u] / 4u;
+        CPPUNIT_ASSERT(particles.isAlive(particleIdx));
+        // Distances may be (almost) equal; thus compare them, not the indices.
+        const Real expectedDistance = particles.getPosition(expected[i]).squaredDistance(camPos);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedDistance,
+                                     particles.getPosition(particleIdx).squaredDistance(camPos),
+                                     expectedDistance * 1e-5f);
+    }
+}
+//--------------------------------------------------------------------------
+void ParticleDepthSortTests::testIndexLayout()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    TestParticles particles(ARRAY_PACKED_REALS * 2u);
+    for (size_t i = 0; i < particles.numParticles; ++i)
+    {
+        particles.setPosition(i, Vector3(0.0f, 0.0f, Real(i)));
+        particles.setTimeToLive(i, 1.0f);
+    }
+
+    // Camera at the origin: the last particle is the farthest
+    std::vector<uint64> keys;
+    calculateKeys(particles, Vector3::ZERO, 1u, keys);
+
+    std::vector<uint64> tmp(keys.size());
+    std::vector<uint16> indices(keys.size() * 6u);
+    const uint32 numSorted = ParticleSystemDef::_sortParticlesBackToFront(
+        &keys[0], &tmp[0], keys.size(), true, &indices[0]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint32>(particles.numParticles), numSorted);
+
+    const uint16 quadIndices[6] = { 0u, 1u, 2u, 1u, 3u, 2u };
+    for (size_t i = 0; i < numSorted; ++i)
+    {
+        const size_t particleIdx = particles.numParticles - i - 1u;
+        for (size_t j = 0; j < 6u; ++j)
+        {
+            CPPUNIT_ASSERT_EQUAL(static_cast<uint16>(particleIdx * 4u + quadIndices[j]),
+                                 indices[i * 6u + j]);
+        }
+    }
+}
+//--------------------------------------------------------------------------
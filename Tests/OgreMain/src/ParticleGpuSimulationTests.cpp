@@ -0,0 +1,158 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "ParticleGpuSimulationTests.h"
+#include "ParticleSystem/OgreParticleGpuSimulation.h"
+#include "ParticleTestHelpers.h"
+
+#include "OgreColourFaderAffector2FX2.h"
+#include "OgreColourFaderAffectorFX2.h"
+#include "OgreDeflectorPlaneAffector2.h"
+#include "OgreLinearForceAffector2.h"
+#include "OgreRotationAffector2.h"
+#include "OgreScaleAffector2.h"
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(ParticleGpuSimulationTests);
+
+namespace
+{
+    /// Runs the given ParticleFX2 affectors through the CPU path and simulateReference.
+    void checkMatchesCpu(const FastArray<ParticleAffector2*>& affectors)
+    {
+        TestParticles particles(1024u);
+        particles.fill();
+
+        String report;
+        const size_t numMismatches =
+            ParticleGpuSimulation::compareWithCpu(particles.cpuData, particles.numParticles, affectors,
+                                                  1.0f / 60.0f, 180u, 1e-3f, &report);
+        CPPUNIT_ASSERT_MESSAGE(report, numMismatches == 0u);
+    }
+}  // namespace
+
+//--------------------------------------------------------------------------
+void ParticleGpuSimulationTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void ParticleGpuSimulationTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void ParticleGpuSimulationTests::testMatchesCpu()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    LinearForceAffector2 forceAffector;
+    forceAffector.setForceVector(Vector3(0.0f, -9.8f, 0.0f));
+    ColourFaderAffectorFX2 faderAffector;
+    faderAffector.setAdjust(-0.5f, 0.25f, -1.0f, -0.3f);
+    ScaleAffector2 scaleAffector;
+    scaleAffector.setAdjust(0.5f);
+    RotationAffector2 rotationAffector;
+
+    FastArray<ParticleAffector2*> affectors;
+    affectors.push_back(&forceAffector);
+    affectors.push_back(&faderAffector);
+    affectors.push_back(&scaleAffector);
+    affectors.push_back(&rotationAffector);
+    checkMatchesCpu(affectors);
+}
+//--------------------------------------------------------------------------
+void ParticleGpuSimulationTests::testMatchesCpuAlternateModes()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    LinearForceAffector2 forceAffector;
+    forceAffector.setForceVector(Vector3(1.0f, 2.0f, -3.0f));
+    forceAffector.setForceApplication(LinearForceAffector2::FA_AVERAGE);
+    ColourFaderAffector2FX2 faderAffector;
+    faderAffector.setAdjust1(-0.5f, 0.25f, -1.0f, -0.3f);
+    faderAffector.setAdjust2(0.75f, -0.5f, 0.5f, -1.0f);
+    faderAffector.setStateChange(0.5f);
+    ScaleAffector2 scaleAffector;
+    scaleAffector.setAdjust(0.9f);
+    scaleAffector.setMultiplyMode(true);
+
+    FastArray<ParticleAffector2*> affectors;
+    affectors.push_back(&forceAffector);
+    affectors.push_back(&faderAffector);
+    affectors.push_back(&scaleAffector);
+    checkMatchesCpu(affectors);
+}
+//--------------------------------------------------------------------------
+void ParticleGpuSimulationTests::testDeadParticles()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    ParticleGpuState states[2];
+    memset(states, 0, sizeof(states));
+    states[0].mTimeToLive = 0.01f;
+    states[0].mDimensions[0] = 1.0f;
+    states[1].mTimeToLive = 1.0f;
+    states[1].mDimensions[0] = 1.0f;
+    states[1].mColour[3] = 1.0f;
+
+    ParticleGpuData gpuData[2];
+    memset(gpuData, 0xFF, sizeof(gpuData));
+    ParticleGpuSimulation::simulateReference(states, gpuData, 2u, 0, 0u, 0.1f);
+
+    // The particle that just died must be fully zeroed so the vertex shader discards it.
+    const uint8* data = reinterpret_cast<const uint8*>(&gpuData[0]);
+    for (size_t i = 0u; i < sizeof(ParticleGpuData); ++i)
+        CPPUNIT_ASSERT_EQUAL((uint8)0u, data[i]);
+    CPPUNIT_ASSERT_EQUAL(0.0f, states[0].mTimeToLive);
+
+    CPPUNIT_ASSERT_EQUAL(1.0f, gpuData[1].mWidth);
+    CPPUNIT_ASSERT_EQUAL((int8)127, gpuData[1].mColourAlpha);
+}
+//--------------------------------------------------------------------------
+void ParticleGpuSimulationTests::testUnsupportedAffector()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    LinearForceAffector2 forceAffector;
+    DeflectorPlaneAffector2 deflectorAffector;
+
+    FastArray<ParticleAffector2*> affectors;
+    FastArray<ParticleGpuAffector> gpuAffectors;
+    affectors.push_back(&forceAffector);
+    CPPUNIT_ASSERT(ParticleGpuSimulation::getGpuAffectors(affectors, gpuAffectors));
+    CPPUNIT_ASSERT_EQUAL((size_t)1u, gpuAffectors.size());
+    CPPUNIT_ASSERT_EQUAL(ParticleGpuAffectorOp::LinearForceAdd, gpuAffectors[0].op);
+    CPPUNIT_ASSERT(gpuAffectors[0].params[0] == Vector4(forceAffector.getForceVector(), 0.0f));
+
+    gpuAffectors.clear();
+    affectors.push_back(&deflectorAffector);
+    CPPUNIT_ASSERT(!ParticleGpuSimulation::getGpuAffectors(affectors, gpuAffectors));
+}
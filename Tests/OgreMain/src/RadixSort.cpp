@@ -28,6 +28,9 @@ THE SOFTWARE.
 #include "RadixSortTests.h"
 #include "OgreRadixSort.h"
 #include "OgreMath.h"
+#include "OgreRenderQueue.h"
+
+#include <algorithm>
 
 #include "UnitTestSuite.h"
 
@@ -219,5 +222,72 @@ void RadixSortTests::testIntVector()
     }
 }
 //--------------------------------------------------------------------------
+static uint64 randomUint64()
+{
+    return ((uint64)rand() << 48u) ^ ((uint64)rand() << 32u) ^ ((uint64)rand() << 16u) ^
+           (uint64)rand();
+}
+//--------------------------------------------------------------------------
+/// Generates hashes that look like RenderQueue's: a handful of materials and
+/// meshes in the most significant bits, random depth in the least significant.
+static void generateQueuedRenderables(std::vector<QueuedRenderable>& container, size_t numEntries)
+{
+    container.clear();
+    container.reserve(numEntries);
+    for (size_t i = 0; i < numEntries; ++i)
+    {
+        const uint64 material = (uint64)(rand() % 64) << 40u;
+        const uint64 mesh = (uint64)(rand() % 256) << 24u;
+        const uint64 depth = randomUint64() & 0xFFFFFF;
+        container.push_back(QueuedRenderable(material | mesh | depth, 0,
+                                             reinterpret_cast<MovableObject*>(i + 1u)));
+    }
+}
+//--------------------------------------------------------------------------
+struct QueuedRenderableHash
+{
+    uint64 operator()(const QueuedRenderable& q) const
+    {
+        return q.hash;
+    }
+};
+//--------------------------------------------------------------------------
+void RadixSortTests::testUint64Keys()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
 
+    std::vector<QueuedRenderable> container;
+    std::vector<QueuedRenderable> tmp;
+
+    // Full 64-bit range
+    container.resize(1000);
+    for (size_t i = 0; i < container.size(); ++i)
+        container[i].hash = randomUint64();
+    tmp.resize(container.size());
+
+    const QueuedRenderable* sorted =
+        radixSortUint64(&container[0], &tmp[0], container.size(), QueuedRenderableHash());
+    for (size_t i = 1; i < container.size(); ++i)
+        CPPUNIT_ASSERT(sorted[i - 1].hash <= sorted[i].hash);
+
+    // Many duplicated keys: must behave like std::stable_sort
+    generateQueuedRenderables(container, 10000);
+    for (size_t i = 0; i < container.size(); ++i)
+        container[i].hash >>= 32u;
+    std::vector<QueuedRenderable> expected = container;
+    std::stable_sort(expected.begin(), expected.end());
+
+    tmp.resize(container.size());
+    sorted = radixSortUint64(&container[0], &tmp[0], container.size(), QueuedRenderableHash());
+    for (size_t i = 0; i < container.size(); ++i)
+    {
+        CPPUNIT_ASSERT(sorted[i].hash == expected[i].hash);
+        CPPUNIT_ASSERT(sorted[i].movableObject == expected[i].movableObject);
+    }
 
+    // Already sorted input must be left untouched
+    container = expected;
+    sorted = radixSortUint64(&container[0], &tmp[0], container.size(), QueuedRenderableHash());
+    CPPUNIT_ASSERT(sorted == &container[0]);
+}
+//--------------------------------------------------------------------------
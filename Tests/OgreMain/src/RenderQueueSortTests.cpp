@@ -0,0 +1,265 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "RenderQueueSortTests.h"
+#include "OgreRenderQueue.h"
+
+#include <algorithm>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(RenderQueueSortTests);
+
+typedef RenderQueue::QueuedRenderableArray QueuedRenderableArray;
+
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+    srand(0);
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+/// Few distinct hashes so there are plenty of duplicates. movableObject holds
+/// a unique id so the entries can be told apart.
+static void generateEntries(QueuedRenderableArray& container, size_t numEntries, size_t firstId)
+{
+    for (size_t i = 0; i < numEntries; ++i)
+    {
+        container.push_back(QueuedRenderable((uint64)(rand() % 512) << 20u, 0,
+                                             reinterpret_cast<MovableObject*>(firstId + i + 1u)));
+    }
+}
+//--------------------------------------------------------------------------
+/// Checks that sorted is sorted and is a permutation of unsorted.
+static void checkSortedPermutation(const QueuedRenderableArray& unsorted,
+                                   const QueuedRenderableArray& sorted)
+{
+    CPPUNIT_ASSERT_EQUAL(unsorted.size(), sorted.size());
+    for (size_t i = 1; i < sorted.size(); ++i)
+        CPPUNIT_ASSERT(sorted[i - 1].hash <= sorted[i].hash);
+
+    std::vector<const MovableObject*> idsA;
+    std::vector<const MovableObject*> idsB;
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        idsA.push_back(unsorted[i].movableObject);
+        idsB.push_back(sorted[i].movableObject);
+    }
+    std::sort(idsA.begin(), idsA.end());
+    std::sort(idsB.begin(), idsB.end());
+    CPPUNIT_ASSERT(idsA == idsB);
+}
+//--------------------------------------------------------------------------
+/// Runs RenderQueue::_sortTemporal on a copy of unsorted and validates the result,
+/// including that sortedIndices maps back to unsorted.
+static void sortTemporalAndCheck(const QueuedRenderableArray& unsorted,
+                                 FastArray<uint32>& sortedIndices)
+{
+    QueuedRenderableArray queuedRenderables = unsorted;
+    QueuedRenderableArray tmpSource;
+    RenderQueue::TemporalSortEntryArray tmpKept;
+    RenderQueue::TemporalSortEntryArray tmpDisplaced;
+
+    RenderQueue::_sortTemporal(queuedRenderables, sortedIndices, tmpSource, tmpKept,
+                               tmpDisplaced);
+
+    checkSortedPermutation(unsorted, queuedRenderables);
+    CPPUNIT_ASSERT_EQUAL(unsorted.size(), sortedIndices.size());
+    for (size_t i = 0; i < sortedIndices.size(); ++i)
+    {
+        CPPUNIT_ASSERT(sortedIndices[i] < unsorted.size());
+        CPPUNIT_ASSERT(queuedRenderables[i].movableObject ==
+                       unsorted[sortedIndices[i]].movableObject);
+    }
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::testTemporalSortFirstFrame()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FastArray<uint32> sortedIndices;
+
+    QueuedRenderableArray unsorted;
+    sortTemporalAndCheck(unsorted, sortedIndices);
+
+    generateEntries(unsorted, 1000u, 0u);
+    sortTemporalAndCheck(unsorted, sortedIndices);
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::testTemporalSortCoherent()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FastArray<uint32> sortedIndices;
+
+    QueuedRenderableArray unsorted;
+    generateEntries(unsorted, 1000u, 0u);
+    sortTemporalAndCheck(unsorted, sortedIndices);
+
+    // Same input as last frame
+    sortTemporalAndCheck(unsorted, sortedIndices);
+
+    // A few objects changed material or depth (only sorts & merges the displaced ones)
+    for (size_t i = 0; i < 20u; ++i)
+        unsorted[(size_t)rand() % unsorted.size()].hash = (uint64)(rand() % 512) << 20u;
+    sortTemporalAndCheck(unsorted, sortedIndices);
+
+    // Single outliers at both ends
+    unsorted[sortedIndices.front()].hash = std::numeric_limits<uint64>::max();
+    unsorted[sortedIndices.back()].hash = 0u;
+    sortTemporalAndCheck(unsorted, sortedIndices);
+
+    // Most objects changed (falls back to a full sort)
+    for (size_t i = 0; i < unsorted.size(); ++i)
+        unsorted[i].hash = (uint64)(rand() % 512) << 20u;
+    sortTemporalAndCheck(unsorted, sortedIndices);
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::testTemporalSortResize()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    FastArray<uint32> sortedIndices;
+
+    QueuedRenderableArray unsorted;
+    generateEntries(unsorted, 1000u, 0u);
+    sortTemporalAndCheck(unsorted, sortedIndices);
+
+    // Queue grew since last frame
+    generateEntries(unsorted, 50u, 1000u);
+    sortTemporalAndCheck(unsorted, sortedIndices);
+
+    // Queue shrank since last frame
+    unsorted.resize(600u);
+    sortTemporalAndCheck(unsorted, sortedIndices);
+
+    // Queue emptied, then refilled
+    unsorted.clear();
+    sortTemporalAndCheck(unsorted, sortedIndices);
+    generateEntries(unsorted, 300u, 2000u);
+    sortTemporalAndCheck(unsorted, sortedIndices);
+}
+//--------------------------------------------------------------------------
+/// Fills numThreads queues as culling would: sorted per thread, then a few
+/// more entries appended afterwards (i.e. v1 objects added from the main thread).
+static void generateThreadQueues(RenderQueue::QueuedRenderableArrayPerThread& perThreadQueue,
+                                 size_t numThreads, RenderQueue::RqSortMode sortMode)
+{
+    perThreadQueue.resize(numThreads);
+    size_t nextId = 0u;
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        RenderQueue::ThreadRenderQueue& threadQueue = perThreadQueue[i];
+        threadQueue.numSorted = 0u;
+
+        const size_t numEntries = (size_t)(rand() % 700);
+        generateEntries(threadQueue.q, numEntries, nextId);
+        nextId += numEntries;
+        RenderQueue::_sortThreadQueue(threadQueue, sortMode);
+
+        const size_t numLate = (size_t)(rand() % 40);
+        generateEntries(threadQueue.q, numLate, nextId);
+        nextId += numLate;
+        RenderQueue::_sortThreadQueue(threadQueue, sortMode);
+    }
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::testThreadQueueSort()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const RenderQueue::RqSortMode sortModes[3] = { RenderQueue::NormalSort,
+                                                   RenderQueue::StableSort,
+                                                   RenderQueue::RadixSort };
+    for (size_t m = 0; m < 3u; ++m)
+    {
+        RenderQueue::ThreadRenderQueue threadQueue;
+        threadQueue.numSorted = 0u;
+        generateEntries(threadQueue.q, 1000u, 0u);
+        RenderQueue::_sortThreadQueue(threadQueue, sortModes[m]);
+        CPPUNIT_ASSERT_EQUAL(threadQueue.q.size(), threadQueue.numSorted);
+
+        // Append unsorted entries; only those get sorted, then merged with the rest
+        generateEntries(threadQueue.q, 100u, 1000u);
+        QueuedRenderableArray expected = threadQueue.q;
+        std::stable_sort(expected.begin(), expected.end());
+
+        RenderQueue::_sortThreadQueue(threadQueue, sortModes[m]);
+        CPPUNIT_ASSERT_EQUAL(threadQueue.q.size(), threadQueue.numSorted);
+        checkSortedPermutation(expected, threadQueue.q);
+
+        if (sortModes[m] != RenderQueue::NormalSort)
+        {
+            for (size_t i = 0; i < expected.size(); ++i)
+                CPPUNIT_ASSERT(expected[i].movableObject == threadQueue.q[i].movableObject);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+void RenderQueueSortTests::testParallelMerge()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    const size_t numQueues[4] = { 1u, 2u, 3u, 7u };
+    const size_t numMergeThreads[4] = { 1u, 2u, 3u, 7u };
+
+    for (size_t q = 0; q < 4u; ++q)
+    {
+        RenderQueue::QueuedRenderableArrayPerThread perThreadQueue;
+        generateThreadQueues(perThreadQueue, numQueues[q], RenderQueue::StableSort);
+
+        // Serial reference: std::stable_sort on the concatenated queues
+        QueuedRenderableArray expected;
+        for (size_t i = 0; i < perThreadQueue.size(); ++i)
+            expected.appendPOD(perThreadQueue[i].q.begin(), perThreadQueue[i].q.end());
+        std::stable_sort(expected.begin(), expected.end());
+
+        for (size_t t = 0; t < 4u; ++t)
+        {
+            QueuedRenderableArray merged;
+            merged.resizePOD(expected.size());
+            for (size_t threadIdx = 0; threadIdx < numMergeThreads[t]; ++threadIdx)
+            {
+                RenderQueue::_mergeThreadQueues(perThreadQueue, merged, threadIdx,
+                                                numMergeThreads[t]);
+            }
+
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                CPPUNIT_ASSERT_EQUAL(expected[i].hash, merged[i].hash);
+                CPPUNIT_ASSERT(expected[i].movableObject == merged[i].movableObject);
+            }
+        }
+    }
+}
@@ -0,0 +1,210 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "StageGraphTests.h"
+#include "Threading/OgreStageGraph.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(StageGraphTests);
+
+//--------------------------------------------------------------------------
+void StageGraphTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void StageGraphTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void StageGraphTests::testSingleThread()
+{
+    StageGraph graph;
+    const size_t a = graph.addStage(3u);
+    const size_t b = graph.addStage(0u, a);
+    graph.addStage(2u, b);
+    graph.finalize();
+
+    const size_t expectedStage[5] = { 0u, 0u, 0u, 2u, 2u };
+    const size_t expectedJob[5] = { 0u, 1u, 2u, 0u, 1u };
+
+    size_t stageIdx, jobIdx;
+    for (size_t i = 0; i < 5u; ++i)
+    {
+        CPPUNIT_ASSERT(graph.getNextJob(stageIdx, jobIdx));
+        CPPUNIT_ASSERT_EQUAL(expectedStage[i], stageIdx);
+        CPPUNIT_ASSERT_EQUAL(expectedJob[i], jobIdx);
+        graph.jobFinished(stageIdx);
+    }
+    CPPUNIT_ASSERT(!graph.getNextJob(stageIdx, jobIdx));
+
+    // Can be reused
+    graph.finalize();
+    size_t numJobs = 0;
+    while (graph.getNextJob(stageIdx, jobIdx))
+    {
+        graph.jobFinished(stageIdx);
+        ++numJobs;
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)5u, numJobs);
+}
+//--------------------------------------------------------------------------
+void StageGraphTests::testDependencies()
+{
+    // Emulates transforms: a chain of depth levels, followed by
+    // several independent stages that depend on the last level.
+    const size_t numThreads = 8u;
+
+    StageGraph graph;
+    std::vector<size_t> numJobsPerStage;
+    std::vector<size_t> dependencies;
+
+    size_t lastStage = StageGraph::NoDependency;
+    for (size_t i = 0; i < 6u; ++i)
+    {
+        const size_t numJobs = i * 7u;
+        dependencies.push_back(lastStage);
+        numJobsPerStage.push_back(numJobs);
+        lastStage = graph.addStage(numJobs, lastStage);
+    }
+    for (size_t i = 0; i < 10u; ++i)
+    {
+        dependencies.push_back(lastStage);
+        numJobsPerStage.push_back(13u);
+        graph.addStage(13u, lastStage);
+    }
+
+    for (int iteration = 0; iteration < 50; ++iteration)
+    {
+        std::vector<std::atomic<uint32> > numJobsDone(numJobsPerStage.size());
+        for (size_t i = 0; i < numJobsDone.size(); ++i)
+            numJobsDone[i] = 0u;
+        std::atomic<bool> dependencyBroken(false);
+
+        graph.finalize();
+
+        std::vector<std::thread> threads;
+        for (size_t threadIdx = 0; threadIdx < numThreads; ++threadIdx)
+        {
+            threads.push_back(std::thread([&]() {
+                size_t stageIdx, jobIdx;
+                while (graph.getNextJob(stageIdx, jobIdx))
+                {
+                    const size_t dependency = dependencies[stageIdx];
+                    if (dependency != StageGraph::NoDependency &&
+                        numJobsDone[dependency].load() != numJobsPerStage[dependency])
+                    {
+                        dependencyBroken = true;
+                    }
+                    ++numJobsDone[stageIdx];
+                    graph.jobFinished(stageIdx);
+                }
+            }));
+        }
+
+        for (size_t i = 0; i < numThreads; ++i)
+            threads[i].join();
+
+        CPPUNIT_ASSERT(!dependencyBroken);
+        for (size_t i = 0; i < numJobsPerStage.size(); ++i)
+            CPPUNIT_ASSERT_EQUAL((uint32)numJobsPerStage[i], numJobsDone[i].load());
+    }
+}
+//--------------------------------------------------------------------------
+void StageGraphTests::testTwoDependencies()
+{
+    // Emulates the scene graph update: transforms, then animations & particle
+    // preparation in parallel, then tag points & bounds waiting for both.
+    const size_t numThreads = 8u;
+
+    StageGraph graph;
+    const size_t transforms = graph.addStage(20u);
+    const size_t animations = graph.addStage(numThreads, transforms);
+    const size_t particles = graph.addStage(numThreads, transforms);
+    const size_t tagPoints = graph.addStage(5u, animations, particles);
+    const size_t bounds = graph.addStage(30u, tagPoints, particles);
+    const size_t lightBounds = graph.addStage(3u, animations, particles);
+
+    const size_t numJobsPerStage[6] = { 20u, numThreads, numThreads, 5u, 30u, 3u };
+    const size_t dependencies[6][2] = {
+        { StageGraph::NoDependency, StageGraph::NoDependency },
+        { transforms, StageGraph::NoDependency },
+        { transforms, StageGraph::NoDependency },
+        { animations, particles },
+        { tagPoints, particles },
+        { animations, particles },
+    };
+    CPPUNIT_ASSERT_EQUAL((size_t)5u, lightBounds);
+    CPPUNIT_ASSERT_EQUAL((size_t)4u, bounds);
+
+    for (int iteration = 0; iteration < 50; ++iteration)
+    {
+        std::atomic<uint32> numJobsDone[6];
+        for (size_t i = 0; i < 6u; ++i)
+            numJobsDone[i] = 0u;
+        std::atomic<bool> dependencyBroken(false);
+
+        graph.finalize();
+
+        std::vector<std::thread> threads;
+        for (size_t threadIdx = 0; threadIdx < numThreads; ++threadIdx)
+        {
+            threads.push_back(std::thread([&]() {
+                size_t stageIdx, jobIdx;
+                while (graph.getNextJob(stageIdx, jobIdx))
+                {
+                    for (size_t i = 0; i < 2u; ++i)
+                    {
+                        const size_t dependency = dependencies[stageIdx][i];
+                        if (dependency != StageGraph::NoDependency &&
+                            numJobsDone[dependency].load() != numJobsPerStage[dependency])
+                        {
+                            dependencyBroken = true;
+                        }
+                    }
+                    ++numJobsDone[stageIdx];
+                    graph.jobFinished(stageIdx);
+                }
+            }));
+        }
+
+        for (size_t i = 0; i < numThreads; ++i)
+            threads[i].join();
+
+        CPPUNIT_ASSERT(!dependencyBroken);
+        for (size_t i = 0; i < 6u; ++i)
+            CPPUNIT_ASSERT_EQUAL((uint32)numJobsPerStage[i], numJobsDone[i].load());
+    }
+}
@@ -0,0 +1,229 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "TraceProfilerTests.h"
+#include "OgreTraceProfiler.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(TraceProfilerTests);
+
+namespace
+{
+    size_t countOccurrences(const String &str, const char *pattern)
+    {
+        size_t count = 0;
+        size_t pos = str.find(pattern);
+        while (pos != String::npos)
+        {
+            ++count;
+            pos = str.find(pattern, pos + 1u);
+        }
+        return count;
+    }
+
+    /// Returns the timestamp of the n-th event of the given phase ("B" or "E")
+    String getTimestamp(const String &json, const char *phase, size_t n)
+    {
+        const String pattern = String("\"ph\":\"") + phase + "\"";
+        size_t pos = json.find(pattern);
+        for (size_t i = 0; i < n && pos != String::npos; ++i)
+            pos = json.find(pattern, pos + 1u);
+        if (pos == String::npos)
+            return String();
+
+        const size_t tsStart = json.find("\"ts\":", pos) + 5u;
+        return json.substr(tsStart, json.find_first_of(",}", tsStart) - tsStart);
+    }
+}
+
+//--------------------------------------------------------------------------
+void TraceProfilerTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void TraceProfilerTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void TraceProfilerTests::testSampleFrequency()
+{
+    static const TraceMarker marker("TraceProfilerTests Frame");
+
+    TraceProfiler traceProfiler;
+    traceProfiler.setSampleFrequency(4u);
+
+    // Nothing is recorded outside of a frame
+    traceProfiler.profileBegin(marker);
+    traceProfiler.profileEnd();
+
+    for (size_t i = 0; i < 12u; ++i)
+    {
+        traceProfiler._frameStarted();
+        CPPUNIT_ASSERT_EQUAL(i % 4u == 0u, traceProfiler.isCapturing());
+        traceProfiler.profileBegin(marker);
+        traceProfiler.profileEnd();
+        traceProfiler._frameEnded();
+    }
+
+    String json;
+    traceProfiler.exportChromeTrace(json);
+    CPPUNIT_ASSERT_EQUAL((size_t)3u, countOccurrences(json, "\"ph\":\"B\""));
+    CPPUNIT_ASSERT_EQUAL((size_t)3u, countOccurrences(json, "\"ph\":\"E\""));
+    CPPUNIT_ASSERT_EQUAL((size_t)3u, countOccurrences(json, "\"name\":\"TraceProfilerTests Frame\""));
+
+    traceProfiler.setEnabled(false);
+    traceProfiler._frameStarted();
+    CPPUNIT_ASSERT(!traceProfiler.isCapturing());
+
+    traceProfiler.reset();
+    traceProfiler.exportChromeTrace(json);
+    CPPUNIT_ASSERT_EQUAL((size_t)0u, countOccurrences(json, "\"ph\":\"B\""));
+}
+//--------------------------------------------------------------------------
+void TraceProfilerTests::testUnbalancedEvents()
+{
+    static const TraceMarker outer("Outer");
+    static const TraceMarker inner("Inner");
+
+    TraceProfiler traceProfiler;
+
+    // Capturing starts in the middle of an event: its end must be dropped
+    traceProfiler._frameStarted();
+    traceProfiler.profileEnd();
+    traceProfiler.profileBegin(outer);
+    traceProfiler.profileBegin(inner);
+    traceProfiler.profileEnd();
+    // And stops before the end of another one: it must be closed
+    traceProfiler._frameEnded();
+    traceProfiler.profileEnd();
+
+    String json;
+    traceProfiler.exportChromeTrace(json);
+    CPPUNIT_ASSERT_EQUAL((size_t)2u, countOccurrences(json, "\"ph\":\"B\""));
+    CPPUNIT_ASSERT_EQUAL((size_t)2u, countOccurrences(json, "\"ph\":\"E\""));
+    CPPUNIT_ASSERT(json.find("\"name\":\"Outer\"") < json.find("\"name\":\"Inner\""));
+}
+//--------------------------------------------------------------------------
+void TraceProfilerTests::testEventsAcrossFrames()
+{
+    static const TraceMarker first("First");
+    static const TraceMarker second("Second");
+
+    TraceProfiler traceProfiler;
+    traceProfiler.setSampleFrequency(2u);
+
+    // Captured frame: 'First' ends after capturing stopped
+    traceProfiler._frameStarted();
+    traceProfiler.profileBegin(first);
+    traceProfiler._frameEnded();
+
+    // Skipped frame
+    traceProfiler._frameStarted();
+    traceProfiler._frameEnded();
+
+    // Captured frame: the end of an event that began in the skipped frame must not close 'First'
+    traceProfiler._frameStarted();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    traceProfiler.profileEnd();
+    traceProfiler.profileBegin(second);
+    traceProfiler.profileEnd();
+    traceProfiler._frameEnded();
+
+    String json;
+    traceProfiler.exportChromeTrace(json);
+    CPPUNIT_ASSERT_EQUAL((size_t)2u, countOccurrences(json, "\"ph\":\"B\""));
+    CPPUNIT_ASSERT_EQUAL((size_t)2u, countOccurrences(json, "\"ph\":\"E\""));
+
+    // 'First' is closed within its own frame
+    CPPUNIT_ASSERT(!getTimestamp(json, "B", 0u).empty());
+    CPPUNIT_ASSERT_EQUAL(getTimestamp(json, "B", 0u), getTimestamp(json, "E", 0u));
+    CPPUNIT_ASSERT(getTimestamp(json, "B", 1u) != getTimestamp(json, "E", 0u));
+}
+//--------------------------------------------------------------------------
+void TraceProfilerTests::testRingBufferWrap()
+{
+    static const TraceMarker marker("Wrap");
+
+    TraceProfiler traceProfiler;
+    traceProfiler.setEventsPerThread(60u);
+    CPPUNIT_ASSERT_EQUAL((size_t)64u, traceProfiler.getEventsPerThread());
+
+    traceProfiler._frameStarted();
+    for (size_t i = 0; i < 1000u; ++i)
+    {
+        traceProfiler.profileBegin(marker);
+        traceProfiler.profileEnd();
+    }
+    traceProfiler._frameEnded();
+
+    // Only the last 64 events are kept
+    String json;
+    traceProfiler.exportChromeTrace(json);
+    CPPUNIT_ASSERT_EQUAL((size_t)32u, countOccurrences(json, "\"ph\":\"B\""));
+    CPPUNIT_ASSERT_EQUAL((size_t)32u, countOccurrences(json, "\"ph\":\"E\""));
+}
+//--------------------------------------------------------------------------
+void TraceProfilerTests::testMultiThreaded()
+{
+    static const TraceMarker marker("Worker \"Job\"");
+
+    TraceProfiler traceProfiler;
+    traceProfiler._frameStarted();
+
+    const size_t numThreads = 4u;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads.push_back(std::thread([&traceProfiler]() {
+            traceProfiler.setThreadName("Test Worker");
+            for (size_t j = 0; j < 100u; ++j)
+            {
+                traceProfiler.profileBegin(marker);
+                traceProfiler.profileEnd();
+            }
+        }));
+    }
+    for (size_t i = 0; i < numThreads; ++i)
+        threads[i].join();
+
+    traceProfiler._frameEnded();
+
+    String json;
+    traceProfiler.exportChromeTrace(json);
+    CPPUNIT_ASSERT_EQUAL(numThreads, countOccurrences(json, "\"name\":\"Test Worker\""));
+    CPPUNIT_ASSERT_EQUAL(numThreads * 100u, countOccurrences(json, "\"ph\":\"B\""));
+    CPPUNIT_ASSERT_EQUAL(numThreads * 100u, countOccurrences(json, "\"name\":\"Worker \\\"Job\\\"\""));
+}
@@ -0,0 +1,198 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "WorkQueueTests.h"
+#include "OgreWorkQueue.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(WorkQueueTests);
+
+namespace
+{
+    const uint16 TestChannel = 1u;
+    /// Requests of this type produce no response; they're finished once handled.
+    const uint16 NoResponseRequest = 1u;
+
+    /// Exposes the aborts the queue is still holding on to.
+    class TestWorkQueue : public DefaultWorkQueue
+    {
+    public:
+        TestWorkQueue() : DefaultWorkQueue("TestWorkQueue") {}
+
+        size_t getNumPendingAbortIds() const { return mPendingAborts.ids.size(); }
+        bool hasPendingAborts() const { return !mPendingAborts.empty(); }
+    };
+
+    class RecordingRequestHandler : public WorkQueue::RequestHandler
+    {
+    public:
+        std::vector<WorkQueue::RequestID> mHandled;
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ) override
+        {
+            mHandled.push_back(req->getID());
+            if (req->getType() == NoResponseRequest)
+                return 0;
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+    };
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::testAbortQueuedRequest()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    RecordingRequestHandler handler;
+    TestWorkQueue queue;
+    queue.addRequestHandler(TestChannel, &handler);
+
+    // No workers were started; requests stay in the ring until we dispatch them
+    const WorkQueue::RequestID rid0 = queue.addRequest(TestChannel, 0u, Any());
+    const WorkQueue::RequestID rid1 = queue.addRequest(TestChannel, 0u, Any());
+    const WorkQueue::RequestID rid2 = queue.addRequest(TestChannel, 0u, Any());
+
+    queue.abortRequest(rid1);
+    CPPUNIT_ASSERT_EQUAL((size_t)1u, queue.getNumPendingAbortIds());
+
+    for (int i = 0; i < 3; ++i)
+        queue._processNextRequest();
+
+    CPPUNIT_ASSERT_EQUAL((size_t)2u, handler.mHandled.size());
+    CPPUNIT_ASSERT_EQUAL(rid0, handler.mHandled[0]);
+    CPPUNIT_ASSERT_EQUAL(rid2, handler.mHandled[1]);
+    CPPUNIT_ASSERT_EQUAL((size_t)0u, queue.getNumPendingAbortIds());
+
+    queue.removeRequestHandler(TestChannel, &handler);
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::testAbortUnissuedRequest()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    RecordingRequestHandler handler;
+    TestWorkQueue queue;
+    queue.addRequestHandler(TestChannel, &handler);
+
+    // Ids that haven't been handed out must not abort the request that later gets them
+    queue.abortRequest(0u);
+    queue.abortRequest(1u);
+    queue.abortRequest(1000u);
+    CPPUNIT_ASSERT_EQUAL((size_t)0u, queue.getNumPendingAbortIds());
+
+    const WorkQueue::RequestID rid = queue.addRequest(TestChannel, 0u, Any());
+    queue.abortRequest(rid + 1u);
+    CPPUNIT_ASSERT_EQUAL((size_t)0u, queue.getNumPendingAbortIds());
+
+    queue._processNextRequest();
+    CPPUNIT_ASSERT_EQUAL((size_t)1u, handler.mHandled.size());
+    CPPUNIT_ASSERT_EQUAL(rid, handler.mHandled[0]);
+
+    queue.removeRequestHandler(TestChannel, &handler);
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::testAbortDispatchedRequest()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    RecordingRequestHandler handler;
+    TestWorkQueue queue;
+    queue.addRequestHandler(TestChannel, &handler);
+
+    const WorkQueue::RequestID rid0 = queue.addRequest(TestChannel, NoResponseRequest, Any());
+    const WorkQueue::RequestID rid1 = queue.addRequest(TestChannel, NoResponseRequest, Any());
+    queue._processNextRequest();
+
+    // rid0 already finished. Its abort can't be told apart from one for a request still in
+    // the ring, so it's recorded until the ring drains.
+    queue.abortRequest(rid0);
+    CPPUNIT_ASSERT_EQUAL((size_t)1u, queue.getNumPendingAbortIds());
+
+    queue._processNextRequest();
+    CPPUNIT_ASSERT_EQUAL((size_t)2u, handler.mHandled.size());
+    CPPUNIT_ASSERT_EQUAL(rid1, handler.mHandled[1]);
+    CPPUNIT_ASSERT_EQUAL((size_t)0u, queue.getNumPendingAbortIds());
+
+    // Nothing is waiting for dispatch, there's nothing to record
+    queue.abortRequest(rid0);
+    queue.abortRequest(rid1);
+    CPPUNIT_ASSERT_EQUAL((size_t)0u, queue.getNumPendingAbortIds());
+
+    queue.removeRequestHandler(TestChannel, &handler);
+}
+//--------------------------------------------------------------------------
+void WorkQueueTests::testAbortRecordsPruned()
+{
+    UnitTestSuite::getSingletonPtr()->startTestMethod(__FUNCTION__);
+
+    RecordingRequestHandler handler;
+    TestWorkQueue queue;
+    queue.addRequestHandler(TestChannel, &handler);
+
+    queue.addRequest(TestChannel, NoResponseRequest, Any());
+    queue.addRequest(TestChannel, NoResponseRequest, Any());
+    queue.abortRequestsByChannel(TestChannel);
+    CPPUNIT_ASSERT(queue.hasPendingAborts());
+
+    // Once the ring drains, nothing issued before the abort can be dispatched anymore
+    queue._processNextRequest();
+    CPPUNIT_ASSERT(queue.hasPendingAborts());
+    queue._processNextRequest();
+    CPPUNIT_ASSERT(!queue.hasPendingAborts());
+    CPPUNIT_ASSERT(handler.mHandled.empty());
+
+    const WorkQueue::RequestID rid = queue.addRequest(TestChannel, NoResponseRequest, Any());
+    queue.abortAllRequests();
+    CPPUNIT_ASSERT(queue.hasPendingAborts());
+    queue._processNextRequest();
+    CPPUNIT_ASSERT(!queue.hasPendingAborts());
+    CPPUNIT_ASSERT(handler.mHandled.empty());
+
+    // Requests issued after the aborts are handled normally
+    const WorkQueue::RequestID rid2 = queue.addRequest(TestChannel, NoResponseRequest, Any());
+    CPPUNIT_ASSERT(rid2 > rid);
+    queue._processNextRequest();
+    CPPUNIT_ASSERT_EQUAL((size_t)1u, handler.mHandled.size());
+    CPPUNIT_ASSERT_EQUAL(rid2, handler.mHandled[0]);
+
+    queue.removeRequestHandler(TestChannel, &handler);
+}
@@ -0,0 +1,146 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "WorkStealingSchedulerTests.h"
+#include "Threading/OgreWorkStealingScheduler.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "UnitTestSuite.h"
+
+using namespace Ogre;
+
+// Register the test suite
+CPPUNIT_TEST_SUITE_REGISTRATION(WorkStealingSchedulerTests);
+
+//--------------------------------------------------------------------------
+void WorkStealingSchedulerTests::setUp()
+{
+    UnitTestSuite::getSingletonPtr()->startTestSetup(__FUNCTION__);
+}
+//--------------------------------------------------------------------------
+void WorkStealingSchedulerTests::tearDown()
+{
+}
+//--------------------------------------------------------------------------
+void WorkStealingSchedulerTests::testSingleThread()
+{
+    WorkStealingScheduler scheduler;
+    scheduler.reset(100u, 1u);
+
+    size_t chunkIdx;
+    for (size_t i = 0; i < 100u; ++i)
+    {
+        CPPUNIT_ASSERT(scheduler.getNextChunk(0u, chunkIdx));
+        CPPUNIT_ASSERT_EQUAL(i, chunkIdx);
+    }
+    CPPUNIT_ASSERT(!scheduler.getNextChunk(0u, chunkIdx));
+    CPPUNIT_ASSERT_EQUAL(100u, scheduler.getNumProcessed(0u));
+    CPPUNIT_ASSERT_EQUAL(0u, scheduler.getNumStolen(0u));
+}
+//--------------------------------------------------------------------------
+void WorkStealingSchedulerTests::testEmpty()
+{
+    WorkStealingScheduler scheduler;
+    scheduler.reset(0u, 4u);
+
+    size_t chunkIdx;
+    for (size_t i = 0; i < 4u; ++i)
+        CPPUNIT_ASSERT(!scheduler.getNextChunk(i, chunkIdx));
+
+    // Less chunks than threads
+    scheduler.reset(2u, 4u);
+    size_t numChunks = 0;
+    for (size_t i = 0; i < 4u; ++i)
+    {
+        while (scheduler.getNextChunk(i, chunkIdx))
+            ++numChunks;
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t)2u, numChunks);
+}
+//--------------------------------------------------------------------------
+static void runThreads(WorkStealingScheduler &scheduler, size_t numChunks, size_t numThreads,
+                       bool unbalanced)
+{
+    std::vector<std::atomic<uint32> > timesProcessed(numChunks);
+    for (size_t i = 0; i < numChunks; ++i)
+        timesProcessed[i] = 0u;
+
+    scheduler.reset(numChunks, numThreads);
+
+    std::vector<std::thread> threads;
+    for (size_t threadIdx = 0; threadIdx < numThreads; ++threadIdx)
+    {
+        threads.push_back(std::thread([&, threadIdx]() {
+            size_t chunkIdx;
+            while (scheduler.getNextChunk(threadIdx, chunkIdx))
+            {
+                ++timesProcessed[chunkIdx];
+                // Make thread 0 much slower than the rest, so others must steal from it
+                if (unbalanced && threadIdx == 0u)
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }));
+    }
+
+    for (size_t i = 0; i < numThreads; ++i)
+        threads[i].join();
+
+    // Every chunk must be processed exactly once
+    for (size_t i = 0; i < numChunks; ++i)
+        CPPUNIT_ASSERT_EQUAL(1u, timesProcessed[i].load());
+
+    size_t totalProcessed = 0;
+    for (size_t i = 0; i < numThreads; ++i)
+        totalProcessed += scheduler.getNumProcessed(i);
+    CPPUNIT_ASSERT_EQUAL(numChunks, totalProcessed);
+}
+//--------------------------------------------------------------------------
+void WorkStealingSchedulerTests::testMultiThreaded()
+{
+    WorkStealingScheduler scheduler;
+    for (int i = 0; i < 20; ++i)
+        runThreads(scheduler, 5000u, 8u, false);
+    runThreads(scheduler, 7u, 8u, false);
+    runThreads(scheduler, 1u, 3u, false);
+}
+//--------------------------------------------------------------------------
+void WorkStealingSchedulerTests::testUnbalanced()
+{
+    WorkStealingScheduler scheduler;
+    runThreads(scheduler, 400u, 4u, true);
+
+    // Thread 0 is slow, so the others must've taken most of its work
+    CPPUNIT_ASSERT(scheduler.getNumProcessed(0u) < 100u);
+
+    uint32 numStolen = 0;
+    for (size_t i = 1; i < 4u; ++i)
+        numStolen += scheduler.getNumStolen(i);
+    CPPUNIT_ASSERT(numStolen > 0u);
+}
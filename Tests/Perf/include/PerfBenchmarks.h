@@ -0,0 +1,46 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __PerfBenchmarks_H__
+#define __PerfBenchmarks_H__
+
+#include "OgrePrerequisites.h"
+
+/** Benchmarks that are too slow or too noisy to live in Test_Ogre.
+    Each one logs its timings through the LogManager; there is no pass/fail.
+*/
+
+/// RadixSort vs std::sort / std::stable_sort on QueuedRenderables
+void benchmarkRadixSortQueuedRenderables();
+
+/// Linear vs ObjectDataBvh frustum culling, plus BVH build & refit times
+void benchmarkObjectDataBvhCull();
+
+/// ParticleSystemDef's radix depth sort vs std::sort on the particle handles
+void benchmarkParticleDepthSort();
+
+#endif
@@ -0,0 +1,225 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PerfBenchmarks.h"
+
+#include "Math/Array/OgreBooleanMask.h"
+#include "Math/Array/OgreObjectDataBvh.h"
+#include "OgreLogManager.h"
+#include "OgrePlane.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+#include <vector>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Fake memory layout of a render queue. Only world AABBs and owners are used.
+    struct BenchmarkObjects
+    {
+        size_t numObjs;
+        ArrayAabb* worldAabb;
+        std::vector<MovableObject*> owners;
+        ObjectData objData;
+        uint32 seed;
+
+        BenchmarkObjects(size_t _numObjs) : numObjs(_numObjs), seed(12345u)
+        {
+            const size_t numPacks = (numObjs + ARRAY_PACKED_REALS - 1u) / ARRAY_PACKED_REALS;
+            worldAabb = reinterpret_cast<ArrayAabb*>(
+                OGRE_MALLOC_SIMD(sizeof(ArrayAabb) * std::max<size_t>(numPacks, 1u),
+                                 MEMCATEGORY_SCENE_OBJECTS));
+            owners.resize(std::max<size_t>(numPacks, 1u) * ARRAY_PACKED_REALS, 0);
+            for (size_t i = 0; i < numPacks; ++i)
+                worldAabb[i] = ArrayAabb::BOX_ZERO;
+
+            memset(&objData, 0, sizeof(objData));
+            objData.mWorldAabb = worldAabb;
+            objData.mOwner = &owners[0];
+        }
+        ~BenchmarkObjects() { OGRE_FREE_SIMD(worldAabb, MEMCATEGORY_SCENE_OBJECTS); }
+
+        Real random()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<Real>(seed >> 8u) / static_cast<Real>(1u << 24u);
+        }
+
+        /// Objects are laid out in rows, the way they'd usually be created when loading a level.
+        void fillCoherent(Real worldSize)
+        {
+            const size_t objsPerRow = static_cast<size_t>(Math::Sqrt(Real(numObjs))) + 1u;
+            const Real spacing = worldSize / Real(objsPerRow);
+            for (size_t i = 0; i < numObjs; ++i)
+            {
+                const Vector3 center(Real(i % objsPerRow) * spacing, random() * 10.0f,
+                                     Real(i / objsPerRow) * spacing);
+                const Aabb aabb(center, Vector3(0.25f + random()) * spacing * 0.5f);
+                worldAabb[i / ARRAY_PACKED_REALS].setFromAabb(aabb, i % ARRAY_PACKED_REALS);
+                // Any non-null pointer will do
+                owners[i] = reinterpret_cast<MovableObject*>(this);
+            }
+        }
+    };
+
+    /// Frustum shaped like a box. Normals point inwards, like Frustum's planes.
+    void makeBoxPlanes(const Vector3& minCorner, const Vector3& maxCorner, Plane outPlanes[6])
+    {
+        outPlanes[0] = Plane(Vector3::UNIT_X, minCorner);
+        outPlanes[1] = Plane(Vector3::NEGATIVE_UNIT_X, maxCorner);
+        outPlanes[2] = Plane(Vector3::UNIT_Y, minCorner);
+        outPlanes[3] = Plane(Vector3::NEGATIVE_UNIT_Y, maxCorner);
+        outPlanes[4] = Plane(Vector3::UNIT_Z, minCorner);
+        outPlanes[5] = Plane(Vector3::NEGATIVE_UNIT_Z, maxCorner);
+    }
+
+    /// Same test as MovableObject::cullFrustum, without the flags & distance checks.
+    /// Returns the number of visible objects; and flags them in outVisible.
+    size_t cullLinear(const BenchmarkObjects& objects, size_t firstPack, size_t numPacks,
+                      const Plane planes[6], std::vector<uint8>& outVisible)
+    {
+        ArrayVector3 planeNormal[6];
+        ArrayVector3 signFlip[6];
+        ArrayReal planeNegD[6];
+        for (size_t i = 0; i < 6u; ++i)
+        {
+            planeNormal[i].setAll(planes[i].normal);
+            signFlip[i].setAll(planes[i].normal);
+            signFlip[i].setToSign();
+            planeNegD[i] = Mathlib::SetAll(-planes[i].d);
+        }
+
+        size_t numVisible = 0u;
+        for (size_t i = firstPack; i < firstPack + numPacks; ++i)
+        {
+            const ArrayAabb& aabb = objects.worldAabb[i];
+            ArrayMaskR mask = BooleanMask4::getAllSetMask();
+            for (size_t j = 0; j < 6u; ++j)
+            {
+                const ArrayReal dotResult =
+                    planeNormal[j].dotProduct(aabb.mCenter + aabb.mHalfSize * signFlip[j]);
+                mask = Mathlib::And(mask, Mathlib::CompareGreater(dotResult, planeNegD[j]));
+            }
+            ArrayMaskR isInfinite = Mathlib::Or(Mathlib::isInfinity(aabb.mHalfSize.mChunkBase[0]),
+                                                Mathlib::isInfinity(aabb.mHalfSize.mChunkBase[1]));
+            isInfinite = Mathlib::Or(Mathlib::isInfinity(aabb.mHalfSize.mChunkBase[2]), isInfinite);
+            const uint32 scalarMask = BooleanMask4::getScalarMask(Mathlib::Or(mask, isInfinite));
+
+            for (size_t j = 0; j < ARRAY_PACKED_REALS; ++j)
+            {
+                const size_t idx = i * ARRAY_PACKED_REALS + j;
+                if (IS_BIT_SET(j, scalarMask) && objects.owners[idx])
+                {
+                    outVisible[idx] = 1u;
+                    ++numVisible;
+                }
+            }
+        }
+
+        return numVisible;
+    }
+
+    size_t cullWithBvh(ObjectDataBvh& bvh, const BenchmarkObjects& objects, const Plane planes[6],
+                       std::vector<uint8>& outVisible)
+    {
+        ObjectDataBvh::PackRangeArray ranges;
+        bvh.cullFrustum(planes, 128u, ranges);
+
+        size_t numVisible = 0u;
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            numVisible += cullLinear(objects, ranges[i].firstPack, ranges[i].numPacks, planes,
+                                     outVisible);
+        }
+        return numVisible;
+    }
+}
+//--------------------------------------------------------------------------
+void benchmarkObjectDataBvhCull()
+{
+    const size_t numEntries[3] = { 100000u, 250000u, 1000000u };
+    const size_t numIterations = 10u;
+
+    Timer timer;
+
+    for (size_t i = 0; i < 3u; ++i)
+    {
+        BenchmarkObjects objects(numEntries[i]);
+        objects.fillCoherent(10000.0f);
+
+        const size_t numPacks = (objects.numObjs + ARRAY_PACKED_REALS - 1u) / ARRAY_PACKED_REALS;
+        std::vector<uint8> visible(objects.owners.size(), 0u);
+
+        // Roughly 10% of the scene is in view
+        Plane planes[6];
+        makeBoxPlanes(Vector3(4000.0f, -100.0f, 4000.0f), Vector3(7000.0f, 100.0f, 7000.0f),
+                      planes);
+
+        ObjectDataBvh bvh;
+        timer.reset();
+        bvh.build(objects.objData, objects.numObjs);
+        const uint64 timeBuild = timer.getMicroseconds();
+
+        uint64 timeLinear = 0;
+        uint64 timeRefit = 0;
+        uint64 timeBvh = 0;
+        size_t numVisible = 0;
+
+        for (size_t j = 0; j < numIterations; ++j)
+        {
+            timer.reset();
+            numVisible = cullLinear(objects, 0u, numPacks, planes, visible);
+            timeLinear += timer.getMicroseconds();
+
+            timer.reset();
+            bvh.refit(objects.objData);
+            timeRefit += timer.getMicroseconds();
+
+            timer.reset();
+            const size_t numVisibleBvh = cullWithBvh(bvh, objects, planes, visible);
+            timeBvh += timer.getMicroseconds();
+
+            if (numVisibleBvh != numVisible)
+            {
+                LogManager::getSingleton().logMessage(
+                    "ERROR: ObjectDataBvh culling doesn't match linear culling", LML_CRITICAL);
+            }
+        }
+
+        LogManager::getSingleton().logMessage(
+            "ObjectDataBvh x" + StringConverter::toString(numEntries[i]) + " (" +
+            StringConverter::toString(numVisible) + " visible, avg over " +
+            StringConverter::toString(numIterations) + " runs): linear " +
+            StringConverter::toString(timeLinear / numIterations) + "us, bvh " +
+            StringConverter::toString(timeBvh / numIterations) + "us, refit " +
+            StringConverter::toString(timeRefit / numIterations) + "us, build " +
+            StringConverter::toString(timeBuild) + "us");
+    }
+}
+//--------------------------------------------------------------------------
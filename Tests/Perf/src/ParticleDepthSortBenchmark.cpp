@@ -0,0 +1,172 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PerfBenchmarks.h"
+
+#include "OgreLogManager.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+#include "ParticleSystem/OgreParticleSystem2.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Only the channels used by the depth sort are allocated.
+    struct BenchmarkParticles
+    {
+        size_t numParticles;
+        ParticleCpuData cpuData;
+        uint32 seed;
+
+        BenchmarkParticles(size_t _numParticles) : numParticles(_numParticles), seed(12345u)
+        {
+            memset(&cpuData, 0, sizeof(cpuData));
+            cpuData.mPosition = reinterpret_cast<ArrayVector3*>(
+                OGRE_MALLOC_SIMD(numParticles * sizeof(Vector3), MEMCATEGORY_GEOMETRY));
+            cpuData.mTimeToLive = reinterpret_cast<ArrayReal*>(
+                OGRE_MALLOC_SIMD(numParticles * sizeof(Real), MEMCATEGORY_GEOMETRY));
+        }
+        ~BenchmarkParticles()
+        {
+            OGRE_FREE_SIMD(cpuData.mTimeToLive, MEMCATEGORY_GEOMETRY);
+            OGRE_FREE_SIMD(cpuData.mPosition, MEMCATEGORY_GEOMETRY);
+        }
+
+        Real random()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<Real>(seed >> 8u) / static_cast<Real>(1u << 24u);
+        }
+
+        Vector3 getPosition(size_t idx) const
+        {
+            Vector3 retVal;
+            cpuData.mPosition[idx / ARRAY_PACKED_REALS].getAsVector3(retVal, idx % ARRAY_PACKED_REALS);
+            return retVal;
+        }
+
+        bool isAlive(size_t idx) const
+        {
+            return reinterpret_cast<const Real*>(cpuData.mTimeToLive)[idx] > 0.0f;
+        }
+
+        /// A cloud of smoke where every 4th particle is dead.
+        void fillSmokeCloud(Real size)
+        {
+            for (size_t i = 0; i < numParticles; ++i)
+            {
+                const Vector3 pos(random() * size, random() * size, random() * size);
+                cpuData.mPosition[i / ARRAY_PACKED_REALS].setFromVector3(pos, i % ARRAY_PACKED_REALS);
+                reinterpret_cast<Real*>(cpuData.mTimeToLive)[i] =
+                    (i % 4u) == 3u ? 0.0f : random() + 0.1f;
+            }
+        }
+    };
+
+    struct SortByDistanceDesc
+    {
+        const BenchmarkParticles& particles;
+        Vector3 camPos;
+
+        SortByDistanceDesc(const BenchmarkParticles& _particles, const Vector3& _camPos) :
+            particles(_particles), camPos(_camPos)
+        {
+        }
+
+        bool operator()(uint32 a, uint32 b) const
+        {
+            return particles.getPosition(a).squaredDistance(camPos) >
+                   particles.getPosition(b).squaredDistance(camPos);
+        }
+    };
+}  // namespace
+//--------------------------------------------------------------------------
+void benchmarkParticleDepthSort()
+{
+    const size_t numEntries[3] = { 100000u, 250000u, 1000000u };
+    const size_t numIterations = 10u;
+
+    const Vector3 camPos(50.0f, 50.0f, -20.0f);
+
+    Timer timer;
+
+    for (size_t i = 0; i < 3u; ++i)
+    {
+        BenchmarkParticles particles(numEntries[i]);
+        particles.fillSmokeCloud(100.0f);
+
+        std::vector<uint64> keys(particles.numParticles);
+        std::vector<uint64> tmp(particles.numParticles);
+        std::vector<uint32> indices(particles.numParticles * 6u);
+        std::vector<uint32> handles;
+
+        uint64 timeKeys = 0;
+        uint64 timeRadixSort = 0;
+        uint64 timeStdSort = 0;
+
+        for (size_t j = 0; j < numIterations; ++j)
+        {
+            // Move the camera so that the previous order can't be reused
+            const Vector3 iterCamPos = camPos + Vector3(Real(j) * 10.0f, 0.0f, 0.0f);
+            ArrayVector3 arrayCamPos;
+            arrayCamPos.setAll(iterCamPos);
+
+            timer.reset();
+            ParticleSystemDef::_calculateDepthSortKeys(particles.cpuData, particles.numParticles,
+                                                       arrayCamPos, 0u, &keys[0]);
+            timeKeys += timer.getMicroseconds();
+
+            timer.reset();
+            ParticleSystemDef::_sortParticlesBackToFront(&keys[0], &tmp[0], keys.size(), false,
+                                                         &indices[0]);
+            timeRadixSort += timer.getMicroseconds();
+
+            // What sorting the handles with a comparison sort would cost
+            handles.clear();
+            for (uint32 k = 0; k < particles.numParticles; ++k)
+            {
+                if (particles.isAlive(k))
+                    handles.push_back(k);
+            }
+            timer.reset();
+            std::sort(handles.begin(), handles.end(), SortByDistanceDesc(particles, iterCamPos));
+            timeStdSort += timer.getMicroseconds();
+        }
+
+        LogManager::getSingleton().logMessage(
+            "Particle depth sort x" + StringConverter::toString(numEntries[i]) + " (avg over " +
+            StringConverter::toString(numIterations) + " runs): keys " +
+            StringConverter::toString(timeKeys / numIterations) + "us, radix sort + indices " +
+            StringConverter::toString(timeRadixSort / numIterations) + "us, std::sort " +
+            StringConverter::toString(timeStdSort / numIterations) + "us");
+    }
+}
+//--------------------------------------------------------------------------
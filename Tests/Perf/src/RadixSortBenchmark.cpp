@@ -0,0 +1,128 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE-Next
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "PerfBenchmarks.h"
+
+#include "OgreLogManager.h"
+#include "OgreRadixSort.h"
+#include "OgreRenderQueue.h"
+#include "OgreStringConverter.h"
+#include "OgreTimer.h"
+
+#include <algorithm>
+
+using namespace Ogre;
+
+static uint64 randomUint64()
+{
+    return ((uint64)rand() << 48u) ^ ((uint64)rand() << 32u) ^ ((uint64)rand() << 16u) ^
+           (uint64)rand();
+}
+//--------------------------------------------------------------------------
+/// Generates hashes that look like RenderQueue's: a handful of materials and
+/// meshes in the most significant bits, random depth in the least significant.
+static void generateQueuedRenderables(std::vector<QueuedRenderable>& container, size_t numEntries)
+{
+    container.clear();
+    container.reserve(numEntries);
+    for (size_t i = 0; i < numEntries; ++i)
+    {
+        const uint64 material = (uint64)(rand() % 64) << 40u;
+        const uint64 mesh = (uint64)(rand() % 256) << 24u;
+        const uint64 depth = randomUint64() & 0xFFFFFF;
+        container.push_back(QueuedRenderable(material | mesh | depth, 0,
+                                             reinterpret_cast<MovableObject*>(i + 1u)));
+    }
+}
+//--------------------------------------------------------------------------
+struct QueuedRenderableHash
+{
+    uint64 operator()(const QueuedRenderable& q) const
+    {
+        return q.hash;
+    }
+};
+//--------------------------------------------------------------------------
+void benchmarkRadixSortQueuedRenderables()
+{
+    const size_t numEntries[3] = { 1000u, 10000u, 100000u };
+    const size_t numIterations = 20u;
+
+    std::vector<QueuedRenderable> source;
+    std::vector<QueuedRenderable> container;
+    std::vector<QueuedRenderable> tmp;
+
+    Timer timer;
+
+    for (size_t i = 0; i < 3u; ++i)
+    {
+        generateQueuedRenderables(source, numEntries[i]);
+        tmp.resize(source.size());
+
+        uint64 timeSort = 0;
+        uint64 timeStableSort = 0;
+        uint64 timeRadixSort = 0;
+
+        for (size_t j = 0; j < numIterations; ++j)
+        {
+            container = source;
+            timer.reset();
+            std::sort(container.begin(), container.end());
+            timeSort += timer.getMicroseconds();
+
+            container = source;
+            timer.reset();
+            std::stable_sort(container.begin(), container.end());
+            timeStableSort += timer.getMicroseconds();
+
+            container = source;
+            timer.reset();
+            const QueuedRenderable* sorted =
+                radixSortUint64(&container[0], &tmp[0], container.size(), QueuedRenderableHash());
+            timeRadixSort += timer.getMicroseconds();
+
+            for (size_t k = 1; k < container.size(); ++k)
+            {
+                if (sorted[k - 1].hash > sorted[k].hash)
+                {
+                    LogManager::getSingleton().logMessage(
+                        "ERROR: radixSortUint64 produced an unsorted QueuedRenderable list",
+                        LML_CRITICAL);
+                    break;
+                }
+            }
+        }
+
+        LogManager::getSingleton().logMessage(
+            "QueuedRenderable x" + StringConverter::toString(numEntries[i]) + " (avg over " +
+            StringConverter::toString(numIterations) + " runs): std::sort " +
+            StringConverter::toString(timeSort / numIterations) + "us, std::stable_sort " +
+            StringConverter::toString(timeStableSort / numIterations) + "us, radixSortUint64 " +
+            StringConverter::toString(timeRadixSort / numIterations) + "us");
+    }
+}
+//--------------------------------------------------------------------------
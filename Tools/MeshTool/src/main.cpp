@@ -101,6 +101,8 @@ void help()
     cout << "-b         = Recalculate bounding box (static meshes only)" << endl;
     cout << "-V version = Specify OGRE version format to write instead of latest" << endl;
     cout << "             Options are: 2.1, 1.10, 1.8, 1.7, 1.4, 1.0" << endl;
+    cout << "             2.1p writes the v2 packed format: vertex & index buffers are stored" << endl;
+    cout << "             page aligned at the end of the file for faster loading. Implies -v2" << endl;
     cout << "-v2          Export the mesh as a v2 object. Keeps the original format otherwise." << endl;
     cout << "             Use this format if you load the mesh by the SceneManager::createItem() method." << endl;
     cout << "-v1          Export the mesh as a v1 object. Keeps the original format otherwise." << endl;
@@ -310,6 +312,12 @@ void parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
             opts.targetVersion  = v1::MESH_VERSION_2_1;
             opts.targetVersionV2= MESH_VERSION_2_1;
         }
+        else if( bi->second == "2.1p" && !opts.exportAsV1 )
+        {
+            //There is no v1 packed format
+            opts.exportAsV2     = true;
+            opts.targetVersionV2= MESH_VERSION_2_1_PACKED;
+        }
 
         if( !opts.exportAsV2 )
         {